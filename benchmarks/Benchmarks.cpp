@@ -1,13 +1,1221 @@
 #include "catch2/benchmark/catch_benchmark_all.hpp"
 #include "catch2/catch_test_macros.hpp"
 
-TEST_CASE ("Boot performance")
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <tracktion_engine/tracktion_engine.h>
+
+#include "AutomationLane.h"
+#include "BeatGrid.h"
+#include "ChopComponent.h"
+#include "ChopTrackLane.h"
+#include "CustomLookAndFeel.h"
+#include "DelayComponent.h"
+#include "FlangerComponent.h"
+#include "FrameScheduler.h"
+#include "LibraryComponent.h"
+#include "Analysis/AnalysisPipeline.h"
+#include "Analysis/DownbeatFinder.h"
+#include "Analysis/KeyAnalyzer.h"
+#include "Analysis/LoudnessAnalyzer.h"
+#include "Analysis/OnsetEnvelopeAnalyzer.h"
+#include "Analysis/PeakPyramidAnalyzer.h"
+#include "Analysis/SilenceAnalyzer.h"
+#include "Analysis/TempoMap.h"
+#include "Analysis/TrackAnalysis.h"
+#include "Analysis/TempoAnalyzer.h"
+#include "LibraryIndex.h"
+#include "LibraryPersistence.h"
+#include "LibrarySnapshot.h"
+#include "PhaserComponent.h"
+#include "PluginAutomationComponent.h"
+#include "RampedValue.h"
+#include "ReverbComponent.h"
+#include "ScratchComponent.h"
+#include "ScrewComponent.h"
+#include "ThumbnailComponent.h"
+#include "TransportComponent.h"
+#include "UIProfiler.h"
+#include "VinylBrakeComponent.h"
+#include "RegionManager.h"
+#include "RingBuffer.h"
+#include "TestFixtures.h"
+#include "minibpm.h"
+
+// Run with no arguments to get console output plus benchmark-results.xml
+// (see Catch2Main.cpp); the XML holds mean/std-dev per benchmark for diffing builds.
+// Only timings live here; what the timed code gets right is checked in tests/,
+// on the same fixtures (TestFixtures.h).
+
+using namespace TestFixtures;
+
+namespace
+{
+    constexpr std::array<int, 4> blockSizes { 64, 128, 512, 1024 };
+
+    // The Edit-dependent components MainComponent shows, laid out at a typical window size
+    struct EditComponents
+    {
+        explicit EditComponents (tracktion::engine::Edit& edit)
+            : reverb (edit), delay (edit), flanger (edit), phaser (edit), chop (edit),
+              screw (edit), scratch (edit), vinylBrake (edit), transport (edit, ZoomState::instance())
+        {
+            for (auto* c : std::initializer_list<BaseEffectComponent*> { &reverb, &delay, &flanger, &phaser,
+                                                                          &chop, &screw, &scratch, &vinylBrake })
+                c->setBounds (0, 0, 300, 160);
+
+            transport.setBounds (0, 0, 900, 340);
+            transport.updateThumbnail();
+        }
+
+        void setEdit (tracktion::engine::Edit& edit)
+        {
+            for (auto* c : std::initializer_list<BaseEffectComponent*> { &reverb, &delay, &flanger, &phaser,
+                                                                          &chop, &screw, &scratch, &vinylBrake })
+                c->setEdit (edit);
+
+            transport.setEdit (edit);
+        }
+
+        ReverbComponent reverb;
+        DelayComponent delay;
+        FlangerComponent flanger;
+        PhaserComponent phaser;
+        ChopComponent chop;
+        ScrewComponent screw;
+        ScratchComponent scratch;
+        VinylBrakeComponent vinylBrake;
+        TransportComponent transport;
+    };
+
+    // Starts the Edit playing through the engine's hosted device and pulls blocks until
+    // one is audible. Returns the number of blocks that took, or -1 if none was.
+    int playUntilFirstAudio (tracktion::engine::Edit& edit, juce::AudioBuffer<float>& block)
+    {
+        auto& hostedDevice = edit.engine.getDeviceManager().getHostedAudioDeviceInterface();
+        juce::MidiBuffer midi;
+
+        edit.getTransport().ensureContextAllocated();
+        edit.getTransport().play (false);
+
+        const auto maxBlocks = (int) (referenceSampleRate * 5.0) / block.getNumSamples();
+
+        for (int i = 0; i < maxBlocks; ++i)
+        {
+            block.clear();
+            hostedDevice.processBlock (block, midi);
+            midi.clear();
+
+            if (block.getMagnitude (0, block.getNumSamples()) > 1.0e-4f)
+                return i + 1;
+        }
+
+        return -1;
+    }
+
+    // Measures one applyToBuffer call per iteration at each of the common block sizes.
+    // The block is refilled from a longer source each time so feedback paths don't settle
+    // into silence or denormals.
+    void benchmarkPluginBlocks (const char* xmlTypeName,
+                                const juce::String& displayName,
+                                std::function<void (tracktion::engine::Plugin&)> configure = {})
+    {
+        ChopShopEngine chopShopEngine;
+        auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+        auto plugin = edit->getPluginCache().createNewPlugin (xmlTypeName, {});
+        REQUIRE (plugin != nullptr);
+
+        if (configure)
+            configure (*plugin);
+
+        const auto source = createClickTrack (referenceSampleRate, 4.0, referenceBpm);
+
+        for (auto blockSize : blockSizes)
+        {
+            plugin->baseClassInitialise ({ tracktion::TimePosition(), referenceSampleRate, blockSize });
+
+            juce::AudioBuffer<float> block (2, blockSize);
+            int sourcePos = 0;
+            auto editTime = tracktion::TimePosition();
+            const auto blockDuration = tracktion::TimeDuration::fromSamples (blockSize, referenceSampleRate);
+
+            auto processBlock = [&]
+            {
+                if (sourcePos + blockSize > source.getNumSamples())
+                    sourcePos = 0;
+
+                for (int ch = 0; ch < 2; ++ch)
+                    block.copyFrom (ch, 0, source, ch, sourcePos, blockSize);
+
+                tracktion::engine::PluginRenderContext rc (&block, juce::AudioChannelSet::stereo(),
+                                                           0, blockSize, nullptr, 0.0,
+                                                           { editTime, editTime + blockDuration },
+                                                           true, false, false, false);
+                plugin->applyToBuffer (rc);
+
+                sourcePos += blockSize;
+                editTime = editTime + blockDuration;
+                return block.getSample (0, 0);
+            };
+
+            BENCHMARK_ADVANCED ((displayName + " block " + juce::String (blockSize)).toStdString())
+            (Catch::Benchmark::Chronometer meter)
+            {
+                meter.measure (processBlock);
+            };
+
+            plugin->baseClassDeinitialise();
+        }
+    }
+}
+
+//==============================================================================
+TEST_CASE ("MiniBPM analysis throughput", "[analysis]")
+{
+    constexpr double seconds = 30.0;
+
+    for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+    {
+        const auto signal = createClickTrack (sampleRate, seconds, referenceBpm, 1);
+        constexpr int blockSize = 1024; // MiniBPM on its own; the import path is "Import analysis pipeline"
+
+        auto analyse = [&]
+        {
+            breakfastquay::MiniBPM detector ((float) sampleRate);
+            detector.setBPMRange (60, 180);
+
+            for (int pos = 0; pos < signal.getNumSamples(); pos += blockSize)
+                detector.process (signal.getReadPointer (0, pos), std::min (blockSize, signal.getNumSamples() - pos));
+
+            return detector.estimateTempo();
+        };
+
+        BENCHMARK ("MiniBPM 30 s @ " + std::to_string ((int) sampleRate) + " Hz")
+        {
+            return analyse();
+        };
+    }
+}
+
+TEST_CASE ("Import analysis pipeline", "[analysis]")
+{
+    // One minute of stereo click track, with two seconds of silence in front
+    constexpr double seconds = 60.0, leadIn = 2.0;
+    const auto clicks = createClickTrack (referenceSampleRate, seconds - leadIn, referenceBpm);
+    juce::AudioBuffer<float> signal (2, (int) (referenceSampleRate * seconds));
+    signal.clear();
+
+    for (int ch = 0; ch < 2; ++ch)
+        signal.copyFrom (ch, (int) (referenceSampleRate * leadIn), clicks, ch, 0, clicks.getNumSamples());
+
+    TemporaryDirectory tempDir;
+    auto reader = createReaderFor (writeWavFile (signal, referenceSampleRate, tempDir.getChildFile ("analysis.wav")));
+
+    TempoAnalyzer tempo;
+    PeakPyramidAnalyzer peaks;
+    OnsetEnvelopeAnalyzer onsets;
+    SilenceAnalyzer silence;
+    const std::array<AudioAnalyzer*, 4> all { &tempo, &peaks, &onsets, &silence };
+
+    auto runPipeline = [&] (int numThreads, std::initializer_list<AudioAnalyzer*> analyzers)
+    {
+        AnalysisPipeline pipeline (numThreads);
+
+        for (auto* analyzer : analyzers)
+            pipeline.addAnalyzer (*analyzer);
+
+        return pipeline.run (*reader);
+    };
+
+    BENCHMARK ("Analysis 60 s, one decode per analyzer")
+    {
+        bool ok = true;
+
+        for (auto* analyzer : all)
+            ok = runPipeline (1, { analyzer }) && ok;
+
+        return ok;
+    };
+
+    BENCHMARK ("Analysis 60 s, one decode, 1 thread")
+    {
+        return runPipeline (1, { &tempo, &peaks, &onsets, &silence });
+    };
+
+    BENCHMARK ("Analysis 60 s, one decode, all cores")
+    {
+        return runPipeline (0, { &tempo, &peaks, &onsets, &silence });
+    };
+
+    reader = nullptr;
+}
+
+TEST_CASE ("Tempo map", "[analysis]")
+{
+    // Two minutes of click track drifting from 117 to 123 BPM, like a live take
+    TemporaryDirectory tempDir;
+    const auto analysis = analyseFile (writeWavFile (createDriftingClickTrack (120.0, 117.0, 123.0),
+                                                     referenceSampleRate, tempDir.getChildFile ("drifting.wav")));
+
+    // The map reuses the onset envelope, so it costs this on top of the global estimate
+    BENCHMARK ("Tempo map from the onset envelope, 120 s")
+    {
+        return TempoMap::estimate (analysis.onsetEnvelope, analysis.onsetFrameRate, analysis.bpm).points.size();
+    };
+}
+
+TEST_CASE ("Downbeat alignment", "[analysis]")
+{
+    // Two pickup beats after a silent lead-in, and a silent tail
+    TemporaryDirectory tempDir;
+    const auto analysis = analyseFile (writeWavFile (createDownbeatTrack (40.0, 1.3, 2, 3.0),
+                                                     referenceSampleRate, tempDir.getChildFile ("downbeat.wav")));
+
+    BENCHMARK ("First downbeat from the onset envelope, 40 s")
+    {
+        return DownbeatFinder::findFirstDownbeat (analysis.onsetEnvelope, analysis.onsetFrameRate, TempoMap::steady (analysis.bpm),
+                                                  analysis.leadingSilence, analysis.duration - analysis.trailingSilence);
+    };
+}
+
+TEST_CASE ("Loudness analysis", "[analysis]")
+{
+    LoudnessAnalyzer loudness;
+    const auto track = createClickTrack (referenceSampleRate, 60.0, referenceBpm);
+
+    BENCHMARK ("Loudness and true peak 60 s stereo")
+    {
+        analyseLoudness (loudness, track, referenceSampleRate);
+        return loudness.getIntegratedLoudness();
+    };
+}
+
+TEST_CASE ("Key detection", "[analysis]")
+{
+    // Budget: a five-minute track, decode included, in under a second. The pipeline
+    // runs the analyzer on one worker thread while this thread decodes, so two
+    // threads are busy, but never more than one core's worth of analysis.
+    TemporaryDirectory tempDir;
+    const auto longFile = writeWavFile (createClickTrack (referenceSampleRate, 300.0, referenceBpm), referenceSampleRate,
+                                        tempDir.getChildFile ("five-minutes.wav"));
+
+    {
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        detectKey (longFile);
+        const auto elapsedMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+        WARN ("Key detection, 5 min track, one analysis thread plus the decoding thread: " << juce::roundToInt (elapsedMs) << " ms");
+        CHECK (elapsedMs < 1000.0);
+    }
+
+    BENCHMARK ("Key detection 5 min, decode included, 1 analysis thread + decoder")
+    {
+        return detectKey (longFile).tonic;
+    };
+}
+
+TEST_CASE ("RingBuffer throughput", "[ringbuffer]")
+{
+    // Same shape as the oscilloscope: stereo, ten blocks deep
+    for (auto blockSize : blockSizes)
+    {
+        RingBuffer<float> ring (2, blockSize * 10);
+        auto input = createClickTrack (referenceSampleRate, 0.1, referenceBpm);
+        juce::AudioBuffer<float> block (2, blockSize), output (2, blockSize);
+        block.copyFrom (0, 0, input, 0, 0, blockSize);
+        block.copyFrom (1, 0, input, 1, 0, blockSize);
+
+        BENCHMARK ("RingBuffer write block " + std::to_string (blockSize))
+        {
+            ring.writeSamples (block, 0, blockSize);
+            return block.getSample (0, 0);
+        };
+
+        BENCHMARK ("RingBuffer write+read block " + std::to_string (blockSize))
+        {
+            ring.writeSamples (block, 0, blockSize);
+            ring.readSamples (output, blockSize);
+            return output.getSample (0, 0);
+        };
+    }
+}
+
+TEST_CASE ("Effect plugin per-block cost", "[plugins]")
+{
+    SECTION ("Scratch")
+    {
+        benchmarkPluginBlocks (ScratchPlugin::xmlTypeName, "Scratch (idle)");
+
+        // Off-centre so the interpolated read path runs rather than the pass-through
+        benchmarkPluginBlocks (ScratchPlugin::xmlTypeName, "Scratch (scratching)", [] (tracktion::engine::Plugin& p)
+        {
+            if (auto param = p.getAutomatableParameterByID ("scratch"))
+                param->setParameter (0.5f, juce::dontSendNotification);
+        });
+    }
+
+    SECTION ("Reverb")      { benchmarkPluginBlocks (AutoReverbPlugin::xmlTypeName, "Reverb"); }
+    SECTION ("Flanger")     { benchmarkPluginBlocks (FlangerPlugin::xmlTypeName, "Flanger"); }
+    SECTION ("AutoPhaser")  { benchmarkPluginBlocks (AutoPhaserPlugin::xmlTypeName, "AutoPhaser"); }
+    SECTION ("AutoDelay")   { benchmarkPluginBlocks (AutoDelayPlugin::xmlTypeName, "AutoDelay"); }
+}
+
+TEST_CASE ("Master rack idle cost", "[plugins][idle]")
+{
+    // Budget: the five master-rack effects, switched on and fed silence, cost less
+    // than half as much per block once they've suspended as while their tails are
+    // still running
+    constexpr int blockSize = 512;
+    constexpr int blocksPerRound = 8;   // well inside the idle detector's 250 ms hold
+    constexpr int numRounds = 200;
+
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    tracktion::engine::Plugin::Array rack;
+
+    // Each effect's on/off control (the one its idle detector watches), half way up
+    const std::tuple<const char*, const char*, float> effects[] {
+        { AutoReverbPlugin::xmlTypeName, "wet level", 0.5f },
+        { FlangerPlugin::xmlTypeName, "mix", 0.5f },
+        { AutoPhaserPlugin::xmlTypeName, "depth", 5.0f },
+        { AutoDelayPlugin::xmlTypeName, "mix proportion", 0.5f },
+        { ScratchPlugin::xmlTypeName, "mix", 0.5f },
+    };
+
+    for (auto [type, paramID, value] : effects)
+    {
+        auto plugin = edit->getPluginCache().createNewPlugin (type, {});
+        REQUIRE (plugin != nullptr);
+
+        auto param = plugin->getAutomatableParameterByID (paramID);
+        REQUIRE (param != nullptr);
+        param->setParameter (value, juce::dontSendNotification);
+
+        plugin->baseClassInitialise ({ tracktion::TimePosition(), referenceSampleRate, blockSize });
+        rack.add (plugin);
+    }
+
+    auto isSuspended = [] (tracktion::engine::Plugin* plugin)
+    {
+        if (auto reverb = dynamic_cast<AutoReverbPlugin*> (plugin))     return reverb->isSuspended();
+        if (auto flanger = dynamic_cast<FlangerPlugin*> (plugin))       return flanger->isSuspended();
+        if (auto phaser = dynamic_cast<AutoPhaserPlugin*> (plugin))     return phaser->isSuspended();
+        if (auto delay = dynamic_cast<AutoDelayPlugin*> (plugin))       return delay->isSuspended();
+        if (auto scratch = dynamic_cast<ScratchPlugin*> (plugin))       return scratch->isSuspended();
+        return false;
+    };
+
+    auto countSuspended = [&]
+    {
+        return (int) std::count_if (rack.begin(), rack.end(), isSuspended);
+    };
+
+    const auto music = createClickTrack (referenceSampleRate, 0.1, referenceBpm);
+    juce::AudioBuffer<float> block (2, blockSize);
+    auto editTime = tracktion::TimePosition();
+    const auto blockDuration = tracktion::TimeDuration::fromSamples (blockSize, referenceSampleRate);
+
+    auto processBlock = [&] (bool audible)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            if (audible)
+                block.copyFrom (ch, 0, music, ch, 0, blockSize);
+            else
+                block.clear (ch, 0, blockSize);
+
+        tracktion::engine::PluginRenderContext rc (&block, juce::AudioChannelSet::stereo(),
+                                                   0, blockSize, nullptr, 0.0,
+                                                   { editTime, editTime + blockDuration },
+                                                   true, false, false, false);
+
+        for (auto plugin : rack)
+            plugin->applyToBuffer (rc);
+
+        editTime = editTime + blockDuration;
+        return block.getSample (0, 0);
+    };
+
+    // Active: a block of music wakes every effect, then the silent blocks after it
+    // are timed while the tails ring, before any effect can suspend
+    double activeMs = 0.0;
+    int maxSuspendedWhileActive = 0;
+
+    for (int round = 0; round < numRounds; ++round)
+    {
+        processBlock (true);
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < blocksPerRound; ++i)
+            processBlock (false);
+
+        activeMs += juce::Time::getMillisecondCounterHiRes() - start;
+        maxSuspendedWhileActive = juce::jmax (maxSuspendedWhileActive, countSuspended());
+    }
+
+    CHECK (maxSuspendedWhileActive == 0);
+
+    // Suspended: the same silence once every tail has decayed, up to a minute of it
+    for (int i = 0; i < (int) (referenceSampleRate * 60.0) / blockSize && countSuspended() < rack.size(); ++i)
+        processBlock (false);
+
+    REQUIRE (countSuspended() == rack.size());
+
+    double suspendedMs = 0.0;
+
+    for (int round = 0; round < numRounds; ++round)
+    {
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < blocksPerRound; ++i)
+            processBlock (false);
+
+        suspendedMs += juce::Time::getMillisecondCounterHiRes() - start;
+    }
+
+    const auto numTimedBlocks = numRounds * blocksPerRound;
+    WARN ("Master rack, silent block of " << blockSize << ": " << activeMs * 1000.0 / numTimedBlocks << " us active, "
+                                          << suspendedMs * 1000.0 / numTimedBlocks << " us suspended");
+    CHECK (suspendedMs < activeMs * 0.5);
+
+    BENCHMARK ("Master rack suspended block " + std::to_string (blockSize))
+    {
+        return processBlock (false);
+    };
+
+    for (auto plugin : rack)
+        plugin->baseClassDeinitialise();
+}
+
+TEST_CASE ("Message-thread wakeups", "[ui][idle]")
+{
+    // Counted on the real components that used to run 30 Hz timers: the thumbnail,
+    // the transport bar and the Edit's ChopPlugin. Every message-thread callback
+    // they make is timed by the UI profiler, and those timings are what's counted.
+    // A wakeup is a burst of callbacks delivered together.
+    struct WakeupCounter
+    {
+        double last = 0.0;
+        int wakeups = 0;
+
+        void callback()
+        {
+            const auto now = juce::Time::getMillisecondCounterHiRes();
+
+            if (now - last > 0.5)
+                ++wakeups;
+
+            last = now;
+        }
+    };
+
+    auto& profiler = UIProfiler::instance();
+    profiler.setEnabled (true);
+
+    auto countCallbacks = [&profiler]
+    {
+        juce::int64 count = 0;
+
+        for (auto& stats : profiler.getStats())
+            count += stats.count;
+
+        return count;
+    };
+
+    ReferenceEdit reference;
+    AnimatedComponents components (*reference.edit);
+    auto& transport = reference.edit->getTransport();
+
+    juce::SharedResourcePointer<FrameScheduler> scheduler;
+
+    // Before: the same components' per-frame work, driven as it was by timers
+    // that ran whether or not anything moved. MainComponent's 30 Hz undo-state
+    // poll and the controller window's 2 Hz poll no longer exist to be driven,
+    // so the baseline is if anything low.
+    struct BaselineTimer : juce::Timer
+    {
+        BaselineTimer (WakeupCounter& c, std::function<void (double)> w) : counter (c), work (std::move (w)) {}
+
+        void timerCallback() override
+        {
+            const UIProfiler::ScopedTimer profile ("Baseline timer");
+            counter.callback();
+            work (juce::Time::getMillisecondCounterHiRes());
+        }
+
+        WakeupCounter& counter;
+        std::function<void (double)> work;
+    };
+
+    struct Measurement
+    {
+        int wakeups = 0;
+        juce::int64 callbacks = 0;
+    };
+
+    auto measureBaseline = [&]
+    {
+        WakeupCounter counter;
+        std::vector<std::unique_ptr<BaselineTimer>> timers;
+        timers.push_back (std::make_unique<BaselineTimer> (counter, [&] (double t) { components.thumbnail.frameCallback (t); }));
+        timers.push_back (std::make_unique<BaselineTimer> (counter, [&] (double t) { components.transportBar.frameCallback (t); }));
+        timers.push_back (std::make_unique<BaselineTimer> (counter, [&] (double t) { components.chopPlugin->frameCallback (t); }));
+
+        for (auto& timer : timers)
+            timer->startTimerHz (30);
+
+        profiler.reset();
+        runDispatchLoopFor (1000);
+        timers.clear();
+
+        return Measurement { counter.wakeups, countCallbacks() };
+    };
+
+    auto measureScheduled = [&]
+    {
+        const auto before = scheduler->getStats();
+        profiler.reset();
+        runDispatchLoopFor (1000);
+
+        return Measurement { (int) (scheduler->getStats().frames - before.frames), countCallbacks() };
+    };
+
+    // Idle: transport stopped, nothing animating
+    const auto idleBaseline = measureBaseline();
+    const auto idleScheduled = measureScheduled();
+
+    // Playing: every animating component is served by one wakeup per frame
+    transport.play (false);
+    runDispatchLoopFor (100);
+    const auto playingScheduled = measureScheduled();
+
+    // The old timers kept running alongside the scheduler's frames, so they're
+    // measured with the scheduler stopped
+    transport.stop (false, false);
+    runDispatchLoopFor (100);
+    const auto playingBaseline = measureBaseline();
+
+    WARN ("Message-thread wakeups (callbacks) per second, idle: " << idleBaseline.wakeups << " (" << idleBaseline.callbacks
+          << ") with the old timers, " << idleScheduled.wakeups << " (" << idleScheduled.callbacks << ") with the frame scheduler; "
+          "playing: " << playingBaseline.wakeups << " (" << playingBaseline.callbacks << ") with the old timers, "
+          << playingScheduled.wakeups << " (" << playingScheduled.callbacks << ") with the frame scheduler");
+
+    profiler.setEnabled (false);
+    profiler.reset();
+}
+
+TEST_CASE ("Thumbnail paint", "[ui]")
+{
+    // A frame of playback at 1x zoom only moves the playhead, so the thumbnail repaints
+    // the strip it left and the strip it entered. "rebuilt" draws the waveform, chops
+    // and beat grid from scratch as every frame used to; "cached" reuses the layers.
+    ReferenceEdit reference;
+
+    ZoomState zoomState;
+    auto thumbnail = std::make_unique<ThumbnailComponent> (*reference.edit, zoomState);
+    thumbnail->setBounds (0, 0, 1200, 200);
+    thumbnail->updateThumbnail();
+
+    // The thumbnail's proxy is built on a background thread
+    runDispatchLoopFor (2000);
+
+    juce::Image frame (juce::Image::ARGB, thumbnail->getWidth(), thumbnail->getHeight(), true);
+    const juce::Rectangle<int> playheadStrip (600, 0, 8, thumbnail->getHeight());
+
+    auto paintStrip = [&]
+    {
+        juce::Graphics g (frame);
+        g.reduceClipRegion (playheadStrip);
+        thumbnail->paint (g);
+    };
+
+    paintStrip();
+
+    BENCHMARK ("Thumbnail playhead frame, rebuilt")
+    {
+        thumbnail->updateThumbnail();
+        paintStrip();
+    };
+
+    BENCHMARK ("Thumbnail playhead frame, cached")
+    {
+        paintStrip();
+    };
+
+    thumbnail = nullptr;
+}
+
+TEST_CASE ("Chop lane drag", "[ui]")
+{
+    // Two thousand chops, one of them dragged a pixel per frame. Each frame repaints
+    // where the chop was and where it is now, rather than the whole lane.
+    ReferenceEdit reference;
+
+    ZoomState zoomState;
+    auto lane = std::make_unique<ChopTrackLane> (*reference.edit, zoomState);
+    lane->setBounds (0, 0, 1200, 30);
+    lane->setSnapToGrid (false);
+
+    constexpr int numChops = 2000;
+
+    for (int i = 0; i < numChops; ++i)
+        lane->addClip (i * 0.03, i * 0.03 + 0.02);
+
+    REQUIRE (EngineHelpers::getChopTrack (*reference.edit)->getClips().size() == numChops);
+
+    auto mouseEvent = [&] (float x, bool dragged) { return createMouseEvent (*lane, { x, 15.0f }, dragged); };
+
+    juce::Image frame (juce::Image::ARGB, lane->getWidth(), lane->getHeight(), true);
+
+    auto paint = [&] (juce::Rectangle<int> area)
+    {
+        juce::Graphics g (frame);
+        g.reduceClipRegion (area);
+        lane->paint (g);
+    };
+
+    // Grab the chop at 30 s, in the middle of the lane
+    constexpr float grabX = 600.2f;
+    lane->mouseDown (mouseEvent (grabX, false));
+
+    float x = grabX;
+
+    BENCHMARK ("Chop lane drag frame, whole lane")
+    {
+        x = x < grabX + 100.0f ? x + 1.0f : grabX;
+        lane->mouseDrag (mouseEvent (x, true));
+        paint (lane->getLocalBounds());
+    };
+
+    BENCHMARK ("Chop lane drag frame, dirty strip")
+    {
+        x = x < grabX + 100.0f ? x + 1.0f : grabX;
+        lane->mouseDrag (mouseEvent (x, true));
+
+        // What the drag invalidates: the chop's old and new bounds, a pixel or two apart
+        paint ({ juce::roundToInt (x) - 4, 0, 8, lane->getHeight() });
+    };
+
+    lane->mouseUp (mouseEvent (x, true));
+    lane = nullptr;
+}
+
+TEST_CASE ("Beat grid", "[ui]")
+{
+    // Ten minutes drifting 117 -> 123 BPM a beat at a time, with 16 bars in view
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    auto& tempoSequence = edit->tempoSequence;
+
+    for (int beat = 4; beat < 1200; beat += 4)
+        tempoSequence.insertTempo (tracktion::BeatPosition::fromBeats ((double) beat), 117.0 + 6.0 * beat / 1200.0, 0.0f);
+
+    BeatGrid grid (*edit);
+    const juce::Range<double> view (120.0, 152.0);
+    constexpr float width = 1200.0f;
+
+    BENCHMARK ("Grid lines for 16 bars, from the tempo sequence")
+    {
+        std::vector<float> xs;
+
+        for (auto beat = std::ceil (tempoSequence.toBeats (tracktion::TimePosition::fromSeconds (view.getStart())).inBeats());; beat += 1.0)
+        {
+            const auto time = tempoSequence.toTime (tracktion::BeatPosition::fromBeats (beat)).inSeconds();
+
+            if (time > view.getEnd())
+                break;
+
+            xs.push_back ((float) ((time - view.getStart()) * width / view.getLength()));
+        }
+
+        return xs.size();
+    };
+
+    // Following the playhead moves the view every frame
+    double offset = 0.0;
+
+    BENCHMARK ("Grid lines for 16 bars, from the beat grid")
+    {
+        offset = offset > 60.0 ? 0.0 : offset + 0.01;
+        return grid.getLines (view + offset, 0.0f, width).size();
+    };
+}
+
+TEST_CASE ("Automation lane at 100k points", "[ui]")
+{
+    // A long gamepad take: 100k points over the edit, a lane 1200 px wide
+    constexpr int numPoints = 100000;
+
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    auto plugin = edit->getPluginCache().createNewPlugin (AutoReverbPlugin::xmlTypeName, {});
+    REQUIRE (plugin != nullptr);
+
+    auto parameter = plugin->getAutomatableParameter (0);
+    REQUIRE (parameter != nullptr);
+
+    auto& curve = parameter->getCurve();
+    juce::Random random (42);
+
+    for (int i = 0; i < numPoints; ++i)
+        curve.addPoint (tracktion::TimePosition::fromSeconds (60.0 * i / numPoints),
+                        parameter->getValueRange().convertFrom0to1 (random.nextFloat()), 0.0f);
+
+    ZoomState zoomState;
+    AutomationLane lane (*edit, zoomState);
+    lane.setBounds (0, 0, 1200, 80);
+    lane.setParameter (parameter.get());
+
+    juce::Image frame (juce::Image::ARGB, lane.getWidth(), lane.getHeight(), true);
+
+    auto paintLane = [&]
+    {
+        juce::Graphics g (frame);
+        lane.paint (g);
+    };
+
+    // Zoomed out the whole take is in view; zoomed in only a slice of it
+    BENCHMARK ("Automation lane paint, 100k points, all in view")
+    {
+        paintLane();
+    };
+
+    zoomState.setZoomLevel (20.0);
+    double scroll = 0.0;
+
+    BENCHMARK ("Automation lane paint, 100k points, scrolling at 20x")
+    {
+        scroll = scroll > 0.9 ? 0.0 : scroll + 0.001;
+        zoomState.setScrollPosition (scroll);
+        paintLane();
+    };
+
+    // Dragging a point updates it in place from the curve's ValueTree and repaints
+    // only the pixels around it
+    float value = 0.0f;
+
+    auto movePoint = [&]
+    {
+        value = value > 0.9f ? 0.0f : value + 0.01f;
+        curve.movePoint (numPoints / 2, curve.getPoint (numPoints / 2).time, value, 0.0f);
+    };
+
+    movePoint();
+    CHECK (lane.getNumPoints() == numPoints);
+
+    BENCHMARK ("Automation lane, one point moved")
+    {
+        movePoint();
+    };
+
+    // Budget: a repaint of the whole lane with the curve rebuilt, at either zoom, in under 1 ms
+    for (auto zoom : { 1.0, 20.0 })
+    {
+        zoomState.setZoomLevel (zoom);
+        zoomState.setScrollPosition (0.45);
+
+        constexpr int numRepaints = 50;
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numRepaints; ++i)
+        {
+            movePoint();
+            paintLane();
+        }
+
+        const auto meanMs = (juce::Time::getMillisecondCounterHiRes() - start) / numRepaints;
+        WARN ("Automation lane, point moved and repainted, 100k points at " << zoom << "x: " << meanMs << " ms");
+        CHECK (meanMs < 1.0);
+    }
+
+    lane.setParameter (nullptr);
+}
+
+TEST_CASE ("Plugin automation panel", "[ui]")
+{
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    RackAutomationPanels rack (*edit);
+    int scrollY = 0;
+
+    BENCHMARK ("Plugin automation panel, scroll by 10 px")
+    {
+        scrollY = scrollY + 10 > rack.height - rack.viewport.getHeight() ? 0 : scrollY + 10;
+        rack.viewport.setViewPosition (0, scrollY);
+        return rack.countLiveLanes();
+    };
+
+    WARN ("Live automation lanes: " << rack.countLiveLanes() << " of " << rack.numParameters << " parameters");
+}
+
+TEST_CASE ("Effect panel repaint", "[ui]")
+{
+    // A gamepad sweeping a knob repaints the whole panel every frame. The panel
+    // background and the knob dials are blitted from the asset cache; only the
+    // value arcs and pointers are drawn.
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+
+    auto lookAndFeel = std::make_unique<CustomLookAndFeel>();
+    auto panel = std::make_unique<ReverbComponent> (*edit);
+    panel->setBounds (0, 0, 300, 160);
+
+    juce::Image frame (juce::Image::ARGB, panel->getWidth(), panel->getHeight(), true);
+
+    auto paintPanel = [&]
+    {
+        juce::Graphics g (frame);
+        panel->paintEntireComponent (g, false);
+    };
+
+    paintPanel();
+
+    const auto sliders = findSliders (*panel);
+    REQUIRE (! sliders.empty());
+    int step = 0;
+
+    BENCHMARK ("Effect panel repaint, knob moving")
+    {
+        for (auto* slider : sliders)
+            slider->setValue (slider->proportionOfLengthToValue ((step % 100) / 100.0), juce::dontSendNotification);
+
+        ++step;
+        paintPanel();
+    };
+
+    WARN ("Pre-rendered assets for the reverb panel: " << lookAndFeel->getAssetCache().getNumAssets());
+
+    panel = nullptr;
+    juce::LookAndFeel::setDefaultLookAndFeel (nullptr);
+    lookAndFeel = nullptr;
+}
+
+TEST_CASE ("UI profiler overhead", "[ui]")
+{
+    // Every paint and timer callback carries a ScopedTimer, so it must cost next
+    // to nothing while profiling is off
+    auto& profiler = UIProfiler::instance();
+    profiler.setEnabled (false);
+    profiler.reset();
+
+    BENCHMARK ("ScopedTimer, profiling off")
+    {
+        const UIProfiler::ScopedTimer profile ("Benchmark::off");
+        return profiler.isEnabled();
+    };
+
+    profiler.setEnabled (true);
+
+    BENCHMARK ("ScopedTimer, profiling on")
+    {
+        const UIProfiler::ScopedTimer profile ("Benchmark::on");
+        return profiler.isEnabled();
+    };
+
+    profiler.setEnabled (false);
+    profiler.reset();
+}
+
+TEST_CASE ("Transport display update", "[ui]")
+{
+    // The time display runs on every frame while playing. "full" reads the bar, time
+    // signature and tempo and formats the whole display, as every frame used to;
+    // the display itself only formats the clock until the position crosses a beat,
+    // and does nothing while the position hasn't moved.
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    auto& transport = edit->getTransport();
+
+    ZoomState zoomState;
+    TransportBar transportBar (*edit, zoomState);
+    transportBar.setBounds (0, 0, 1200, 40);
+
+    auto* timeDisplay = findTimeDisplay (transportBar);
+
+    double timeMs = 0.0;
+    int frame = 0;
+
+    // A position a few milliseconds on each frame, as playback moves it
+    auto advance = [&]
+    {
+        transport.setPosition (tracktion::TimePosition::fromSeconds (12.0 + (frame++ % 1000) * 0.0167));
+        timeMs += 16.7;
+    };
+
+    for (int i = 0; i < 100; ++i)
+    {
+        advance();
+        transportBar.frameCallback (timeMs);
+    }
+
+    BENCHMARK ("Transport display frame, full")
+    {
+        advance();
+        timeDisplay->setText (formatTransportDisplay (*edit), juce::dontSendNotification);
+    };
+
+    BENCHMARK ("Transport display frame, moving")
+    {
+        advance();
+        transportBar.frameCallback (timeMs);
+    };
+
+    BENCHMARK ("Transport display frame, stopped")
+    {
+        timeMs += 16.7;
+        transportBar.frameCallback (timeMs);
+    };
+}
+
+TEST_CASE ("RegionManager at scale", "[regions]")
+{
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    auto plugin = edit->getPluginCache().createNewPlugin (FlangerPlugin::xmlTypeName, {});
+    REQUIRE (plugin != nullptr);
+
+    auto param = plugin->getAutomatableParameterByID ("mix");
+    REQUIRE (param != nullptr);
+
+    for (int numRegions : { 100, 1000, 5000 })
+    {
+        RegionManager regions (param.get());
+
+        // One region per second, half a second long, alternating sides
+        auto addAll = [&]
+        {
+            regions.clearRegions();
+
+            for (int i = 0; i < numRegions; ++i)
+                regions.addRegion ({ (double) i + 0.1, (double) i + 0.6, (i % 2) == 0 });
+        };
+
+        BENCHMARK ("RegionManager add " + std::to_string (numRegions) + " regions")
+        {
+            addAll();
+            return regions.getRegions().size();
+        };
+
+        addAll();
+        const auto middle = (size_t) numRegions / 2;
+
+        BENCHMARK_ADVANCED ("RegionManager move 1 of " + std::to_string (numRegions))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            // Nudge within its own slot so the move never overlaps a neighbour
+            meter.measure ([&] (int i)
+            {
+                regions.moveRegion (middle, (double) middle + ((i % 2) == 0 ? 0.2 : 0.1));
+                return regions.getRegions()[middle].startTime;
+            });
+        };
+
+        BENCHMARK ("RegionManager lookup among " + std::to_string (numRegions))
+        {
+            return regions.getRegionAtTime ((double) numRegions - 0.5);
+        };
+
+        BENCHMARK ("RegionManager remove+add among " + std::to_string (numRegions))
+        {
+            regions.removeRegion (regions.getRegions().size() - 1);
+            regions.addRegion ({ (double) numRegions - 0.9, (double) numRegions - 0.4, true });
+            return regions.getRegions().size();
+        };
+    }
+}
+
+TEST_CASE ("Library index at 100k rows", "[library]")
 {
-    BENCHMARK_ADVANCED ("Mock test")
+    constexpr int numEntries = 100000;
+
+    const auto entries = createLibraryEntries (numEntries);
+
+    LibraryIndex index;
+    index.build (entries);
+    REQUIRE (index.size() == numEntries);
+
+    BENCHMARK ("LibraryIndex build 100k")
+    {
+        LibraryIndex fresh;
+        fresh.build (entries);
+        return fresh.getNumRows();
+    };
+
+    BENCHMARK ("LibraryIndex build 100k + first sort by BPM")
+    {
+        LibraryIndex fresh;
+        fresh.build (entries);
+        fresh.setSortOrder (LibraryIndex::Column::bpm, true);
+        return fresh.getEntryForRow (0);
+    };
+
+    // Both orders are cached after the first pass, so this is the cost of a header click
+    BENCHMARK ("LibraryIndex re-sort 100k by name / BPM")
+    {
+        index.setSortOrder (LibraryIndex::Column::bpm, false);
+        index.setSortOrder (LibraryIndex::Column::name, true);
+        return index.getEntryForRow (0);
+    };
+
+    BENCHMARK ("LibraryIndex BPM range 120-128 among 100k")
+    {
+        return index.getEntriesInBpmRange (120.0f, 128.0f).size();
+    };
+
+    // One keystroke at a time, as the search box delivers them
+    const juce::String typed = "dub step 12";
+
+    BENCHMARK ("LibraryIndex type-ahead \"" + typed.toStdString() + "\" among 100k")
+    {
+        for (int i = 1; i <= typed.length(); ++i)
+            index.setFilter (typed.substring (0, i));
+
+        const auto numRows = index.getNumRows();
+        index.setFilter ({});
+        return numRows;
+    };
+
+    BENCHMARK ("LibraryIndex filter \"dub 120-128\" among 100k")
+    {
+        index.setFilter ("dub 120-128");
+        const auto numRows = index.getNumRows();
+        index.setFilter ({});
+        return numRows;
+    };
+
+    // Startup: the snapshot stands in for the Project until it has been reconciled
+    TemporaryDirectory tempDir;
+    const auto projectFile = tempDir.getChildFile ("Library.tracktion");
+    projectFile.replaceWithText ("stand-in for the project file");
+    const auto snapshotFile = LibrarySnapshot::getFileFor (projectFile);
+    REQUIRE (LibraryPersistence::writeAtomically (snapshotFile, LibrarySnapshot::serialise (index, projectFile)));
+
+    BENCHMARK ("LibrarySnapshot write 100k")
+    {
+        return LibraryPersistence::writeAtomically (snapshotFile, LibrarySnapshot::serialise (index, projectFile));
+    };
+
+    BENCHMARK ("LibrarySnapshot read + index build 100k")
+    {
+        LibraryIndex fresh;
+        fresh.build (*LibrarySnapshot::read (snapshotFile, projectFile));
+        return fresh.getNumRows();
+    };
+}
+
+TEST_CASE ("Library write-behind persistence", "[library]")
+{
+    // A 1,000-file import: every file marks the library changed, and the saves
+    // collapse into one when the window closes (flush() stands in for the timer)
+    constexpr int numImports = 1000;
+
+    TemporaryDirectory tempDir;
+    const auto target = tempDir.getChildFile ("Library.snapshot");
+
+    juce::MemoryBlock payload (1024 * 1024);
+    payload.fillWith (0x5a);
+
+    BENCHMARK_ADVANCED ("LibraryPersistence " + std::to_string (numImports) + " changes, save and write")
     (Catch::Benchmark::Chronometer meter)
     {
-        meter.measure ([&] (int /* i */) {
-            // do nothing
+        LibraryPersistence persistence;
+        persistence.onSave = [&] { persistence.writeFile (target, payload); };
+
+        meter.measure ([&]
+        {
+            for (int i = 0; i < numImports; ++i)
+                persistence.markChanged();
+
+            persistence.flush();
+            return persistence.getNumSaves();
+        });
+    };
+}
+
+TEST_CASE ("Offline render of the reference Edit", "[render]")
+{
+    // The realtime factor is referenceSeconds divided by the reported mean
+    constexpr double referenceSeconds = 4.0;
+
+    // Built exactly as LibraryComponent::addToLibrary builds a library item
+    ReferenceEdit reference (referenceSeconds);
+    auto renderFile = reference.tempDir.getChildFile ("render.wav");
+
+    BENCHMARK ("Render " + std::to_string ((int) referenceSeconds) + " s reference Edit")
+    {
+        return tracktion::engine::Renderer::renderToFile (*reference.edit, renderFile, false);
+    };
+}
+
+TEST_CASE ("Edit switch to first audio", "[load]")
+{
+    // Times what MainComponent::loadNewEdit does once the library has a loaded Edit:
+    // stop the old Edit, point the UI at the new one, start playback and wait for the
+    // first audible block. "rebuilt" is the old teardown-and-recreate path, "rebound"
+    // the setEdit() one.
+    constexpr int blockSize = 512;
+
+    ChopShopEngine chopShopEngine;
+    auto& engine = chopShopEngine.engine;
+    engine.getDeviceManager().getHostedAudioDeviceInterface().initialise ({ referenceSampleRate, blockSize });
+
+    TemporaryDirectory tempDir;
+    const auto sourceFile = writeWavFile (createClickTrack (referenceSampleRate, 8.0, referenceBpm),
+                                          referenceSampleRate, tempDir.getChildFile ("reference.wav"));
+
+    auto createEdits = [&] (int numEdits)
+    {
+        std::vector<std::unique_ptr<tracktion::engine::Edit>> edits;
+
+        for (int i = 0; i < numEdits; ++i)
+        {
+            edits.push_back (LibraryComponent::createEditForAudioFile (engine, sourceFile, (float) referenceBpm));
+            REQUIRE (edits.back() != nullptr);
+        }
+
+        return edits;
+    };
+
+    juce::AudioBuffer<float> block (2, blockSize);
+
+    {
+        auto edits = createEdits (2);
+        auto components = std::make_unique<EditComponents> (*edits[0]);
+        components->setEdit (*edits[1]);
+
+        const auto numBlocks = playUntilFirstAudio (*edits[1], block);
+        CHECK (numBlocks > 0);
+        WARN ("First audible block after " << numBlocks << " block(s) of " << blockSize);
+
+        components = nullptr;
+    }
+
+    BENCHMARK_ADVANCED ("Edit switch to first audio, components rebuilt")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        auto edits = createEdits (meter.runs() + 1);
+        auto components = std::make_unique<EditComponents> (*edits[0]);
+
+        meter.measure ([&] (int i)
+        {
+            edits[(size_t) i]->getTransport().stop (false, false);
+            components = nullptr;
+            components = std::make_unique<EditComponents> (*edits[(size_t) i + 1]);
+            return playUntilFirstAudio (*edits[(size_t) i + 1], block);
+        });
+
+        components = nullptr;
+    };
+
+    BENCHMARK_ADVANCED ("Edit switch to first audio, components rebound")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        auto edits = createEdits (meter.runs() + 1);
+        EditComponents components (*edits[0]);
+
+        meter.measure ([&] (int i)
+        {
+            edits[(size_t) i]->getTransport().stop (false, false);
+            components.setEdit (*edits[(size_t) i + 1]);
+            return playUntilFirstAudio (*edits[(size_t) i + 1], block);
         });
     };
 }
@@ -11,7 +11,23 @@ int main (int argc, char* argv[])
     // It's nicer DX when placed here vs. manually in Catch2 SECTIONs
     juce::ScopedJuceInitialiser_GUI gui;
 
-    const int result = Catch::Session().run (argc, argv);
+    std::vector<const char*> args (argv, argv + argc);
+
+    // Unless a reporter was asked for, print to the console and also write
+    // machine-readable results so runs from two builds can be diffed
+    const auto hasReporterOrListing = std::any_of (args.begin() + 1, args.end(), [] (const char* arg)
+    {
+        const juce::String a (arg);
+        return a == "-r" || a.startsWith ("--reporter") || a.startsWith ("--list");
+    });
+
+    if (! hasReporterOrListing)
+    {
+        for (auto* arg : { "--reporter", "console", "--reporter", "xml::out=benchmark-results.xml" })
+            args.push_back (arg);
+    }
+
+    const int result = Catch::Session().run ((int) args.size(), args.data());
 
     return result;
 }
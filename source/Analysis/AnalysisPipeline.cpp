@@ -0,0 +1,353 @@
+#include "AnalysisPipeline.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    //==============================================================================
+    // Halves the sample rate: a 31-tap half-band low-pass with its cut-off at the
+    // new Nyquist, then every other sample. Keeps its state between blocks.
+    class HalfbandDecimator
+    {
+    public:
+        static constexpr int numTaps = 31;
+
+        void prepare (int numChannels, int maxBlockSize)
+        {
+            work.setSize (numChannels, numTaps - 1 + maxBlockSize);
+            work.clear();
+            keepNext = true;
+        }
+
+        /** Returns the number of samples written to the output. */
+        int process (const juce::AudioBuffer<float>& input, int numSamples, juce::AudioBuffer<float>& output)
+        {
+            constexpr int history = numTaps - 1;
+            const auto& taps = getTaps();
+            const int firstKept = keepNext ? 0 : 1;
+            const int numOut = (numSamples - firstKept + 1) / 2;
+
+            for (int ch = 0; ch < work.getNumChannels(); ++ch)
+            {
+                auto* w = work.getWritePointer (ch);
+                auto* out = output.getWritePointer (ch);
+                juce::FloatVectorOperations::copy (w + history, input.getReadPointer (ch), numSamples);
+
+                for (int q = firstKept, o = 0; q < numSamples; q += 2, ++o)
+                {
+                    // Only the centre tap and every other one are non-zero in a half-band filter
+                    const auto* x = w + q;
+                    auto sum = taps.centre * x[history / 2];
+
+                    for (int j = 0; j < history / 2; j += 2)
+                        sum += taps.outer[(size_t) j / 2] * (x[j] + x[history - j]);
+
+                    out[o] = sum;
+                }
+
+                std::memmove (w, w + numSamples, (size_t) history * sizeof (float));
+            }
+
+            if ((numSamples % 2) != 0)
+                keepNext = ! keepNext;
+
+            return juce::jmax (0, numOut);
+        }
+
+    private:
+        juce::AudioBuffer<float> work;
+        bool keepNext = true;
+
+        struct Taps
+        {
+            float centre = 0.0f;
+            std::array<float, (numTaps - 1) / 4 + 1> outer {}; // taps 0, 2, 4 ... mirrored about the centre
+        };
+
+        // Blackman-windowed sinc, normalised to unity gain at DC
+        static const Taps& getTaps()
+        {
+            static const Taps taps = []
+            {
+                constexpr int centreIndex = (numTaps - 1) / 2;
+                std::array<double, numTaps> h {};
+                double sum = 0.0;
+
+                for (int n = 0; n < numTaps; ++n)
+                {
+                    const auto x = (n - centreIndex) * 0.5;
+                    const auto sinc = x == 0.0 ? 1.0 : std::sin (juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                    const auto phase = juce::MathConstants<double>::twoPi * n / (numTaps - 1);
+                    h[(size_t) n] = sinc * (0.42 - 0.5 * std::cos (phase) + 0.08 * std::cos (2.0 * phase));
+                    sum += h[(size_t) n];
+                }
+
+                Taps t;
+                t.centre = (float) (h[(size_t) centreIndex] / sum);
+
+                for (int n = 0; n < centreIndex; n += 2)
+                    t.outer[(size_t) n / 2] = (float) (h[(size_t) n] / sum);
+
+                return t;
+            }();
+
+            return taps;
+        }
+    };
+
+    //==============================================================================
+    // One block of the file in every format an analyzer asked for
+    struct Block
+    {
+        std::vector<juce::AudioBuffer<float>> streams;
+        std::vector<int> numSamples;
+    };
+
+    using BlockPtr = std::shared_ptr<const Block>;
+
+    class BlockQueue
+    {
+    public:
+        explicit BlockQueue (size_t maxSize) : capacity (maxSize) {}
+
+        void push (BlockPtr block)
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            notFull.wait (lock, [this] { return blocks.size() < capacity; });
+            blocks.push_back (std::move (block));
+            notEmpty.notify_one();
+        }
+
+        BlockPtr pop()
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            notEmpty.wait (lock, [this] { return ! blocks.empty(); });
+            auto block = std::move (blocks.front());
+            blocks.pop_front();
+            notFull.notify_one();
+            return block;
+        }
+
+    private:
+        const size_t capacity;
+        std::mutex mutex;
+        std::condition_variable notFull, notEmpty;
+        std::deque<BlockPtr> blocks;
+    };
+
+    //==============================================================================
+    // The file at successively halved rates, in one channel layout
+    struct DecimationChain
+    {
+        int numChannels = 0;
+        std::vector<HalfbandDecimator> decimators;      // decimators[k - 1] makes level k from level k - 1
+        std::vector<juce::AudioBuffer<float>> levels;   // the current block at each level
+        std::vector<int> levelSamples;
+
+        void prepare (int channels, int numLevels, int blockSize)
+        {
+            numChannels = channels;
+            decimators.resize ((size_t) juce::jmax (0, numLevels - 1));
+            levels.resize ((size_t) numLevels);
+            levelSamples.assign ((size_t) numLevels, 0);
+
+            for (int k = 0; k < numLevels; ++k)
+            {
+                const auto maxSamples = (blockSize >> k) + 1;
+                levels[(size_t) k].setSize (channels, maxSamples);
+
+                if (k > 0)
+                    decimators[(size_t) k - 1].prepare (channels, (blockSize >> (k - 1)) + 1);
+            }
+        }
+
+        void decimate()
+        {
+            for (size_t k = 1; k < levels.size(); ++k)
+                levelSamples[k] = decimators[k - 1].process (levels[k - 1], levelSamples[k - 1], levels[k]);
+        }
+    };
+
+    struct StreamSpec
+    {
+        bool mono;
+        int level;
+    };
+
+    constexpr int maxDecimationLevel = 6;
+}
+
+//==============================================================================
+AnalysisPipeline::AnalysisPipeline (int maxThreads, int maxBlocks)
+    : maxWorkerThreads (maxThreads > 0 ? maxThreads : juce::jmax (1, juce::SystemStats::getNumCpus() - 1)),
+      maxBlocksInFlight (juce::jmax (1, maxBlocks))
+{
+}
+
+void AnalysisPipeline::addAnalyzer (AudioAnalyzer& analyzer)
+{
+    analyzers.push_back (&analyzer);
+}
+
+bool AnalysisPipeline::run (juce::AudioFormatReader& reader, std::function<bool()> shouldCancel)
+{
+    if (analyzers.empty())
+        return true;
+
+    if (reader.sampleRate <= 0.0 || reader.numChannels == 0)
+        return false;
+
+    const auto sourceRate = reader.sampleRate;
+    const auto numSourceChannels = (int) reader.numChannels;
+    const auto length = reader.lengthInSamples;
+
+    // Work out the distinct formats, and which one each analyzer reads
+    std::vector<StreamSpec> streams;
+    std::vector<size_t> analyzerStreams;
+    std::array<int, 2> numLevels {}; // per layout: [0] as in the file, [1] mono
+
+    for (auto* analyzer : analyzers)
+    {
+        const auto format = analyzer->getFormat();
+        int level = 0;
+
+        if (format.minSampleRate > 0.0)
+            while (level < maxDecimationLevel && sourceRate / (double) (1 << (level + 1)) >= format.minSampleRate)
+                ++level;
+
+        auto found = std::find_if (streams.begin(), streams.end(), [&] (const StreamSpec& s) { return s.mono == format.mono && s.level == level; });
+
+        if (found == streams.end())
+            found = streams.insert (streams.end(), StreamSpec { format.mono, level });
+
+        analyzerStreams.push_back ((size_t) std::distance (streams.begin(), found));
+
+        auto& layoutLevels = numLevels[format.mono ? 1 : 0];
+        layoutLevels = juce::jmax (layoutLevels, level + 1);
+
+        analyzer->prepare (sourceRate / (double) (1 << level), format.mono ? 1 : numSourceChannels, length >> level);
+    }
+
+    std::array<DecimationChain, 2> chains;
+    chains[0].prepare (numSourceChannels, numLevels[0], blockSize);
+    chains[1].prepare (1, numLevels[1], blockSize);
+
+    // Spread the analyzers over the workers
+    struct Worker
+    {
+        explicit Worker (size_t queueSize) : queue (queueSize) {}
+
+        BlockQueue queue;
+        std::vector<size_t> analyzerIndices;
+        std::thread thread;
+    };
+
+    const auto numWorkers = juce::jlimit (1, (int) analyzers.size(), maxWorkerThreads);
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> cancelled { false };
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back (std::make_unique<Worker> ((size_t) maxBlocksInFlight));
+
+    for (size_t i = 0; i < analyzers.size(); ++i)
+        workers[i % (size_t) numWorkers]->analyzerIndices.push_back (i);
+
+    for (auto& worker : workers)
+    {
+        worker->thread = std::thread ([this, &analyzerStreams, &cancelled, w = worker.get()]
+        {
+            // A null block marks the end of the file
+            while (auto block = w->queue.pop())
+            {
+                for (auto index : w->analyzerIndices)
+                {
+                    const auto stream = analyzerStreams[index];
+
+                    if (const auto numSamples = block->numSamples[stream]; numSamples > 0)
+                        analyzers[index]->process (block->streams[stream], numSamples);
+                }
+            }
+
+            if (! cancelled)
+                for (auto index : w->analyzerIndices)
+                    analyzers[index]->finish();
+        });
+    }
+
+    // Decode on this thread
+    juce::AudioBuffer<float> source (numSourceChannels, blockSize);
+
+    for (juce::int64 pos = 0; pos < length; pos += blockSize)
+    {
+        if (shouldCancel && shouldCancel())
+        {
+            cancelled = true;
+            break;
+        }
+
+        const auto numSamples = (int) juce::jmin ((juce::int64) blockSize, length - pos);
+        reader.read (&source, 0, numSamples, pos, true, true);
+
+        if (numLevels[0] > 0)
+        {
+            auto& chain = chains[0];
+
+            for (int ch = 0; ch < numSourceChannels; ++ch)
+                chain.levels[0].copyFrom (ch, 0, source, ch, 0, numSamples);
+
+            chain.levelSamples[0] = numSamples;
+            chain.decimate();
+        }
+
+        if (numLevels[1] > 0)
+        {
+            auto& chain = chains[1];
+            auto* mix = chain.levels[0].getWritePointer (0);
+            juce::FloatVectorOperations::copy (mix, source.getReadPointer (0), numSamples);
+
+            for (int ch = 1; ch < numSourceChannels; ++ch)
+                juce::FloatVectorOperations::add (mix, source.getReadPointer (ch), numSamples);
+
+            juce::FloatVectorOperations::multiply (mix, 1.0f / (float) numSourceChannels, numSamples);
+
+            chain.levelSamples[0] = numSamples;
+            chain.decimate();
+        }
+
+        auto block = std::make_shared<Block>();
+        block->streams.resize (streams.size());
+        block->numSamples.resize (streams.size());
+
+        for (size_t s = 0; s < streams.size(); ++s)
+        {
+            const auto& chain = chains[streams[s].mono ? 1 : 0];
+            const auto level = (size_t) streams[s].level;
+            const auto n = chain.levelSamples[level];
+
+            block->streams[s].setSize (chain.numChannels, juce::jmax (1, n));
+
+            for (int ch = 0; ch < chain.numChannels; ++ch)
+                block->streams[s].copyFrom (ch, 0, chain.levels[level], ch, 0, n);
+
+            block->numSamples[s] = n;
+        }
+
+        for (auto& worker : workers)
+            worker->queue.push (block);
+    }
+
+    for (auto& worker : workers)
+        worker->queue.push (nullptr);
+
+    for (auto& worker : workers)
+        worker->thread.join();
+
+    return ! cancelled;
+}
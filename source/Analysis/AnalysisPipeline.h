@@ -0,0 +1,48 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "AudioAnalyzer.h"
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+    Decodes an audio file once and feeds every AudioAnalyzer from that single pass.
+
+    The decoded blocks are converted once per distinct format rather than once
+    per analyzer:
+    - analyzers asking for mono share one mix-down
+    - lower rates come from a chain of half-band decimators, so an analyzer
+      at a quarter of the file's rate reuses the half-rate stage another one
+      already needed. Each halving delays the stream by 15 samples at the rate
+      it halves, which is well under a millisecond at the rates used here.
+
+    The analyzers are spread over up to maxWorkerThreads threads. Each thread
+    has a queue of at most maxBlocksInFlight blocks, so the decoder can run
+    ahead of the slowest analyzer by that much and no further; memory use
+    doesn't grow with the file's length.
+*/
+class AnalysisPipeline
+{
+public:
+    /** maxWorkerThreads <= 0 uses one thread per core, less one for decoding. */
+    explicit AnalysisPipeline (int maxWorkerThreads = 0, int maxBlocksInFlight = 8);
+
+    /** Adds an analyzer. It isn't owned, and has to outlive run(). */
+    void addAnalyzer (AudioAnalyzer&);
+
+    /** Reads the whole file, feeding it to every analyzer, and returns once they
+        have all finished. Returns false if shouldCancel returned true (it's
+        checked between blocks), in which case finish() isn't called.
+    */
+    bool run (juce::AudioFormatReader&, std::function<bool()> shouldCancel = {});
+
+    /** Samples read from the file per block. */
+    static constexpr int blockSize = 4096;
+
+private:
+    int maxWorkerThreads, maxBlocksInFlight;
+    std::vector<AudioAnalyzer*> analyzers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisPipeline)
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/**
+    One analysis run by an AnalysisPipeline.
+
+    The pipeline decodes a file once and hands every analyzer the same stream
+    of blocks, converted to the format the analyzer asked for. All calls come
+    from one pipeline thread, in order: prepare(), process() for each block,
+    then finish() once the file has been read to the end. Results are read
+    from the analyzer after AnalysisPipeline::run() returns.
+*/
+class AudioAnalyzer
+{
+public:
+    virtual ~AudioAnalyzer() = default;
+
+    struct Format
+    {
+        /** The lowest rate the analysis can work at, or 0 for the file's own rate.
+            The pipeline halves the file's rate while it stays at or above this.
+        */
+        double minSampleRate = 0.0;
+
+        /** True for a mix-down of all channels, false for the file's channels as they are. */
+        bool mono = true;
+    };
+
+    virtual Format getFormat() const = 0;
+
+    /** Called before the first block with the rate and channel count the pipeline picked.
+        The length is the file's, in samples at that rate.
+    */
+    virtual void prepare (double sampleRate, int numChannels, juce::int64 lengthInSamples) = 0;
+
+    virtual void process (const juce::AudioBuffer<float>& block, int numSamples) = 0;
+
+    virtual void finish() {}
+};
@@ -0,0 +1,137 @@
+#include "DownbeatFinder.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+double DownbeatFinder::findFirstDownbeat (const std::vector<float>& envelope, double frameRate, const TempoMap& map,
+                                          double audibleStart, double audibleEnd, int beatsPerBar)
+{
+    if (envelope.empty() || frameRate <= 0.0 || map.points.empty() || beatsPerBar < 1 || audibleEnd <= audibleStart)
+        return audibleStart;
+
+    // Frame i's onset is at i / frameRate: the flux peaks in the frame whose last
+    // hop the onset falls in
+    const auto numFrames = envelope.size();
+    std::vector<double> frameBeats (numFrames);
+
+    for (size_t i = 0; i < numFrames; ++i)
+        frameBeats[i] = map.getBeatAt ((double) i / frameRate);
+
+    const auto firstFrame = (size_t) juce::jmax (0, juce::roundToInt (audibleStart * frameRate));
+    const auto endFrame = (size_t) juce::jlimit (0, (int) numFrames, juce::roundToInt (audibleEnd * frameRate));
+
+    if (firstFrame >= endFrame)
+        return audibleStart;
+
+    // The beat phase: the envelope folded onto one beat
+    constexpr int phaseBins = 32;
+    std::array<double, phaseBins> phaseStrength {};
+
+    for (auto i = firstFrame; i < endFrame; ++i)
+    {
+        const auto beat = frameBeats[i];
+        phaseStrength[(size_t) ((int) ((beat - std::floor (beat)) * phaseBins) % phaseBins)] += envelope[i];
+    }
+
+    int bestBin = 0;
+    double bestStrength = -1.0;
+
+    for (int bin = 0; bin < phaseBins; ++bin)
+    {
+        const auto smoothed = phaseStrength[(size_t) ((bin + phaseBins - 1) % phaseBins)]
+                            + 2.0 * phaseStrength[(size_t) bin]
+                            + phaseStrength[(size_t) ((bin + 1) % phaseBins)];
+
+        if (smoothed > bestStrength)
+        {
+            bestStrength = smoothed;
+            bestBin = bin;
+        }
+    }
+
+    if (bestStrength <= 0.0)
+        return audibleStart;
+
+    const auto phase = (bestBin + 0.5) / phaseBins;
+
+    // Which beat of the bar is strongest, from the frames on the beat
+    std::vector<double> slotStrength ((size_t) beatsPerBar, 0.0);
+
+    for (auto i = firstFrame; i < endFrame; ++i)
+    {
+        const auto beat = frameBeats[i] - phase;
+        const auto nearest = std::round (beat);
+
+        if (std::abs (beat - nearest) < 1.5 / phaseBins)
+            slotStrength[(size_t) (((long long) nearest % beatsPerBar + beatsPerBar) % beatsPerBar)] += envelope[i];
+    }
+
+    const auto downbeatSlot = (int) std::distance (slotStrength.begin(), std::max_element (slotStrength.begin(), slotStrength.end()));
+
+    // Every downbeat's time and onset strength (the envelope's peak around it)
+    auto timeOfBeat = [&] (double beat)
+    {
+        const auto next = std::lower_bound (frameBeats.begin(), frameBeats.end(), beat);
+
+        // Before the first frame (a downbeat just ahead of the track) the first tempo holds
+        if (next == frameBeats.begin())
+            return (beat - frameBeats.front()) * 60.0 / map.getBpmAt (0.0);
+
+        if (next == frameBeats.end())
+            return (double) (numFrames - 1) / frameRate;
+
+        const auto i = (size_t) std::distance (frameBeats.begin(), next);
+        const auto proportion = (beat - frameBeats[i - 1]) / (frameBeats[i] - frameBeats[i - 1]);
+        return ((double) (i - 1) + proportion) / frameRate;
+    };
+
+    struct Downbeat
+    {
+        double time, strength;
+    };
+
+    std::vector<Downbeat> downbeats;
+    const auto lastBeat = frameBeats[endFrame - 1];
+    auto bar = std::floor ((frameBeats[firstFrame] - phase - downbeatSlot) / beatsPerBar);
+
+    for (;; bar += 1.0)
+    {
+        const auto beat = bar * beatsPerBar + downbeatSlot + phase;
+
+        if (beat > lastBeat)
+            break;
+
+        const auto time = timeOfBeat (beat);
+        const auto frame = juce::roundToInt (time * frameRate);
+        float strength = 0.0f;
+
+        for (auto i = juce::jmax (0, frame - 2); i <= juce::jmin ((int) numFrames - 1, frame + 2); ++i)
+            strength = juce::jmax (strength, envelope[(size_t) i]);
+
+        if (time >= audibleStart - snapToAudibleStart)
+            downbeats.push_back ({ time, strength });
+    }
+
+    if (downbeats.empty())
+        return audibleStart;
+
+    double meanStrength = 0.0;
+
+    for (auto& d : downbeats)
+        meanStrength += d.strength;
+
+    meanStrength /= (double) downbeats.size();
+
+    for (auto& d : downbeats)
+    {
+        if (d.strength >= 0.5 * meanStrength)
+        {
+            if (std::abs (d.time - audibleStart) <= snapToAudibleStart)
+                return audibleStart;
+
+            return juce::jmax (audibleStart, d.time);
+        }
+    }
+
+    return audibleStart;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "TempoMap.h"
+#include <vector>
+
+//==============================================================================
+/**
+    Finds where a track's first bar starts, so imported clips can begin on it.
+
+    Works from the onset envelope and tempo map the import analysis already
+    has. The envelope is folded onto one beat to find the beat phase, then
+    onto one bar to find which beat of the bar is hit hardest - the downbeat.
+    The first downbeat after the leading silence whose onset is at least half
+    as strong as a typical downbeat's is the one returned, which skips pickup
+    bars and count-ins.
+*/
+struct DownbeatFinder
+{
+    /** Returns the first strong downbeat, in seconds, at or after audibleStart
+        (the end of the leading silence). Returns audibleStart if there's no
+        clear pulse to go on.
+    */
+    static double findFirstDownbeat (const std::vector<float>& onsetEnvelope, double frameRate,
+                                     const TempoMap&, double audibleStart, double audibleEnd,
+                                     int beatsPerBar = 4);
+
+    /** A downbeat this close to the first audible sample is snapped onto it, which
+        is sample-accurate where the envelope is only accurate to a frame.
+    */
+    static constexpr double snapToAudibleStart = 0.05;
+};
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "AudioAnalyzer.h"
+#include "MusicalKey.h"
+#include <array>
+#include <vector>
+
+//==============================================================================
+/**
+    Estimates a track's key from its chromagram.
+
+    The magnitude spectra of long, half-overlapping frames are summed over the
+    whole track, so the per-frame work is a window, an FFT and a vector add.
+    At the end the summed spectrum is folded into 12 pitch classes and
+    correlated with the Krumhansl-Kessler profiles for all 24 keys; the best
+    match is the key.
+*/
+class KeyAnalyzer : public AudioAnalyzer
+{
+public:
+    static constexpr int fftOrder = 13;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+
+    // Notes from C2 up to B6; below that bins are wider than a semitone
+    static constexpr double lowestFrequency = 63.0, highestFrequency = 2000.0;
+
+    // At ~11 kHz an 8192 point frame resolves 1.35 Hz, a third of a semitone at C2
+    Format getFormat() const override                   { return { 11025.0, true }; }
+
+    void prepare (double sampleRateToUse, int, juce::int64) override
+    {
+        sampleRate = sampleRateToUse;
+        window.assign (fftSize, 0.0f);
+        fftData.assign (fftSize * 2, 0.0f);
+        spectrum.assign (fftSize / 2 + 1, 0.0f);
+        samplesSinceFrame = 0;
+        numFrames = 0;
+        key = {};
+        chroma = {};
+        confidence = 0.0f;
+
+        windowShape.resize (fftSize);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables (windowShape.data(), fftSize,
+                                                                  juce::dsp::WindowingFunction<float>::hann, false);
+    }
+
+    void process (const juce::AudioBuffer<float>& block, int numSamples) override
+    {
+        const auto* data = block.getReadPointer (0);
+
+        for (int start = 0; start < numSamples;)
+        {
+            const auto n = juce::jmin (numSamples - start, hopSize - samplesSinceFrame);
+
+            std::move (window.begin() + n, window.end(), window.begin());
+            std::copy (data + start, data + start + n, window.end() - n);
+
+            samplesSinceFrame += n;
+            start += n;
+
+            if (samplesSinceFrame == hopSize)
+            {
+                analyseFrame();
+                samplesSinceFrame = 0;
+            }
+        }
+    }
+
+    void finish() override
+    {
+        // A track shorter than a frame is analysed from what there is
+        if (numFrames == 0)
+            analyseFrame();
+
+        for (size_t bin = 1; bin < spectrum.size(); ++bin)
+        {
+            const auto frequency = (double) bin * sampleRate / fftSize;
+
+            if (frequency < lowestFrequency || frequency > highestFrequency)
+                continue;
+
+            const auto note = juce::roundToInt (69.0 + 12.0 * std::log2 (frequency / 440.0));
+            chroma[(size_t) (note % 12)] += spectrum[bin];
+        }
+
+        float best = -1.0f, secondBest = -1.0f;
+
+        for (int tonic = 0; tonic < 12; ++tonic)
+        {
+            for (auto minor : { false, true })
+            {
+                const auto c = correlate (minor ? minorProfile : majorProfile, tonic);
+
+                if (c > best)
+                {
+                    secondBest = best;
+                    best = c;
+                    key = { tonic, minor };
+                }
+                else if (c > secondBest)
+                {
+                    secondBest = c;
+                }
+            }
+        }
+
+        // Silence correlates with nothing
+        if (! std::isfinite (best) || best <= 0.0f)
+        {
+            key = {};
+            return;
+        }
+
+        confidence = best - secondBest;
+    }
+
+    /** The estimated key; not valid if the track had no tonal content. */
+    MusicalKey getKey() const noexcept                  { return key; }
+
+    /** How far ahead of the runner-up the chosen key correlated (0 to 2). */
+    float getConfidence() const noexcept                { return confidence; }
+
+    /** The track's summed energy per pitch class, C first. */
+    const std::array<float, 12>& getChroma() const noexcept { return chroma; }
+
+private:
+    using Profile = std::array<float, 12>;
+
+    // Krumhansl & Kessler's probe-tone ratings, tonic first
+    static constexpr Profile majorProfile { 6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f };
+    static constexpr Profile minorProfile { 6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f };
+
+    juce::dsp::FFT fft { fftOrder };
+    double sampleRate = 11025.0;
+    std::vector<float> window, windowShape, fftData, spectrum;
+    int samplesSinceFrame = 0, numFrames = 0;
+
+    MusicalKey key;
+    std::array<float, 12> chroma {};
+    float confidence = 0.0f;
+
+    void analyseFrame()
+    {
+        juce::FloatVectorOperations::multiply (fftData.data(), window.data(), windowShape.data(), fftSize);
+        std::fill (fftData.begin() + fftSize, fftData.end(), 0.0f);
+        fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+        juce::FloatVectorOperations::add (spectrum.data(), fftData.data(), (int) spectrum.size());
+        ++numFrames;
+    }
+
+    // Pearson correlation of the chroma, rotated to the tonic, with a profile
+    float correlate (const Profile& profile, int tonic) const
+    {
+        float chromaMean = 0.0f, profileMean = 0.0f;
+
+        for (size_t i = 0; i < 12; ++i)
+        {
+            chromaMean += chroma[i] / 12.0f;
+            profileMean += profile[i] / 12.0f;
+        }
+
+        float sum = 0.0f, chromaSquares = 0.0f, profileSquares = 0.0f;
+
+        for (size_t i = 0; i < 12; ++i)
+        {
+            const auto c = chroma[(i + (size_t) tonic) % 12] - chromaMean;
+            const auto p = profile[i] - profileMean;
+            sum += c * p;
+            chromaSquares += c * c;
+            profileSquares += p * p;
+        }
+
+        return sum / std::sqrt (chromaSquares * profileSquares);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KeyAnalyzer)
+};
@@ -0,0 +1,299 @@
+#include "LoudnessAnalyzer.h"
+#include <array>
+#include <cstring>
+
+namespace
+{
+    constexpr int interpolatorPhases = 4;
+    constexpr int interpolatorLength = 48;
+
+    // 4x polyphase interpolator: a Blackman-windowed sinc centred on a tap, so
+    // phase 0 is the input itself and phase 2 lies halfway between samples. Each
+    // phase is normalised to unity gain at DC and stored reversed, ready to be
+    // run over the most recent samples.
+    struct Interpolator
+    {
+        static constexpr int tapsPerPhase = interpolatorLength / interpolatorPhases;
+
+        std::array<std::array<float, tapsPerPhase>, interpolatorPhases> taps {};
+
+        // The most any phase can amplify its input by, for skipping quiet stretches
+        float maxGain = 0.0f;
+
+        static const Interpolator& get()
+        {
+            static const Interpolator interpolator = []
+            {
+                constexpr int centre = interpolatorLength / 2;
+                Interpolator t;
+
+                for (int p = 0; p < interpolatorPhases; ++p)
+                {
+                    double sum = 0.0, absSum = 0.0;
+                    std::array<double, tapsPerPhase> h {};
+
+                    for (int k = 0; k < tapsPerPhase; ++k)
+                    {
+                        const auto n = k * interpolatorPhases + p;
+                        const auto x = (n - centre) / (double) interpolatorPhases;
+                        const auto sinc = x == 0.0 ? 1.0 : std::sin (juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                        const auto phase = juce::MathConstants<double>::twoPi * n / interpolatorLength;
+                        h[(size_t) k] = sinc * (0.42 - 0.5 * std::cos (phase) + 0.08 * std::cos (2.0 * phase));
+                        sum += h[(size_t) k];
+                    }
+
+                    for (int k = 0; k < tapsPerPhase; ++k)
+                    {
+                        t.taps[(size_t) p][(size_t) (tapsPerPhase - 1 - k)] = (float) (h[(size_t) k] / sum);
+                        absSum += std::abs (h[(size_t) k] / sum);
+                    }
+
+                    t.maxGain = juce::jmax (t.maxGain, (float) absSum);
+                }
+
+                return t;
+            }();
+
+            return interpolator;
+        }
+    };
+
+    double blockLoudness (double power)
+    {
+        return -0.691 + 10.0 * std::log10 (power);
+    }
+
+    double powerForLoudness (double lufs)
+    {
+        return std::pow (10.0, (lufs + 0.691) / 10.0);
+    }
+}
+
+//==============================================================================
+void LoudnessAnalyzer::prepare (double sampleRate, int numChannels, juce::int64)
+{
+    using namespace juce;
+    const auto pi = MathConstants<double>::pi;
+
+    // BS.1770 gives the K-weighting coefficients at 48 kHz; these are the
+    // analogue prototypes they came from, so any rate gets the same response.
+    {
+        const auto f0 = 1681.974450955533, gain = 3.999843853973347, q = 0.7071752369554196;
+        const auto k = std::tan (pi * f0 / sampleRate);
+        const auto vh = std::pow (10.0, gain / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        shelf = Biquad::create ((vh + vb * k / q + k * k) / a0,
+                                2.0 * (k * k - vh) / a0,
+                                (vh - vb * k / q + k * k) / a0,
+                                2.0 * (k * k - 1.0) / a0,
+                                (1.0 - k / q + k * k) / a0);
+    }
+
+    {
+        const auto f0 = 38.13547087602444, q = 0.5003270373238773;
+        const auto k = std::tan (pi * f0 / sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        highPass = Biquad::create (1.0, -2.0, 1.0,
+                                   2.0 * (k * k - 1.0) / a0,
+                                   (1.0 - k / q + k * k) / a0);
+    }
+
+    // Surrounds count for +1.5 dB and the LFE not at all (BS.1770 for 5.1, in the usual WAV order)
+    channelWeights.assign ((size_t) numChannels, 1.0);
+
+    if (numChannels == 6)
+    {
+        channelWeights[3] = 0.0;
+        channelWeights[4] = channelWeights[5] = 1.41;
+    }
+
+    groups.clear();
+    const auto lanes = (int) Vec::size();
+
+    for (int first = 0; first < numChannels; first += lanes)
+    {
+        ChannelGroup group;
+        group.firstChannel = first;
+        group.numChannels = jmin (lanes, numChannels - first);
+        group.shelfState1 = group.shelfState2 = group.highPassState1 = group.highPassState2 = group.sum = Vec::expand (0.0);
+        groups.push_back (group);
+    }
+
+    samplesPerStep = jmax (1, roundToInt (sampleRate * 0.1));
+    samplesInStep = 0;
+    stepPowers.clear();
+
+    oversampling = sampleRate < 88200.0 ? 4 : (sampleRate < 176400.0 ? 2 : 1);
+    peakHistory.assign ((size_t) numChannels, std::vector<float> ((size_t) interpolatorTaps - 1, 0.0f));
+    truePeak = samplePeak = 0.0f;
+
+    integratedLoudness = -std::numeric_limits<double>::infinity();
+}
+
+void LoudnessAnalyzer::process (const juce::AudioBuffer<float>& block, int numSamples)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    measurePeaks (block, numSamples);
+
+    for (int done = 0; done < numSamples;)
+    {
+        const auto chunk = juce::jmin (numSamples - done, samplesPerStep - samplesInStep);
+
+        for (auto& group : groups)
+            filterAndAccumulate (group, block, done, chunk);
+
+        done += chunk;
+        samplesInStep += chunk;
+
+        if (samplesInStep == samplesPerStep)
+            endStep();
+    }
+}
+
+void LoudnessAnalyzer::filterAndAccumulate (ChannelGroup& group, const juce::AudioBuffer<float>& block, int start, int numSamples)
+{
+    std::array<const float*, Vec::SIMDNumElements> input {};
+
+    for (int lane = 0; lane < group.numChannels; ++lane)
+        input[(size_t) lane] = block.getReadPointer (group.firstChannel + lane, start);
+
+    auto s1 = group.shelfState1, s2 = group.shelfState2;
+    auto h1 = group.highPassState1, h2 = group.highPassState2;
+    auto sum = group.sum;
+    auto x = Vec::expand (0.0);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int lane = 0; lane < group.numChannels; ++lane)
+            x.set ((size_t) lane, (double) input[(size_t) lane][i]);
+
+        // Transposed direct form II, both stages
+        const auto y = shelf.b0 * x + s1;
+        s1 = shelf.b1 * x - shelf.a1 * y + s2;
+        s2 = shelf.b2 * x - shelf.a2 * y;
+
+        const auto z = highPass.b0 * y + h1;
+        h1 = highPass.b1 * y - highPass.a1 * z + h2;
+        h2 = highPass.b2 * y - highPass.a2 * z;
+
+        sum += z * z;
+    }
+
+    group.shelfState1 = s1;
+    group.shelfState2 = s2;
+    group.highPassState1 = h1;
+    group.highPassState2 = h2;
+    group.sum = sum;
+}
+
+void LoudnessAnalyzer::endStep()
+{
+    double power = 0.0;
+
+    for (auto& group : groups)
+    {
+        for (int lane = 0; lane < group.numChannels; ++lane)
+            power += channelWeights[(size_t) (group.firstChannel + lane)] * group.sum.get ((size_t) lane);
+
+        group.sum = Vec::expand (0.0);
+    }
+
+    stepPowers.push_back (power / samplesPerStep);
+    samplesInStep = 0;
+}
+
+void LoudnessAnalyzer::measurePeaks (const juce::AudioBuffer<float>& block, int numSamples)
+{
+    static_assert (interpolatorTaps == Interpolator::tapsPerPhase);
+
+    constexpr int history = interpolatorTaps - 1;
+    constexpr int segmentSize = 64;
+    const auto& interpolator = Interpolator::get();
+
+    for (int ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        const auto* data = block.getReadPointer (ch);
+        const auto range = juce::FloatVectorOperations::findMinAndMax (data, numSamples);
+        samplePeak = juce::jmax (samplePeak, -range.getStart(), range.getEnd());
+        truePeak = juce::jmax (truePeak, samplePeak);
+
+        auto& work = peakHistory[(size_t) ch];
+        work.resize ((size_t) (history + numSamples));
+        juce::FloatVectorOperations::copy (work.data() + history, data, numSamples);
+
+        if (oversampling > 1)
+        {
+            // No phase can exceed its input by more than maxGain, so most segments
+            // can be ruled out from their sample peak alone
+            const auto phaseStep = interpolatorPhases / oversampling;
+
+            for (int segment = 0; segment < numSamples; segment += segmentSize)
+            {
+                const auto length = juce::jmin (segmentSize, numSamples - segment);
+                const auto* w = work.data() + segment;
+                const auto segmentRange = juce::FloatVectorOperations::findMinAndMax (w, length + history);
+
+                if (juce::jmax (-segmentRange.getStart(), segmentRange.getEnd()) * interpolator.maxGain <= truePeak)
+                    continue;
+
+                for (int i = 0; i < length; ++i)
+                {
+                    for (int p = phaseStep; p < interpolatorPhases; p += phaseStep)
+                    {
+                        const auto& taps = interpolator.taps[(size_t) p];
+                        float y = 0.0f;
+
+                        for (int k = 0; k < interpolatorTaps; ++k)
+                            y += taps[(size_t) k] * w[i + k];
+
+                        truePeak = juce::jmax (truePeak, std::abs (y));
+                    }
+                }
+            }
+        }
+
+        std::memmove (work.data(), work.data() + numSamples, (size_t) history * sizeof (float));
+        work.resize ((size_t) history);
+    }
+}
+
+void LoudnessAnalyzer::finish()
+{
+    // Gating blocks are 400 ms long, starting every 100 ms
+    std::vector<double> blockPowers;
+
+    for (size_t i = 3; i < stepPowers.size(); ++i)
+        blockPowers.push_back ((stepPowers[i - 3] + stepPowers[i - 2] + stepPowers[i - 1] + stepPowers[i]) / 4.0);
+
+    auto meanAbove = [&blockPowers] (double threshold, double& mean)
+    {
+        double sum = 0.0;
+        size_t count = 0;
+
+        for (auto power : blockPowers)
+        {
+            if (power > threshold)
+            {
+                sum += power;
+                ++count;
+            }
+        }
+
+        mean = count > 0 ? sum / (double) count : 0.0;
+        return count > 0;
+    };
+
+    double ungated = 0.0, gated = 0.0;
+
+    if (! meanAbove (powerForLoudness (absoluteGate), ungated))
+        return;
+
+    const auto relativeThreshold = juce::jmax (powerForLoudness (absoluteGate), powerForLoudness (blockLoudness (ungated) + relativeGate));
+
+    if (meanAbove (relativeThreshold, gated))
+        integratedLoudness = blockLoudness (gated);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "AudioAnalyzer.h"
+#include <vector>
+
+//==============================================================================
+/**
+    EBU R128 / ITU-R BS.1770-4 integrated loudness and true peak.
+
+    Loudness: each channel goes through the K-weighting filters (a high
+    shelf, then a high-pass), mean squares are taken over 400 ms blocks
+    overlapping by 75%, and blocks are gated at -70 LUFS and then at 10 LU
+    below the mean of the rest. The filters run on SIMD registers with one
+    channel per lane, so a stereo file is filtered in a single pass.
+
+    True peak: the signal is oversampled to at least 176.4 kHz with a
+    polyphase interpolator and the largest magnitude is taken.
+*/
+class LoudnessAnalyzer : public AudioAnalyzer
+{
+public:
+    LoudnessAnalyzer() = default;
+
+    // The filters are specified at the file's rate, and every channel counts
+    Format getFormat() const override                   { return { 0.0, false }; }
+
+    void prepare (double sampleRate, int numChannels, juce::int64 lengthInSamples) override;
+    void process (const juce::AudioBuffer<float>& block, int numSamples) override;
+    void finish() override;
+
+    /** Integrated loudness in LUFS, or -infinity if the file never got above the absolute gate. */
+    double getIntegratedLoudness() const noexcept       { return integratedLoudness; }
+
+    /** True peak in dBTP (and the plain sample peak in dBFS). */
+    double getTruePeak() const noexcept                 { return juce::Decibels::gainToDecibels ((double) truePeak, -200.0); }
+    double getSamplePeak() const noexcept               { return juce::Decibels::gainToDecibels ((double) samplePeak, -200.0); }
+
+    static constexpr double absoluteGate = -70.0;      // LUFS
+    static constexpr double relativeGate = -10.0;      // LU
+
+private:
+    using Vec = juce::dsp::SIMDRegister<double>;
+
+    struct Biquad
+    {
+        Vec b0, b1, b2, a1, a2;
+
+        static Biquad create (double b0, double b1, double b2, double a1, double a2)
+        {
+            return { Vec::expand (b0), Vec::expand (b1), Vec::expand (b2), Vec::expand (a1), Vec::expand (a2) };
+        }
+    };
+
+    // One group of channels, a lane each
+    struct ChannelGroup
+    {
+        int firstChannel = 0, numChannels = 0;
+        Vec shelfState1, shelfState2, highPassState1, highPassState2;
+        Vec sum;
+    };
+
+    Biquad shelf, highPass;
+    std::vector<ChannelGroup> groups;
+    std::vector<double> channelWeights;
+
+    int samplesPerStep = 0, samplesInStep = 0;      // 100 ms steps; a gating block is four of them
+    std::vector<double> stepPowers;                 // weighted mean square of each step
+
+    // True peak
+    static constexpr int interpolatorTaps = 12;     // per phase
+    int oversampling = 1;
+    std::vector<std::vector<float>> peakHistory;    // each channel's last interpolatorTaps - 1 samples
+    float truePeak = 0.0f, samplePeak = 0.0f;
+
+    double integratedLoudness = -std::numeric_limits<double>::infinity();
+
+    void filterAndAccumulate (ChannelGroup&, const juce::AudioBuffer<float>&, int start, int numSamples);
+    void endStep();
+    void measurePeaks (const juce::AudioBuffer<float>&, int numSamples);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessAnalyzer)
+};
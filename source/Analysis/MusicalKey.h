@@ -0,0 +1,79 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/**
+    One of the 24 major and minor keys.
+
+    The library stores keys by name ("Am", "F#"). The Camelot code ("8A") is
+    what DJs mix by: keys with the same number, or numbers one apart, mix
+    harmonically, so it's also what the key column sorts by.
+*/
+struct MusicalKey
+{
+    int tonic = -1;         // pitch class, 0 = C ... 11 = B; -1 if unknown
+    bool minor = false;
+
+    bool isValid() const noexcept                       { return tonic >= 0 && tonic < 12; }
+
+    juce::String getName() const
+    {
+        static const char* const majorNames[] = { "C", "Db", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+        static const char* const minorNames[] = { "Cm", "C#m", "Dm", "Ebm", "Em", "Fm", "F#m", "Gm", "G#m", "Am", "Bbm", "Bm" };
+
+        if (! isValid())
+            return {};
+
+        return minor ? minorNames[tonic] : majorNames[tonic];
+    }
+
+    /** 1-12 round the circle of fifths; a key and its relative share a number. */
+    int getCamelotNumber() const noexcept
+    {
+        const auto relativeMajor = minor ? (tonic + 3) % 12 : tonic;
+        return (relativeMajor * 7 + 7) % 12 + 1;
+    }
+
+    juce::String getCamelotCode() const
+    {
+        return isValid() ? juce::String (getCamelotNumber()) + (minor ? "A" : "B") : juce::String();
+    }
+
+    /** Orders keys round the Camelot wheel (1A, 1B, 2A ...), with unknown keys last. */
+    int getSortOrder() const noexcept
+    {
+        return isValid() ? getCamelotNumber() * 2 + (minor ? 0 : 1) : std::numeric_limits<int>::max();
+    }
+
+    /** Parses a name written by getName(), accepting either spelling of the black keys. */
+    static MusicalKey fromName (const juce::String& name)
+    {
+        auto text = name.trim();
+        MusicalKey key;
+
+        if (text.isEmpty())
+            return key;
+
+        static const juce::String letters ("C D EF G A B");
+        const auto letter = letters.indexOfChar (juce::CharacterFunctions::toUpperCase (text[0]));
+
+        if (letter < 0 || text[0] == ' ')
+            return key;
+
+        auto tonic = letter;
+        text = text.substring (1);
+
+        if (text.startsWithChar ('#'))      { ++tonic; text = text.substring (1); }
+        else if (text.startsWithChar ('b')) { --tonic; text = text.substring (1); }
+
+        if (text.isNotEmpty() && text != "m")
+            return key;
+
+        key.tonic = (tonic + 12) % 12;
+        key.minor = text == "m";
+        return key;
+    }
+
+    bool operator== (const MusicalKey&) const = default;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "AudioAnalyzer.h"
+#include <vector>
+
+//==============================================================================
+/**
+    A spectral-flux onset envelope: one value per hop, rising where new energy
+    appears in the spectrum (drum hits, note starts). Beat tracking, tempo
+    mapping and downbeat finding all start from this.
+*/
+class OnsetEnvelopeAnalyzer : public AudioAnalyzer
+{
+public:
+    static constexpr int fftOrder = 10;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = 128;
+
+    // ~11 kHz keeps kick and snare detail and gives ~11.6 ms frames
+    Format getFormat() const override                   { return { 11025.0, true }; }
+
+    void prepare (double sampleRateToUse, int, juce::int64 lengthInSamples) override
+    {
+        sampleRate = sampleRateToUse;
+        window.assign (fftSize, 0.0f);
+        fftData.assign (fftSize * 2, 0.0f);
+        previousMagnitudes.assign (fftSize / 2 + 1, 0.0f);
+        samplesSinceFrame = 0;
+        envelope.clear();
+        envelope.reserve ((size_t) (lengthInSamples / hopSize + 1));
+
+        windowShape.resize (fftSize);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables (windowShape.data(), fftSize,
+                                                                  juce::dsp::WindowingFunction<float>::hann, false);
+    }
+
+    void process (const juce::AudioBuffer<float>& block, int numSamples) override
+    {
+        const auto* data = block.getReadPointer (0);
+
+        for (int start = 0; start < numSamples;)
+        {
+            const auto n = juce::jmin (numSamples - start, hopSize - samplesSinceFrame);
+
+            // Slide the analysis window along
+            std::move (window.begin() + n, window.end(), window.begin());
+            std::copy (data + start, data + start + n, window.end() - n);
+
+            samplesSinceFrame += n;
+            start += n;
+
+            if (samplesSinceFrame == hopSize)
+            {
+                analyseFrame();
+                samplesSinceFrame = 0;
+            }
+        }
+    }
+
+    /** Frames per second. Frame i ends at sample (i + 1) * hopSize of the analysed stream. */
+    double getFrameRate() const noexcept                { return sampleRate / hopSize; }
+
+    const std::vector<float>& getEnvelope() const noexcept { return envelope; }
+
+private:
+    juce::dsp::FFT fft { fftOrder };
+    double sampleRate = 11025.0;
+    std::vector<float> window, windowShape, fftData, previousMagnitudes, envelope;
+    int samplesSinceFrame = 0;
+
+    void analyseFrame()
+    {
+        juce::FloatVectorOperations::multiply (fftData.data(), window.data(), windowShape.data(), fftSize);
+        std::fill (fftData.begin() + fftSize, fftData.end(), 0.0f);
+        fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+        // Log-compressed so quiet passages still register, half-wave rectified so only rises count
+        float flux = 0.0f;
+
+        for (size_t bin = 0; bin < previousMagnitudes.size(); ++bin)
+        {
+            const auto magnitude = std::log1p (100.0f * fftData[bin]);
+            flux += juce::jmax (0.0f, magnitude - previousMagnitudes[bin]);
+            previousMagnitudes[bin] = magnitude;
+        }
+
+        envelope.push_back (flux);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OnsetEnvelopeAnalyzer)
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "AudioAnalyzer.h"
+#include <vector>
+
+//==============================================================================
+/**
+    Min/max peaks per channel at a ladder of resolutions, for drawing the
+    waveform at any zoom without going back to the file.
+
+    Level 0 holds one peak per samplesPerPeak samples; each level above it
+    merges levelRatio peaks of the one below, up to a single peak for the
+    whole file.
+*/
+class PeakPyramidAnalyzer : public AudioAnalyzer
+{
+public:
+    static constexpr int samplesPerPeak = 256;
+    static constexpr int levelRatio = 4;
+
+    Format getFormat() const override                   { return { 0.0, false }; }
+
+    void prepare (double, int numChannelsToUse, juce::int64 lengthInSamples) override
+    {
+        numChannels = numChannelsToUse;
+        levels.assign (1, {});
+        levels[0].reserve ((size_t) (lengthInSamples / samplesPerPeak + 1) * (size_t) numChannels);
+        current.assign ((size_t) numChannels, {});
+        samplesInCurrent = 0;
+    }
+
+    void process (const juce::AudioBuffer<float>& block, int numSamples) override
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            const auto n = juce::jmin (numSamples - start, samplesPerPeak - samplesInCurrent);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto range = juce::FloatVectorOperations::findMinAndMax (block.getReadPointer (ch, start), n);
+                auto& peak = current[(size_t) ch];
+                peak = samplesInCurrent == 0 ? range : peak.getUnionWith (range);
+            }
+
+            samplesInCurrent += n;
+            start += n;
+
+            if (samplesInCurrent == samplesPerPeak)
+                pushCurrent();
+        }
+    }
+
+    void finish() override
+    {
+        if (samplesInCurrent > 0)
+            pushCurrent();
+
+        // Each level merges levelRatio peaks of the one below
+        while (levels.back().size() > (size_t) numChannels)
+        {
+            const auto& below = levels.back();
+            const auto numBelow = below.size() / (size_t) numChannels;
+            std::vector<juce::Range<float>> level;
+            level.reserve ((numBelow / levelRatio + 1) * (size_t) numChannels);
+
+            for (size_t first = 0; first < numBelow; first += levelRatio)
+            {
+                for (size_t ch = 0; ch < (size_t) numChannels; ++ch)
+                {
+                    auto peak = below[first * (size_t) numChannels + ch];
+
+                    for (size_t i = first + 1; i < juce::jmin (first + levelRatio, numBelow); ++i)
+                        peak = peak.getUnionWith (below[i * (size_t) numChannels + ch]);
+
+                    level.push_back (peak);
+                }
+            }
+
+            levels.push_back (std::move (level));
+        }
+    }
+
+    int getNumLevels() const noexcept                   { return (int) levels.size(); }
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** The number of file samples each peak at a level covers. */
+    static juce::int64 getSamplesPerPeak (int level) noexcept
+    {
+        juce::int64 n = samplesPerPeak;
+
+        for (int i = 0; i < level; ++i)
+            n *= levelRatio;
+
+        return n;
+    }
+
+    int getNumPeaks (int level) const noexcept          { return (int) (levels[(size_t) level].size() / (size_t) juce::jmax (1, numChannels)); }
+
+    juce::Range<float> getPeak (int level, int index, int channel) const noexcept
+    {
+        return levels[(size_t) level][(size_t) index * (size_t) numChannels + (size_t) channel];
+    }
+
+private:
+    int numChannels = 0;
+    std::vector<std::vector<juce::Range<float>>> levels; // peaks interleaved by channel
+    std::vector<juce::Range<float>> current;
+    int samplesInCurrent = 0;
+
+    void pushCurrent()
+    {
+        levels[0].insert (levels[0].end(), current.begin(), current.end());
+        samplesInCurrent = 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PeakPyramidAnalyzer)
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "AudioAnalyzer.h"
+
+//==============================================================================
+/** Finds the first and last audible samples, for trimming silent lead-ins and tails. */
+class SilenceAnalyzer : public AudioAnalyzer
+{
+public:
+    explicit SilenceAnalyzer (float thresholdDecibels = -60.0f)
+        : threshold (juce::Decibels::decibelsToGain (thresholdDecibels)) {}
+
+    // At the file's rate, so the trim points are sample-accurate
+    Format getFormat() const override                   { return { 0.0, false }; }
+
+    void prepare (double sampleRateToUse, int, juce::int64) override
+    {
+        sampleRate = sampleRateToUse;
+        position = 0;
+        firstAudible = -1;
+        lastAudible = -1;
+    }
+
+    void process (const juce::AudioBuffer<float>& block, int numSamples) override
+    {
+        for (int ch = 0; ch < block.getNumChannels(); ++ch)
+        {
+            const auto* data = block.getReadPointer (ch);
+            const auto range = juce::FloatVectorOperations::findMinAndMax (data, numSamples);
+
+            // Most blocks are either all quiet or have audio at both ends, so only scan when it matters
+            if (range.getStart() > -threshold && range.getEnd() < threshold)
+                continue;
+
+            if (firstAudible < 0 || firstAudible > position)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    if (std::abs (data[i]) >= threshold)
+                    {
+                        firstAudible = firstAudible < 0 ? position + i : juce::jmin (firstAudible, position + i);
+                        break;
+                    }
+                }
+            }
+
+            for (int i = numSamples; --i >= 0;)
+            {
+                if (std::abs (data[i]) >= threshold)
+                {
+                    lastAudible = juce::jmax (lastAudible, position + i);
+                    break;
+                }
+            }
+        }
+
+        position += numSamples;
+    }
+
+    /** True if nothing in the file reached the threshold. */
+    bool isSilent() const noexcept                      { return firstAudible < 0; }
+
+    /** The silence before the first audible sample, in seconds. */
+    double getLeadingSilence() const noexcept           { return isSilent() ? 0.0 : (double) firstAudible / sampleRate; }
+
+    /** The silence after the last audible sample, in seconds. */
+    double getTrailingSilence() const noexcept          { return isSilent() ? 0.0 : (double) (position - 1 - lastAudible) / sampleRate; }
+
+private:
+    float threshold;
+    double sampleRate = 44100.0;
+    juce::int64 position = 0, firstAudible = -1, lastAudible = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SilenceAnalyzer)
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "AudioAnalyzer.h"
+#include "minibpm.h"
+#include <memory>
+
+//==============================================================================
+/** The track's overall tempo, from MiniBPM. */
+class TempoAnalyzer : public AudioAnalyzer
+{
+public:
+    TempoAnalyzer (double minBpmToUse = 60.0, double maxBpmToUse = 180.0)
+        : minBpm (minBpmToUse), maxBpm (maxBpmToUse) {}
+
+    // MiniBPM only needs the band up to a few kHz, and takes a single channel
+    Format getFormat() const override                   { return { 22050.0, true }; }
+
+    void prepare (double sampleRate, int, juce::int64) override
+    {
+        detector = std::make_unique<breakfastquay::MiniBPM> ((float) sampleRate);
+        detector->setBPMRange (minBpm, maxBpm);
+        bpm = 0.0f;
+    }
+
+    void process (const juce::AudioBuffer<float>& block, int numSamples) override
+    {
+        detector->process (block.getReadPointer (0), numSamples);
+    }
+
+    void finish() override
+    {
+        bpm = (float) detector->estimateTempo();
+    }
+
+    /** The estimate, or 0 if MiniBPM couldn't find one. */
+    float getBpm() const noexcept                       { return bpm; }
+
+private:
+    double minBpm, maxBpm;
+    std::unique_ptr<breakfastquay::MiniBPM> detector;
+    float bpm = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TempoAnalyzer)
+};
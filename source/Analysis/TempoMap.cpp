@@ -0,0 +1,254 @@
+#include "TempoMap.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+    struct WindowEstimate
+    {
+        double time, bpm, confidence;
+    };
+
+    // Autocorrelation read between lags
+    double interpolate (const std::vector<double>& values, double index)
+    {
+        const auto i = (size_t) index;
+
+        if (i + 1 >= values.size())
+            return values.back();
+
+        const auto frac = index - (double) i;
+        return values[i] * (1.0 - frac) + values[i + 1] * frac;
+    }
+}
+
+//==============================================================================
+double TempoMap::getBpmAt (double time) const
+{
+    if (points.empty())
+        return 0.0;
+
+    auto next = std::upper_bound (points.begin(), points.end(), time, [] (double t, const Point& p) { return t < p.time; });
+
+    if (next == points.begin())
+        return points.front().bpm;
+
+    if (next == points.end())
+        return points.back().bpm;
+
+    const auto& previous = *std::prev (next);
+    const auto proportion = (time - previous.time) / (next->time - previous.time);
+    return previous.bpm + (next->bpm - previous.bpm) * proportion;
+}
+
+double TempoMap::getBeatAt (double time) const
+{
+    if (points.empty())
+        return 0.0;
+
+    // The tempo is linear between points, so each stretch between them is a trapezoid
+    double beats = 0.0, position = 0.0;
+
+    for (auto& p : points)
+    {
+        if (p.time <= position)
+            continue;
+
+        const auto end = juce::jmin (p.time, time);
+        beats += (end - position) * (getBpmAt (position) + getBpmAt (end)) / 120.0;
+        position = end;
+
+        if (position >= time)
+            return beats;
+    }
+
+    return beats + juce::jmax (0.0, time - position) * points.back().bpm / 60.0;
+}
+
+TempoMap TempoMap::startingAt (double time) const
+{
+    if (points.empty() || time <= 0.0)
+        return *this;
+
+    TempoMap map;
+    map.points.push_back ({ 0.0, getBpmAt (time) });
+
+    for (auto& p : points)
+        if (p.time > time)
+            map.points.push_back ({ p.time - time, p.bpm });
+
+    return map;
+}
+
+//==============================================================================
+TempoMap TempoMap::estimate (const std::vector<float>& envelope, double frameRate, double globalBpm)
+{
+    const auto windowFrames = juce::roundToInt (windowSeconds * frameRate);
+    const auto hopFrames = juce::roundToInt (hopSeconds * frameRate);
+
+    if (globalBpm <= 0.0 || frameRate <= 0.0 || (int) envelope.size() < windowFrames + hopFrames)
+        return steady (globalBpm);
+
+    // Candidate tempos, and the lags they need: a comb over four beats sharpens
+    // the estimate well below one frame
+    constexpr int combBeats = 4;
+    constexpr double candidateStep = 0.05;
+    const auto lowestBpm = globalBpm * (1.0 - maxDeviation), highestBpm = globalBpm * (1.0 + maxDeviation);
+    const auto maxLag = (int) std::ceil (combBeats * 60.0 * frameRate / lowestBpm) + 2;
+
+    if (maxLag >= windowFrames)
+        return steady (globalBpm);
+
+    std::vector<double> window ((size_t) windowFrames), autocorrelation ((size_t) maxLag + 1);
+    std::vector<WindowEstimate> estimates;
+
+    for (int start = 0; start + windowFrames <= (int) envelope.size(); start += hopFrames)
+    {
+        double mean = 0.0;
+
+        for (int i = 0; i < windowFrames; ++i)
+            mean += envelope[(size_t) (start + i)];
+
+        mean /= windowFrames;
+
+        for (int i = 0; i < windowFrames; ++i)
+            window[(size_t) i] = envelope[(size_t) (start + i)] - mean;
+
+        for (int lag = 0; lag <= maxLag; ++lag)
+        {
+            double sum = 0.0;
+
+            for (int i = 0; i + lag < windowFrames; ++i)
+                sum += window[(size_t) i] * window[(size_t) (i + lag)];
+
+            autocorrelation[(size_t) lag] = sum / (windowFrames - lag);
+        }
+
+        if (autocorrelation[0] <= 0.0)
+            continue;
+
+        auto score = [&] (double bpm)
+        {
+            const auto beatLag = 60.0 * frameRate / bpm;
+            double sum = 0.0;
+
+            for (int k = 1; k <= combBeats; ++k)
+                sum += interpolate (autocorrelation, k * beatLag);
+
+            return sum / (combBeats * autocorrelation[0]);
+        };
+
+        double bestBpm = lowestBpm, bestScore = -1.0;
+
+        for (auto bpm = lowestBpm; bpm <= highestBpm; bpm += candidateStep)
+        {
+            if (const auto s = score (bpm); s > bestScore)
+            {
+                bestScore = s;
+                bestBpm = bpm;
+            }
+        }
+
+        // Fit a parabola through the peak and its neighbours
+        const auto below = score (bestBpm - candidateStep), above = score (bestBpm + candidateStep);
+        const auto curvature = below - 2.0 * bestScore + above;
+
+        if (curvature < 0.0)
+            bestBpm += juce::jlimit (-0.5, 0.5, 0.5 * (below - above) / curvature) * candidateStep;
+
+        estimates.push_back ({ (start + windowFrames * 0.5) / frameRate, bestBpm, bestScore });
+    }
+
+    // Windows without a clear pulse (breakdowns, intros) are left to their neighbours
+    constexpr double minConfidence = 0.1;
+    std::erase_if (estimates, [] (const WindowEstimate& e) { return e.confidence < minConfidence; });
+
+    if (estimates.size() < 3)
+        return steady (globalBpm);
+
+    // A running median removes single-window outliers, then two passes of a
+    // three-point average smooth what's left
+    std::vector<double> bpms;
+
+    for (size_t i = 0; i < estimates.size(); ++i)
+    {
+        std::array<double, 5> neighbourhood {};
+        size_t count = 0;
+
+        for (auto j = (int) i - 2; j <= (int) i + 2; ++j)
+            if (j >= 0 && j < (int) estimates.size())
+                neighbourhood[count++] = estimates[(size_t) j].bpm;
+
+        std::nth_element (neighbourhood.begin(), neighbourhood.begin() + (int) count / 2, neighbourhood.begin() + (int) count);
+        bpms.push_back (neighbourhood[count / 2]);
+    }
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        auto smoothed = bpms;
+
+        for (size_t i = 1; i + 1 < bpms.size(); ++i)
+            smoothed[i] = (bpms[i - 1] + 2.0 * bpms[i] + bpms[i + 1]) / 4.0;
+
+        bpms = std::move (smoothed);
+    }
+
+    const auto [lowest, highest] = std::minmax_element (bpms.begin(), bpms.end());
+
+    if (*highest - *lowest < steadyTolerance * globalBpm)
+        return steady (globalBpm);
+
+    // The first tempo holds from the start of the track
+    TempoMap map;
+    map.points.push_back ({ 0.0, bpms.front() });
+
+    for (size_t i = 1; i < bpms.size(); ++i)
+        map.points.push_back ({ estimates[i].time, bpms[i] });
+
+    // Points a straight line between their neighbours already predicts add nothing
+    constexpr double thinningTolerance = 0.02;
+
+    for (size_t i = 1; i + 1 < map.points.size();)
+    {
+        const auto& before = map.points[i - 1];
+        const auto& after = map.points[i + 1];
+        const auto predicted = before.bpm + (after.bpm - before.bpm) * (map.points[i].time - before.time) / (after.time - before.time);
+
+        if (std::abs (predicted - map.points[i].bpm) < thinningTolerance)
+            map.points.erase (map.points.begin() + (std::ptrdiff_t) i);
+        else
+            ++i;
+    }
+
+    return map;
+}
+
+//==============================================================================
+juce::String TempoMap::toString() const
+{
+    juce::StringArray pairs;
+
+    for (auto& p : points)
+        pairs.add (juce::String (p.time, 3) + ":" + juce::String (p.bpm, 3));
+
+    return pairs.joinIntoString (" ");
+}
+
+TempoMap TempoMap::fromString (const juce::String& text)
+{
+    TempoMap map;
+
+    for (auto& pair : juce::StringArray::fromTokens (text, " ", {}))
+    {
+        if (! pair.containsChar (':'))
+            continue;
+
+        const auto bpm = pair.fromFirstOccurrenceOf (":", false, false).getDoubleValue();
+
+        if (bpm > 0.0)
+            map.points.push_back ({ pair.upToFirstOccurrenceOf (":", false, false).getDoubleValue(), bpm });
+    }
+
+    return map;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+//==============================================================================
+/**
+    How a track's tempo changes over time, for live recordings and vinyl rips
+    that drift.
+
+    Estimated from the onset envelope the import analysis already computes
+    (see OnsetEnvelopeAnalyzer): the envelope is cut into overlapping windows,
+    each window's tempo is found from its autocorrelation near the track's
+    overall tempo, and the per-window tempos are smoothed into a curve. The
+    tempo ramps linearly from one point to the next.
+
+    A steady track has a single point.
+*/
+struct TempoMap
+{
+    struct Point
+    {
+        double time = 0.0;      // seconds into the track
+        double bpm = 120.0;
+
+        bool operator== (const Point&) const = default;
+    };
+
+    std::vector<Point> points;
+
+    bool isSteady() const noexcept                      { return points.size() <= 1; }
+
+    /** The tempo at a time in the track. */
+    double getBpmAt (double time) const;
+
+    /** The number of beats played from the start of the track to a time. */
+    double getBeatAt (double time) const;
+
+    /** Estimates the map from an onset envelope. globalBpm is the overall tempo
+        (e.g. from TempoAnalyzer); the windowed estimates are kept within a few
+        percent of it, which rules out half- and double-tempo errors. Returns a
+        single point at globalBpm if the track doesn't drift measurably.
+    */
+    static TempoMap estimate (const std::vector<float>& onsetEnvelope, double frameRate, double globalBpm);
+
+    /** The map from a time in the track on, with that time as the new zero. */
+    TempoMap startingAt (double time) const;
+
+    /** A steady map at one tempo. */
+    static TempoMap steady (double bpm)                 { return { { Point { 0.0, bpm } } }; }
+
+    /** "time:bpm" pairs separated by spaces, for storing in an Edit's state. */
+    juce::String toString() const;
+    static TempoMap fromString (const juce::String&);
+
+    static constexpr double windowSeconds = 8.0;
+    static constexpr double hopSeconds = 2.0;
+    static constexpr double maxDeviation = 0.08;        // from globalBpm, as a fraction
+    static constexpr double steadyTolerance = 0.003;    // a map varying less than this is steady
+
+    bool operator== (const TempoMap&) const = default;
+};
@@ -0,0 +1,59 @@
+#include "TrackAnalysis.h"
+#include "AnalysisPipeline.h"
+#include "DownbeatFinder.h"
+#include "KeyAnalyzer.h"
+#include "LoudnessAnalyzer.h"
+#include "OnsetEnvelopeAnalyzer.h"
+#include "SilenceAnalyzer.h"
+#include "TempoAnalyzer.h"
+
+TrackAnalysis TrackAnalysis::analyse (juce::AudioFormatReader& reader, std::function<bool()> shouldCancel)
+{
+    TrackAnalysis result;
+
+    if (reader.sampleRate <= 0.0)
+        return result;
+
+    TempoAnalyzer tempo;
+    SilenceAnalyzer silence;
+    OnsetEnvelopeAnalyzer onsets;
+    LoudnessAnalyzer loudness;
+    KeyAnalyzer keyAnalyzer;
+
+    AnalysisPipeline pipeline;
+    pipeline.addAnalyzer (tempo);
+    pipeline.addAnalyzer (silence);
+    pipeline.addAnalyzer (onsets);
+    pipeline.addAnalyzer (loudness);
+    pipeline.addAnalyzer (keyAnalyzer);
+
+    if (! pipeline.run (reader, std::move (shouldCancel)))
+        return result;
+
+    result.sampleRate = reader.sampleRate;
+    result.duration = (double) reader.lengthInSamples / reader.sampleRate;
+    result.bpm = tempo.getBpm();
+    result.key = keyAnalyzer.getKey();
+    result.leadingSilence = silence.getLeadingSilence();
+    result.trailingSilence = silence.getTrailingSilence();
+    result.onsetEnvelope = onsets.getEnvelope();
+    result.onsetFrameRate = onsets.getFrameRate();
+    result.tempoMap = result.bpm > 0.0f ? TempoMap::estimate (result.onsetEnvelope, result.onsetFrameRate, result.bpm)
+                                        : TempoMap();
+    result.firstDownbeat = result.bpm > 0.0f ? DownbeatFinder::findFirstDownbeat (result.onsetEnvelope, result.onsetFrameRate, result.tempoMap,
+                                                                                  result.leadingSilence, result.duration - result.trailingSilence)
+                                             : result.leadingSilence;
+    result.loudness = loudness.getIntegratedLoudness();
+    result.truePeak = loudness.getTruePeak();
+
+    return result;
+}
+
+float TrackAnalysis::getNormalisationGain() const
+{
+    if (! std::isfinite (loudness))
+        return 0.0f;
+
+    const auto gain = juce::jmin (targetLoudness - loudness, truePeakCeiling - truePeak);
+    return (float) juce::jlimit (-(double) maxNormalisationGain, (double) maxNormalisationGain, gain);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "MusicalKey.h"
+#include "TempoMap.h"
+#include <functional>
+#include <limits>
+#include <vector>
+
+//==============================================================================
+/**
+    Everything the library learns about a track when it's imported, from a
+    single decode of the file (see AnalysisPipeline).
+*/
+struct TrackAnalysis
+{
+    double sampleRate = 0.0;
+    double duration = 0.0;              // seconds
+
+    float bpm = 0.0f;                   // 0 if no tempo was found
+    MusicalKey key;                     // not valid if no key was found
+    TempoMap tempoMap;                  // steady at bpm unless the track drifts
+
+    double leadingSilence = 0.0;        // seconds before the first audible sample
+    double trailingSilence = 0.0;       // seconds after the last one
+    double firstDownbeat = 0.0;         // seconds; where the first full bar starts (see DownbeatFinder)
+
+    std::vector<float> onsetEnvelope;   // see OnsetEnvelopeAnalyzer
+    double onsetFrameRate = 0.0;
+
+    double loudness = -std::numeric_limits<double>::infinity();  // integrated, in LUFS
+    double truePeak = -200.0;           // dBTP
+
+    /** Tracks are brought to this loudness when they're imported... */
+    static constexpr double targetLoudness = -14.0;
+    /** ...unless that would push the true peak over this. */
+    static constexpr double truePeakCeiling = -1.0;
+
+    /** The clip gain, in dB, that levels this track with the rest of the library.
+        0 for silent tracks, and never more than maxNormalisationGain.
+    */
+    float getNormalisationGain() const;
+
+    static constexpr float maxNormalisationGain = 12.0f;
+
+    /** Analyses a whole file. Returns nothing useful if shouldCancel returns true part-way. */
+    static TrackAnalysis analyse (juce::AudioFormatReader&, std::function<bool()> shouldCancel = {});
+};
@@ -0,0 +1,305 @@
+#include "AudioCallbackMonitor.h"
+#include "UIProfiler.h"
+
+//==============================================================================
+class AudioCallbackMonitor::DeviceCallback : public juce::AudioIODeviceCallback
+{
+public:
+    DeviceCallback (AudioCallbackMonitor& m, juce::AudioDeviceManager& dm)
+        : monitor (m), manager (dm)
+    {
+    }
+
+    void audioDeviceIOCallbackWithContext (const float* const* /*inputChannelData*/,
+                                           int /*numInputChannels*/,
+                                           float* const* outputChannelData,
+                                           int numOutputChannels,
+                                           int numSamples,
+                                           const juce::AudioIODeviceCallbackContext& /*context*/) override
+    {
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        // Secondary callbacks are mixed into the output, so ours must stay silent
+        for (int i = 0; i < numOutputChannels; ++i)
+            if (auto* channel = outputChannelData[i])
+                juce::FloatVectorOperations::clear (channel, numSamples);
+
+        const auto xruns = device.load() != nullptr ? device.load()->getXRunCount() : -1;
+        monitor.pushCallback (Source::engineDevice, startMs, juce::Time::getMillisecondCounterHiRes(),
+                              numSamples, (float) manager.getCpuUsage(), xruns);
+    }
+
+    void audioDeviceAboutToStart (juce::AudioIODevice* newDevice) override
+    {
+        device = newDevice;
+
+        if (newDevice != nullptr)
+            monitor.prepare (Source::engineDevice, newDevice->getCurrentSampleRate());
+    }
+
+    void audioDeviceStopped() override
+    {
+        device = nullptr;
+    }
+
+private:
+    AudioCallbackMonitor& monitor;
+    juce::AudioDeviceManager& manager;
+    std::atomic<juce::AudioIODevice*> device { nullptr };
+};
+
+//==============================================================================
+AudioCallbackMonitor::AudioCallbackMonitor()
+{
+    startTimerHz (15);
+}
+
+AudioCallbackMonitor::~AudioCallbackMonitor()
+{
+    stopTimer();
+    detach();
+}
+
+juce::String AudioCallbackMonitor::getSourceName (Source source)
+{
+    switch (source)
+    {
+        case Source::mainComponent: return "App";
+        case Source::engineDevice:  return "Engine";
+        case Source::numSources:    break;
+    }
+
+    return {};
+}
+
+void AudioCallbackMonitor::prepare (Source source, double sampleRate)
+{
+    auto& state = sourceStates[(size_t) source];
+
+    if (sampleRate > 0.0)
+        state.sampleRate = sampleRate;
+
+    // Don't report the gap across a device restart as an xrun
+    state.lastStartMs = 0.0;
+    state.lastDeviceXruns = -1;
+}
+
+void AudioCallbackMonitor::attachTo (juce::AudioDeviceManager& manager)
+{
+    detach();
+
+    deviceCallback = std::make_unique<DeviceCallback> (*this, manager);
+    attachedManager = &manager;
+    attachedManager->addAudioCallback (deviceCallback.get());
+}
+
+void AudioCallbackMonitor::detach()
+{
+    if (attachedManager != nullptr && deviceCallback != nullptr)
+        attachedManager->removeAudioCallback (deviceCallback.get());
+
+    attachedManager = nullptr;
+    deviceCallback = nullptr;
+}
+
+void AudioCallbackMonitor::pushCallback (Source source, double startMs, double endMs, int numSamples,
+                                         float measuredLoad, int deviceXruns) noexcept
+{
+    auto& state = sourceStates[(size_t) source];
+
+    CallbackRecord record;
+    record.source = source;
+    record.startMs = startMs;
+    record.numSamples = numSamples;
+    record.expectedMs = 1000.0 * numSamples / state.sampleRate.load();
+
+    if (measuredLoad >= 0.0f)
+    {
+        // The engine's load covers its own callback, which ran before ours
+        record.load = measuredLoad;
+        record.endMs = startMs + measuredLoad * record.expectedMs;
+    }
+    else
+    {
+        record.endMs = endMs;
+        record.load = record.expectedMs > 0.0 ? (float) ((endMs - startMs) / record.expectedMs) : 0.0f;
+    }
+
+    if (state.lastStartMs > 0.0)
+    {
+        record.gapMs = startMs - state.lastStartMs;
+        record.xrun = record.gapMs > record.expectedMs * (1.0 + xrunTolerance.load());
+    }
+
+    record.xrun = record.xrun || record.load > 1.0f;
+
+    if (deviceXruns >= 0)
+    {
+        if (state.lastDeviceXruns >= 0 && deviceXruns > state.lastDeviceXruns)
+            record.xrun = true;
+
+        state.lastDeviceXruns = deviceXruns;
+    }
+
+    state.lastStartMs = startMs;
+
+    const auto scope = state.fifo.write (1);
+
+    if (scope.blockSize1 > 0)
+        state.records[(size_t) scope.startIndex1] = record;
+    else
+        state.dropped.fetch_add (1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void AudioCallbackMonitor::timerCallback()
+{
+    const UIProfiler::ScopedTimer profile ("AudioCallbackMonitor::timerCallback");
+
+    bool changed = false;
+    bool sawNewXrun = false;
+
+    for (int i = 0; i < numSources; ++i)
+    {
+        auto& state = sourceStates[(size_t) i];
+        auto& sourceStats = stats[(size_t) i];
+
+        const auto numReady = state.fifo.getNumReady();
+
+        if (numReady == 0)
+        {
+            // Let the meters fall back when a device goes quiet
+            sourceStats.currentLoad *= 0.5f;
+            sourceStats.peakLoad *= 0.9f;
+            continue;
+        }
+
+        const auto scope = state.fifo.read (numReady);
+        float maxLoad = 0.0f;
+
+        scope.forEach ([&] (int index)
+        {
+            const auto& record = state.records[(size_t) index];
+            history.push_back (record);
+
+            const auto bin = juce::jlimit (0, numHistogramBins - 1, (int) (record.load * 10.0f));
+            ++sourceStats.histogram[(size_t) bin];
+            maxLoad = juce::jmax (maxLoad, record.load);
+
+            if (record.xrun)
+            {
+                XrunEvent event;
+                event.wallClock = juce::Time::getCurrentTime();
+                event.timeMs = record.startMs;
+                event.source = record.source;
+                event.gapMs = record.gapMs;
+                event.expectedMs = record.expectedMs;
+                event.load = record.load;
+
+                xrunLog.push_back (event);
+                ++sourceStats.xrunCount;
+                sawNewXrun = true;
+            }
+        });
+
+        sourceStats.currentLoad = maxLoad;
+        sourceStats.peakLoad = juce::jmax (maxLoad, sourceStats.peakLoad * 0.95f);
+        sourceStats.droppedRecords = state.dropped.load (std::memory_order_relaxed);
+        changed = true;
+    }
+
+    while (xrunLog.size() > maxXrunLogSize)
+        xrunLog.pop_front();
+
+    const auto nowMs = juce::Time::getMillisecondCounterHiRes();
+    trimHistory (nowMs);
+
+    if (sawNewXrun && dumpOnXrun && nowMs - lastDumpMs > minDumpIntervalMs)
+    {
+        lastDumpMs = nowMs;
+        auto file = dumpHistory ("xrun");
+
+        if (file != juce::File())
+            DBG ("Audio timing dumped to " + file.getFullPathName());
+    }
+
+    if (changed)
+        sendChangeMessage();
+}
+
+void AudioCallbackMonitor::trimHistory (double nowMs)
+{
+    const auto cutoffMs = nowMs - historySeconds * 1000.0;
+
+    while (! history.empty() && history.front().startMs < cutoffMs)
+        history.pop_front();
+
+    while (! events.empty() && events.front().first < cutoffMs)
+        events.pop_front();
+}
+
+void AudioCallbackMonitor::resetStats()
+{
+    for (auto& s : stats)
+        s = {};
+
+    for (auto& state : sourceStates)
+        state.dropped = 0;
+
+    xrunLog.clear();
+    sendChangeMessage();
+}
+
+void AudioCallbackMonitor::markEvent (const juce::String& description)
+{
+    events.emplace_back (juce::Time::getMillisecondCounterHiRes(), description);
+}
+
+juce::File AudioCallbackMonitor::getDiagnosticsDirectory()
+{
+    return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+        .getChildFile ("ChopShop")
+        .getChildFile ("Diagnostics");
+}
+
+juce::File AudioCallbackMonitor::dumpHistory (const juce::String& reason) const
+{
+    auto dir = getDiagnosticsDirectory();
+
+    if (! dir.createDirectory())
+        return {};
+
+    auto file = dir.getChildFile ("audio-timing-" + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S") + ".csv")
+                   .getNonexistentSibling();
+
+    juce::FileOutputStream out (file);
+
+    if (! out.openedOk())
+        return {};
+
+    // Times are Time::getMillisecondCounterHiRes() values, so callbacks and
+    // UI events share the same clock
+    out << "# ChopShop audio timing dump (" << reason << ") "
+        << juce::Time::getCurrentTime().toString (true, true, true, true) << "\n";
+    out << "# now_ms," << juce::String (juce::Time::getMillisecondCounterHiRes(), 3) << "\n";
+    out << "kind,source,start_ms,end_ms,gap_ms,expected_ms,samples,load,xrun,description\n";
+
+    for (const auto& record : history)
+    {
+        out << "callback," << getSourceName (record.source)
+            << "," << juce::String (record.startMs, 3)
+            << "," << juce::String (record.endMs, 3)
+            << "," << juce::String (record.gapMs, 3)
+            << "," << juce::String (record.expectedMs, 3)
+            << "," << record.numSamples
+            << "," << juce::String (record.load, 4)
+            << "," << (record.xrun ? 1 : 0)
+            << ",\n";
+    }
+
+    for (const auto& [timeMs, description] : events)
+        out << "event,," << juce::String (timeMs, 3) << ",,,,,,," << description.quoted() << "\n";
+
+    out.flush();
+    return file;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <array>
+#include <atomic>
+#include <deque>
+
+//==============================================================================
+/**
+    Records the timing of every audio callback we own so that missed deadlines
+    become visible.
+
+    The audio threads push one CallbackRecord per block into a lock-free FIFO
+    (one single-producer FIFO per source, so the two devices never contend).
+    A message-thread timer drains the FIFOs into a rolling history, updates the
+    load histogram and xrun log and broadcasts a change so overlays can repaint.
+
+    An xrun is flagged when the gap between two consecutive callbacks exceeds
+    the block duration by more than the tolerance, when the callback overran
+    its own budget, or when the device reports a new xrun itself.
+*/
+class AudioCallbackMonitor : public juce::ChangeBroadcaster,
+                             private juce::Timer
+{
+public:
+    enum class Source
+    {
+        mainComponent = 0, // AudioAppComponent::getNextAudioBlock
+        engineDevice,      // tracktion engine's AudioDeviceManager
+        numSources
+    };
+
+    static constexpr int numSources = (int) Source::numSources;
+    static constexpr int numHistogramBins = 12; // 10% wide, last bin is >= 110%
+
+    struct CallbackRecord
+    {
+        double startMs = 0.0;
+        double endMs = 0.0;
+        double gapMs = 0.0;      // since the previous callback from the same source
+        double expectedMs = 0.0;
+        int numSamples = 0;
+        float load = 0.0f;       // proportion of the block duration spent in the callback
+        bool xrun = false;
+        Source source = Source::mainComponent;
+    };
+
+    struct XrunEvent
+    {
+        juce::Time wallClock;
+        double timeMs = 0.0;
+        Source source = Source::mainComponent;
+        double gapMs = 0.0;
+        double expectedMs = 0.0;
+        float load = 0.0f;
+    };
+
+    struct SourceStats
+    {
+        float currentLoad = 0.0f;
+        float peakLoad = 0.0f;
+        int xrunCount = 0;
+        int droppedRecords = 0;
+        std::array<juce::uint32, numHistogramBins> histogram{};
+    };
+
+    AudioCallbackMonitor();
+    ~AudioCallbackMonitor() override;
+
+    static juce::String getSourceName (Source source);
+
+    //==============================================================================
+    // Audio thread
+
+    /** Must be called before callbacks for a source arrive (e.g. from prepareToPlay). */
+    void prepare (Source source, double sampleRate);
+
+    /** Brackets a callback we control directly. */
+    class ScopedCallback
+    {
+    public:
+        ScopedCallback (AudioCallbackMonitor& m, Source s, int numSamples) noexcept
+            : monitor (m), source (s), samples (numSamples),
+              startMs (juce::Time::getMillisecondCounterHiRes())
+        {
+        }
+
+        ~ScopedCallback() noexcept
+        {
+            monitor.pushCallback (source, startMs, juce::Time::getMillisecondCounterHiRes(), samples, -1.0f, -1);
+        }
+
+    private:
+        AudioCallbackMonitor& monitor;
+        const Source source;
+        const int samples;
+        const double startMs;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCallback)
+    };
+
+    /** Adds a passive callback to the given device manager (the engine's) that
+        timestamps each of its blocks. That manager doesn't let us wrap its primary
+        callback, so the block duration is taken from its own CPU load measurement.
+    */
+    void attachTo (juce::AudioDeviceManager& manager);
+    void detach();
+
+    //==============================================================================
+    // Message thread
+
+    SourceStats getStats (Source source) const { return stats[(size_t) source]; }
+    const std::deque<XrunEvent>& getXrunLog() const { return xrunLog; }
+    void resetStats();
+
+    /** Records a UI action so it appears next to the timing data in dumps. */
+    void markEvent (const juce::String& description);
+
+    /** When enabled, the last historySeconds of timing are written to the
+        diagnostics folder each time an xrun is drained.
+    */
+    void setDumpOnXrun (bool shouldDump) { dumpOnXrun = shouldDump; }
+    bool isDumpOnXrunEnabled() const { return dumpOnXrun; }
+
+    void setHistoryLength (double seconds) { historySeconds = juce::jmax (1.0, seconds); }
+    double getHistoryLength() const { return historySeconds; }
+
+    /** Writes the current history as CSV; returns the file or an empty File on failure. */
+    juce::File dumpHistory (const juce::String& reason) const;
+
+    static juce::File getDiagnosticsDirectory();
+
+    void setXrunTolerance (double proportionOfBlock) { xrunTolerance = proportionOfBlock; }
+
+private:
+    static constexpr int fifoSize = 4096;
+
+    struct SourceState
+    {
+        juce::AbstractFifo fifo { fifoSize };
+        std::array<CallbackRecord, fifoSize> records;
+        std::atomic<double> sampleRate { 44100.0 };
+        std::atomic<int> dropped { 0 };
+        double lastStartMs = 0.0;      // audio thread only
+        int lastDeviceXruns = -1;      // audio thread only
+    };
+
+    class DeviceCallback;
+
+    void pushCallback (Source source, double startMs, double endMs, int numSamples,
+                       float measuredLoad, int deviceXruns) noexcept;
+
+    void timerCallback() override;
+    void trimHistory (double nowMs);
+
+    std::array<SourceState, numSources> sourceStates;
+    std::array<SourceStats, numSources> stats;
+
+    std::deque<CallbackRecord> history;
+    std::deque<std::pair<double, juce::String>> events;
+    std::deque<XrunEvent> xrunLog;
+
+    std::unique_ptr<DeviceCallback> deviceCallback;
+    juce::AudioDeviceManager* attachedManager = nullptr;
+
+    std::atomic<double> xrunTolerance { 1.5 };
+    double historySeconds = 10.0;
+    bool dumpOnXrun = false;
+    double lastDumpMs = 0.0;
+
+    static constexpr size_t maxXrunLogSize = 100;
+    static constexpr double minDumpIntervalMs = 5000.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioCallbackMonitor)
+};
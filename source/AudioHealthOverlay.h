@@ -0,0 +1,179 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "AudioCallbackMonitor.h"
+#include "CustomLookAndFeel.h"
+
+// Floating panel showing live callback load, the load histogram and the most
+// recent xruns reported by the AudioCallbackMonitor
+class AudioHealthOverlay : public juce::Component,
+                           private juce::ChangeListener
+{
+public:
+    AudioHealthOverlay (AudioCallbackMonitor& m) : monitor (m)
+    {
+        setInterceptsMouseClicks (true, true);
+
+        dumpOnXrunButton.setButtonText ("Dump on xrun");
+        dumpOnXrunButton.setToggleState (monitor.isDumpOnXrunEnabled(), juce::dontSendNotification);
+        dumpOnXrunButton.onClick = [this] { monitor.setDumpOnXrun (dumpOnXrunButton.getToggleState()); };
+        addAndMakeVisible (dumpOnXrunButton);
+
+        dumpNowButton.setButtonText ("Dump");
+        dumpNowButton.onClick = [this]
+        {
+            auto file = monitor.dumpHistory ("manual");
+
+            if (file != juce::File())
+                file.revealToUser();
+        };
+        addAndMakeVisible (dumpNowButton);
+
+        resetButton.setButtonText ("Reset");
+        resetButton.onClick = [this] { monitor.resetStats(); };
+        addAndMakeVisible (resetButton);
+
+        monitor.addChangeListener (this);
+    }
+
+    ~AudioHealthOverlay() override
+    {
+        monitor.removeChangeListener (this);
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        g.setColour (juce::Colour (0xE0121212));
+        g.fillRoundedRectangle (bounds, 6.0f);
+        g.setColour (juce::Colour (0xFF2A2A2A));
+        g.drawRoundedRectangle (bounds.reduced (0.5f), 6.0f, 1.0f);
+
+        auto area = getLocalBounds().reduced (8);
+        area.removeFromBottom (buttonRowHeight);
+
+        g.setFont (CustomLookAndFeel::getMonospaceFont().withHeight (12.0f));
+
+        for (int i = 0; i < AudioCallbackMonitor::numSources; ++i)
+        {
+            const auto source = (AudioCallbackMonitor::Source) i;
+            const auto stats = monitor.getStats (source);
+            auto row = area.removeFromTop (rowHeight);
+
+            g.setColour (juce::Colours::white);
+            g.drawText (AudioCallbackMonitor::getSourceName (source), row.removeFromLeft (52),
+                        juce::Justification::centredLeft);
+
+            auto text = juce::String (juce::roundToInt (stats.currentLoad * 100.0f)) + "% "
+                        + juce::String (stats.xrunCount) + " xr";
+            g.drawText (text, row.removeFromRight (80), juce::Justification::centredRight);
+
+            drawLoadBar (g, row.reduced (4, 5).toFloat(), stats.currentLoad, stats.peakLoad);
+        }
+
+        area.removeFromTop (4);
+        drawHistogram (g, area.removeFromTop (histogramHeight).toFloat());
+        area.removeFromTop (4);
+
+        const auto& log = monitor.getXrunLog();
+        g.setColour (log.empty() ? juce::Colours::white.withAlpha (0.5f) : juce::Colour (0xFFFF6E6E));
+
+        if (log.empty())
+        {
+            g.drawText ("No xruns", area.removeFromTop (lineHeight), juce::Justification::centredLeft);
+            return;
+        }
+
+        for (auto it = log.rbegin(); it != log.rend() && area.getHeight() >= lineHeight; ++it)
+        {
+            auto line = it->wallClock.formatted ("%H:%M:%S") + " "
+                        + AudioCallbackMonitor::getSourceName (it->source).paddedRight (' ', 7)
+                        + "gap " + juce::String (it->gapMs, 1) + "/" + juce::String (it->expectedMs, 1) + "ms"
+                        + " load " + juce::String (juce::roundToInt (it->load * 100.0f)) + "%";
+
+            g.drawText (line, area.removeFromTop (lineHeight), juce::Justification::centredLeft);
+        }
+    }
+
+    void resized() override
+    {
+        auto row = getLocalBounds().reduced (8).removeFromBottom (buttonRowHeight);
+        dumpOnXrunButton.setBounds (row.removeFromLeft (120));
+        resetButton.setBounds (row.removeFromRight (60));
+        row.removeFromRight (6);
+        dumpNowButton.setBounds (row.removeFromRight (60));
+    }
+
+private:
+    AudioCallbackMonitor& monitor;
+
+    juce::ToggleButton dumpOnXrunButton;
+    juce::TextButton dumpNowButton;
+    juce::TextButton resetButton;
+
+    static constexpr int rowHeight = 20;
+    static constexpr int lineHeight = 15;
+    static constexpr int histogramHeight = 40;
+    static constexpr int buttonRowHeight = 24;
+
+    void changeListenerCallback (juce::ChangeBroadcaster*) override
+    {
+        if (isShowing())
+            repaint();
+    }
+
+    static juce::Colour getLoadColour (float load)
+    {
+        if (load >= 0.9f) return juce::Colour (0xFFFF4545);
+        if (load >= 0.7f) return juce::Colour (0xFFFFB445);
+        return juce::Colour (0xFF00FF41);
+    }
+
+    void drawLoadBar (juce::Graphics& g, juce::Rectangle<float> bar, float load, float peak) const
+    {
+        g.setColour (juce::Colour (0xFF2A2A2A));
+        g.fillRect (bar);
+
+        g.setColour (getLoadColour (load));
+        g.fillRect (bar.withWidth (bar.getWidth() * juce::jlimit (0.0f, 1.0f, load)));
+
+        g.setColour (juce::Colours::white);
+        const auto peakX = bar.getX() + bar.getWidth() * juce::jlimit (0.0f, 1.0f, peak);
+        g.drawVerticalLine (juce::roundToInt (peakX), bar.getY(), bar.getBottom());
+    }
+
+    void drawHistogram (juce::Graphics& g, juce::Rectangle<float> area) const
+    {
+        // Both sources share the bins; the tallest bin sets the scale (log, so the tail stays visible)
+        std::array<juce::uint64, AudioCallbackMonitor::numHistogramBins> bins{};
+
+        for (int i = 0; i < AudioCallbackMonitor::numSources; ++i)
+        {
+            const auto stats = monitor.getStats ((AudioCallbackMonitor::Source) i);
+
+            for (size_t b = 0; b < bins.size(); ++b)
+                bins[b] += stats.histogram[b];
+        }
+
+        const auto maxCount = *std::max_element (bins.begin(), bins.end());
+        const auto binWidth = area.getWidth() / (float) bins.size();
+
+        g.setColour (juce::Colour (0xFF1E1E1E));
+        g.fillRect (area);
+
+        if (maxCount == 0)
+            return;
+
+        const auto scale = std::log1p ((double) maxCount);
+
+        for (size_t b = 0; b < bins.size(); ++b)
+        {
+            const auto h = (float) (std::log1p ((double) bins[b]) / scale) * area.getHeight();
+            g.setColour (getLoadColour ((float) b / 10.0f).withAlpha (0.8f));
+            g.fillRect (area.getX() + b * binWidth + 1.0f, area.getBottom() - h, binWidth - 2.0f, h);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioHealthOverlay)
+};
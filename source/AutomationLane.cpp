@@ -1,4 +1,6 @@
 #include "AutomationLane.h"
+#include "UIProfiler.h"
+#include <algorithm>
 
 AutomationLane::AutomationLane(tracktion::engine::Edit& e, ZoomState& zs)
     : edit(e)
@@ -13,11 +15,13 @@ AutomationLane::~AutomationLane()
 {
     if (parameter != nullptr)
         parameter->removeListener(this);
+    curveState.removeListener(this);
     zoomState.removeListener(this);
 }
 
 void AutomationLane::paint(juce::Graphics& g)
 {
+    const UIProfiler::ScopedTimer profile ("AutomationLane::paint");
     auto bounds = getLocalBounds().toFloat();
     
     // Draw background
@@ -48,47 +52,117 @@ void AutomationLane::paint(juce::Graphics& g)
         }
         else
         {
-            // Draw horizontal line from start to first point
-            auto firstPoint = timeToXY(automationPoints[0].first, automationPoints[0].second);
-            g.drawLine(bounds.getX(), firstPoint.y, firstPoint.x, firstPoint.y, 2.0f);
+            updateCurvePath(bounds, getVisibleTimeRange());
+            g.fillPath(curvePath);
 
-            // If there's only one point, draw a horizontal line to the end
-            if (automationPoints.size() == 1)
+            // Make points more visible
+            if (showPoints)
+                g.fillPath(pointsPath);
+
+            // Highlight dragged point
+            if (draggedPointIndex >= 0 && draggedPointIndex < static_cast<int>(automationPoints.size()))
             {
-                g.drawLine(firstPoint.x, firstPoint.y, bounds.getRight(), firstPoint.y, 2.0f);
+                auto point = timeToXY(automationPoints[(size_t) draggedPointIndex].first, automationPoints[(size_t) draggedPointIndex].second);
+                g.setColour(juce::Colours::yellow);
+                g.drawEllipse(point.x - pointSize/2 - 2, point.y - pointSize/2 - 2,
+                            pointSize + 4, pointSize + 4, 2.0f);
             }
-            
-            for (size_t i = 0; i < automationPoints.size(); ++i)
+        }
+    }
+}
+
+std::pair<size_t, size_t> AutomationLane::getPointsInRange(juce::Range<double> timeRange) const
+{
+    auto byTime = [] (const auto& point, double time) { return point.first < time; };
+    auto first = std::lower_bound(automationPoints.begin(), automationPoints.end(), timeRange.getStart(), byTime);
+    auto last = std::lower_bound(first, automationPoints.end(), timeRange.getEnd(), byTime);
+
+    // Take in the neighbours either side, which the lines in range lead to
+    if (first != automationPoints.begin())
+        --first;
+
+    if (last != automationPoints.end())
+        ++last;
+
+    return { (size_t) std::distance(automationPoints.begin(), first),
+             (size_t) std::distance(automationPoints.begin(), last) };
+}
+
+void AutomationLane::updateCurvePath(juce::Rectangle<float> bounds, juce::Range<double> view)
+{
+    const CurveCacheKey key { curveRevision, view, bounds };
+
+    if (curveCacheKey == key)
+        return;
+
+    curveCacheKey = key;
+    curvePath.clear();
+    pointsPath.clear();
+    showPoints = false;
+
+    if (automationPoints.empty() || view.isEmpty() || bounds.isEmpty())
+        return;
+
+    // The same mapping as timeToXY, worked out once for the whole curve
+    const auto pixelsPerSecond = bounds.getWidth() / view.getLength();
+    const auto valueRange = parameter != nullptr ? parameter->getValueRange() : juce::Range<float>(0.0f, 1.0f);
+    const auto valueScale = valueRange.getLength() > 0.0f ? bounds.getHeight() / valueRange.getLength() : 0.0f;
+
+    auto toX = [&] (size_t i) { return bounds.getX() + (float) ((automationPoints[i].first - view.getStart()) * pixelsPerSecond); };
+    auto toY = [&] (size_t i) { return bounds.getBottom() - ((float) automationPoints[i].second - valueRange.getStart()) * valueScale; };
+
+    const auto [first, last] = getPointsInRange(view);
+    juce::Path line;
+
+    // Flat from the start to the first point, and from the last point to the end
+    if (first == 0)
+        line.startNewSubPath(bounds.getX(), toY(0));
+    else
+        line.startNewSubPath(toX(first), toY(first));
+
+    if (last - first <= (size_t) bounds.getWidth())
+    {
+        for (auto i = first; i < last; ++i)
+            line.lineTo(toX(i), toY(i));
+
+        showPoints = (float) (last - first) * pointSize <= bounds.getWidth();
+
+        for (auto i = first; showPoints && i < last; ++i)
+            pointsPath.addEllipse(toX(i) - pointSize/2, toY(i) - pointSize/2, pointSize, pointSize);
+    }
+    else
+    {
+        // More points than pixels: each column goes from the value it was entered
+        // at, through the lowest and highest values in it, to the value it's left at
+        for (auto i = first; i < last;)
+        {
+            const auto column = std::floor(toX(i));
+            const auto entryY = toY(i);
+            auto minY = entryY, maxY = entryY, exitY = entryY;
+
+            for (++i; i < last && std::floor(toX(i)) == column; ++i)
             {
-                auto point = timeToXY(automationPoints[i].first, automationPoints[i].second);
-                
-                // Make points more visible
-                const float pointSize = 8.0f;
-                g.fillEllipse(point.x - pointSize/2, point.y - pointSize/2, pointSize, pointSize);
-                
-                // Highlight dragged point
-                if (static_cast<int>(i) == draggedPointIndex)
-                {
-                    g.setColour(juce::Colours::yellow);
-                    g.drawEllipse(point.x - pointSize/2 - 2, point.y - pointSize/2 - 2, 
-                                pointSize + 4, pointSize + 4, 2.0f);
-                    g.setColour(juce::Colours::orange);
-                }
-                
-                // Draw line to next point
-                if (i < automationPoints.size() - 1)
-                {
-                    auto nextPoint = timeToXY(automationPoints[i + 1].first, automationPoints[i + 1].second);
-                    g.drawLine(point.x, point.y, nextPoint.x, nextPoint.y, 2.0f);
-                }
-                // Draw horizontal line from last point to end
-                else if (i == automationPoints.size() - 1)
-                {
-                    g.drawLine(point.x, point.y, bounds.getRight(), point.y, 2.0f);
-                }
+                exitY = toY(i);
+                minY = juce::jmin(minY, exitY);
+                maxY = juce::jmax(maxY, exitY);
             }
+
+            line.lineTo(column, entryY);
+
+            if (minY != maxY)
+            {
+                line.lineTo(column, minY);
+                line.lineTo(column, maxY);
+            }
+
+            line.lineTo(column, exitY);
         }
     }
+
+    if (last == automationPoints.size())
+        line.lineTo(bounds.getRight(), toY(last - 1));
+
+    juce::PathStrokeType(2.0f).createStrokedPath(curvePath, line);
 }
 
 void AutomationLane::resized()
@@ -102,14 +176,17 @@ int AutomationLane::findPointNear(float x, float y) const
 
     // Increase hit radius for easier selection
     const float hitRadius = 10.0f;
-    
-    for (size_t i = 0; i < automationPoints.size(); ++i)
+
+    // Only the points within the hit radius of x need checking
+    const auto view = getVisibleTimeRange();
+    const auto secondsPerPixel = view.getLength() / getLocalBounds().getWidth();
+    const auto [time, value] = XYToTime(x, y);
+    const auto [first, last] = getPointsInRange({ time - hitRadius * secondsPerPixel, time + hitRadius * secondsPerPixel });
+
+    for (auto i = first; i < last; ++i)
     {
         auto point = timeToXY(automationPoints[i].first, automationPoints[i].second);
         float distance = std::hypot(point.x - x, point.y - y);
-        
-        DBG("Point " << i << " at (" << point.x << "," << point.y << ") distance: " << distance 
-            << " from click (" << x << "," << y << ")");
             
         if (distance <= hitRadius)
             return static_cast<int>(i);
@@ -194,6 +271,7 @@ void AutomationLane::setParameter(tracktion::engine::AutomatableParameter* param
     if (parameter != nullptr)
         parameter->addListener(this);
         
+    attachToCurveState();
     onParameterChanged(param);
     updatePoints();
     repaint();
@@ -206,62 +284,123 @@ void AutomationLane::updatePoints()
     if (parameter != nullptr)
     {
         auto& curve = parameter->getCurve();
-        auto& tempoSequence = edit.tempoSequence;
+        automationPoints.reserve((size_t) curve.getNumPoints());
         
         // Get all automation points from the curve
         for (int i = 0; i < curve.getNumPoints(); ++i)
         {
             auto point = curve.getPoint(i);
-            // Store the time in seconds but convert through beats for proper tempo handling
-            auto beatPos = tempoSequence.toBeats(point.time);
-            auto timeInSeconds = tempoSequence.toTime(beatPos).inSeconds();
-            automationPoints.emplace_back(timeInSeconds, point.value);
+            automationPoints.emplace_back(point.time.inSeconds(), point.value);
         }
     }
     
+    ++curveRevision;
     repaint();
 }
 
-void AutomationLane::curveHasChanged(tracktion::engine::AutomatableParameter&)
+bool AutomationLane::attachToCurveState()
+{
+    auto state = parameter != nullptr ? parameter->getCurve().state : juce::ValueTree();
+
+    if (state == curveState)
+        return false;
+
+    curveState.removeListener(this);
+    curveState = state;
+    curveState.addListener(this);
+    return true;
+}
+
+void AutomationLane::repaintPoints(int first, int last)
+{
+    const auto bounds = getLocalBounds().toFloat();
+    const auto view = getVisibleTimeRange();
+    const auto pixelsPerSecond = bounds.getWidth() / view.getLength();
+    const auto numPoints = (int) automationPoints.size();
+
+    auto toX = [&] (int i) { return bounds.getX() + (float) ((automationPoints[(size_t) i].first - view.getStart()) * pixelsPerSecond); };
+
+    // The lines to the neighbours either side change too, and beyond the first
+    // and last points the flat lines that follow them
+    const auto start = first - 1 >= 0 && first - 1 < numPoints ? toX(first - 1) : bounds.getX();
+    const auto end = last + 1 >= 0 && last + 1 < numPoints ? toX(last + 1) : bounds.getRight();
+
+    const auto pad = pointSize + 4.0f;
+    repaint(juce::Rectangle<float>(start - pad, bounds.getY(), end - start + 2.0f * pad, bounds.getHeight())
+                .getSmallestIntegerContainer());
+}
+
+void AutomationLane::valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier&)
+{
+    if (parameter == nullptr || tree.getParent() != curveState)
+        return;
+
+    const auto index = curveState.indexOf(tree);
+
+    if (index < 0 || index >= (int) automationPoints.size())
+        return updatePoints();
+
+    // The strip the point leaves and the strip it moves into
+    repaintPoints(index, index);
+
+    const auto point = parameter->getCurve().getPoint(index);
+    automationPoints[(size_t) index] = { point.time.inSeconds(), point.value };
+    ++curveRevision;
+
+    repaintPoints(index, index);
+}
+
+void AutomationLane::valueTreeChildAdded(juce::ValueTree& parent, juce::ValueTree& child)
+{
+    if (parameter == nullptr || parent != curveState)
+        return;
+
+    const auto index = parent.indexOf(child);
+
+    if (index < 0 || index > (int) automationPoints.size())
+        return updatePoints();
+
+    const auto point = parameter->getCurve().getPoint(index);
+    automationPoints.insert(automationPoints.begin() + index, { point.time.inSeconds(), point.value });
+    ++curveRevision;
+
+    repaintPoints(index, index);
+}
+
+void AutomationLane::valueTreeChildRemoved(juce::ValueTree& parent, juce::ValueTree&, int index)
+{
+    if (parameter == nullptr || parent != curveState)
+        return;
+
+    if (index < 0 || index >= (int) automationPoints.size())
+        return updatePoints();
+
+    automationPoints.erase(automationPoints.begin() + index);
+    ++curveRevision;
+
+    // The line now runs straight from the point before to the point after
+    repaintPoints(index, index - 1);
+}
+
+void AutomationLane::valueTreeChildOrderChanged(juce::ValueTree& parent, int, int)
+{
+    if (parent == curveState)
+        updatePoints();
+}
+
+void AutomationLane::valueTreeRedirected(juce::ValueTree&)
 {
-    if (parameter != nullptr)
-    {
-        auto& curve = parameter->getCurve();
-        std::vector<std::pair<double, double>> newPoints;
-        
-        // Get current points
-        for (int i = 0; i < curve.getNumPoints(); ++i)
-        {
-            auto point = curve.getPoint(i);
-            newPoints.emplace_back(point.time.inSeconds(), point.value);
-        }
-        
-        // Compare with previous points to show changes
-        if (newPoints.size() > automationPoints.size())
-        {
-            DBG("Points added: Previous count=" << automationPoints.size() << ", New count=" << newPoints.size());
-        }
-        else if (newPoints.size() < automationPoints.size())
-        {
-            DBG("Points removed: Previous count=" << automationPoints.size() << ", New count=" << newPoints.size());
-        }
-        
-        // Check for value changes in existing points
-        size_t minSize = std::min(newPoints.size(), automationPoints.size());
-        for (size_t i = 0; i < minSize; ++i)
-        {
-            if (std::abs(newPoints[i].second - automationPoints[i].second) > 0.0001)
-            {
-                DBG("Point " << i << " value changed from " << automationPoints[i].second 
-                    << " to " << newPoints[i].second 
-                    << " at time " << newPoints[i].first << "s");
-            }
-        }
-    }
-    
     updatePoints();
 }
 
+void AutomationLane::curveHasChanged(tracktion::engine::AutomatableParameter&)
+{
+    // The points have already followed the ValueTree, unless the curve has a new
+    // one (e.g. it's only just been created for the first point)
+    if (attachToCurveState() || (parameter != nullptr && (int) automationPoints.size() != parameter->getCurve().getNumPoints()))
+        updatePoints();
+}
+
 void AutomationLane::currentValueChanged(tracktion::engine::AutomatableParameter&)
 {
     // No need to handle this as we're only interested in curve point changes
@@ -284,23 +423,20 @@ void AutomationLane::parameterChangeGestureEnd(tracktion::engine::AutomatablePar
     // We don't need to do anything here as we're only interested in curve point changes
 }
 
+juce::Range<double> AutomationLane::getVisibleTimeRange() const
+{
+    auto sourceLength = getSourceLength();
+    auto visibleTimeStart = sourceLength * zoomState.getScrollPosition();
+    return { visibleTimeStart, visibleTimeStart + (sourceLength / zoomState.getZoomLevel()) };
+}
+
 juce::Point<float> AutomationLane::timeToXY(double timeInSeconds, double value) const
 {
     auto bounds = getLocalBounds().toFloat();
-    auto& tempoSequence = edit.tempoSequence;
-    
-    // Convert time to beats using edit's tempo sequence
-    auto beatPosition = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(timeInSeconds));
     
-    // Calculate visible beat range
-    auto visibleTimeStart = getSourceLength() * zoomState.getScrollPosition();
-    auto visibleTimeStartBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(visibleTimeStart));
-    auto visibleTimeEnd = visibleTimeStart + (getSourceLength() / zoomState.getZoomLevel());
-    auto visibleTimeEndBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(visibleTimeEnd));
-    
-    // Normalize beat position to width using the visible beat range
-    float normalizedTime = (beatPosition.inBeats() - visibleTimeStartBeats.inBeats()) / 
-                          (visibleTimeEndBeats.inBeats() - visibleTimeStartBeats.inBeats());
+    // Time runs linearly across the visible range, as in the thumbnail and chop lane
+    auto visibleRange = getVisibleTimeRange();
+    float normalizedTime = static_cast<float>((timeInSeconds - visibleRange.getStart()) / visibleRange.getLength());
     float x = bounds.getX() + (normalizedTime * bounds.getWidth());
     
     // Normalize value to height
@@ -318,21 +454,11 @@ juce::Point<float> AutomationLane::timeToXY(double timeInSeconds, double value)
 std::pair<double, double> AutomationLane::XYToTime(float x, float y) const
 {
     auto bounds = getLocalBounds().toFloat();
-    auto& tempoSequence = edit.tempoSequence;
-    
-    // Calculate visible beat range
-    auto visibleTimeStart = getSourceLength() * zoomState.getScrollPosition();
-    auto visibleTimeStartBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(visibleTimeStart));
-    auto visibleTimeEnd = visibleTimeStart + (getSourceLength() / zoomState.getZoomLevel());
-    auto visibleTimeEndBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(visibleTimeEnd));
+    auto visibleRange = getVisibleTimeRange();
     
-    // Convert x to beats using the visible beat range
+    // Convert x to time across the visible range
     double normalizedX = (x - bounds.getX()) / bounds.getWidth();
-    double beatPosition = visibleTimeStartBeats.inBeats() + 
-                         (normalizedX * (visibleTimeEndBeats.inBeats() - visibleTimeStartBeats.inBeats()));
-    
-    // Convert beats back to seconds
-    double timeInSeconds = tempoSequence.toTime(tracktion::BeatPosition::fromBeats(beatPosition)).inSeconds();
+    double timeInSeconds = visibleRange.getStart() + normalizedX * visibleRange.getLength();
     
     // Convert y to parameter value
     float normalizedValue = 1.0f - ((y - bounds.getY()) / bounds.getHeight());
@@ -6,10 +6,12 @@
 #include <tracktion_engine/tracktion_engine.h>
 #include "ZoomState.h"
 #include "Utilities.h"
+#include <optional>
 
 class AutomationLane : public juce::Component,
                      public virtual ZoomStateListener,
-                     public tracktion::engine::AutomatableParameter::Listener
+                     public tracktion::engine::AutomatableParameter::Listener,
+                     private juce::ValueTree::Listener
 {
 public:
     AutomationLane(tracktion::engine::Edit&, ZoomState&);
@@ -29,6 +31,7 @@ public:
 
     virtual void setParameter(tracktion::engine::AutomatableParameter*);
     virtual void updatePoints();
+    int getNumPoints() const noexcept { return (int) automationPoints.size(); }
     
     double getSourceLength() const 
     { 
@@ -36,7 +39,6 @@ public:
         if (clip != nullptr)
             return clip->getPosition().getLength().inSeconds();
 
-        DBG("No clip found, returning default length");
         return 60.0; // Default length if no clip
     }
 
@@ -68,6 +70,44 @@ protected:
 
     juce::Point<float> timeToXY(double timeInSeconds, double value) const;
     std::pair<double, double> XYToTime(float x, float y) const;
+    juce::Range<double> getVisibleTimeRange() const;
+
+    // Recorded automation can run to 100k+ points, so painting only looks at the
+    // points in view (plus one either side), and where there are more points than
+    // pixels draws each pixel column as the span of values it covers. The stroked
+    // curve is kept until the points, the view or the size change.
+    struct CurveCacheKey
+    {
+        juce::uint32 revision = 0;
+        juce::Range<double> view;
+        juce::Rectangle<float> bounds;
+
+        bool operator== (const CurveCacheKey&) const = default;
+    };
+
+    juce::uint32 curveRevision = 0;
+    std::optional<CurveCacheKey> curveCacheKey;
+    juce::Path curvePath, pointsPath;
+    bool showPoints = false;    // only when they're far enough apart to tell apart
+
+    static constexpr float pointSize = 8.0f;
+
+    std::pair<size_t, size_t> getPointsInRange(juce::Range<double> timeRange) const;
+    void updateCurvePath(juce::Rectangle<float> bounds, juce::Range<double> view);
+
+    // automationPoints follows the curve's ValueTree a point at a time, so an
+    // edit doesn't re-read every point, and only the part of the lane the
+    // changed point covers is repainted
+    juce::ValueTree curveState;
+    bool attachToCurveState();
+    void repaintPoints(int first, int last);
+
+    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded(juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved(juce::ValueTree&, juce::ValueTree&, int) override;
+    void valueTreeChildOrderChanged(juce::ValueTree&, int, int) override;
+    void valueTreeRedirected(juce::ValueTree&) override;
+
     void addPoint(double timeInSeconds, double value);
     void updateValueAtTime(double timeInSeconds, double value);
 
@@ -9,9 +9,10 @@
 */
 
 #include "BaseEffectComponent.h"
+#include "UIProfiler.h"
 
 BaseEffectComponent::BaseEffectComponent(tracktion::engine::Edit& e)
-    : edit(e)
+    : edit(&e)
 {
     // Configure title label with more sophisticated styling
     titleLabel.setFont(juce::FontOptions(12.0f).withStyle("Bold"));
@@ -28,8 +29,24 @@ BaseEffectComponent::BaseEffectComponent(tracktion::engine::Edit& e)
 
 void BaseEffectComponent::paint(juce::Graphics& g)
 {
-    auto bounds = getLocalBounds().toFloat();
-    
+    // Each panel is profiled under its own title
+    if (profileName.isEmpty())
+        profileName = "BaseEffectComponent::paint (" + titleLabel.getText() + ")";
+
+    const UIProfiler::ScopedTimer profile (profileName);
+
+    // The panel only changes with its size, so it's drawn once per size and scale.
+    // Painting is unclipped: the area takes in the outer half of the border and
+    // the shadow below.
+    auto area = getLocalBounds().expanded(1).withTrimmedBottom(-1);
+    panelAssets->draw(g, {}, area, [bounds = getLocalBounds().toFloat().translated(1.0f, 1.0f)] (juce::Graphics& pg)
+    {
+        drawPanel(pg, bounds);
+    });
+}
+
+void BaseEffectComponent::drawPanel(juce::Graphics& g, juce::Rectangle<float> bounds)
+{
     // Define colors from our modern flat theme
     const auto surfaceColor = juce::Colour(0xFF1E1E1E);    // Dark surface color
     const auto borderColor = juce::Colour(0xFF505050);     // Medium gray for borders
@@ -111,15 +128,44 @@ void BaseEffectComponent::resized()
     flexBox.performLayout(effectiveArea);
 }
 
+void BaseEffectComponent::setEdit(tracktion::engine::Edit& newEdit)
+{
+    if (edit == &newEdit)
+        return;
+
+    // The old Edit's parameters go with it, so nothing may call into them after this
+    unbindSliders();
+    plugin = nullptr;
+
+    edit = &newEdit;
+    bindToEdit();
+}
+
 void BaseEffectComponent::bindSliderToParameter(juce::Slider& slider, tracktion::engine::AutomatableParameter& param)
 {
     slider.setRange(param.getValueRange().getStart(), param.getValueRange().getEnd(), 0.01);
     slider.setValue(param.getCurrentValue(), juce::dontSendNotification);
     
-    slider.onValueChange = [&param, &slider] {
-        param.setParameter(static_cast<float>(slider.getValue()), juce::sendNotification);
+    tracktion::engine::AutomatableParameter::Ptr paramPtr(&param);
+
+    slider.onValueChange = [paramPtr, &slider] {
+        paramPtr->setParameter(static_cast<float>(slider.getValue()), juce::sendNotification);
     };
     
-    slider.onDragStart = [&param] { param.parameterChangeGestureBegin(); };
-    slider.onDragEnd = [&param] { param.parameterChangeGestureEnd(); };
+    slider.onDragStart = [paramPtr] { paramPtr->parameterChangeGestureBegin(); };
+    slider.onDragEnd = [paramPtr] { paramPtr->parameterChangeGestureEnd(); };
+
+    boundSliders.addIfNotAlreadyThere(&slider);
+}
+
+void BaseEffectComponent::unbindSliders()
+{
+    for (auto* slider : boundSliders)
+    {
+        slider->onValueChange = nullptr;
+        slider->onDragStart = nullptr;
+        slider->onDragEnd = nullptr;
+    }
+
+    boundSliders.clear();
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include <juce_graphics/juce_graphics.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <tracktion_engine/tracktion_engine.h>
+#include "RenderedAssetCache.h"
 #include "Utilities.h"
 
 
@@ -27,6 +28,11 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
     
+    /** Points the component at another Edit, keeping its controls, layout and
+        UI state. Derived classes look their plugin up again in bindToEdit().
+    */
+    void setEdit(tracktion::engine::Edit& newEdit);
+
     virtual void storeAndSetMixLevel(float newLevel)
     {
         if (auto mixParam = plugin->getAutomatableParameterByID(mixParameterId))
@@ -54,10 +60,15 @@ public:
     tracktion::engine::Plugin::Ptr getPlugin() const { return plugin; }
     
 protected:
+    /** Called by setEdit() once the Edit has changed, and by derived constructors.
+        Finds the plugin in the current Edit and binds the controls to it.
+    */
+    virtual void bindToEdit() {}
+
     void bindSliderToParameter(juce::Slider& slider, tracktion::engine::AutomatableParameter& param);
     juce::Rectangle<float> getEffectiveArea() const;
     
-    tracktion::engine::Edit& edit;
+    tracktion::engine::Edit* edit;
     tracktion::engine::Plugin::Ptr plugin;
     juce::Label titleLabel;
     juce::Component contentComponent;  // Container for effect-specific content
@@ -66,8 +77,16 @@ protected:
     juce::String mixParameterId = "mix"; // Default ID, can be overridden by derived classes
     
 private:
+    static void drawPanel(juce::Graphics& g, juce::Rectangle<float> bounds);
     void drawScrew(juce::Graphics& g, float x, float y);
+    void unbindSliders();
+
     juce::Random random;
+    juce::Array<juce::Slider*> boundSliders;
+
+    // Panels of the same size share one pre-rendered background
+    juce::SharedResourcePointer<RenderedAssetCache> panelAssets;
+    juce::String profileName;
 
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BaseEffectComponent)
@@ -0,0 +1,209 @@
+#include "BeatGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace te = tracktion::engine;
+
+//==============================================================================
+/** The beat times of one Edit, extended as far as anyone has looked and thrown
+    away when the tempo sequence changes.
+*/
+class BeatGrid::Timeline : private juce::ValueTree::Listener
+{
+public:
+    explicit Timeline (te::Edit& e)
+        : edit (e), tempoState (e.state.getChildWithName (te::IDs::TEMPOSEQUENCE))
+    {
+        tempoState.addListener (this);
+    }
+
+    ~Timeline() override
+    {
+        tempoState.removeListener (this);
+    }
+
+    bool isFor (te::Edit& e) const
+    {
+        return &edit == &e && tempoState == e.state.getChildWithName (te::IDs::TEMPOSEQUENCE);
+    }
+
+    double getTimeOfBeat (double beat)
+    {
+        const auto index = (size_t) juce::jmax (0.0, std::floor (beat));
+        extendTo (index + 2);
+
+        if (index + 1 >= beatTimes.size())
+            return std::numeric_limits<double>::infinity();
+
+        // Within a beat the tempo is taken as steady, which only moves lines between beats
+        const auto t0 = beatTimes[index];
+        return t0 + (beat - (double) index) * (beatTimes[index + 1] - t0);
+    }
+
+    double getBeatAtTime (double time)
+    {
+        while (beatTimes.size() < maxBeats && (beatTimes.empty() || beatTimes.back() <= time))
+            extendTo (beatTimes.size() * 2 + 64);
+
+        const auto next = std::upper_bound (beatTimes.begin(), beatTimes.end(), time);
+
+        if (next == beatTimes.begin() || next == beatTimes.end())
+            return next == beatTimes.begin() ? 0.0 : (double) beatTimes.size() - 1;
+
+        const auto index = (size_t) std::distance (beatTimes.begin(), next) - 1;
+        return (double) index + (time - beatTimes[index]) / (beatTimes[index + 1] - beatTimes[index]);
+    }
+
+    bool isBar (size_t beat)
+    {
+        extendTo (beat + 1);
+        return bars[beat];
+    }
+
+    juce::uint32 revision = 1;
+    std::vector<BeatGrid*> grids;
+
+private:
+    te::Edit& edit;
+    juce::ValueTree tempoState;
+
+    std::vector<double> beatTimes;
+    std::vector<bool> bars;
+    int beatInBar = 0;
+
+    // Far beyond any track, but stops a broken tempo from growing the table forever
+    static constexpr size_t maxBeats = 1 << 20;
+
+    void extendTo (size_t numBeats)
+    {
+        auto& tempoSequence = edit.tempoSequence;
+        numBeats = std::min (numBeats, maxBeats);
+
+        while (beatTimes.size() < numBeats)
+        {
+            const auto time = tempoSequence.toTime (tracktion::BeatPosition::fromBeats ((double) beatTimes.size()));
+            const auto beatsPerBar = juce::jmax (1, tempoSequence.getTimeSigAt (time).numerator.get());
+
+            beatInBar = beatInBar % beatsPerBar;
+            bars.push_back (beatInBar == 0);
+            beatTimes.push_back (time.inSeconds());
+            ++beatInBar;
+        }
+    }
+
+    void tempoChanged()
+    {
+        ++revision;
+        beatTimes.clear();
+        bars.clear();
+        beatInBar = 0;
+
+        for (auto* grid : std::vector<BeatGrid*> (grids))
+            if (grid->onChange != nullptr)
+                grid->onChange();
+    }
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override   { tempoChanged(); }
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override               { tempoChanged(); }
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override        { tempoChanged(); }
+    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override                { tempoChanged(); }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Timeline)
+};
+
+//==============================================================================
+BeatGrid::BeatGrid (te::Edit& edit)
+{
+    attach (edit);
+}
+
+BeatGrid::~BeatGrid()
+{
+    detach();
+}
+
+void BeatGrid::setEdit (te::Edit& edit)
+{
+    if (timeline != nullptr && timeline->isFor (edit))
+        return;
+
+    detach();
+    attach (edit);
+}
+
+juce::uint32 BeatGrid::getRevision() const noexcept
+{
+    return timeline->revision;
+}
+
+std::shared_ptr<BeatGrid::Timeline> BeatGrid::getTimeline (te::Edit& edit)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    static std::vector<std::weak_ptr<Timeline>> timelines;
+    std::erase_if (timelines, [] (auto& t) { return t.expired(); });
+
+    for (auto& t : timelines)
+        if (auto existing = t.lock(); existing->isFor (edit))
+            return existing;
+
+    auto created = std::make_shared<Timeline> (edit);
+    timelines.push_back (created);
+    return created;
+}
+
+void BeatGrid::attach (te::Edit& edit)
+{
+    timeline = getTimeline (edit);
+    timeline->grids.push_back (this);
+    linesKey.reset();
+}
+
+void BeatGrid::detach()
+{
+    if (timeline != nullptr)
+        std::erase (timeline->grids, this);
+
+    timeline = nullptr;
+}
+
+//==============================================================================
+const std::vector<BeatGrid::Line>& BeatGrid::getLines (juce::Range<double> view, float left, float width, double gridSizeInBeats)
+{
+    const Key key { timeline->revision, view, left, width, gridSizeInBeats };
+
+    if (linesKey == key)
+        return lines;
+
+    linesKey = key;
+    lines.clear();
+
+    if (view.isEmpty() || width <= 0.0f || gridSizeInBeats <= 0.0)
+        return lines;
+
+    const auto pixelsPerSecond = width / view.getLength();
+
+    // A line a hair before the view still counts, so rounding can't drop the first one
+    constexpr auto epsilon = 1.0e-9;
+    auto index = std::ceil (timeline->getBeatAtTime (view.getStart()) / gridSizeInBeats - epsilon);
+
+    for (;; index += 1.0)
+    {
+        const auto beat = index * gridSizeInBeats;
+        const auto time = timeline->getTimeOfBeat (beat);
+
+        if (time > view.getEnd())
+            break;
+
+        const auto wholeBeat = std::round (beat);
+        const auto isBeat = std::abs (beat - wholeBeat) < epsilon;
+
+        lines.push_back ({ left + (float) ((time - view.getStart()) * pixelsPerSecond),
+                           time,
+                           isBeat,
+                           isBeat && timeline->isBar ((size_t) wholeBeat) });
+    }
+
+    return lines;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <tracktion_engine/tracktion_engine.h>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+//==============================================================================
+/**
+    Where the grid lines of an Edit fall on a timeline component.
+
+    The time of every beat is read from the tempo sequence once after each
+    tempo change, and shared by all the BeatGrids on the same Edit. Asking for
+    the lines in view is then a binary search plus one multiply per line, with
+    no tempo sequence queries; asking again for the same view returns the
+    lines from last time.
+
+    Message thread only.
+*/
+class BeatGrid
+{
+public:
+    struct Line
+    {
+        float x = 0.0f;
+        double time = 0.0;      // edit seconds
+        bool isBeat = false;    // false for lines between beats
+        bool isBar = false;
+    };
+
+    explicit BeatGrid (tracktion::engine::Edit&);
+    ~BeatGrid();
+
+    void setEdit (tracktion::engine::Edit&);
+
+    /** The lines every gridSizeInBeats beats within view (edit seconds), with the
+        view spanning width pixels from left.
+    */
+    const std::vector<Line>& getLines (juce::Range<double> view, float left, float width, double gridSizeInBeats = 1.0);
+
+    /** Goes up by one whenever the tempo sequence changes. */
+    juce::uint32 getRevision() const noexcept;
+
+    /** Called when the tempo sequence changes. */
+    std::function<void()> onChange;
+
+private:
+    class Timeline;
+
+    struct Key
+    {
+        juce::uint32 revision = 0;
+        juce::Range<double> view;
+        float left = 0.0f, width = 0.0f;
+        double gridSizeInBeats = 0.0;
+
+        bool operator== (const Key&) const = default;
+    };
+
+    std::shared_ptr<Timeline> timeline;
+    std::optional<Key> linesKey;
+    std::vector<Line> lines;
+
+    static std::shared_ptr<Timeline> getTimeline (tracktion::engine::Edit&);
+    void attach (tracktion::engine::Edit&);
+    void detach();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BeatGrid)
+};
@@ -5,17 +5,6 @@
 ChopComponent::ChopComponent (tracktion::engine::Edit& editIn)
     : BaseEffectComponent (editIn)
 {
-    chopTrack = EngineHelpers::getChopTrack(edit);
-
-    if (!chopTrack)
-    {
-        titleLabel.setText ("Error loading Chop", juce::dontSendNotification);
-        DBG ("Error: No chop track found");
-        return;
-    }
-
-    titleLabel.setText ("Chop Controls", juce::dontSendNotification);
-
     // Configure labels
     durationLabel.setText ("Duration", juce::dontSendNotification);
     durationLabel.setJustificationType (juce::Justification::left);
@@ -41,13 +30,28 @@ ChopComponent::ChopComponent (tracktion::engine::Edit& editIn)
 
     // Make sure this component can receive keyboard focus
     setWantsKeyboardFocus (true);
+
+    bindToEdit();
 }
 
-ChopComponent::~ChopComponent()
+void ChopComponent::bindToEdit()
 {
-    stopTimer(); // Make sure to stop the timer
+    chopTrack = EngineHelpers::getChopTrack (*edit);
+
+    if (!chopTrack)
+    {
+        titleLabel.setText ("Error loading Chop", juce::dontSendNotification);
+        DBG ("Error: No chop track found");
+        contentComponent.setVisible (false);
+        return;
+    }
+
+    titleLabel.setText ("Chop Controls", juce::dontSendNotification);
+    contentComponent.setVisible (true);
 }
 
+ChopComponent::~ChopComponent() = default;
+
 void ChopComponent::resized()
 {
     // First let the base component handle its layout
@@ -99,14 +103,14 @@ void ChopComponent::handleChopButtonPressed()
     if (!chopTrack)
         return;
 
-    auto& transport = edit.getTransport();
+    auto& transport = edit->getTransport();
     double currentPositionSeconds = transport.getPosition().inSeconds();
     
     // Convert duration from beats to time
     auto durationInBeats = getChopDurationInBeats();
-    auto startBeat = edit.tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(currentPositionSeconds));
+    auto startBeat = edit->tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(currentPositionSeconds));
     auto endBeat = tracktion::BeatPosition::fromBeats(startBeat.inBeats() + durationInBeats);
-    auto endTime = edit.tempoSequence.toTime(endBeat).inSeconds();
+    auto endTime = edit->tempoSequence.toTime(endBeat).inSeconds();
 
     // Create a new clip at the current position
     auto timeRange = tracktion::TimeRange::between(
@@ -124,10 +128,4 @@ void ChopComponent::handleChopButtonPressed()
 void ChopComponent::handleChopButtonReleased()
 {
     // Nothing needed here as clips are created on press
-}
-
-void ChopComponent::timerCallback()
-{
-    stopTimer();
-    chopReleaseDelay = 0;
 }
\ No newline at end of file
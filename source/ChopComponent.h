@@ -3,8 +3,7 @@
 #include "BaseEffectComponent.h"
 #include "ChopTrackLane.h"
 
-class ChopComponent : public BaseEffectComponent,
-                     public juce::Timer
+class ChopComponent : public BaseEffectComponent
 {
 public:
     explicit ChopComponent(tracktion::engine::Edit&);
@@ -18,8 +17,8 @@ public:
     void handleChopButtonPressed();
     void handleChopButtonReleased();
 
-    // Timer callback
-    void timerCallback() override;
+protected:
+    void bindToEdit() override;
 
 private:
     juce::Label durationLabel;
@@ -27,8 +26,5 @@ private:
     juce::TextButton chopButton;
     tracktion::engine::AudioTrack::Ptr chopTrack;
 
-    double chopStartTime = 0.0;
-    double chopReleaseDelay = 0.0;
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChopComponent)
 }; 
\ No newline at end of file
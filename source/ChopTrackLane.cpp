@@ -1,24 +1,178 @@
 #include "ChopTrackLane.h"
 #include "Utilities.h"
+#include "UIProfiler.h"
+#include <algorithm>
 
 ChopTrackLane::ChopTrackLane(tracktion::engine::Edit& e, ZoomState& zs)
-    : edit(e), zoomState(zs)
+    : edit(&e), zoomState(zs), beatGrid(e)
 {
     // Register as a zoom state listener
     zoomState.addListener(this);
+    beatGrid.onChange = [this] { repaint(); };
     chopTrack = getOrCreateChopTrack();
+    attachToChopTrack();
 }
 
 ChopTrackLane::~ChopTrackLane()
 {
     // Remove zoom state listener
     zoomState.removeListener(this);
+    detachFromChopTrack();
     clearClips();
 }
 
+void ChopTrackLane::setEdit(tracktion::engine::Edit& newEdit)
+{
+    if (edit == &newEdit)
+        return;
+
+    detachFromChopTrack();
+    edit = &newEdit;
+    beatGrid.setEdit(newEdit);
+    chopTrack = getOrCreateChopTrack();
+    attachToChopTrack();
+    selectedClip = nullptr;
+    isDragging = false;
+    repaint();
+}
+
+void ChopTrackLane::setGpuRendered(bool shouldBeGpuRendered)
+{
+    gpuRendered = shouldBeGpuRendered;
+    repaint();
+}
+
+void ChopTrackLane::attachToChopTrack()
+{
+    if (chopTrack != nullptr)
+        chopTrackState = chopTrack->state;
+
+    chopTrackState.addListener(this);
+    chopsValid = false;
+}
+
+void ChopTrackLane::detachFromChopTrack()
+{
+    chopTrackState.removeListener(this);
+    chopTrackState = {};
+    chops.clear();
+    chopsValid = false;
+}
+
+void ChopTrackLane::chopTrackChanged()
+{
+    // Our own edits keep the cache up to date and repaint what they touched
+    if (editingChops)
+        return;
+
+    chopsValid = false;
+    repaint();
+}
+
+const std::vector<ChopTrackLane::ChopGeometry>& ChopTrackLane::getChops()
+{
+    if (chopsValid)
+        return chops;
+
+    chops.clear();
+    longestChop = 0.0;
+
+    if (chopTrack != nullptr)
+    {
+        for (auto clip : chopTrack->getClips())
+        {
+            const auto position = clip->getPosition();
+            chops.push_back({ clip, position.getStart().inSeconds(), position.getEnd().inSeconds() });
+            longestChop = juce::jmax(longestChop, chops.back().end - chops.back().start);
+        }
+    }
+
+    std::stable_sort(chops.begin(), chops.end(), [] (auto& a, auto& b) { return a.start < b.start; });
+    chopsValid = true;
+    return chops;
+}
+
+std::span<const ChopTrackLane::ChopGeometry> ChopTrackLane::getChopsInRange(juce::Range<double> timeRange)
+{
+    auto& all = getChops();
+
+    // No chop starting before this can reach the range
+    auto first = std::lower_bound(all.begin(), all.end(), timeRange.getStart() - longestChop,
+                                  [] (auto& chop, double time) { return chop.start < time; });
+    auto last = std::upper_bound(first, all.end(), timeRange.getEnd(),
+                                 [] (double time, auto& chop) { return time < chop.start; });
+
+    return { first, last };
+}
+
+tracktion::engine::Clip* ChopTrackLane::findChopAt(double time)
+{
+    for (auto& chop : getChopsInRange({ time, time }))
+        if (time >= chop.start && time <= chop.end)
+            return chop.clip;
+
+    return nullptr;
+}
+
+void ChopTrackLane::moveChop(tracktion::engine::Clip& clip, double newStart)
+{
+    const auto duration = clip.getPosition().getLength().inSeconds();
+    auto newTimeRange = tracktion::TimeRange::between(
+        tracktion::TimePosition::fromSeconds(newStart),
+        tracktion::TimePosition::fromSeconds(newStart + duration)
+    );
+
+    {
+        const juce::ScopedValueSetter<bool> editing(editingChops, true);
+        clip.setPosition({ newTimeRange, tracktion::TimeDuration() });
+    }
+
+    if (! chopsValid)
+        return;
+
+    // Take the chop out and put it back where it now sorts
+    auto found = std::find_if(chops.begin(), chops.end(), [&clip] (auto& chop) { return chop.clip == &clip; });
+
+    if (found == chops.end())
+    {
+        chopsValid = false;
+        return;
+    }
+
+    auto moved = *found;
+    chops.erase(found);
+    moved.start = clip.getPosition().getStart().inSeconds();
+    moved.end = clip.getPosition().getEnd().inSeconds();
+
+    auto insertAt = std::upper_bound(chops.begin(), chops.end(), moved.start,
+                                     [] (double time, auto& chop) { return time < chop.start; });
+    chops.insert(insertAt, moved);
+}
+
+juce::Rectangle<int> ChopTrackLane::getChopBounds(double startTime, double endTime) const
+{
+    const auto startX = timeToXY(startTime, 1.0).x;
+    const auto endX = timeToXY(endTime, 1.0).x;
+
+    // Takes in the border either side
+    return juce::Rectangle<float>(startX, 0.0f, endX - startX, (float) getHeight())
+        .expanded(1.0f, 0.0f)
+        .getSmallestIntegerContainer()
+        .getIntersection(getLocalBounds());
+}
+
+juce::Rectangle<int> ChopTrackLane::getChopBounds(const tracktion::engine::Clip* clip) const
+{
+    if (clip == nullptr)
+        return {};
+
+    const auto position = clip->getPosition();
+    return getChopBounds(position.getStart().inSeconds(), position.getEnd().inSeconds());
+}
+
 tracktion::engine::AudioTrack::Ptr ChopTrackLane::getOrCreateChopTrack()
 {
-    auto track = EngineHelpers::getChopTrack(edit);
+    auto track = EngineHelpers::getChopTrack(*edit);
     if (track == nullptr)
     {
         DBG("No chop track found");
@@ -29,81 +183,69 @@ tracktion::engine::AudioTrack::Ptr ChopTrackLane::getOrCreateChopTrack()
 
 void ChopTrackLane::paint(juce::Graphics& g)
 {
+    const UIProfiler::ScopedTimer profile ("ChopTrackLane::paint");
     auto bounds = getLocalBounds().toFloat();
-    auto& tempoSequence = edit.tempoSequence;
-    
-    // Draw background
-    g.setColour(juce::Colours::darkgrey);
-    g.fillRect(bounds);
-    
-    // Draw grid lines
-    g.setColour(juce::Colours::grey.withAlpha(0.5f));
     
     // Calculate visible time range in seconds
-    auto visibleTimeStart = getSourceLength() * zoomState.getScrollPosition();
-    auto visibleTimeEnd = visibleTimeStart + (getSourceLength() / zoomState.getZoomLevel());
-    
-    DBG("Paint - Visible time range: " + juce::String(visibleTimeStart) + " to " + juce::String(visibleTimeEnd));
-    DBG("Paint - Zoom level: " + juce::String(zoomState.getZoomLevel()) + ", Scroll position: " + juce::String(zoomState.getScrollPosition()));
-    
-    // Convert to beats for grid drawing
-    auto visibleTimeStartBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(visibleTimeStart));
-    auto visibleTimeEndBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(visibleTimeEnd));
-    
-    // Draw vertical grid lines based on current grid size
-    double gridTimeBeats = std::floor(visibleTimeStartBeats.inBeats() / zoomState.getGridSize()) * zoomState.getGridSize();
-    while (gridTimeBeats <= visibleTimeEndBeats.inBeats())
+    auto sourceLength = getSourceLength();
+    auto visibleTimeStart = sourceLength * zoomState.getScrollPosition();
+    auto visibleTimeEnd = visibleTimeStart + (sourceLength / zoomState.getZoomLevel());
+    const juce::Range<double> visibleRange(visibleTimeStart, visibleTimeEnd);
+
+    if (! gpuRendered)
     {
-        auto gridTimeSeconds = tempoSequence.toTime(tracktion::BeatPosition::fromBeats(gridTimeBeats)).inSeconds();
-        auto xPos = timeToXY(gridTimeSeconds, 0.0).x;
-        g.drawVerticalLine(static_cast<int>(xPos), bounds.getY(), bounds.getBottom());
-        gridTimeBeats += zoomState.getGridSize();
+        // Draw background
+        g.setColour(juce::Colours::darkgrey);
+        g.fillRect(bounds);
+
+        // Draw vertical grid lines based on current grid size
+        g.setColour(juce::Colours::grey.withAlpha(0.5f));
+
+        for (auto& line : beatGrid.getLines(visibleRange, bounds.getX(), bounds.getWidth(), zoomState.getGridSize()))
+            g.drawVerticalLine(static_cast<int>(line.x), bounds.getY(), bounds.getBottom());
     }
     
-    // Draw clips
-    if (chopTrack != nullptr)
-    {
-        for (auto clip : chopTrack->getClips())
-        {
-            auto startTime = clip->getPosition().getStart().inSeconds();
-            auto endTime = clip->getPosition().getEnd().inSeconds();
+    // Draw clips; only those under the area being repainted, mapped to x without
+    // going back to the clips
+    const auto pixelsPerSecond = bounds.getWidth() / visibleRange.getLength();
+    auto timeToX = [&] (double time) { return bounds.getX() + (float) ((time - visibleTimeStart) * pixelsPerSecond); };
 
-            DBG("ChopTrackLane::paint - Clip position: " + juce::String(startTime) + " - " + juce::String(endTime));
-            
-            // Skip clips that are completely outside the visible range
-            if (endTime < visibleTimeStart || startTime > visibleTimeEnd)
-                continue;
-            
-            // Clamp clip times to visible range
-            double clampedStartTime = juce::jlimit(visibleTimeStart, visibleTimeEnd, startTime);
-            double clampedEndTime = juce::jlimit(visibleTimeStart, visibleTimeEnd, endTime);
-            
-            // Convert clip times through beats for proper tempo handling
-            auto startBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(clampedStartTime));
-            auto endBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(clampedEndTime));
-            
-            auto startTimeSeconds = tempoSequence.toTime(startBeats).inSeconds();
-            auto endTimeSeconds = tempoSequence.toTime(endBeats).inSeconds();
-            
-            auto startPoint = timeToXY(startTimeSeconds, 1.0);
-            auto endPoint = timeToXY(endTimeSeconds, 1.0);
-            
-            // Calculate rectangle bounds for the clip
-            juce::Rectangle<float> clipBounds(
-                startPoint.x,
-                bounds.getY(),
-                endPoint.x - startPoint.x,
-                bounds.getHeight()
-            );
-            
-            // Draw clip with different color if selected
-            g.setColour(clip == selectedClip ? juce::Colours::orangered : juce::Colours::orange);
-            g.fillRect(clipBounds);
-            
-            // Draw border
-            g.setColour(clip == selectedClip ? juce::Colours::white : juce::Colours::white.withAlpha(0.5f));
-            g.drawRect(clipBounds, 1.0f);
-        }
+    const auto dirty = g.getClipBounds().toFloat().expanded(1.0f, 0.0f);
+    const auto dirtyRange = juce::Range<double>(visibleTimeStart + (dirty.getX() - bounds.getX()) / pixelsPerSecond,
+                                                visibleTimeStart + (dirty.getRight() - bounds.getX()) / pixelsPerSecond)
+                                .getIntersectionWith(visibleRange);
+
+    for (auto& chop : getChopsInRange(dirtyRange))
+    {
+        auto clip = chop.clip;
+
+        // The renderer draws every chop unselected
+        if (gpuRendered && clip != selectedClip)
+            continue;
+
+        // Skip clips that are completely outside the visible range
+        if (chop.end < visibleTimeStart || chop.start > visibleTimeEnd)
+            continue;
+
+        // Clamp clip times to visible range; clip positions are already in edit time
+        auto startX = timeToX(visibleRange.clipValue(chop.start));
+        auto endX = timeToX(visibleRange.clipValue(chop.end));
+
+        // Calculate rectangle bounds for the clip
+        juce::Rectangle<float> clipBounds(
+            startX,
+            bounds.getY(),
+            endX - startX,
+            bounds.getHeight()
+        );
+
+        // Draw clip with different color if selected
+        g.setColour(clip == selectedClip ? juce::Colours::orangered : juce::Colours::orange);
+        g.fillRect(clipBounds);
+
+        // Draw border
+        g.setColour(clip == selectedClip ? juce::Colours::white : juce::Colours::white.withAlpha(0.5f));
+        g.drawRect(clipBounds, 1.0f);
     }
 }
 
@@ -114,28 +256,20 @@ void ChopTrackLane::mouseDown(const juce::MouseEvent& event)
 
     // Use XYToTime instead of raw calculation to properly account for zoom and scroll
     auto [time, value] = XYToTime(event.position.x, event.position.y);
-    
-    DBG("MouseDown - Initial time from XYToTime: " + juce::String(time));
-    DBG("MouseDown - Mouse X: " + juce::String(event.position.x));
-    DBG("MouseDown - Zoom level: " + juce::String(zoomState.getZoomLevel()) + 
-        ", Scroll position: " + juce::String(zoomState.getScrollPosition()));
+
+    // The previous selection is repainted along with the new one
+    const auto previousSelection = getChopBounds(selectedClip);
 
     // First check if we clicked on a clip - use raw time before snapping
-    selectedClip = nullptr;
-    for (auto clip : chopTrack->getClips())
+    selectedClip = findChopAt(time);
+
+    if (selectedClip != nullptr)
     {
-        auto startTime = clip->getPosition().getStart().inSeconds();
-        auto endTime = clip->getPosition().getEnd().inSeconds();
-        
-        if (time >= startTime && time <= endTime)
-        {
-            selectedClip = clip;
-            isDragging = true;
-            dragStartTime = time;
-            dragOffsetTime = time - startTime;
-            repaint();
-            return;
-        }
+        isDragging = true;
+        dragStartTime = time;
+        dragOffsetTime = time - selectedClip->getPosition().getStart().inSeconds();
+        repaint(previousSelection.getUnion(getChopBounds(selectedClip)));
+        return;
     }
     
     // If we didn't click on a clip, then we can snap the time for new clip creation
@@ -143,21 +277,16 @@ void ChopTrackLane::mouseDown(const juce::MouseEvent& event)
         time = snapTimeToGrid(time);
         
     // Convert 1 beat to seconds using the tempo sequence
-    auto startBeat = edit.tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(time));
+    auto startBeat = edit->tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(time));
     auto endBeat = tracktion::BeatPosition::fromBeats(startBeat.inBeats() + 1.0);
-    auto endTime = edit.tempoSequence.toTime(endBeat).inSeconds();
-    
-    DBG("MouseDown - Adding clip - Start time: " + juce::String(time) + 
-        ", Start beat: " + juce::String(startBeat.inBeats()) + 
-        ", End beat: " + juce::String(endBeat.inBeats()) + 
-        ", End time: " + juce::String(endTime));
+    auto endTime = edit->tempoSequence.toTime(endBeat).inSeconds();
     
     addClip(time, endTime);
 
+    // addClip() repaints the new chop and the previous selection
     isDragging = true;
     dragStartTime = time;
     dragOffsetTime = 0.0;
-    repaint();
 }
 
 void ChopTrackLane::mouseDrag(const juce::MouseEvent& event)
@@ -180,7 +309,7 @@ void ChopTrackLane::mouseDrag(const juce::MouseEvent& event)
         double moveAmount = newStartTime - originalStartTime;
         
         // Snap the move amount to the grid
-        auto& tempoSequence = edit.tempoSequence;
+        auto& tempoSequence = edit->tempoSequence;
         auto moveInBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(std::abs(moveAmount)));
         double gridSize = zoomState.getGridSize();
         
@@ -210,22 +339,18 @@ void ChopTrackLane::mouseDrag(const juce::MouseEvent& event)
     if (newStartTime < 0)
         newStartTime = 0;
     
-    // Move the clip
-    auto duration = selectedClip->getPosition().getLength().inSeconds();
-    auto newTimeRange = tracktion::TimeRange::between(
-        tracktion::TimePosition::fromSeconds(newStartTime),
-        tracktion::TimePosition::fromSeconds(newStartTime + duration)
-    );
-    
-    selectedClip->setPosition({ newTimeRange, tracktion::TimeDuration() });
-    repaint();
+    // Move the clip, repainting where it was and where it is now
+    const auto oldBounds = getChopBounds(selectedClip);
+    moveChop(*selectedClip, newStartTime);
+    repaint(oldBounds.getUnion(getChopBounds(selectedClip)));
 }
 
 void ChopTrackLane::mouseUp(const juce::MouseEvent&)
 {
+    const auto deselected = getChopBounds(selectedClip);
     isDragging = false;
     selectedClip = nullptr;
-    repaint();
+    repaint(deselected);
 }
 
 void ChopTrackLane::mouseDoubleClick(const juce::MouseEvent& event)
@@ -236,18 +361,18 @@ void ChopTrackLane::mouseDoubleClick(const juce::MouseEvent& event)
     auto [time, value] = XYToTime(event.position.x, event.position.y);
     
     // Check if we double-clicked on a clip
-    for (auto clip : chopTrack->getClips())
+    if (auto clip = findChopAt(time))
     {
-        auto startTime = clip->getPosition().getStart().inSeconds();
-        auto endTime = clip->getPosition().getEnd().inSeconds();
-        
-        if (time >= startTime && time <= endTime)
+        const auto removed = getChopBounds(clip);
+
         {
+            const juce::ScopedValueSetter<bool> editing(editingChops, true);
             clip->removeFromParent();
-            selectedClip = nullptr;
-            repaint();
-            return;
         }
+
+        chopsValid = false;
+        selectedClip = nullptr;
+        repaint(removed);
     }
 }
 
@@ -299,14 +424,10 @@ double ChopTrackLane::snapTimeToGrid(double time) const
     if (!snapEnabled)
         return time;
         
-    auto& tempoSequence = edit.tempoSequence;
+    auto& tempoSequence = edit->tempoSequence;
     auto timeInBeats = tempoSequence.toBeats(tracktion::TimePosition::fromSeconds(time));
     double gridSize = zoomState.getGridSize();
     
-    DBG("Snap - Time: " + juce::String(time) + 
-        ", In beats: " + juce::String(timeInBeats.inBeats()) + 
-        ", Grid size: " + juce::String(gridSize));
-    
     // Find the previous and next grid lines relative to the click position
     double previousGridLine = std::floor(timeInBeats.inBeats() / gridSize) * gridSize;
     double nextGridLine = previousGridLine + gridSize;
@@ -318,13 +439,7 @@ double ChopTrackLane::snapTimeToGrid(double time) const
     // Choose which grid line to snap to
     double snappedBeats = (percentageToNext >= 0.9) ? nextGridLine : previousGridLine;
     
-    auto snappedTime = tempoSequence.toTime(tracktion::BeatPosition::fromBeats(snappedBeats)).inSeconds();
-    
-    DBG("Snap - Distance to next: " + juce::String(percentageToNext * 100) + "%, Previous: " + 
-        juce::String(previousGridLine) + ", Next: " + juce::String(nextGridLine) + 
-        ", Snapped to: " + juce::String(snappedBeats));
-    
-    return snappedTime;
+    return tempoSequence.toTime(tracktion::BeatPosition::fromBeats(snappedBeats)).inSeconds();
 }
 
 void ChopTrackLane::clearClips()
@@ -341,9 +456,16 @@ void ChopTrackLane::deleteSelectedClip()
 {
     if (selectedClip != nullptr)
     {
-        selectedClip->removeFromParent();
+        const auto removed = getChopBounds(selectedClip);
+
+        {
+            const juce::ScopedValueSetter<bool> editing(editingChops, true);
+            selectedClip->removeFromParent();
+        }
+
+        chopsValid = false;
         selectedClip = nullptr;
-        repaint();
+        repaint(removed);
     }
 }
 
@@ -352,27 +474,28 @@ void ChopTrackLane::addClip(double startTime, double endTime)
     if (chopTrack == nullptr)
         return;
 
-    DBG("AddClip - Creating clip from " + juce::String(startTime) + " to " + juce::String(endTime));
-
     auto timeRange = tracktion::TimeRange::between(
         tracktion::TimePosition::fromSeconds(startTime),
         tracktion::TimePosition::fromSeconds(endTime)
     );
 
-    auto newClip = chopTrack->insertNewClip(tracktion::engine::TrackItem::Type::arranger, timeRange, nullptr);
-    if (newClip != nullptr)
-    {
-        newClip->setName("Chop " + juce::String(chopTrack->getClips().size()));
-        selectedClip = newClip;
-        DBG("AddClip - Clip created successfully with range: " + 
-            juce::String(newClip->getPosition().getStart().inSeconds()) + " to " + 
-            juce::String(newClip->getPosition().getEnd().inSeconds()));
-    }
-    else
+    const auto previousSelection = getChopBounds(selectedClip);
+    tracktion::engine::Clip::Ptr newClip;
+
     {
-        DBG("AddClip - Failed to create clip!");
+        const juce::ScopedValueSetter<bool> editing(editingChops, true);
+        newClip = chopTrack->insertNewClip(tracktion::engine::TrackItem::Type::arranger, timeRange, nullptr);
+
+        if (newClip != nullptr)
+            newClip->setName("Chop " + juce::String(chopTrack->getClips().size()));
     }
-    repaint();
+
+    chopsValid = false;
+
+    if (newClip != nullptr)
+        selectedClip = newClip.get();
+
+    repaint(previousSelection.getUnion(getChopBounds(newClip.get())));
 }
 
 juce::Point<float> ChopTrackLane::timeToXY(double time, double value) const
@@ -407,10 +530,9 @@ double ChopTrackLane::getSourceLength() const
 {
     // For now, return a fixed length of 60 seconds
     // This should be updated based on your actual track length
-        auto clip = EngineHelpers::getCurrentClip(edit);
+    auto clip = EngineHelpers::getCurrentClip(*edit);
     if (clip != nullptr)
         return clip->getPosition().getLength().inSeconds();
 
-    DBG("No clip found, returning default length");
     return 60.0;
 } 
\ No newline at end of file
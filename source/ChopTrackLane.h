@@ -2,18 +2,24 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <tracktion_engine/tracktion_engine.h>
+#include "BeatGrid.h"
 #include "ZoomState.h"
 #include <vector>
 #include <optional>
 #include <functional>
+#include <span>
 
 class ChopTrackLane : public juce::Component,
-                      public ZoomStateListener
+                      public ZoomStateListener,
+                      private juce::ValueTree::Listener
 {
 public:
     ChopTrackLane(tracktion::engine::Edit&, ZoomState&);
     ~ChopTrackLane() override;
 
+    /** Shows another Edit's chop track. */
+    void setEdit(tracktion::engine::Edit& newEdit);
+
     void paint(juce::Graphics& g) override;
     void mouseDown(const juce::MouseEvent& event) override;
     void mouseDrag(const juce::MouseEvent& event) override;
@@ -31,6 +37,11 @@ public:
     void addClip(double startTime, double endTime);
     void launchClip(tracktion::engine::Clip* clip);
 
+    /** Leaves the grid and chops to a TimelineRenderer drawing beneath this
+        component; only the selected chop is still painted here.
+    */
+    void setGpuRendered(bool shouldBeGpuRendered);
+
     // ZoomStateListener implementation
     void zoomLevelChanged(double newZoomLevel) override { repaint(); }
     void scrollPositionChanged(double newScrollPosition) override { repaint(); }
@@ -41,17 +52,52 @@ public:
     std::pair<double, double> XYToTime(float x, float y) const;
 
 private:
-    tracktion::engine::Edit& edit;
+    tracktion::engine::Edit* edit;
     ZoomState& zoomState;
     tracktion::engine::AudioTrack::Ptr chopTrack;
+    BeatGrid beatGrid;
     bool snapEnabled = true;
     bool isDragging = false;
+    bool gpuRendered = false;
     tracktion::engine::Clip* selectedClip = nullptr;
 
     // Drag state tracking
     double dragStartTime = 0.0;
     double dragOffsetTime = 0.0;
 
+    // Where each chop is, sorted by start, so painting and hit testing only visit
+    // the chops near the view. Rebuilt after the chop track changes, except that
+    // the chop being dragged is moved in place. Edits made here repaint only the
+    // chops they touch; changes from elsewhere repaint the lane.
+    struct ChopGeometry
+    {
+        tracktion::engine::Clip* clip = nullptr;
+        double start = 0.0, end = 0.0;
+    };
+
+    std::vector<ChopGeometry> chops;
+    double longestChop = 0.0;
+    bool chopsValid = false;
+    bool editingChops = false;
+    juce::ValueTree chopTrackState;
+
+    const std::vector<ChopGeometry>& getChops();
+    std::span<const ChopGeometry> getChopsInRange(juce::Range<double> timeRange);
+    tracktion::engine::Clip* findChopAt(double time);
+    void moveChop(tracktion::engine::Clip&, double newStart);
+
+    juce::Rectangle<int> getChopBounds(double startTime, double endTime) const;
+    juce::Rectangle<int> getChopBounds(const tracktion::engine::Clip*) const;
+
+    void attachToChopTrack();
+    void detachFromChopTrack();
+    void chopTrackChanged();
+
+    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override { chopTrackChanged(); }
+    void valueTreeChildAdded(juce::ValueTree&, juce::ValueTree&) override { chopTrackChanged(); }
+    void valueTreeChildRemoved(juce::ValueTree&, juce::ValueTree&, int) override { chopTrackChanged(); }
+    void valueTreeChildOrderChanged(juce::ValueTree&, int, int) override { chopTrackChanged(); }
+
     double getSourceLength() const;
     tracktion::engine::AudioTrack::Ptr getOrCreateChopTrack();
 
@@ -30,13 +30,13 @@ ControllerMappingComponent::ControllerMappingComponent()
         {{300, 170}, 15, "Triangle", SDL_GAMEPAD_BUTTON_NORTH}
     };
 
-    // Start timer to check connection status
-    startTimer(100);
+    checkControllerConnection();
+    GamepadManager::getInstance()->addListener(this);
 }
 
 ControllerMappingComponent::~ControllerMappingComponent()
 {
-    stopTimer();
+    GamepadManager::getInstance()->removeListener(this);
 }
 
 void ControllerMappingComponent::resized()
@@ -224,21 +224,16 @@ void ControllerMappingComponent::checkControllerConnection()
     }
 }
 
-void ControllerMappingComponent::timerCallback()
+void ControllerMappingComponent::gamepadConnected()
 {
-    if (getTimerInterval() != 500)
-    {
-        stopTimer();
-        startTimerHz(2);
-    }
-    
-    bool wasConnected = isControllerConnected;
     checkControllerConnection();
-    
-    if (wasConnected != isControllerConnected)
-    {
-        repaint();
-    }
+    repaint();
+}
+
+void ControllerMappingComponent::gamepadDisconnected()
+{
+    checkControllerConnection();
+    repaint();
 }
 
 void ControllerMappingComponent::drawMappingsList(juce::Graphics& g, juce::Rectangle<float> bounds)
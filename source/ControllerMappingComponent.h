@@ -12,7 +12,7 @@
 class ControllerMappingWindow;
 
 class ControllerMappingComponent : public juce::Component,
-                                  private juce::Timer
+                                  private GamepadManager::Listener
 {
 public:
     ControllerMappingComponent();
@@ -20,9 +20,6 @@ public:
 
     void paint(juce::Graphics& g) override;
     void resized() override;
-    
-    // Add timer callback
-    void timerCallback() override;
 
     struct ControllerMapping
     {
@@ -68,6 +65,14 @@ private:
     juce::String connectedControllerName;
     
     void checkControllerConnection();
+
+    // The connection status follows the gamepad manager's notifications
+    void gamepadButtonPressed(int) override {}
+    void gamepadButtonReleased(int) override {}
+    void gamepadAxisMoved(int, float) override {}
+    void gamepadTouchpadMoved(float, float, bool) override {}
+    void gamepadConnected() override;
+    void gamepadDisconnected() override;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ControllerMappingComponent)
 };
@@ -5,6 +5,8 @@
 #include <juce_graphics/juce_graphics.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 
+#include "RenderedAssetCache.h"
+
 class CustomLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
@@ -67,35 +69,21 @@ public:
         }
     }
 
+    // The parts of the sliders and knobs that don't move are pre-rendered (see
+    // RenderedAssetCache); a repaint blits them and draws only the value live
     void drawLinearSlider (juce::Graphics& g, int x, int y, int width, int height, float sliderPos, float minSliderPos, float maxSliderPos, const juce::Slider::SliderStyle style, juce::Slider& slider) override
     {
+        const auto thumbColour = findColour(juce::Slider::thumbColourId);
+        const auto trackColour = findColour(juce::Slider::trackColourId);
+
         if (slider.getName() == "Crossfader")
         {
-            // Calculate groove dimensions
-            auto grooveWidth = width * 0.8f;
-            auto grooveHeight = 3.0f;  // Slightly thinner
-            auto grooveBounds = juce::Rectangle<float> (
-                x + (width - grooveWidth) * 0.5f,
-                y + (height - grooveHeight) * 0.5f,
-                grooveWidth,
-                grooveHeight);
-
-            // Draw groove with subtle gradient
-            juce::ColourGradient grooveGradient(
-                findColour(juce::Slider::trackColourId).brighter(0.1f),
-                grooveBounds.getTopLeft(),
-                findColour(juce::Slider::trackColourId).darker(0.1f),
-                grooveBounds.getBottomLeft(),
-                false);
-            g.setGradientFill(grooveGradient);
-            g.fillRoundedRectangle(grooveBounds, 1.5f);
-
-            // Center marker
-            float centerX = x + width * 0.5f;
-            g.setColour(findColour(juce::Slider::thumbColourId).withAlpha(0.3f));
-            g.drawVerticalLine(static_cast<int>(centerX), grooveBounds.getY(), grooveBounds.getBottom());
-
-            // Draw fader handle
+            // Groove and center marker
+            assets.draw(g, { crossfaderGroove, 0, 0, 1.0f, thumbColour.getARGB(), trackColour.getARGB() },
+                        { x, y, width, height },
+                        [=] (juce::Graphics& ag) { drawCrossfaderGroove(ag, (float) width, (float) height, thumbColour, trackColour); });
+
+            // Draw fader handle, whole pixels apart so one image serves every position
             float handleWidth = 24.0f;  // Slightly narrower
             float handleHeight = height * 0.7f;  // Slightly shorter
 
@@ -103,39 +91,16 @@ public:
             float maxX = x + width - handleWidth * 0.5f;
             float limitedSliderPos = juce::jlimit(minX, maxX, sliderPos);
 
-            auto thumbBounds = juce::Rectangle<float>(
-                limitedSliderPos - handleWidth * 0.5f,
-                y + (height - handleHeight) * 0.5f,
-                handleWidth,
-                handleHeight);
-
-            // Simple shadow
-            g.setColour(juce::Colours::black.withAlpha(0.2f));
-            g.fillRoundedRectangle(thumbBounds.translated(0, 1), 3.0f);
-
-            // Handle with subtle gradient
-            juce::ColourGradient handleGradient(
-                findColour(juce::Slider::thumbColourId).brighter(0.1f),
-                thumbBounds.getTopLeft(),
-                findColour(juce::Slider::thumbColourId).darker(0.1f),
-                thumbBounds.getBottomLeft(),
-                false);
-            g.setGradientFill(handleGradient);
-            g.fillRoundedRectangle(thumbBounds, 3.0f);
-
-            // Handle detail lines
-            g.setColour(juce::Colours::black.withAlpha(0.2f));
-            float lineSpacing = 4.0f;
-            int numLines = 3;
-            float startY = thumbBounds.getCentreY() - (numLines - 1) * lineSpacing * 0.5f;
+            const auto handleX = juce::roundToInt(limitedSliderPos - handleWidth * 0.5f);
+            const auto handleY = (height - handleHeight) * 0.5f;
 
-            for (int i = 0; i < numLines; ++i)
-            {
-                float lineY = startY + i * lineSpacing;
-                g.drawHorizontalLine(static_cast<int>(lineY),
-                    thumbBounds.getX() + 5.0f,
-                    thumbBounds.getRight() - 5.0f);
-            }
+            // The area takes in the shadow below the handle
+            assets.draw(g, { crossfaderHandle, 0, 0, 1.0f, thumbColour.getARGB() },
+                        { handleX, y, (int) handleWidth, height + 1 },
+                        [=] (juce::Graphics& ag)
+                        {
+                            drawCrossfaderHandle(ag, { 0.0f, handleY, handleWidth, handleHeight }, thumbColour);
+                        });
         }
         else
         {
@@ -150,48 +115,34 @@ public:
             const float trackHeight = 4.0f;
             auto trackBounds = bounds.withHeight(trackHeight).withY(height * 0.5f - trackHeight * 0.5f);
             
-            // Draw track background with subtle gradient
-            juce::ColourGradient trackGradient(
-                findColour(juce::Slider::trackColourId).brighter(0.1f),
-                trackBounds.getTopLeft(),
-                findColour(juce::Slider::trackColourId).darker(0.1f),
-                trackBounds.getBottomLeft(),
-                false);
-            g.setGradientFill(trackGradient);
-            g.fillRoundedRectangle(trackBounds, 2.0f);
+            // Track background, drawn from the whole pixel above it
+            const auto trackArea = trackBounds.getSmallestIntegerContainer();
+            const auto trackOffset = trackBounds.getPosition() - trackArea.getPosition().toFloat();
+
+            assets.draw(g, { linearTrack, 0, 0, 1.0f, trackColour.getARGB() }, trackArea,
+                        [=] (juce::Graphics& ag) { drawLinearTrack(ag, trackBounds.withPosition(trackOffset), trackColour); });
             
             // Draw filled portion of track
             if (style == juce::Slider::LinearHorizontal)
             {
                 auto filledTrack = trackBounds.withWidth(sliderPos - x);
-                g.setColour(findColour(juce::Slider::thumbColourId));
+                g.setColour(thumbColour);
                 g.fillRoundedRectangle(filledTrack, 2.0f);
             }
 
-            // Thumb
+            // Thumb, at whole pixels so one image serves every position; its
+            // area takes in the border and the shadow below
             auto thumbRect = juce::Rectangle<float>(
-                sliderPos - thumbWidth * 0.5f,
+                (float) juce::roundToInt(sliderPos - thumbWidth * 0.5f),
                 height * 0.5f - thumbHeight * 0.5f,
                 thumbWidth,
                 thumbHeight);
 
-            // Simple shadow
-            g.setColour(juce::Colours::black.withAlpha(0.2f));
-            g.fillRoundedRectangle(thumbRect.translated(0, 1), 2.0f);
-
-            // Thumb with subtle gradient
-            juce::ColourGradient thumbGradient(
-                findColour(juce::Slider::thumbColourId).brighter(0.1f),
-                thumbRect.getTopLeft(),
-                findColour(juce::Slider::thumbColourId).darker(0.1f),
-                thumbRect.getBottomLeft(),
-                false);
-            g.setGradientFill(thumbGradient);
-            g.fillRoundedRectangle(thumbRect, 2.0f);
-            
-            // Thumb border
-            g.setColour(findColour(juce::Slider::thumbColourId).darker(0.2f));
-            g.drawRoundedRectangle(thumbRect, 2.0f, 1.0f);
+            const auto thumbArea = thumbRect.withHeight(thumbHeight + 1.0f).expanded(1.0f).getSmallestIntegerContainer();
+            const auto thumbOffset = thumbRect.getPosition() - thumbArea.getPosition().toFloat();
+
+            assets.draw(g, { linearThumb, 0, 0, 1.0f, thumbColour.getARGB() }, thumbArea,
+                        [=] (juce::Graphics& ag) { drawLinearThumb(ag, thumbRect.withPosition(thumbOffset), thumbColour); });
         }
     }
 
@@ -207,25 +158,22 @@ public:
         const auto thumbColor = findColour(juce::Slider::thumbColourId);
         const auto trackColor = findColour(juce::Slider::trackColourId);
 
-        // Draw background
-        auto dialBounds = juce::Rectangle<float>(centreX - radius, centreY - radius, radius * 2, radius * 2);
-        g.setColour(trackColor);
-        g.fillEllipse(dialBounds);
-
-        // Draw track
-        g.setColour(thumbColor.withAlpha(0.3f));
         auto lineW = juce::jmin(4.0f, radius * 0.1f);
         auto arcRadius = radius - lineW * 1.5f;
 
-        juce::Path backgroundArc;
-        backgroundArc.addCentredArc(centreX, centreY, arcRadius, arcRadius,
-                                  0.0f, rotaryStartAngle, rotaryEndAngle, true);
-        g.strokePath(backgroundArc, juce::PathStrokeType(lineW));
+        // Dial, track and center dot
+        assets.draw(g, { rotaryBackground, 0, 0, 1.0f, thumbColor.getARGB(), trackColor.getARGB(), rotaryStartAngle, rotaryEndAngle },
+                    { x, y, width, height },
+                    [=] (juce::Graphics& ag)
+                    {
+                        drawRotaryBackground(ag, centreX - x, centreY - y, radius, rotaryStartAngle, rotaryEndAngle, thumbColor, trackColor);
+                    });
 
         // Draw value arc
+        g.setColour(thumbColor);
+
         if (rotaryStartAngle < angle)
         {
-            g.setColour(thumbColor);
             juce::Path valueArc;
             valueArc.addCentredArc(centreX, centreY, arcRadius, arcRadius,
                                  0.0f, rotaryStartAngle, angle, true);
@@ -239,13 +187,7 @@ public:
         p.addRectangle(-pointerThickness * 0.5f, -radius + lineW * 2,
                       pointerThickness, pointerLength);
         p.applyTransform(juce::AffineTransform::rotation(angle).translated(centreX, centreY));
-        g.setColour(thumbColor);
         g.fillPath(p);
-
-        // Draw center dot
-        auto dotRadius = radius * 0.1f;
-        g.setColour(thumbColor);
-        g.fillEllipse(centreX - dotRadius, centreY - dotRadius, dotRadius * 2, dotRadius * 2);
     }
 
     void drawComboBox (juce::Graphics& g, int width, int height, bool isButtonDown, int buttonX, int buttonY, int buttonW, int buttonH, juce::ComboBox& box) override
@@ -387,4 +329,135 @@ public:
         g.setColour(juce::Colours::white);
         textLayout.draw(g, juce::Rectangle<float>(textArea.toFloat()));
     }
-};
\ No newline at end of file
+
+    /** The pre-rendered slider and knob parts, for benchmarks and tests. */
+    const RenderedAssetCache& getAssetCache() const noexcept { return assets; }
+
+private:
+    enum Asset
+    {
+        crossfaderGroove = 1,
+        crossfaderHandle,
+        linearTrack,
+        linearThumb,
+        rotaryBackground
+    };
+
+    RenderedAssetCache assets;
+
+    static void drawCrossfaderGroove (juce::Graphics& g, float width, float height, juce::Colour thumbColour, juce::Colour trackColour)
+    {
+        // Calculate groove dimensions
+        auto grooveWidth = width * 0.8f;
+        auto grooveHeight = 3.0f;  // Slightly thinner
+        auto grooveBounds = juce::Rectangle<float> (
+            (width - grooveWidth) * 0.5f,
+            (height - grooveHeight) * 0.5f,
+            grooveWidth,
+            grooveHeight);
+
+        // Draw groove with subtle gradient
+        juce::ColourGradient grooveGradient(
+            trackColour.brighter(0.1f),
+            grooveBounds.getTopLeft(),
+            trackColour.darker(0.1f),
+            grooveBounds.getBottomLeft(),
+            false);
+        g.setGradientFill(grooveGradient);
+        g.fillRoundedRectangle(grooveBounds, 1.5f);
+
+        // Center marker
+        float centerX = width * 0.5f;
+        g.setColour(thumbColour.withAlpha(0.3f));
+        g.drawVerticalLine(static_cast<int>(centerX), grooveBounds.getY(), grooveBounds.getBottom());
+    }
+
+    static void drawCrossfaderHandle (juce::Graphics& g, juce::Rectangle<float> thumbBounds, juce::Colour thumbColour)
+    {
+        // Simple shadow
+        g.setColour(juce::Colours::black.withAlpha(0.2f));
+        g.fillRoundedRectangle(thumbBounds.translated(0, 1), 3.0f);
+
+        // Handle with subtle gradient
+        juce::ColourGradient handleGradient(
+            thumbColour.brighter(0.1f),
+            thumbBounds.getTopLeft(),
+            thumbColour.darker(0.1f),
+            thumbBounds.getBottomLeft(),
+            false);
+        g.setGradientFill(handleGradient);
+        g.fillRoundedRectangle(thumbBounds, 3.0f);
+
+        // Handle detail lines
+        g.setColour(juce::Colours::black.withAlpha(0.2f));
+        float lineSpacing = 4.0f;
+        int numLines = 3;
+        float startY = thumbBounds.getCentreY() - (numLines - 1) * lineSpacing * 0.5f;
+
+        for (int i = 0; i < numLines; ++i)
+        {
+            float lineY = startY + i * lineSpacing;
+            g.drawHorizontalLine(static_cast<int>(lineY),
+                thumbBounds.getX() + 5.0f,
+                thumbBounds.getRight() - 5.0f);
+        }
+    }
+
+    static void drawLinearTrack (juce::Graphics& g, juce::Rectangle<float> trackBounds, juce::Colour trackColour)
+    {
+        // Draw track background with subtle gradient
+        juce::ColourGradient trackGradient(
+            trackColour.brighter(0.1f),
+            trackBounds.getTopLeft(),
+            trackColour.darker(0.1f),
+            trackBounds.getBottomLeft(),
+            false);
+        g.setGradientFill(trackGradient);
+        g.fillRoundedRectangle(trackBounds, 2.0f);
+    }
+
+    static void drawLinearThumb (juce::Graphics& g, juce::Rectangle<float> thumbRect, juce::Colour thumbColour)
+    {
+        // Simple shadow
+        g.setColour(juce::Colours::black.withAlpha(0.2f));
+        g.fillRoundedRectangle(thumbRect.translated(0, 1), 2.0f);
+
+        // Thumb with subtle gradient
+        juce::ColourGradient thumbGradient(
+            thumbColour.brighter(0.1f),
+            thumbRect.getTopLeft(),
+            thumbColour.darker(0.1f),
+            thumbRect.getBottomLeft(),
+            false);
+        g.setGradientFill(thumbGradient);
+        g.fillRoundedRectangle(thumbRect, 2.0f);
+        
+        // Thumb border
+        g.setColour(thumbColour.darker(0.2f));
+        g.drawRoundedRectangle(thumbRect, 2.0f, 1.0f);
+    }
+
+    static void drawRotaryBackground (juce::Graphics& g, float centreX, float centreY, float radius,
+                                      float rotaryStartAngle, float rotaryEndAngle, juce::Colour thumbColor, juce::Colour trackColor)
+    {
+        // Draw background
+        auto dialBounds = juce::Rectangle<float>(centreX - radius, centreY - radius, radius * 2, radius * 2);
+        g.setColour(trackColor);
+        g.fillEllipse(dialBounds);
+
+        // Draw track
+        g.setColour(thumbColor.withAlpha(0.3f));
+        auto lineW = juce::jmin(4.0f, radius * 0.1f);
+        auto arcRadius = radius - lineW * 1.5f;
+
+        juce::Path backgroundArc;
+        backgroundArc.addCentredArc(centreX, centreY, arcRadius, arcRadius,
+                                  0.0f, rotaryStartAngle, rotaryEndAngle, true);
+        g.strokePath(backgroundArc, juce::PathStrokeType(lineW));
+
+        // Draw center dot; the pointer is drawn over it, in the same colour
+        auto dotRadius = radius * 0.1f;
+        g.setColour(thumbColor);
+        g.fillEllipse(centreX - dotRadius, centreY - dotRadius, dotRadius * 2, dotRadius * 2);
+    }
+};
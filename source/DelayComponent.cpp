@@ -46,8 +46,16 @@ DelayComponent::DelayComponent(tracktion::engine::Edit& edit)
     contentComponent.addAndMakeVisible(timeLabel);
     contentComponent.addAndMakeVisible(noteValueBox);
 
-    // Create and setup plugin
-    plugin = EngineHelpers::getPluginFromRack(edit, AutoDelayPlugin::xmlTypeName);
+    mixRamp.onValueChange = [this](float value) {
+        mixSlider.setValue(value, juce::sendNotification);
+    };
+
+    bindToEdit();
+}
+
+void DelayComponent::bindToEdit()
+{
+    plugin = EngineHelpers::getPluginFromRack(*edit, AutoDelayPlugin::xmlTypeName);
     
     if (plugin != nullptr)
     {
@@ -65,10 +73,6 @@ DelayComponent::DelayComponent(tracktion::engine::Edit& edit)
             updateDelayTimeFromNote();
         }
     }
-
-    mixRamp.onValueChange = [this](float value) {
-        mixSlider.setValue(value, juce::sendNotification);
-    };
 }
 
 void DelayComponent::resized()
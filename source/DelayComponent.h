@@ -24,6 +24,9 @@ public:
     void rampMixLevel(bool rampUp);
     void setTempo(double newTempo) { tempo = newTempo; updateDelayTimeFromNote(); }
 
+protected:
+    void bindToEdit() override;
+
 private:
     RotarySliderComponent feedbackSlider { "Feedback" };
     RotarySliderComponent mixSlider { "Mix" };
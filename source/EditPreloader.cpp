@@ -0,0 +1,177 @@
+#include "EditPreloader.h"
+
+namespace te = tracktion::engine;
+
+//==============================================================================
+struct EditPreloader::Job
+{
+    std::atomic<bool> cancelled { false };
+    std::unique_ptr<te::Edit> edit;
+};
+
+//==============================================================================
+EditPreloader::EditPreloader (te::Engine& e) : engine (e)
+{
+}
+
+EditPreloader::~EditPreloader()
+{
+    clear();
+    pool.removeAllJobs (true, 10000);
+}
+
+void EditPreloader::preload (te::ProjectItem::Ptr item)
+{
+    clear();
+
+    if (item == nullptr)
+        return;
+
+    // Resolve everything that needs the ProjectManager here, on the message thread
+    const auto editFile = item->getSourceFile();
+    itemID = item->getID();
+    state = State::loading;
+
+    auto job = std::make_shared<Job>();
+    currentJob = job;
+
+    pool.addJob ([&eng = engine, job, editFile, id = itemID, weakThis = juce::WeakReference<EditPreloader> (this)]
+    {
+        // Replaced while it waited behind an earlier load
+        if (job->cancelled)
+            return;
+
+        auto edit = loadEdit (eng, editFile, id, *job);
+
+        if (edit != nullptr && ! job->cancelled)
+            readAheadSources (*edit, *job);
+
+        job->edit = std::move (edit);
+
+        // Edits own message-thread objects, so even a cancelled one is handed
+        // back there to be deleted
+        juce::MessageManager::callAsync ([weakThis, job]
+        {
+            if (auto* preloader = weakThis.get())
+                preloader->jobFinished (job);
+            else
+                job->edit = nullptr;
+        });
+    });
+
+    sendChangeMessage();
+}
+
+void EditPreloader::clear()
+{
+    if (currentJob != nullptr)
+        currentJob->cancelled = true;
+
+    currentJob = nullptr;
+    loadedEdit = nullptr;
+    itemID = {};
+
+    if (state != State::empty)
+    {
+        state = State::empty;
+        sendChangeMessage();
+    }
+}
+
+std::unique_ptr<te::Edit> EditPreloader::takeEdit()
+{
+    if (state != State::ready)
+        return {};
+
+    auto edit = std::move (loadedEdit);
+    clear();
+    return edit;
+}
+
+void EditPreloader::jobFinished (std::shared_ptr<Job> job)
+{
+    if (job != currentJob || job->cancelled)
+    {
+        job->edit = nullptr;
+        return;
+    }
+
+    currentJob = nullptr;
+    loadedEdit = std::move (job->edit);
+
+    if (loadedEdit == nullptr)
+    {
+        state = State::failed;
+        sendChangeMessage();
+        return;
+    }
+
+    // Building the playback graph talks to the device manager, so it's done
+    // here rather than on the loader thread. The transport stays stopped.
+    loadedEdit->getTransport().ensureContextAllocated();
+
+    state = State::ready;
+    sendChangeMessage();
+}
+
+//==============================================================================
+std::unique_ptr<te::Edit> EditPreloader::loadEdit (te::Engine& engine, const juce::File& editFile,
+                                                   te::ProjectItemID id, const Job& job)
+{
+    if (! editFile.existsAsFile())
+    {
+        DBG ("EditPreloader: missing Edit file " + editFile.getFullPathName());
+        return {};
+    }
+
+    auto editState = te::loadEditFromFile (engine, editFile, id);
+
+    if (! editState.isValid() || job.cancelled)
+        return {};
+
+    auto options = te::Edit::Options { engine };
+    options.editState = editState;
+    options.editProjectItemID = id;
+    options.numUndoLevelsToStore = 0;
+    options.role = te::Edit::forEditing;
+
+    auto edit = te::Edit::createEdit (std::move (options));
+
+    if (edit == nullptr)
+        DBG ("EditPreloader: failed to create Edit from " + editFile.getFullPathName());
+
+    return edit;
+}
+
+void EditPreloader::readAheadSources (te::Edit& edit, const Job& job)
+{
+    juce::Array<juce::File> files;
+
+    for (auto track : te::getAudioTracks (edit))
+        for (auto clip : track->getClips())
+            if (auto waveClip = dynamic_cast<te::WaveAudioClip*> (clip))
+                files.addIfNotAlreadyThere (waveClip->getAudioFile().getFile());
+
+    juce::HeapBlock<char> chunk (1024 * 1024);
+
+    for (auto& file : files)
+    {
+        // Caches the file's format info in the engine as well
+        te::AudioFile (edit.engine, file).getInfo();
+
+        juce::FileInputStream in (file);
+
+        if (! in.openedOk())
+            continue;
+
+        for (juce::int64 total = 0; total < readAheadBytes && ! job.cancelled;)
+        {
+            const auto bytesRead = in.read (chunk.get(), 1024 * 1024);
+
+            if (bytesRead <= 0)
+                break;
+
+            total += bytesRead;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <tracktion_engine/tracktion_engine.h>
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+    Loads one library Edit in the background so switching to it only swaps the
+    Edit and rebinds the components. The old Edit is stopped before the new one
+    starts, so a mid-set switch is quick but leaves a short gap.
+
+    The slot holds at most one Edit. preload() replaces it, cancelling any load
+    in flight. The background job does the slow parts:
+    - reads and parses the Edit file
+    - constructs the Edit
+    - reads ahead through the clips' source audio, so the first seconds come
+      from the OS cache rather than the disk
+
+    Back on the message thread the Edit's playback graph is allocated, the slot
+    becomes ready and a change message is sent. takeEdit() then hands the
+    Edit over with nothing left to do.
+*/
+class EditPreloader : public juce::ChangeBroadcaster
+{
+public:
+    enum class State
+    {
+        empty,
+        loading,
+        ready,
+        failed
+    };
+
+    explicit EditPreloader (tracktion::engine::Engine&);
+    ~EditPreloader() override;
+
+    /** Starts loading the Edit for a library item into the slot. */
+    void preload (tracktion::engine::ProjectItem::Ptr item);
+
+    /** Empties the slot, cancelling a load in progress. */
+    void clear();
+
+    State getState() const noexcept                         { return state; }
+    tracktion::engine::ProjectItemID getItemID() const      { return itemID; }
+    bool holds (tracktion::engine::ProjectItemID id) const  { return state != State::empty && itemID == id; }
+
+    /** Returns the loaded Edit and empties the slot, or nullptr if it isn't ready. */
+    std::unique_ptr<tracktion::engine::Edit> takeEdit();
+
+    /** Bytes of source audio read ahead per file. */
+    static constexpr juce::int64 readAheadBytes = 32 * 1024 * 1024;
+
+private:
+    struct Job;
+
+    tracktion::engine::Engine& engine;
+    juce::ThreadPool pool { 1 };
+
+    std::shared_ptr<Job> currentJob;
+    std::unique_ptr<tracktion::engine::Edit> loadedEdit;
+    tracktion::engine::ProjectItemID itemID;
+    State state = State::empty;
+
+    void jobFinished (std::shared_ptr<Job>);
+
+    static std::unique_ptr<tracktion::engine::Edit> loadEdit (tracktion::engine::Engine&, const juce::File& editFile,
+                                                              tracktion::engine::ProjectItemID, const Job&);
+    static void readAheadSources (tracktion::engine::Edit&, const Job&);
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (EditPreloader)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditPreloader)
+};
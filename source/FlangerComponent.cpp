@@ -40,8 +40,16 @@ FlangerComponent::FlangerComponent(tracktion::engine::Edit &edit)
     contentComponent.addAndMakeVisible(widthSlider);
     contentComponent.addAndMakeVisible(mixSlider);
 
-    // Create and setup plugin
-    plugin = EngineHelpers::getPluginFromRack(edit, FlangerPlugin::xmlTypeName);
+    mixRamp.onValueChange = [this](float value) {
+        mixSlider.setValue(value, juce::sendNotification);
+    };
+
+    bindToEdit();
+}
+
+void FlangerComponent::bindToEdit()
+{
+    plugin = EngineHelpers::getPluginFromRack(*edit, FlangerPlugin::xmlTypeName);
 
     if (plugin != nullptr)
     {
@@ -74,10 +82,6 @@ FlangerComponent::FlangerComponent(tracktion::engine::Edit &edit)
         else
             DBG("Mix parameter not found");
     }
-
-    mixRamp.onValueChange = [this](float value) {
-        mixSlider.setValue(value, juce::sendNotification);
-    };
 }
 
 void FlangerComponent::resized()
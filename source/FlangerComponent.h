@@ -26,6 +26,9 @@ public:
     void setMix(float value);
     void rampMixLevel(bool rampUp);
 
+protected:
+    void bindToEdit() override;
+
 private:
     RotarySliderComponent depthSlider { "Depth" };
     RotarySliderComponent speedSlider { "Speed" };
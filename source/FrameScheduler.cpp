@@ -0,0 +1,182 @@
+#include "FrameScheduler.h"
+#include "UIProfiler.h"
+#include <algorithm>
+#include <utility>
+
+FrameScheduler::FrameScheduler() = default;
+
+FrameScheduler::~FrameScheduler()
+{
+    cancelPendingUpdate();
+    stop();
+}
+
+void FrameScheduler::setDisplayComponent (juce::Component* component)
+{
+    if (displayComponent == component)
+        return;
+
+    displayComponent = component;
+
+    // Move any running frames over to the new display
+    if (isRunning())
+    {
+        stop();
+        start();
+    }
+}
+
+//==============================================================================
+void FrameScheduler::startAnimating (Client& client)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (! isAnimating (client))
+        animating.push_back (&client);
+
+    start();
+}
+
+void FrameScheduler::stopAnimating (Client& client)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    std::erase (animating, &client);
+    std::erase (oneShot, &client);
+
+    // A client can stop (or be deleted) while the current frame is calling others
+    std::replace (calling.begin(), calling.end(), &client, static_cast<Client*> (nullptr));
+}
+
+bool FrameScheduler::isAnimating (const Client& client) const
+{
+    return std::find (animating.begin(), animating.end(), &client) != animating.end();
+}
+
+void FrameScheduler::requestFrame (Client& client)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (std::find (oneShot.begin(), oneShot.end(), &client) == oneShot.end())
+        oneShot.push_back (&client);
+
+    start();
+}
+
+//==============================================================================
+void FrameScheduler::invalidate (juce::Component& component)
+{
+    invalidate (component, component.getLocalBounds());
+
+    for (auto& i : invalid)
+        if (i.component == &component)
+            i.wholeComponent = true;
+}
+
+void FrameScheduler::invalidate (juce::Component& component, juce::Rectangle<int> area)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    auto existing = std::find_if (invalid.begin(), invalid.end(), [&] (const Invalidation& i) { return i.component == &component; });
+
+    if (existing != invalid.end())
+        existing->area = existing->area.getUnion (area);
+    else
+        invalid.push_back ({ &component, area, false });
+
+    start();
+}
+
+//==============================================================================
+FrameScheduler::Stats FrameScheduler::getStats() const
+{
+    auto result = stats;
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    result.wakeupsInLastSecond = (int) std::count_if (recentFrames.begin(), recentFrames.end(), [now] (double t) { return t > now - 1000.0; });
+    return result;
+}
+
+void FrameScheduler::start()
+{
+    if (isRunning())
+        return;
+
+    if (displayComponent != nullptr && displayComponent->isShowing())
+        vBlank = std::make_unique<juce::VBlankAttachment> (displayComponent.getComponent(), [this] { runFrame(); });
+    else
+        startTimerHz (fallbackFrameRate);
+}
+
+void FrameScheduler::stop()
+{
+    vBlank = nullptr;
+    stopTimer();
+}
+
+void FrameScheduler::runFrame()
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+
+    UIProfiler::instance().beginFrame (now);
+    const UIProfiler::ScopedTimer profile ("FrameScheduler::runFrame");
+
+    ++stats.frames;
+    recentFrames.push_back (now);
+
+    while (recentFrames.front() < now - 1000.0)
+        recentFrames.pop_front();
+
+    // Everything animating, plus anything that asked for a single frame
+    calling = animating;
+
+    for (auto* client : oneShot)
+        if (std::find (calling.begin(), calling.end(), client) == calling.end())
+            calling.push_back (client);
+
+    oneShot.clear();
+
+    for (size_t i = 0; i < calling.size(); ++i)
+    {
+        if (auto* client = calling[i])
+        {
+            client->frameCallback (now);
+            ++stats.clientCallbacks;
+        }
+    }
+
+    calling.clear();
+
+    // Then one repaint per component, however many times it was invalidated
+    for (auto& i : std::exchange (invalid, {}))
+    {
+        if (auto* component = i.component.getComponent())
+        {
+            if (i.wholeComponent)
+                component->repaint();
+            else
+                component->repaint (i.area);
+
+            ++stats.repaints;
+        }
+    }
+
+    // The timer started before the window was on screen hands over to the vblank
+    if (isTimerRunning() && displayComponent != nullptr && displayComponent->isShowing())
+    {
+        stopTimer();
+        vBlank = std::make_unique<juce::VBlankAttachment> (displayComponent.getComponent(), [this] { runFrame(); });
+    }
+
+    // The vblank attachment can't be deleted from its own callback, so detaching
+    // (when idle, or when the window has gone) happens just after
+    if (! hasWork() || (vBlank != nullptr && (displayComponent == nullptr || ! displayComponent->isShowing())))
+        triggerAsyncUpdate();
+}
+
+void FrameScheduler::handleAsyncUpdate()
+{
+    stop();
+
+    if (hasWork())
+        start();
+}
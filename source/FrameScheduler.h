@@ -0,0 +1,102 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <deque>
+#include <vector>
+
+//==============================================================================
+/**
+    Drives the UI's animation from the display's refresh.
+
+    Anything that changes every frame (the playhead, the time display, the
+    chop crossfade, ramps and springs) registers as a Client while it's moving
+    and unregisters when it stops, and all the clients are called back from
+    the same vblank. Repaints asked for through invalidate() are merged and
+    issued once per frame, after the clients have run.
+
+    When no client is animating and nothing is waiting to repaint, the
+    scheduler detaches from the display, so an idle UI causes no wakeups.
+
+    Frames follow the vblank of the window holding the display component (see
+    setDisplayComponent). Without one on screen, e.g. in tests or with the
+    window minimised, a timer at fallbackFrameRate stands in.
+
+    Message thread only. Shared through juce::SharedResourcePointer.
+*/
+class FrameScheduler : private juce::Timer,
+                       private juce::AsyncUpdater
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        /** Called once per frame while the client is animating, or once after
+            requestFrame(). timeMs is on the Time::getMillisecondCounterHiRes() clock.
+        */
+        virtual void frameCallback (double timeMs) = 0;
+    };
+
+    FrameScheduler();
+    ~FrameScheduler() override;
+
+    /** The component whose window's vblank drives the frames (the main component). */
+    void setDisplayComponent (juce::Component*);
+
+    /** Calls the client back every frame until stopAnimating(). */
+    void startAnimating (Client&);
+    void stopAnimating (Client&);
+    bool isAnimating (const Client&) const;
+
+    /** Calls the client back once, on the next frame. */
+    void requestFrame (Client&);
+
+    /** Repaints the component (or an area of it) on the next frame. */
+    void invalidate (juce::Component&);
+    void invalidate (juce::Component&, juce::Rectangle<int> area);
+
+    /** Frames run so far, and how many ran in the last second. Each frame is one
+        message-thread wakeup, however many clients and repaints it served.
+    */
+    struct Stats
+    {
+        juce::int64 frames = 0;
+        juce::int64 clientCallbacks = 0;
+        juce::int64 repaints = 0;
+        int wakeupsInLastSecond = 0;
+    };
+
+    Stats getStats() const;
+
+    bool isRunning() const noexcept                     { return vBlank != nullptr || isTimerRunning(); }
+
+    static constexpr int fallbackFrameRate = 60;
+
+private:
+    struct Invalidation
+    {
+        juce::Component::SafePointer<juce::Component> component;
+        juce::Rectangle<int> area;
+        bool wholeComponent = false;
+    };
+
+    juce::Component::SafePointer<juce::Component> displayComponent;
+    std::unique_ptr<juce::VBlankAttachment> vBlank;
+
+    std::vector<Client*> animating, oneShot, calling;
+    std::vector<Invalidation> invalid;
+
+    Stats stats;
+    std::deque<double> recentFrames;
+
+    bool hasWork() const noexcept                       { return ! animating.empty() || ! oneShot.empty() || ! invalid.empty(); }
+    void start();
+    void stop();
+    void runFrame();
+
+    void timerCallback() override                       { runFrame(); }
+    void handleAsyncUpdate() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FrameScheduler)
+};
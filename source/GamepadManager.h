@@ -3,6 +3,7 @@
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
 #include <SDL3/SDL.h>
+#include "UIProfiler.h"
 #include <thread>
 #include <atomic>
 #include <mutex>
@@ -45,7 +46,11 @@ protected:
     // New method to safely dispatch UI updates
     template<typename Callback>
     void dispatchToUI(Callback&& callback) {
-        juce::MessageManager::callAsync(std::forward<Callback>(callback));
+        juce::MessageManager::callAsync([callback = std::forward<Callback>(callback)]() mutable
+        {
+            const UIProfiler::ScopedTimer profile ("GamepadManager::dispatchToUI");
+            callback();
+        });
     }
 
 private:
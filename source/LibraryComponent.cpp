@@ -9,62 +9,25 @@
 */
 
 #include "LibraryComponent.h"
-#include "minibpm.h"
+#include "Analysis/TrackAnalysis.h"
+#include "UIProfiler.h"
+#include "LibrarySnapshot.h"
 
+struct LibraryComponent::Import
+{
+    juce::File file;
+    TrackAnalysis analysis;
+    bool decoded = false;
+    juce::int64 fileHash = 0;
+};
+
+//==============================================================================
 LibraryComponent::LibraryComponent (te::Engine& engineToUse)
     : engine (engineToUse)
 {
-    // Create or load the library project
-    auto projectFile = juce::File::getSpecialLocation (juce::File::userMusicDirectory)
-                           .getChildFile ("ChopShop")
-                           .getChildFile ("Library.tracktion");
-
-    // Create the directory if it doesn't exist
-    auto projectDir = juce::File::getSpecialLocation (juce::File::userMusicDirectory).getChildFile ("ChopShop");
-    bool dirCreated = projectDir.createDirectory();
-    DBG ("Project directory creation result: " + juce::String (dirCreated ? "Success" : "Failed") + " Path: " + projectDir.getFullPathName());
-
-    // Get or create the library project
-    libraryProject = engine.getProjectManager().getProject (projectFile);
-    if (libraryProject == nullptr || !libraryProject->isValid())
-    {
-        DBG ("Attempting to create new project at: " + projectFile.getFullPathName());
-        libraryProject = engine.getProjectManager().createNewProject (projectFile);
-        if (libraryProject != nullptr)
-        {
-            libraryProject->createNewProjectId();
-            libraryProject->setName ("ChopShop Library");
-            libraryProject->setDescription ("Created: " + juce::Time::getCurrentTime().toString (true, false));
-
-            if (libraryProject->save())
-            {
-                DBG ("Created and saved new ChopShop Library project at: " + projectFile.getFullPathName());
-            }
-            else
-            {
-                DBG ("Failed to save project!");
-            }
-        }
-        else
-        {
-            DBG ("Failed to create new project!");
-        }
-    }
-    else
-    {
-        DBG ("Loaded existing ChopShop Library project from: " + projectFile.getFullPathName());
-        DBG ("Project contains " + juce::String (libraryProject->getNumProjectItems()) + " items");
-
-        // Log the items in the project
-        for (int i = 0; i < libraryProject->getNumProjectItems(); ++i)
-        {
-            auto item = libraryProject->getProjectItemAt (i);
-            if (item != nullptr)
-            {
-                DBG ("  Item " + juce::String (i) + ": " + item->getName() + " (BPM: " + juce::String (item->getNamedProperty ("bpm").getFloatValue(), 1) + ", File: " + item->getSourceFile().getFileName() + ")");
-            }
-        }
-    }
+    projectFile = juce::File::getSpecialLocation (juce::File::userMusicDirectory)
+                      .getChildFile ("ChopShop")
+                      .getChildFile ("Library.tracktion");
 
     // Set up add file button
     addFileButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xFF505050));      // Medium gray
@@ -84,19 +47,48 @@ LibraryComponent::LibraryComponent (te::Engine& engineToUse)
     editBpmButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
     editBpmButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
     editBpmButton.onClick = [this]() {
-        auto selectedRow = playlistTable->getSelectedRow();
-        if (selectedRow >= 0)
-        {
-            showBpmEditorWindow(selectedRow);
-        }
+        whenProjectLoaded(playlistTable->getSelectedRow(), [this](auto projectItem) {
+            showBpmEditorWindow(libraryIndex.getRowForID(projectItem->getID()));
+        });
     };
     addAndMakeVisible(editBpmButton);
 
+    // Set up cue next button
+    cueNextButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xFF505050));      // Medium gray
+    cueNextButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    cueNextButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    cueNextButton.onClick = [this]() {
+        whenProjectLoaded(playlistTable->getSelectedRow(), [this](auto projectItem) {
+            cueProjectItem(projectItem);
+        });
+    };
+    addAndMakeVisible(cueNextButton);
+
+    // Set up search box; filters the table as you type
+    searchBox.setTextToShowWhenEmpty("Search names, keys or a BPM range like 120-128", juce::Colour(0xFF808080));
+    searchBox.setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xFF1E1E1E));     // Surface color
+    searchBox.setColour(juce::TextEditor::textColourId, juce::Colours::white);               // White text
+    searchBox.setColour(juce::TextEditor::outlineColourId, juce::Colour(0xFF505050));       // Medium gray
+    searchBox.setColour(juce::TextEditor::focusedOutlineColourId, juce::Colour(0xFF707070)); // Light gray accent
+    searchBox.onTextChange = [this]() {
+        libraryIndex.setFilter(searchBox.getText());
+        updateTable();
+    };
+    searchBox.onEscapeKey = [this]() { searchBox.clear(); };
+    addAndMakeVisible(searchBox);
+
+    preloader.addChangeListener(this);
+    loader.addChangeListener(this);
+    persistence.onSave = [this]() { saveLibrary(); };
+
     // Set up playlist table with modern styling
     playlistTable = std::make_unique<juce::TableListBox>();
     playlistTable->setModel(this);
     playlistTable->getHeader().addColumn("Name", 1, 300);
     playlistTable->getHeader().addColumn("BPM", 2, 100);
+    playlistTable->getHeader().addColumn("Duration", 3, 100);
+    playlistTable->getHeader().addColumn("Key", 4, 100);
+    playlistTable->getHeader().addColumn("Added", 5, 150);
     playlistTable->getHeader().setStretchToFitActive(true);
     
     // Modern dark theme colors
@@ -129,20 +121,25 @@ LibraryComponent::LibraryComponent (te::Engine& engineToUse)
     };
 
     removeFileButton.onClick = [this]() {
-        auto selectedRow = playlistTable->getSelectedRow();
-        if (selectedRow >= 0)
-        {
-            removeFromLibrary (selectedRow);
-        }
+        whenProjectLoaded (playlistTable->getSelectedRow(), [this] (auto projectItem) {
+            // The row may have moved while the Project was loading
+            removeFromLibrary (libraryIndex.getRowForID (projectItem->getID()));
+        });
     };
 
-    // Load existing library
+    // Show the library from its snapshot; the Project itself is loaded later
     loadLibrary();
 }
 
 LibraryComponent::~LibraryComponent()
 {
-    // No need to explicitly save as the Project class handles this
+    preloader.removeChangeListener(this);
+    loader.removeChangeListener(this);
+    stopTimer();
+    importer.removeAllJobs (true, 10000);
+
+    // Writes out a save that's still waiting for its window to close
+    persistence.flush();
 }
 
 void LibraryComponent::paint(juce::Graphics& g)
@@ -160,7 +157,8 @@ void LibraryComponent::resized()
     auto bounds = getLocalBounds();
     auto buttonHeight = 30;
 
-    // Playlist table takes all space except bottom button area
+    // Search box along the top, table in between, buttons along the bottom
+    searchBox.setBounds (bounds.removeFromTop (buttonHeight).reduced (2));
     auto buttonArea = bounds.removeFromBottom (buttonHeight);
     playlistTable->setBounds (bounds.reduced (2));
 
@@ -168,12 +166,13 @@ void LibraryComponent::resized()
     addFileButton.setBounds (buttonArea.removeFromLeft (100).reduced (2));
     removeFileButton.setBounds (buttonArea.removeFromLeft (100).reduced (2));
     editBpmButton.setBounds (buttonArea.removeFromLeft (100).reduced (2));
+    cueNextButton.setBounds (buttonArea.removeFromLeft (100).reduced (2));
 }
 
 // TableListBoxModel implementations
 int LibraryComponent::getNumRows()
 {
-    return libraryProject ? libraryProject->getNumProjectItems() : 0;
+    return libraryIndex.getNumRows();
 }
 
 void LibraryComponent::paintRowBackground(juce::Graphics& g, int rowNumber, int width, int height, bool rowIsSelected)
@@ -183,52 +182,77 @@ void LibraryComponent::paintRowBackground(juce::Graphics& g, int rowNumber, int
         // Use a more subtle selection color
         g.fillAll(juce::Colour(0xFF505050).withAlpha(0.3f));     // Medium gray with transparency
     }
+
+    // Mark the cued item: amber while it loads, green once it can be swapped in
+    auto entry = libraryIndex.getEntryForRow(rowNumber);
+    if (entry >= 0 && preloader.holds(libraryIndex.getID(entry)))
+    {
+        auto colour = preloader.getState() == EditPreloader::State::ready ? juce::Colour(0xFF00FF41)
+                    : preloader.getState() == EditPreloader::State::failed ? juce::Colour(0xFFFF4545)
+                    : juce::Colour(0xFFFFB445);
+        g.setColour(colour);
+        g.fillRect(0, 0, 3, height);
+    }
 }
 
 void LibraryComponent::paintCell(juce::Graphics& g, int rowNumber, int columnId, int width, int height, bool rowIsSelected)
 {
-    if (!libraryProject || rowNumber >= libraryProject->getNumProjectItems())
-        return;
-
-    auto projectItem = libraryProject->getProjectItemAt(rowNumber);
-    if (projectItem == nullptr)
+    auto entry = libraryIndex.getEntryForRow(rowNumber);
+    if (entry < 0)
         return;
 
     // Use white text color for better contrast
     g.setColour(juce::Colours::white);
 
-    if (columnId == 1) // Name column
-        g.drawText(projectItem->getName(), 2, 0, width - 4, height, juce::Justification::centredLeft);
-    else if (columnId == 2) // BPM column
-        g.drawText(juce::String(projectItem->getNamedProperty("bpm").getFloatValue(), 1), 2, 0, width - 4, height, juce::Justification::centred);
+    switch ((LibraryIndex::Column) columnId)
+    {
+        case LibraryIndex::Column::name:
+            g.drawText(libraryIndex.getName(entry), 2, 0, width - 4, height, juce::Justification::centredLeft);
+            break;
+
+        case LibraryIndex::Column::bpm:
+            g.drawText(juce::String(libraryIndex.getBpm(entry), 1), 2, 0, width - 4, height, juce::Justification::centred);
+            break;
+
+        case LibraryIndex::Column::duration:
+            if (auto seconds = juce::roundToInt(libraryIndex.getDuration(entry)); seconds > 0)
+                g.drawText(juce::String(seconds / 60) + ":" + juce::String(seconds % 60).paddedLeft('0', 2),
+                           2, 0, width - 4, height, juce::Justification::centred);
+            break;
+
+        case LibraryIndex::Column::key:
+            if (auto key = MusicalKey::fromName(libraryIndex.getKey(entry)); key.isValid())
+                g.drawText(key.getName() + " (" + key.getCamelotCode() + ")", 2, 0, width - 4, height, juce::Justification::centred);
+            else
+                g.drawText(libraryIndex.getKey(entry), 2, 0, width - 4, height, juce::Justification::centred);
+            break;
+
+        case LibraryIndex::Column::dateAdded:
+            if (auto added = libraryIndex.getDateAdded(entry); added > 0)
+                g.drawText(juce::Time(added).formatted("%Y-%m-%d %H:%M"), 2, 0, width - 4, height, juce::Justification::centred);
+            break;
+    }
 }
 
 void LibraryComponent::cellDoubleClicked (int rowNumber, int columnId, const juce::MouseEvent&)
 {
-    if (!libraryProject || rowNumber >= libraryProject->getNumProjectItems())
-        return;
-
-    auto projectItem = libraryProject->getProjectItemAt (rowNumber);
-    if (projectItem != nullptr && onEditSelected)
-    {
-        if (auto edit = loadEditFromProjectItem (projectItem))
-            onEditSelected (std::move (edit));
-    }
+    whenProjectLoaded (rowNumber, [this] (auto projectItem) { playProjectItem (projectItem); });
 }
 
 void LibraryComponent::cellClicked (int rowNumber, int columnId, const juce::MouseEvent& event)
 {
-    if (event.mods.isRightButtonDown() && libraryProject && rowNumber < libraryProject->getNumProjectItems())
+    if (event.mods.isRightButtonDown())
     {
-        auto projectItem = libraryProject->getProjectItemAt (rowNumber);
+        auto projectItem = getProjectItemForRow (rowNumber);
         if (projectItem == nullptr)
             return;
 
         juce::PopupMenu menu;
         menu.addItem (1, "Show in Finder");
         menu.addItem (2, "Remove");
+        menu.addItem (3, "Cue Next");
 
-        menu.showMenuAsync (juce::PopupMenu::Options(), [this, rowNumber, projectItem] (int result) {
+        menu.showMenuAsync (juce::PopupMenu::Options(), [this, projectItem] (int result) {
             if (result == 1) // Show in Finder
             {
                 juce::File file (projectItem->getSourceFile());
@@ -237,23 +261,30 @@ void LibraryComponent::cellClicked (int rowNumber, int columnId, const juce::Mou
             }
             else if (result == 2) // Remove
             {
-                removeFromLibrary (rowNumber);
+                // The row may have moved while the menu was open
+                removeFromLibrary (libraryIndex.getRowForID (projectItem->getID()));
+            }
+            else if (result == 3) // Cue Next
+            {
+                cueProjectItem (projectItem);
             }
         });
     }
 }
 
+void LibraryComponent::selectedRowsChanged (int lastRowSelected)
+{
+    auto entry = libraryIndex.getEntryForRow (lastRowSelected);
+    selectedID = entry >= 0 ? libraryIndex.getID (entry) : te::ProjectItemID();
+}
+
 void LibraryComponent::sortOrderChanged (int newSortColumnId, bool isForwards)
 {
-    if (newSortColumnId != sortedColumnId || isForwards != sortedForward)
-    {
-        sortedColumnId = newSortColumnId;
-        sortedForward = isForwards;
+    if (newSortColumnId == 0)
+        return;
 
-        // We can't directly sort the project items, so we'll need to reload the table
-        // after sorting is changed
-        playlistTable->updateContent();
-    }
+    libraryIndex.setSortOrder ((LibraryIndex::Column) newSortColumnId, isForwards);
+    updateTable();
 }
 
 void LibraryComponent::createPluginRack(std::unique_ptr<tracktion::engine::Edit>& edit)
@@ -262,7 +293,8 @@ void LibraryComponent::createPluginRack(std::unique_ptr<tracktion::engine::Edit>
     {
         tracktion::engine::Plugin::Array plugins;
 
-        auto reverbPlugin = EngineHelpers::createPlugin(*edit, tracktion::engine::ReverbPlugin::xmlTypeName);
+        // The Auto* effects suspend themselves while they're off or fed silence
+        auto reverbPlugin = EngineHelpers::createPlugin(*edit, AutoReverbPlugin::xmlTypeName);
         reverbPlugin->remapOnTempoChange.setValue(true, nullptr);
         plugins.add (reverbPlugin);
 
@@ -292,58 +324,157 @@ void LibraryComponent::createPluginRack(std::unique_ptr<tracktion::engine::Edit>
 
 void LibraryComponent::addToLibrary (const juce::File& file)
 {
-    if (!libraryProject)
+    if (!file.existsAsFile())
     {
-        DBG ("Error: No library project available");
+        DBG ("Error: File does not exist: " + file.getFullPathName());
         return;
     }
 
-    if (!file.existsAsFile())
+    // Decoding takes seconds, so the file is analysed and hashed on the import
+    // thread, and the Edit and project item are made back on the message thread
+    importer.addJob ([file, safeThis = juce::Component::SafePointer<LibraryComponent> (this)]
     {
-        DBG ("Error: File does not exist: " + file.getFullPathName());
+        auto imported = std::make_shared<Import>();
+        imported->file = file;
+
+        auto shouldCancel = [job = juce::ThreadPoolJob::getCurrentThreadPoolJob()] { return job->shouldExit(); };
+
+        // One decode of the file feeds every analysis
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        if (std::unique_ptr<juce::AudioFormatReader> reader { formatManager.createReaderFor (file) })
+        {
+            imported->analysis = TrackAnalysis::analyse (*reader, shouldCancel);
+            imported->decoded = true;
+        }
+
+        if (shouldCancel())
+            return;
+
+        imported->fileHash = LibraryIndex::hashFile (file);
+
+        juce::MessageManager::callAsync ([safeThis, imported]
+        {
+            if (auto* library = safeThis.getComponent())
+                library->finishImport (*imported);
+        });
+    });
+}
+
+void LibraryComponent::finishImport (const Import& imported)
+{
+    if (!projectIsLoaded)
+    {
+        // Added once the Project is ready; the table already shows the snapshot
+        whenProjectLoaded ([this, imported] { finishImport (imported); });
+        return;
+    }
+
+    const UIProfiler::ScopedTimer profile ("LibraryComponent::finishImport");
+
+    auto project = getLibraryProject();
+    if (!project)
+    {
+        DBG ("Error: No library project available");
         return;
     }
 
-    // Calculate BPM first
-    float detectedBPM = 120.0f; // Default BPM
+    const auto& file = imported.file;
+    const auto& analysis = imported.analysis;
+    const auto detectedBPM = analysis.bpm > 0 ? analysis.bpm : 120.0f; // Default BPM
 
-    juce::AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();
+    // Level the track with the rest of the library, and start both decks on the
+    // first downbeat with the silence either side left out
+    ClipSettings settings;
+    settings.gainDecibels = analysis.getNormalisationGain();
+    settings.tempoMap = analysis.tempoMap;
 
-    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (file));
-    if (reader)
+    if (imported.decoded)
     {
-        // Create MiniBPM detector
-        breakfastquay::MiniBPM bpmDetector (reader->sampleRate);
-        bpmDetector.setBPMRange (60, 180); // typical range for music
+        settings.start = analysis.firstDownbeat;
+        settings.end = analysis.duration - analysis.trailingSilence;
+    }
 
-        // Process audio in chunks
-        const int blockSize = 1024;
-        juce::AudioBuffer<float> buffer (1, blockSize);
-        std::vector<float> samples (blockSize);
+    auto edit = createEditForAudioFile (engine, file, detectedBPM, settings);
+    if (!edit)
+        return;
 
-        for (int pos = 0; pos < reader->lengthInSamples; pos += blockSize)
-        {
-            const int numSamples = std::min (blockSize,
-                static_cast<int> (reader->lengthInSamples - pos));
+    // Create a file path for the edit in the library project directory
+    auto editFileName = file.getFileNameWithoutExtension() + ".tracktionedit";
+    auto editFile = project->getDefaultDirectory().getChildFile (editFileName);
+
+    // Serialised here and written on the persistence thread, so importing a
+    // folder doesn't stall the message thread on a save per file. Cueing or
+    // playing the item waits for the write if it hasn't landed yet.
+    edit->flushState();
+    auto editXml = edit->state.createXml();
+    if (editXml == nullptr)
+    {
+        DBG ("Error: Failed to serialise edit");
+        return;
+    }
 
-            reader->read (&buffer, 0, numSamples, pos, true, false);
-            memcpy (samples.data(), buffer.getReadPointer (0), numSamples * sizeof (float));
+    juce::MemoryOutputStream editData;
+    editXml->writeTo (editData);
+    persistence.writeFile (editFile, editData.getMemoryBlock());
 
-            bpmDetector.process (samples.data(), numSamples);
-        }
+    // Saves from the main window go to the same file
+    edit->editFileRetriever = [editFile] { return editFile; };
+    edit->resetChangedStatus();
+
+    DBG ("Edit queued for saving to: " + editFile.getFullPathName());
+
+    onEditSelected (std::move (edit));
 
-        float tempBPM = bpmDetector.estimateTempo();
-        if (tempBPM > 0)
-            detectedBPM = tempBPM;
+    // Add the Edit file to the project
+    auto projectItem = project->createNewItem (editFile,
+        te::ProjectItem::editItemType(),
+        file.getFileNameWithoutExtension(),
+        {},
+        te::ProjectItem::Category::edit,
+        true);
+
+    if (projectItem)
+    {
+        // Store BPM and the other indexed fields as properties on the project item too
+        LibraryIndex::Entry entry;
+        entry.id = projectItem->getID();
+        entry.name = projectItem->getName();
+        entry.bpm = detectedBPM;
+        entry.key = analysis.key.getName();
+        entry.duration = analysis.duration;
+        entry.dateAdded = juce::Time::currentTimeMillis();
+        entry.fileHash = imported.fileHash;
+        LibraryIndex::storeEntryProperties (*projectItem, entry);
+
+        // Loudness isn't indexed, but is kept so the gain can be re-derived later
+        if (std::isfinite (analysis.loudness))
+            projectItem->setNamedProperty ("loudness", juce::String (analysis.loudness, 2));
+
+        projectItem->setNamedProperty ("truePeak", juce::String (analysis.truePeak, 2));
+        projectItem->setNamedProperty ("gain", juce::String (settings.gainDecibels, 2));
+
+        libraryIndex.update (entry);
+        updateTable();
+
+        // Saved with anything else imported in the same batch
+        persistence.markChanged();
     }
+    else
+    {
+        DBG ("Error: Failed to create project item");
+    }
+}
 
+std::unique_ptr<tracktion::engine::Edit> LibraryComponent::createEditForAudioFile (te::Engine& engineToUse, const juce::File& file, float detectedBPM, const ClipSettings& settings)
+{
     // Calculate beat duration in seconds
     double beatDuration = 60.0 / detectedBPM;
 
     // Create a new Edit for this file
-    auto options = te::Edit::Options {engine};
-    options.editState = te::createEmptyEdit (engine);
+    auto options = te::Edit::Options {engineToUse};
+    options.editState = te::createEmptyEdit (engineToUse);
     options.editProjectItemID = te::ProjectItemID::fromProperty (options.editState, te::IDs::projectID);
     options.numAudioTracks = 2;
     options.role = te::Edit::forEditing;
@@ -352,9 +483,20 @@ void LibraryComponent::addToLibrary (const juce::File& file)
     if (!edit)
     {
         DBG ("Error: Failed to create edit");
-        return;
+        return {};
     }
 
+    // The tempo sequence follows the track from where the clips start, drift included
+    const auto tempoMap = settings.tempoMap.points.empty() ? TempoMap::steady (detectedBPM) : settings.tempoMap;
+    const auto editTempoMap = tempoMap.startingAt (settings.start);
+
+    edit->state.setProperty ("bpm", detectedBPM, nullptr);
+
+    if (! editTempoMap.isSteady())
+        edit->state.setProperty ("tempoMap", editTempoMap.toString(), nullptr);
+
+    EngineHelpers::setTempo (*edit, detectedBPM);
+
     // Get the insert point at the end of all tracks
     auto insertPoint = TrackInsertPoint::getEndOfTracks(*edit);
 
@@ -367,7 +509,7 @@ void LibraryComponent::addToLibrary (const juce::File& file)
         chopTrack->getOutput().setOutputToDefaultDevice(true);
     } else {
         DBG ("Error: Failed to create chop track");
-        return;
+        return {};
     }
     // add chop plugin to master plugin list
     // Should use PluginCache::createNewPlugin to create the ones you add here
@@ -380,7 +522,7 @@ void LibraryComponent::addToLibrary (const juce::File& file)
         chopTrack->pluginList.insertPlugin(chopPlugin, -1, nullptr);
     } else {
         DBG ("Error: Failed to create chop plugin");
-        return;
+        return {};
     }
 
     createPluginRack(edit);
@@ -393,7 +535,7 @@ void LibraryComponent::addToLibrary (const juce::File& file)
         {
             DBG ("Setup track " + juce::String (trackIndex + 1));
             // Get the audio file length
-            te::AudioFile audioFile (engine, file);
+            te::AudioFile audioFile (engineToUse, file);
             if (!audioFile.isValid())
             {
                 DBG ("Error: Invalid audio file");
@@ -403,9 +545,19 @@ void LibraryComponent::addToLibrary (const juce::File& file)
             auto fileLength = audioFile.getLength();
             DBG ("Audio file length: " + juce::String (fileLength) + " seconds");
 
+            // Only the audible part of the file is played, and so stretched: the clip
+            // is as many beats long as the file has between start and end, and its
+            // offset (in auto-tempo time, a beat per 60 / detectedBPM seconds) skips
+            // everything before the start
+            const auto start = juce::jlimit (0.0, fileLength, settings.start);
+            const auto end = settings.end > start ? juce::jmin (settings.end, fileLength) : fileLength;
+            const auto startBeat = tempoMap.getBeatAt (start);
+            const auto clipLength = edit->tempoSequence.toTime (tracktion::BeatPosition::fromBeats (tempoMap.getBeatAt (end) - startBeat));
+
             // Create clip position
-            auto timeRange = tracktion::TimeRange (tracktion::TimePosition(), tracktion::TimePosition::fromSeconds (fileLength));
-            auto position = tracktion::engine::createClipPosition (edit->tempoSequence, timeRange, tracktion::TimeDuration::fromSeconds (trackIndex == 0 ? 0.0 : beatDuration));
+            auto timeRange = tracktion::TimeRange (tracktion::TimePosition(), clipLength);
+            auto position = tracktion::engine::createClipPosition (edit->tempoSequence, timeRange,
+                                                                   tracktion::TimeDuration::fromSeconds (startBeat * beatDuration + (trackIndex == 0 ? 0.0 : beatDuration)));
 
             DBG ("Clip position: " + juce::String (position.time.getStart().inSeconds()) + " to " + juce::String (position.time.getEnd().inSeconds()));
             DBG ("Clip offset: " + juce::String (position.offset.inSeconds()));
@@ -420,7 +572,7 @@ void LibraryComponent::addToLibrary (const juce::File& file)
             if (!clip)
             {
                 DBG ("Failed to create clip for track " + juce::String (trackIndex + 1));
-                return;
+                return {};
             }
 
             DBG ("Created clip for track " + juce::String (trackIndex + 1) + " with BPM: " + juce::String (detectedBPM) + " and beat duration: " + juce::String (beatDuration) + " at position: " + juce::String (position.time.getStart().inSeconds()) + " to " + juce::String (position.time.getEnd().inSeconds()));
@@ -431,6 +583,29 @@ void LibraryComponent::addToLibrary (const juce::File& file)
             clip->setUsesProxy (false);
             clip->setAutoTempo (true);
             clip->getLoopInfo().setBpm (detectedBPM, clip->getAudioFile().getInfo());
+            clip->setGainDB (settings.gainDecibels);
+
+            // Auto-tempo plays the source as if it were steady at detectedBPM, so a
+            // drifting track is first warped steady: each tempo map point's beat
+            // lands where it would at detectedBPM. The tempo sequence then puts the
+            // drift back, and the grid lines up with the beats as played.
+            if (! tempoMap.isSteady())
+            {
+                clip->setWarpTime (true);
+                auto& warpTime = clip->getWarpTimeManager();
+                warpTime.removeAllMarkers();
+
+                auto steadyTime = [&] (double sourceTime)
+                {
+                    return tracktion::TimePosition::fromSeconds (tempoMap.getBeatAt (sourceTime) * 60.0 / detectedBPM);
+                };
+
+                for (auto& point : tempoMap.points)
+                    warpTime.insertMarker (te::WarpMarker (tracktion::TimePosition::fromSeconds (point.time), steadyTime (point.time)));
+
+                warpTime.insertMarker (te::WarpMarker (tracktion::TimePosition::fromSeconds (fileLength), steadyTime (fileLength)));
+                warpTime.setWarpEndMarkerTime (steadyTime (fileLength));
+            }
 
             // Flush clip state to ValueTree
             clip->flushStateToValueTree();
@@ -445,112 +620,268 @@ void LibraryComponent::addToLibrary (const juce::File& file)
     if (!clipsCreated)
     {
         DBG ("Error: No clips were created successfully");
-        return;
+        return {};
     }
 
-    // Store BPM in the Edit's ValueTree
-    edit->state.setProperty ("bpm", detectedBPM, nullptr);
+    // Where the clips start and stop in the file, for views of the source
+    edit->state.setProperty ("sourceStart", settings.start, nullptr);
+    edit->state.setProperty ("sourceEnd", settings.end, nullptr);
 
     DBG ("Edit created");
+    return edit;
+}
 
-    // Create a file path for the edit in the library project directory
-    auto editFileName = file.getFileNameWithoutExtension() + ".tracktionedit";
-    auto editFile = libraryProject->getDefaultDirectory().getChildFile (editFileName);
+void LibraryComponent::removeFromLibrary (int rowNumber)
+{
+    auto projectItem = getProjectItemForRow (rowNumber);
+    if (projectItem == nullptr)
+        return;
+
+    auto projectItemID = projectItem->getID();
+
+    if (preloader.holds (projectItemID))
+        preloader.clear();
+
+    if (loader.holds (projectItemID))
+        loader.clear();
 
-    // Save the edit to disk
-    if (!te::EditFileOperations (*edit).saveAs (editFile, true))
+    DBG ("Removing item from library: " + projectItem->getName() + " (ID: " + projectItemID.toString() + ")");
+
+    libraryProject->removeProjectItem (projectItemID, false); // false = don't delete source material
+    libraryIndex.remove (projectItemID);
+    persistence.markChanged();
+    updateTable();
+
+    DBG ("Library now contains " + juce::String (libraryIndex.size()) + " items");
+}
+
+void LibraryComponent::loadLibrary()
+{
+    // A snapshot that's newer than the project file is shown straight away, and
+    // the Project is loaded and checked against it a slice at a time afterwards
+    if (auto entries = LibrarySnapshot::read (LibrarySnapshot::getFileFor (projectFile), projectFile))
     {
-        DBG ("Error: Failed to save edit file");
-        return;
+        libraryIndex.build (std::move (*entries));
+        snapshotIsCurrent = true;
+        DBG ("Library loaded from snapshot with " + juce::String (libraryIndex.size()) + " items");
     }
-
-    if (!editFile.exists())
+    else
     {
-        throw std::runtime_error (("Failed to save edit file: " + editFile.getFullPathName()).toStdString());
+        libraryIndex.clear();
+        snapshotIsCurrent = false;
+        DBG ("No usable library snapshot, loading the Project");
     }
 
-    DBG ("Edit saved to: " + editFile.getFullPathName());
+    auto& header = playlistTable->getHeader();
+    libraryIndex.setSortOrder ((LibraryIndex::Column) header.getSortColumnId(), header.isSortedForwards());
+    updateTable();
 
-    onEditSelected (std::move (edit));
+    libraryProject = nullptr;
+    projectIsLoaded = false;
+    reconciledEntries.clear();
+    reconcilePosition = 0;
+    startTimer (snapshotIsCurrent ? 500 : 1);
+}
 
-    // Add the Edit file to the project
-    auto projectItem = libraryProject->createNewItem (editFile,
-        te::ProjectItem::editItemType(),
-        file.getFileNameWithoutExtension(),
-        {},
-        te::ProjectItem::Category::edit,
-        true);
+te::Project* LibraryComponent::getLibraryProject()
+{
+    return projectIsLoaded ? libraryProject.get() : nullptr;
+}
 
-    if (projectItem)
-    {
-        // Store BPM as a property on the project item too
-        projectItem->setNamedProperty ("bpm", juce::String (detectedBPM));
+void LibraryComponent::openLibraryProject()
+{
+    const UIProfiler::ScopedTimer profile ("LibraryComponent::openLibraryProject");
+
+    // Create the directory if it doesn't exist
+    auto projectDir = projectFile.getParentDirectory();
+    bool dirCreated = projectDir.createDirectory();
+    DBG ("Project directory creation result: " + juce::String (dirCreated ? "Success" : "Failed") + " Path: " + projectDir.getFullPathName());
 
-        // Save the project to ensure the item is persisted
-        if (libraryProject->save())
+    // Get or create the library project
+    libraryProject = engine.getProjectManager().getProject (projectFile);
+    if (libraryProject == nullptr || !libraryProject->isValid())
+    {
+        DBG ("Attempting to create new project at: " + projectFile.getFullPathName());
+        libraryProject = engine.getProjectManager().createNewProject (projectFile);
+        if (libraryProject != nullptr)
         {
-            DBG ("Project saved successfully with new item");
-            playlistTable->updateContent();
-            playlistTable->repaint();
+            libraryProject->createNewProjectId();
+            libraryProject->setName ("ChopShop Library");
+            libraryProject->setDescription ("Created: " + juce::Time::getCurrentTime().toString (true, false));
+
+            if (libraryProject->save())
+            {
+                DBG ("Created and saved new ChopShop Library project at: " + projectFile.getFullPathName());
+            }
+            else
+            {
+                DBG ("Failed to save project!");
+            }
         }
         else
         {
-            DBG ("Error: Failed to save project");
+            DBG ("Failed to create new project!");
         }
     }
     else
     {
-        DBG ("Error: Failed to create project item");
+        DBG ("Loaded existing ChopShop Library project from: " + projectFile.getFullPathName());
     }
 }
 
-void LibraryComponent::removeFromLibrary (int index)
+void LibraryComponent::saveLibrary()
 {
-    if (!libraryProject || index < 0 || index >= libraryProject->getNumProjectItems())
+    if (libraryProject == nullptr)
+        return;
+
+    // tracktion's Project writes its own file and belongs to the message thread,
+    // so it's saved here, once for everything that changed in the window. The
+    // snapshot is serialised after it, so it's stamped with the file just written,
+    // and written behind like the Edits.
+    if (!libraryProject->save())
+    {
+        DBG ("Failed to save the library project");
         return;
+    }
 
-    auto projectItem = libraryProject->getProjectItemAt (index);
-    auto projectItemID = libraryProject->getProjectItemID (index);
+    writeSnapshot();
+}
 
-    if (projectItem != nullptr)
+void LibraryComponent::writeSnapshot()
+{
+    persistence.writeFile (LibrarySnapshot::getFileFor (projectFile), LibrarySnapshot::serialise (libraryIndex, projectFile));
+    snapshotIsCurrent = true;
+}
+
+void LibraryComponent::timerCallback()
+{
+    // The first slice may have waited for the window to come up; the rest follow on quickly
+    startTimer (1);
+
+    if (libraryProject != nullptr)
     {
-        DBG ("Removing item from library: " + projectItem->getName() + " (ID: " + projectItemID.toString() + ")");
+        reconcileWithProject (itemsPerReconcileSlice);
+        return;
     }
 
-    libraryProject->removeProjectItem (projectItemID, false); // false = don't delete source material
-    libraryProject->save();
-    playlistTable->updateContent();
+    openLibraryProject();
 
-    DBG ("Library now contains " + juce::String (libraryProject->getNumProjectItems()) + " items");
+    // Nothing to reconcile against; what was deferred finds no Project and gives up
+    if (libraryProject == nullptr)
+        projectLoaded();
 }
 
-void LibraryComponent::loadLibrary()
+void LibraryComponent::reconcileWithProject (int maxItems)
 {
-    // The project is already loaded in the constructor
-    playlistTable->updateContent();
+    const UIProfiler::ScopedTimer profile ("LibraryComponent::reconcileWithProject");
+
+    const auto numItems = libraryProject->getNumProjectItems();
+    const auto end = reconcilePosition + juce::jmin (maxItems, numItems - reconcilePosition);
+
+    for (; reconcilePosition < end; ++reconcilePosition)
+        if (auto item = libraryProject->getProjectItemAt (reconcilePosition))
+            reconciledEntries.push_back (LibraryIndex::createEntry (*item));
+
+    if (reconcilePosition < numItems)
+        return;
+
+    bool matchesIndex = (int) reconciledEntries.size() == libraryIndex.size();
 
-    // Log the current state of the library
-    if (libraryProject)
+    for (int i = 0; matchesIndex && i < libraryIndex.size(); ++i)
+        matchesIndex = reconciledEntries[(size_t) i] == libraryIndex.getEntry (i);
+
+    if (!matchesIndex)
     {
-        DBG ("Library loaded with " + juce::String (libraryProject->getNumProjectItems()) + " items");
+        DBG ("Library snapshot was out of date, reloaded " + juce::String ((int) reconciledEntries.size()) + " items from the Project");
+        libraryIndex.build (std::move (reconciledEntries));
+        updateTable();
+        snapshotIsCurrent = false;
+    }
 
-        // Sort the items if needed
-        if (sortedColumnId != 0)
-        {
-            DBG ("Items are sorted by " + juce::String (sortedColumnId == 1 ? "Name" : "BPM") + (sortedForward ? " (ascending)" : " (descending)"));
-        }
+    reconciledEntries = {};
+
+    if (!snapshotIsCurrent)
+        writeSnapshot();
+
+    projectLoaded();
+}
+
+void LibraryComponent::projectLoaded()
+{
+    stopTimer();
+    projectIsLoaded = true;
+
+    // Imports, double-clicks and edits made while the Project was loading
+    auto deferred = std::exchange (deferredUntilLoaded, {});
+
+    for (auto& action : deferred)
+        action();
+}
+
+void LibraryComponent::whenProjectLoaded (std::function<void()> action)
+{
+    if (projectIsLoaded)
+    {
+        action();
+        return;
     }
+
+    // Someone's waiting on it, so the rest of the Project is read without the startup delay
+    deferredUntilLoaded.push_back (std::move (action));
+    startTimer (1);
+}
+
+void LibraryComponent::whenProjectLoaded (int rowNumber, std::function<void (te::ProjectItem::Ptr)> action)
+{
+    // The row may have moved by the time the Project is ready, so the item is found again by ID
+    auto entry = libraryIndex.getEntryForRow (rowNumber);
+    if (entry < 0)
+        return;
+
+    whenProjectLoaded ([this, id = libraryIndex.getID (entry), action = std::move (action)]
+    {
+        if (auto project = getLibraryProject())
+            if (auto projectItem = project->getProjectItemForID (id))
+                action (projectItem);
+    });
+}
+
+void LibraryComponent::updateTable()
+{
+    // The rows have already moved, so the selection is found again by ID
+    auto idToSelect = selectedID;
+    playlistTable->updateContent();
+
+    auto selectedRow = idToSelect.isValid() ? libraryIndex.getRowForID (idToSelect) : -1;
+    if (selectedRow >= 0)
+        playlistTable->selectRow (selectedRow, true, true);
+    else
+        playlistTable->deselectAllRows();
+
+    // Keep it, so it's selected again if a later filter shows it
+    selectedID = idToSelect;
+    playlistTable->repaint();
+}
+
+te::ProjectItem::Ptr LibraryComponent::getProjectItemForRow (int rowNumber)
+{
+    auto entry = libraryIndex.getEntryForRow (rowNumber);
+    if (entry < 0 || getLibraryProject() == nullptr)
+        return nullptr;
+
+    return libraryProject->getProjectItemForID (libraryIndex.getID (entry));
 }
 
-te::ProjectItem::Ptr LibraryComponent::getProjectItemForFile (const juce::File& file) const
+te::ProjectItem::Ptr LibraryComponent::getProjectItemForFile (const juce::File& file)
 {
-    if (!libraryProject)
+    auto project = getLibraryProject();
+    if (!project)
     {
         DBG ("getProjectItemForFile: No library project available");
         return nullptr;
     }
 
-    auto projectItem = libraryProject->getProjectItemForFile (file);
+    auto projectItem = project->getProjectItemForFile (file);
 
     if (projectItem != nullptr)
     {
@@ -564,26 +895,20 @@ te::ProjectItem::Ptr LibraryComponent::getProjectItemForFile (const juce::File&
     return projectItem;
 }
 
-void LibraryComponent::showBpmEditorWindow (int rowIndex)
+void LibraryComponent::showBpmEditorWindow (int rowNumber)
 {
-    DBG ("Opening BPM editor for row: " + juce::String (rowIndex));
+    DBG ("Opening BPM editor for row: " + juce::String (rowNumber));
 
-    if (!libraryProject)
+    if (!getLibraryProject())
     {
         DBG ("ERROR: No library project available");
         return;
     }
 
-    if (rowIndex < 0 || rowIndex >= libraryProject->getNumProjectItems())
-    {
-        DBG ("ERROR: Invalid row index: " + juce::String (rowIndex) + " (Project has " + juce::String (libraryProject->getNumProjectItems()) + " items)");
-        return;
-    }
-
-    auto projectItem = libraryProject->getProjectItemAt (rowIndex);
+    auto projectItem = getProjectItemForRow (rowNumber);
     if (projectItem == nullptr)
     {
-        DBG ("ERROR: Failed to get project item at index: " + juce::String (rowIndex));
+        DBG ("ERROR: Invalid row: " + juce::String (rowNumber) + " (Table has " + juce::String (libraryIndex.getNumRows()) + " rows)");
         return;
     }
 
@@ -669,10 +994,10 @@ void LibraryComponent::showBpmEditorWindow (int rowIndex)
                     {
                         projectItem->setNamedProperty("bpm", juce::String(newBpm));
 
-                        DBG("Saving project after BPM update...");
-                        libraryComponent.libraryProject->save();
+                        libraryComponent.libraryIndex.update(LibraryIndex::createEntry(*projectItem));
+                        libraryComponent.persistence.markChanged();
 
-                        libraryComponent.playlistTable->updateContent();
+                        libraryComponent.updateTable();
                         DBG("BPM updated successfully");
                     }
                     catch (const std::exception& e)
@@ -720,119 +1045,62 @@ void LibraryComponent::showBpmEditorWindow (int rowIndex)
     options.launchAsync();
 }
 
-std::unique_ptr<tracktion::engine::Edit> LibraryComponent::loadEditFromProjectItem(tracktion::engine::ProjectItem::Ptr projectItem)
+void LibraryComponent::cueProjectItem(tracktion::engine::ProjectItem::Ptr projectItem)
 {
-    DBG("=== Starting Edit Load Process ===");
-    
-    if (!projectItem)
-    {
-        DBG("ERROR: Project item is null");
-        return nullptr;
-    }
+    if (projectItem == nullptr || preloader.holds(projectItem->getID()))
+        return;
 
-    auto sourceFile = projectItem->getSourceFile();
-    DBG("Loading edit from: " + sourceFile.getFullPathName());
-    DBG("Project Item ID: " + projectItem->getID().toString());
+    // A just-imported item's Edit may still be queued for writing
+    persistence.waitForWrite(projectItem->getSourceFile());
 
-    if (!sourceFile.exists())
-    {
-        DBG("ERROR: Source file doesn't exist: " + sourceFile.getFullPathName());
-        return nullptr;
-    }
+    DBG("Cueing " + projectItem->getName());
+    preloader.preload(projectItem);
+}
 
-    // Load edit state
-    DBG("Loading edit state from project manager...");
-    auto editState = te::loadEditFromProjectManager(engine.getProjectManager(), projectItem->getID());
-    
-    if (!editState.isValid())
-    {
-        DBG("ERROR: Failed to load edit state");
-        return nullptr;
-    }
-    DBG("Edit state loaded successfully");
+void LibraryComponent::playProjectItem(tracktion::engine::ProjectItem::Ptr projectItem)
+{
+    if (projectItem == nullptr || !onEditSelected)
+        return;
 
-    // Create edit options
-    auto options = te::Edit::Options{engine};
-    options.editState = editState;
-    options.editProjectItemID = projectItem->getID();
-    options.numUndoLevelsToStore = 0;
-    options.role = te::Edit::forEditing;
+    pendingPlayID = projectItem->getID();
+    persistence.waitForWrite(projectItem->getSourceFile());
 
-    // Create edit
-    DBG("Creating edit from state...");
-    auto edit = te::Edit::createEdit(std::move(options));
-    
-    if (!edit)
-    {
-        DBG("ERROR: Failed to create edit");
-        return nullptr;
-    }
-    DBG("Edit created successfully");
+    // The cued Edit is used if it's this one; otherwise it stays cued. A failed
+    // load is retried; one in progress is left to finish.
+    if (!preloader.holds(pendingPlayID) || preloader.getState() == EditPreloader::State::failed)
+        if (!loader.holds(pendingPlayID) || loader.getState() == EditPreloader::State::failed)
+            loader.preload(projectItem);
 
-    // Debug edit contents
-    DBG("=== Edit Contents ===");
-    DBG("Edit ID: " + edit->getProjectItemID().toString());
-    DBG("Edit Name: " + edit->getName());
-    
-    // Debug tracks
-    auto audioTracks = te::getAudioTracks(*edit);
-    DBG("Number of audio tracks: " + juce::String(audioTracks.size()));
+    changeListenerCallback(nullptr);
+}
 
-    for (auto track : audioTracks)
-    {
-        DBG("--- Track: " + track->getName() + " (ID: " + track->state.getProperty("id").toString() + ") ---");
-        DBG("  Track type: " + track->state.getType().toString());
-        // DBG("  playSlotClips value: " + juce::String(track->playSlotClips.get()));
-        
-        // Debug clips
-        auto clips = track->getClips();
-        DBG("  Number of clips: " + juce::String(clips.size()));
-        
-        for (auto clip : clips)
-        {
-            DBG("    Clip: " + clip->getName());
-            DBG("    Start: " + juce::String(clip->getPosition().getStart().inSeconds()));
-            DBG("    Length: " + juce::String(clip->getPosition().getLength().inSeconds()));
-            DBG("    Source file: " + clip->getSourceFileReference().getFile().getFullPathName());
-        }
+void LibraryComponent::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    playlistTable->repaint();
 
-        // Debug clip slots
-        auto& clipSlots = track->getClipSlotList();
-        auto slots = clipSlots.getClipSlots();
-        DBG("  Number of clip slots: " + juce::String(slots.size()));
-        
-        for (auto slot : slots)
-        {
-            if (auto slotClip = slot->getClip())
-            {
-                DBG("    Slot clip: " + slotClip->getName());
-            }
-        }
-    }
+    if (!pendingPlayID.isValid())
+        return;
+
+    // A retry of a failed cue goes through the loader, so it's checked first
+    auto* slot = loader.holds(pendingPlayID) ? &loader
+               : preloader.holds(pendingPlayID) ? &preloader
+               : nullptr;
 
-    // Debug ValueTree structure
-    DBG("=== Edit State Structure ===");
-    std::function<void(const juce::ValueTree&, const juce::String&)> dumpTree = 
-        [&](const juce::ValueTree& tree, const juce::String& indent)
+    if (slot == nullptr)
+        return;
+
+    if (slot->getState() == EditPreloader::State::failed)
     {
-        DBG(indent + tree.getType().toString());
-        
-        // Print all properties
-        for (int i = 0; i < tree.getNumProperties(); ++i)
-        {
-            auto propName = tree.getPropertyName(i);
-            DBG(indent + "  " + propName.toString() + ": " + tree.getProperty(propName).toString());
-        }
-        
-        // Recursively print children
-        for (int i = 0; i < tree.getNumChildren(); ++i)
-            dumpTree(tree.getChild(i), indent + "  ");
-    };
-    
-    dumpTree(edit->state, "");
+        DBG("ERROR: Failed to load edit for " + pendingPlayID.toString());
+        pendingPlayID = {};
+    }
+    else if (slot->getState() == EditPreloader::State::ready)
+    {
+        pendingPlayID = {};
 
-    DBG("=== Edit Load Process Complete ===");
-    return edit;
+        if (auto edit = slot->takeEdit())
+            onEditSelected(std::move(edit));
+    }
 }
 
 // FileBrowserListener methods (no longer used but kept for interface)
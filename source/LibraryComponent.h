@@ -20,13 +20,19 @@
 #include "Plugins/AutoDelayPlugin.h"
 #include "Plugins/FlangerPlugin.h"
 #include "Plugins/AutoPhaserPlugin.h"
+#include "Plugins/AutoReverbPlugin.h"
 #include "Plugins/ScratchPlugin.h"
 #include "Utilities.h"
+#include "EditPreloader.h"
+#include "LibraryIndex.h"
+#include "LibraryPersistence.h"
 
 // We'll use ProjectItem instead of PlaylistEntry
 class LibraryComponent : public juce::Component,
                         public juce::FileBrowserListener,
-                        public juce::TableListBoxModel
+                        public juce::TableListBoxModel,
+                        private juce::ChangeListener,
+                        private juce::Timer
 {
 public:
     LibraryComponent(tracktion::engine::Engine& engineToUse);
@@ -47,11 +53,28 @@ public:
     void paintCell(juce::Graphics& g, int rowNumber, int columnId, int width, int height, bool rowIsSelected) override;
     void cellDoubleClicked(int rowNumber, int columnId, const juce::MouseEvent&) override;
     void cellClicked(int rowNumber, int columnId, const juce::MouseEvent& event) override;
+    void selectedRowsChanged(int lastRowSelected) override;
     void sortOrderChanged(int newSortColumnId, bool isForwards) override;
 
     std::function<void(std::unique_ptr<tracktion::engine::Edit>)> onEditSelected;
 
-    float getBPMForFile(const juce::File& file) const {
+    // How the clips are laid out from the file, mostly from its TrackAnalysis
+    struct ClipSettings
+    {
+        float gainDecibels = 0.0f;  // loudness normalisation applied to both wave clips
+        TempoMap tempoMap;          // a drifting map becomes the tempo sequence, with the clips warped to match
+        double start = 0.0;         // seconds into the file the clips start at, e.g. the first downbeat
+        double end = 0.0;           // seconds into the file they stop at; 0 plays to the end
+    };
+
+    // Builds the two-deck Edit (chop track + master plugin rack) used for every library item.
+    // Static so the benchmarks and tests can build identical Edits without a library.
+    static std::unique_ptr<tracktion::engine::Edit> createEditForAudioFile(tracktion::engine::Engine& engineToUse,
+                                                                           const juce::File& file, float detectedBPM,
+                                                                           const ClipSettings& settings = {});
+    static void createPluginRack(std::unique_ptr<tracktion::engine::Edit>& edit);
+
+    float getBPMForFile(const juce::File& file) {
         auto projectItem = getProjectItemForFile(file);
         if (projectItem != nullptr)
             return projectItem->getNamedProperty("bpm").getFloatValue();
@@ -59,27 +82,70 @@ public:
     }
 
 private:
+    // Analyses the file on the import thread, then adds it in finishImport()
     void addToLibrary(const juce::File& file);
-    void removeFromLibrary(int index);
+    struct Import;
+    void finishImport(const Import&);
+    void removeFromLibrary(int rowNumber);
     void loadLibrary();
-    void showBpmEditorWindow(int rowIndex);
-    void createPluginRack(std::unique_ptr<tracktion::engine::Edit>& edit);
+    tracktion::engine::Project* getLibraryProject(); // nullptr until the Project has been reconciled
+    void saveLibrary();
+    void writeSnapshot();
+    void showBpmEditorWindow(int rowNumber);
     
-    tracktion::engine::ProjectItem::Ptr getProjectItemForFile(const juce::File& file) const;
+    tracktion::engine::ProjectItem::Ptr getProjectItemForFile(const juce::File& file);
+    tracktion::engine::ProjectItem::Ptr getProjectItemForRow(int rowNumber);
+
+    // tracktion's Project belongs to the message thread, so it's opened and its
+    // items read a slice per timer tick, then replace the index if they don't
+    // match what the snapshot showed. Anything that needs the Project before
+    // then is deferred until projectLoaded().
+    void timerCallback() override;
+    void openLibraryProject();
+    void reconcileWithProject(int maxItems);
+    void projectLoaded();
+    void whenProjectLoaded(std::function<void()> action);
+    void whenProjectLoaded(int rowNumber, std::function<void(tracktion::engine::ProjectItem::Ptr)> action);
+
+    // Refreshes the table after the index changes, keeping the selected item selected
+    void updateTable();
     
-    std::unique_ptr<tracktion::engine::Edit> loadEditFromProjectItem(tracktion::engine::ProjectItem::Ptr projectItem);
+    // "Cue next" loads into the preloader's slot, and double-clicking the cued item
+    // hands over the already-built Edit. Any other item loads through its own
+    // slot, so a direct load doesn't throw the cued Edit away.
+    void cueProjectItem(tracktion::engine::ProjectItem::Ptr projectItem);
+    void playProjectItem(tracktion::engine::ProjectItem::Ptr projectItem);
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
     
     std::unique_ptr<juce::TableListBox> playlistTable;
     std::shared_ptr<juce::FileChooser> fileChooser;
     juce::TextButton addFileButton{"Add File"};
     juce::TextButton removeFileButton{"Remove File"};
     juce::TextButton editBpmButton{"Edit BPM"};
+    juce::TextButton cueNextButton{"Cue Next"};
+    juce::TextEditor searchBox;
     
     tracktion::engine::Engine& engine;
+    juce::File projectFile;
     tracktion::engine::Project::Ptr libraryProject;
-    
-    int sortedColumnId = 0;
-    bool sortedForward = true;
+    LibraryIndex libraryIndex;
+    bool snapshotIsCurrent = false;
+
+    static constexpr int itemsPerReconcileSlice = 250;
+    std::vector<LibraryIndex::Entry> reconciledEntries;
+    int reconcilePosition = 0;
+    bool projectIsLoaded = false;
+    std::vector<std::function<void()>> deferredUntilLoaded;
+
+    juce::ThreadPool importer { 1 };
+
+    // Project saves are batched; see saveLibrary()
+    LibraryPersistence persistence;
+    tracktion::engine::ProjectItemID selectedID;
+
+    EditPreloader preloader { engine };             // the cued item
+    EditPreloader loader { engine };                // double-clicked items that weren't cued
+    tracktion::engine::ProjectItemID pendingPlayID; // double-clicked, waiting for its slot
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryComponent)
 };
@@ -0,0 +1,426 @@
+#include "LibraryIndex.h"
+#include "Analysis/MusicalKey.h"
+#include <algorithm>
+#include <numeric>
+
+namespace te = tracktion::engine;
+
+//==============================================================================
+void LibraryIndex::build (te::Project& project)
+{
+    std::vector<Entry> entries;
+    entries.reserve ((size_t) project.getNumProjectItems());
+
+    for (int i = 0; i < project.getNumProjectItems(); ++i)
+        if (auto item = project.getProjectItemAt (i))
+            entries.push_back (createEntry (*item));
+
+    build (std::move (entries));
+}
+
+void LibraryIndex::build (std::vector<Entry> entries)
+{
+    ids.clear();
+    names.clear();
+    keys.clear();
+    nameKeys.clear();
+    keyKeys.clear();
+    bpms.clear();
+    durations.clear();
+    datesAdded.clear();
+    fileHashes.clear();
+    indexByID.clear();
+
+    ids.reserve (entries.size());
+    names.reserve (entries.size());
+    keys.reserve (entries.size());
+    nameKeys.reserve (entries.size());
+    keyKeys.reserve (entries.size());
+    bpms.reserve (entries.size());
+    durations.reserve (entries.size());
+    datesAdded.reserve (entries.size());
+    fileHashes.reserve (entries.size());
+    indexByID.reserve (entries.size());
+
+    for (auto& entry : entries)
+        append (entry);
+
+    entriesChanged();
+}
+
+void LibraryIndex::update (const Entry& entry)
+{
+    const auto index = indexOf (entry.id);
+
+    if (index < 0)
+    {
+        append (entry);
+    }
+    else
+    {
+        const auto i = (size_t) index;
+        names[i] = entry.name;
+        keys[i] = entry.key;
+        nameKeys[i] = entry.name.toLowerCase();
+        keyKeys[i] = entry.key.toLowerCase();
+        bpms[i] = entry.bpm;
+        durations[i] = entry.duration;
+        datesAdded[i] = entry.dateAdded;
+        fileHashes[i] = entry.fileHash;
+    }
+
+    entriesChanged();
+}
+
+void LibraryIndex::remove (te::ProjectItemID id)
+{
+    const auto index = indexOf (id);
+
+    if (index < 0)
+        return;
+
+    auto eraseAt = [index] (auto& column) { column.erase (column.begin() + index); };
+    eraseAt (ids);
+    eraseAt (names);
+    eraseAt (keys);
+    eraseAt (nameKeys);
+    eraseAt (keyKeys);
+    eraseAt (bpms);
+    eraseAt (durations);
+    eraseAt (datesAdded);
+    eraseAt (fileHashes);
+
+    indexByID.erase (id.getRawID());
+
+    for (auto i = (size_t) index; i < ids.size(); ++i)
+        indexByID[ids[i].getRawID()] = (int) i;
+
+    entriesChanged();
+}
+
+void LibraryIndex::clear()
+{
+    build (std::vector<Entry>());
+}
+
+LibraryIndex::Entry LibraryIndex::createEntry (te::ProjectItem& item)
+{
+    Entry entry;
+    entry.id = item.getID();
+    entry.name = item.getName();
+    entry.bpm = item.getNamedProperty ("bpm").getFloatValue();
+    entry.duration = item.getNamedProperty ("duration").getDoubleValue();
+    entry.key = item.getNamedProperty ("key");
+    entry.dateAdded = item.getNamedProperty ("dateAdded").getLargeIntValue();
+    entry.fileHash = item.getNamedProperty ("fileHash").getHexValue64();
+    return entry;
+}
+
+void LibraryIndex::storeEntryProperties (te::ProjectItem& item, const Entry& entry)
+{
+    item.setNamedProperty ("bpm", juce::String (entry.bpm));
+    item.setNamedProperty ("duration", juce::String (entry.duration, 3));
+    item.setNamedProperty ("key", entry.key);
+    item.setNamedProperty ("dateAdded", juce::String (entry.dateAdded));
+    item.setNamedProperty ("fileHash", juce::String::toHexString (entry.fileHash));
+}
+
+juce::int64 LibraryIndex::hashFile (const juce::File& file)
+{
+    juce::FileInputStream in (file);
+
+    if (! in.openedOk())
+        return 0;
+
+    // 64-bit FNV-1a
+    auto hash = (juce::uint64) 14695981039346656037ull;
+    constexpr int chunkSize = 1024 * 1024;
+    juce::HeapBlock<juce::uint8> chunk (chunkSize);
+
+    for (;;)
+    {
+        const auto bytesRead = in.read (chunk.get(), chunkSize);
+
+        if (bytesRead <= 0)
+            break;
+
+        for (int i = 0; i < bytesRead; ++i)
+        {
+            hash ^= chunk[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    // 0 means "unknown"
+    return hash != 0 ? (juce::int64) hash : 1;
+}
+
+int LibraryIndex::indexOf (te::ProjectItemID id) const
+{
+    const auto found = indexByID.find (id.getRawID());
+    return found != indexByID.end() ? found->second : -1;
+}
+
+LibraryIndex::Entry LibraryIndex::getEntry (int entry) const
+{
+    const auto i = (size_t) entry;
+    return { ids[i], names[i], bpms[i], durations[i], keys[i], datesAdded[i], fileHashes[i] };
+}
+
+std::span<const int> LibraryIndex::getEntriesInBpmRange (float minBpm, float maxBpm)
+{
+    const auto& order = getOrder (Column::bpm);
+
+    const auto first = std::lower_bound (order.begin(), order.end(), minBpm,
+                                         [this] (int entry, float bpm) { return bpms[(size_t) entry] < bpm; });
+    const auto last = std::upper_bound (first, order.end(), maxBpm,
+                                        [this] (float bpm, int entry) { return bpm < bpms[(size_t) entry]; });
+
+    return { first, last };
+}
+
+//==============================================================================
+void LibraryIndex::setSortOrder (Column column, bool forwards)
+{
+    if (column == sortColumn && forwards == sortForwards)
+        return;
+
+    sortColumn = column;
+    sortForwards = forwards;
+    updateRows();
+}
+
+void LibraryIndex::setFilter (const juce::String& text)
+{
+    if (text == filterText)
+        return;
+
+    auto newQuery = Query::parse (text);
+    const bool narrowing = ! query.isEmpty() && newQuery.narrows (query);
+
+    filterText = text;
+    query = std::move (newQuery);
+    refilter (narrowing);
+}
+
+int LibraryIndex::getEntryForRow (int row) const noexcept
+{
+    return juce::isPositiveAndBelow (row, getNumRows()) ? rows[(size_t) row] : -1;
+}
+
+int LibraryIndex::getRowForID (te::ProjectItemID id) const
+{
+    const auto entry = indexOf (id);
+
+    if (entry < 0)
+        return -1;
+
+    const auto found = std::find (rows.begin(), rows.end(), entry);
+    return found != rows.end() ? (int) std::distance (rows.begin(), found) : -1;
+}
+
+//==============================================================================
+LibraryIndex::Query LibraryIndex::Query::parse (const juce::String& text)
+{
+    Query q;
+
+    for (auto& token : juce::StringArray::fromTokens (text.toLowerCase(), " \t", ""))
+    {
+        if (token.isEmpty())
+            continue;
+
+        const auto low = token.upToFirstOccurrenceOf ("-", false, false);
+        const auto high = token.fromFirstOccurrenceOf ("-", false, false);
+        auto isNumber = [] (const juce::String& s) { return s.isNotEmpty() && s.containsOnly ("0123456789."); };
+
+        if (isNumber (low) && isNumber (high))
+        {
+            const auto a = low.getFloatValue(), b = high.getFloatValue();
+            q.bpmRanges.add ({ juce::jmin (a, b), juce::jmax (a, b) });
+        }
+        else
+        {
+            q.words.add (token);
+        }
+    }
+
+    return q;
+}
+
+bool LibraryIndex::Query::narrows (const Query& previous) const
+{
+    // Every previous condition has to be implied by one of ours. A longer word
+    // only implies the words it contains through the name; one that could be a
+    // key (e.g. "am" after "a") can also match the key exactly, where it doesn't.
+    auto implies = [] (const juce::String& w, const juce::String& word)
+    {
+        return w == word || (w.contains (word) && ! MusicalKey::fromName (w).isValid());
+    };
+
+    for (auto& word : previous.words)
+        if (std::none_of (words.begin(), words.end(), [&] (const juce::String& w) { return implies (w, word); }))
+            return false;
+
+    for (auto& range : previous.bpmRanges)
+        if (std::none_of (bpmRanges.begin(), bpmRanges.end(), [&] (const juce::Range<float>& r)
+                          { return range.getStart() <= r.getStart() && r.getEnd() <= range.getEnd(); }))
+            return false;
+
+    return true;
+}
+
+//==============================================================================
+void LibraryIndex::append (const Entry& entry)
+{
+    indexByID[entry.id.getRawID()] = (int) ids.size();
+
+    ids.push_back (entry.id);
+    names.push_back (entry.name);
+    keys.push_back (entry.key);
+    nameKeys.push_back (entry.name.toLowerCase());
+    keyKeys.push_back (entry.key.toLowerCase());
+    bpms.push_back (entry.bpm);
+    durations.push_back (entry.duration);
+    datesAdded.push_back (entry.dateAdded);
+    fileHashes.push_back (entry.fileHash);
+}
+
+void LibraryIndex::entriesChanged()
+{
+    for (auto& order : orders)
+        order.clear();
+
+    for (auto& rank : ranks)
+        rank.clear();
+
+    refilter (false);
+}
+
+const std::vector<int>& LibraryIndex::getOrder (Column column)
+{
+    auto& order = orders[(size_t) column - 1];
+
+    if (order.size() == ids.size())
+        return order;
+
+    if (column == Column::name)
+    {
+        order.resize (ids.size());
+        std::iota (order.begin(), order.end(), 0);
+        std::stable_sort (order.begin(), order.end(), [this] (int a, int b) { return nameKeys[(size_t) a] < nameKeys[(size_t) b]; });
+        return order;
+    }
+
+    // Starting from the name order keeps equal values (e.g. tracks at the same BPM) alphabetical
+    order = getOrder (Column::name);
+
+    auto sortBy = [&order] (const auto& values)
+    {
+        std::stable_sort (order.begin(), order.end(), [&values] (int a, int b) { return values[(size_t) a] < values[(size_t) b]; });
+    };
+
+    switch (column)
+    {
+        case Column::bpm:        sortBy (bpms); break;
+        case Column::duration:   sortBy (durations); break;
+        case Column::key:
+        {
+            // Round the Camelot wheel, so keys that mix harmonically sit together
+            std::vector<int> keyOrders;
+            keyOrders.reserve (keys.size());
+
+            for (auto& key : keys)
+                keyOrders.push_back (MusicalKey::fromName (key).getSortOrder());
+
+            sortBy (keyOrders);
+            break;
+        }
+        case Column::dateAdded:  sortBy (datesAdded); break;
+        case Column::name:       break;
+    }
+
+    return order;
+}
+
+const std::vector<int>& LibraryIndex::getRanks (Column column)
+{
+    auto& rank = ranks[(size_t) column - 1];
+
+    if (rank.size() == ids.size())
+        return rank;
+
+    const auto& order = getOrder (column);
+    rank.resize (order.size());
+
+    for (size_t i = 0; i < order.size(); ++i)
+        rank[(size_t) order[i]] = (int) i;
+
+    return rank;
+}
+
+bool LibraryIndex::matchesQuery (int entry, const Query& q) const
+{
+    const auto i = (size_t) entry;
+
+    for (auto& range : q.bpmRanges)
+        if (bpms[i] < range.getStart() || bpms[i] > range.getEnd())
+            return false;
+
+    for (auto& word : q.words)
+        if (! nameKeys[i].contains (word) && keyKeys[i] != word)
+            return false;
+
+    return true;
+}
+
+void LibraryIndex::refilter (bool narrowing)
+{
+    if (query.isEmpty())
+    {
+        matches.resize (ids.size());
+        std::iota (matches.begin(), matches.end(), 0);
+    }
+    else if (narrowing)
+    {
+        std::erase_if (matches, [this] (int entry) { return ! matchesQuery (entry, query); });
+    }
+    else if (! query.bpmRanges.isEmpty())
+    {
+        // Only the entries inside the first BPM range need testing
+        const auto range = query.bpmRanges.getFirst();
+        matches.clear();
+
+        for (auto entry : getEntriesInBpmRange (range.getStart(), range.getEnd()))
+            if (matchesQuery (entry, query))
+                matches.push_back (entry);
+
+        std::sort (matches.begin(), matches.end());
+    }
+    else
+    {
+        matches.clear();
+
+        for (int entry = 0; entry < size(); ++entry)
+            if (matchesQuery (entry, query))
+                matches.push_back (entry);
+    }
+
+    updateRows();
+}
+
+void LibraryIndex::updateRows()
+{
+    if (matches.size() == ids.size())
+    {
+        rows = getOrder (sortColumn);
+    }
+    else
+    {
+        const auto& rank = getRanks (sortColumn);
+        rows = matches;
+        std::sort (rows.begin(), rows.end(), [&rank] (int a, int b) { return rank[(size_t) a] < rank[(size_t) b]; });
+    }
+
+    if (! sortForwards)
+        std::reverse (rows.begin(), rows.end());
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <tracktion_engine/tracktion_engine.h>
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+//==============================================================================
+/**
+    An in-memory, column-per-field index of the library's ProjectItems.
+
+    The library table reads every cell from here rather than from the Project,
+    which would create a ProjectItem and parse a property for each cell painted.
+
+    Each field is stored in its own array, addressed by an entry index. On top
+    of the columns the index keeps:
+    - a sort order per column, built the first time it's needed and reused
+      until the entries change. Sorting the visible rows is then a sort of
+      integer ranks rather than a string or property comparison.
+    - the BPM order doubles as a search tree: getEntriesInBpmRange() is two
+      binary searches.
+    - the rows currently visible in the table, after the filter and sort.
+
+    Filters are typed a character at a time, so when a new filter can only
+    match a subset of the previous one (e.g. "dub" -> "dubs") only the
+    previous matches are re-tested.
+*/
+class LibraryIndex
+{
+public:
+    /** The sortable columns. The values are the library table's column IDs. */
+    enum class Column
+    {
+        name = 1,
+        bpm,
+        duration,
+        key,
+        dateAdded
+    };
+
+    /** One library item's fields. */
+    struct Entry
+    {
+        tracktion::engine::ProjectItemID id;
+        juce::String name;
+        float bpm = 0.0f;
+        double duration = 0.0;        // seconds, 0 if unknown
+        juce::String key;             // musical key, as MusicalKey::getName(); empty if unknown
+        juce::int64 dateAdded = 0;    // milliseconds since the epoch, 0 if unknown
+        juce::int64 fileHash = 0;     // hash of the source audio, 0 if unknown
+
+        bool operator== (const Entry&) const = default;
+    };
+
+    LibraryIndex() = default;
+
+    //==============================================================================
+    /** Replaces the contents with every item in the project. */
+    void build (tracktion::engine::Project&);
+    void build (std::vector<Entry>);
+
+    /** Adds an entry, or replaces the one with the same ID. */
+    void update (const Entry&);
+    void remove (tracktion::engine::ProjectItemID);
+    void clear();
+
+    /** Reads an entry from the named properties LibraryComponent stores on an item. */
+    static Entry createEntry (tracktion::engine::ProjectItem&);
+
+    /** Writes the fields an entry holds beyond the item's name back to its properties. */
+    static void storeEntryProperties (tracktion::engine::ProjectItem&, const Entry&);
+
+    /** A hash of a file's contents, so a track can be recognised after it's moved or renamed. */
+    static juce::int64 hashFile (const juce::File&);
+
+    //==============================================================================
+    int size() const noexcept                                       { return (int) ids.size(); }
+
+    /** Returns the entry index for an item, or -1. */
+    int indexOf (tracktion::engine::ProjectItemID) const;
+
+    tracktion::engine::ProjectItemID getID (int entry) const        { return ids[(size_t) entry]; }
+    const juce::String& getName (int entry) const                   { return names[(size_t) entry]; }
+    float getBpm (int entry) const                                  { return bpms[(size_t) entry]; }
+    double getDuration (int entry) const                            { return durations[(size_t) entry]; }
+    const juce::String& getKey (int entry) const                    { return keys[(size_t) entry]; }
+    juce::int64 getDateAdded (int entry) const                      { return datesAdded[(size_t) entry]; }
+    juce::int64 getFileHash (int entry) const                       { return fileHashes[(size_t) entry]; }
+    Entry getEntry (int entry) const;
+
+    /** The entries with minBpm <= BPM <= maxBpm, in ascending BPM order. The
+        span is invalidated by the next change to the entries.
+    */
+    std::span<const int> getEntriesInBpmRange (float minBpm, float maxBpm);
+
+    //==============================================================================
+    /** Sets the order of the visible rows. */
+    void setSortOrder (Column, bool forwards);
+    Column getSortColumn() const noexcept                           { return sortColumn; }
+    bool isSortedForwards() const noexcept                          { return sortForwards; }
+
+    /** Filters the visible rows.
+
+        The text is split into words, each of which must appear in an entry's
+        name or be its key (case-insensitive). A word of the form "120-128"
+        instead matches entries with a BPM in that range.
+    */
+    void setFilter (const juce::String& text);
+    const juce::String& getFilter() const noexcept                  { return filterText; }
+
+    /** The visible rows, after filtering and sorting. */
+    int getNumRows() const noexcept                                 { return (int) rows.size(); }
+
+    /** Returns the entry index shown in a row, or -1 if the row doesn't exist. */
+    int getEntryForRow (int row) const noexcept;
+
+    /** Returns the row an item is shown in, or -1 if it's filtered out or missing. */
+    int getRowForID (tracktion::engine::ProjectItemID) const;
+
+private:
+    struct Query
+    {
+        juce::StringArray words;
+        juce::Array<juce::Range<float>> bpmRanges;
+
+        static Query parse (const juce::String&);
+        bool isEmpty() const noexcept       { return words.isEmpty() && bpmRanges.isEmpty(); }
+        bool narrows (const Query& previous) const;
+    };
+
+    static constexpr int numColumns = (int) Column::dateAdded;
+
+    // The columns
+    std::vector<tracktion::engine::ProjectItemID> ids;
+    std::vector<juce::String> names, keys;
+    std::vector<juce::String> nameKeys, keyKeys;    // lower-case, for matching (and sorting, for names)
+    std::vector<float> bpms;
+    std::vector<double> durations;
+    std::vector<juce::int64> datesAdded, fileHashes;
+    std::unordered_map<juce::int64, int> indexByID;
+
+    // Per column: entries in ascending order, and each entry's position in it.
+    // Empty until first needed.
+    std::array<std::vector<int>, numColumns> orders, ranks;
+
+    Column sortColumn = Column::name;
+    bool sortForwards = true;
+
+    juce::String filterText;
+    Query query;
+    std::vector<int> matches;   // entries passing the filter, ascending
+    std::vector<int> rows;      // matches in display order
+
+    void append (const Entry&);
+    void entriesChanged();
+    const std::vector<int>& getOrder (Column);
+    const std::vector<int>& getRanks (Column);
+    bool matchesQuery (int entry, const Query&) const;
+    void refilter (bool narrowing);
+    void updateRows();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryIndex)
+};
@@ -0,0 +1,166 @@
+#include "LibraryPersistence.h"
+#include "UIProfiler.h"
+
+//==============================================================================
+struct LibraryPersistence::Writer : public juce::Thread
+{
+    explicit Writer (std::atomic<int>& counter)
+        : juce::Thread ("Library writer"), numWrites (counter)
+    {
+        idle.signal();
+        startThread (juce::Thread::Priority::background);
+    }
+
+    ~Writer() override
+    {
+        // Anything still queued is written before the thread exits
+        signalThreadShouldExit();
+        notify();
+        stopThread (-1);
+    }
+
+    void enqueue (const juce::File& file, juce::MemoryBlock data)
+    {
+        {
+            const juce::ScopedLock sl (lock);
+            pending[file] = std::move (data);
+            idle.reset();
+        }
+
+        notify();
+    }
+
+    void waitUntilIdle()
+    {
+        idle.wait (-1);
+    }
+
+    bool isQueued (const juce::File& file)
+    {
+        const juce::ScopedLock sl (lock);
+        return file == writing || pending.count (file) > 0;
+    }
+
+    void run() override
+    {
+        for (;;)
+        {
+            writePending();
+
+            if (threadShouldExit())
+                break;
+
+            wait (-1);
+        }
+
+        writePending();
+    }
+
+private:
+    std::atomic<int>& numWrites;
+    juce::CriticalSection lock;
+    std::map<juce::File, juce::MemoryBlock> pending;
+    juce::File writing;
+    juce::WaitableEvent idle { true };
+
+    void writePending()
+    {
+        for (;;)
+        {
+            juce::MemoryBlock data;
+
+            {
+                const juce::ScopedLock sl (lock);
+                writing = juce::File();
+
+                if (pending.empty())
+                {
+                    idle.signal();
+                    return;
+                }
+
+                auto next = pending.begin();
+                writing = next->first;
+                data = std::move (next->second);
+                pending.erase (next);
+            }
+
+            if (! writeAtomically (writing, data))
+                DBG ("LibraryPersistence: failed to write " + writing.getFullPathName());
+
+            ++numWrites;
+        }
+    }
+};
+
+//==============================================================================
+LibraryPersistence::LibraryPersistence()
+    : writer (std::make_unique<Writer> (numFileWrites))
+{
+}
+
+LibraryPersistence::~LibraryPersistence()
+{
+    flush();
+}
+
+void LibraryPersistence::markChanged()
+{
+    // The window isn't restarted by later changes, so a steady stream of them still gets saved
+    if (! isTimerRunning())
+        startTimer (saveWindowMilliseconds);
+}
+
+void LibraryPersistence::writeFile (const juce::File& file, juce::MemoryBlock data)
+{
+    writer->enqueue (file, std::move (data));
+}
+
+bool LibraryPersistence::writeAtomically (const juce::File& file, const juce::MemoryBlock& data)
+{
+    juce::TemporaryFile temp (file);
+
+    {
+        juce::FileOutputStream out (temp.getFile());
+
+        if (! out.openedOk())
+            return false;
+
+        out.write (data.getData(), data.getSize());
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+void LibraryPersistence::flush()
+{
+    if (isTimerRunning())
+        save();
+
+    writer->waitUntilIdle();
+}
+
+void LibraryPersistence::waitForWrite (const juce::File& file)
+{
+    if (writer->isQueued (file))
+        writer->waitUntilIdle();
+}
+
+void LibraryPersistence::timerCallback()
+{
+    const UIProfiler::ScopedTimer profile ("LibraryPersistence::timerCallback");
+    save();
+}
+
+void LibraryPersistence::save()
+{
+    stopTimer();
+    ++numSaves;
+
+    if (onSave)
+        onSave();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <atomic>
+#include <functional>
+#include <map>
+
+//==============================================================================
+/**
+    Write-behind saving for the library.
+
+    Changes are reported with markChanged(). The first one opens a short
+    window, and when it closes onSave is called once on the message thread
+    for everything that changed in it, so importing a folder of files saves
+    the library once rather than once per file.
+
+    onSave can hand data it has serialised to writeFile(), which writes it on
+    a background thread: to a temporary file first, then renamed over the
+    target, so a crash mid-write never leaves a truncated file. A newer write
+    to the same file replaces one that hasn't started yet.
+
+    Files that can only be written by the object that owns them (tracktion's
+    Project keeps its own file) are saved by onSave itself, on the message
+    thread, once per window.
+
+    flush() runs a pending save straight away and waits for the writes; it's
+    called on destruction, so nothing is lost at shutdown.
+*/
+class LibraryPersistence : private juce::Timer
+{
+public:
+    LibraryPersistence();
+    ~LibraryPersistence() override;
+
+    /** Saves everything that's changed. Called on the message thread. */
+    std::function<void()> onSave;
+
+    /** Schedules a save at the end of the current window. */
+    void markChanged();
+    bool hasPendingSave() const noexcept                    { return isTimerRunning(); }
+
+    /** Queues data to be written atomically on the background thread. */
+    void writeFile (const juce::File&, juce::MemoryBlock data);
+
+    /** Writes data to a temporary file and renames it over the target. Any thread. */
+    static bool writeAtomically (const juce::File&, const juce::MemoryBlock& data);
+
+    /** Saves now if a save is pending, then waits for all queued writes. */
+    void flush();
+
+    /** Waits for a queued write to the file to land, if there is one. */
+    void waitForWrite (const juce::File&);
+
+    int getNumSaves() const noexcept                        { return numSaves; }
+    int getNumFileWrites() const noexcept                   { return numFileWrites; }
+
+    static constexpr int saveWindowMilliseconds = 1000;
+
+private:
+    struct Writer;
+    std::unique_ptr<Writer> writer;
+
+    int numSaves = 0;
+    std::atomic<int> numFileWrites { 0 };
+
+    void timerCallback() override;
+    void save();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryPersistence)
+};
@@ -0,0 +1,111 @@
+#include "LibrarySnapshot.h"
+#include <cstring>
+
+namespace te = tracktion::engine;
+
+juce::File LibrarySnapshot::getFileFor (const juce::File& projectFile)
+{
+    return projectFile.withFileExtension ("snapshot");
+}
+
+juce::MemoryBlock LibrarySnapshot::serialise (const LibraryIndex& index, const juce::File& projectFile)
+{
+    std::vector<Record> records ((size_t) index.size());
+    juce::MemoryOutputStream strings;
+
+    auto appendString = [&strings] (const juce::String& s, juce::uint32& offset, juce::uint32& length)
+    {
+        offset = (juce::uint32) strings.getDataSize();
+        length = (juce::uint32) s.getNumBytesAsUTF8();
+        strings.write (s.toRawUTF8(), length);
+    };
+
+    for (int i = 0; i < index.size(); ++i)
+    {
+        auto& record = records[(size_t) i];
+        record = {};
+        record.itemID = index.getID (i).getItemID();
+        record.projectID = index.getID (i).getProjectID();
+        record.dateAdded = index.getDateAdded (i);
+        record.fileHash = index.getFileHash (i);
+        record.duration = index.getDuration (i);
+        record.bpm = index.getBpm (i);
+        appendString (index.getName (i), record.nameOffset, record.nameLength);
+        appendString (index.getKey (i), record.keyOffset, record.keyLength);
+    }
+
+    Header header {};
+    header.magic = magic;
+    header.version = currentVersion;
+    header.projectModificationTime = projectFile.getLastModificationTime().toMilliseconds();
+    header.projectFileSize = projectFile.getSize();
+    header.numEntries = (juce::uint32) records.size();
+    header.stringBytes = (juce::uint32) strings.getDataSize();
+
+    juce::MemoryOutputStream out (sizeof (header) + records.size() * sizeof (Record) + strings.getDataSize());
+    out.write (&header, sizeof (header));
+    out.write (records.data(), records.size() * sizeof (Record));
+    out.write (strings.getData(), strings.getDataSize());
+    return out.getMemoryBlock();
+}
+
+std::optional<std::vector<LibraryIndex::Entry>> LibrarySnapshot::read (const juce::File& snapshotFile, const juce::File& projectFile)
+{
+    if (! snapshotFile.existsAsFile() || ! projectFile.existsAsFile())
+        return std::nullopt;
+
+    juce::MemoryMappedFile mapped (snapshotFile, juce::MemoryMappedFile::readOnly);
+    const auto* data = static_cast<const char*> (mapped.getData());
+    const auto size = mapped.getSize();
+
+    if (data == nullptr || size < sizeof (Header))
+        return std::nullopt;
+
+    Header header;
+    std::memcpy (&header, data, sizeof (header));
+
+    if (header.magic != magic || header.version != currentVersion)
+        return std::nullopt;
+
+    // Saved since the snapshot was written, so it can't be trusted
+    if (header.projectModificationTime != projectFile.getLastModificationTime().toMilliseconds()
+        || header.projectFileSize != projectFile.getSize())
+        return std::nullopt;
+
+    const auto recordsStart = sizeof (Header);
+    const auto stringsStart = recordsStart + (size_t) header.numEntries * sizeof (Record);
+
+    if (stringsStart + header.stringBytes != size)
+        return std::nullopt;
+
+    const auto* strings = data + stringsStart;
+
+    auto isInBlob = [&header] (juce::uint32 offset, juce::uint32 length)
+    {
+        return (juce::uint64) offset + length <= header.stringBytes;
+    };
+
+    std::vector<LibraryIndex::Entry> entries;
+    entries.reserve (header.numEntries);
+
+    for (size_t i = 0; i < header.numEntries; ++i)
+    {
+        Record record;
+        std::memcpy (&record, data + recordsStart + i * sizeof (Record), sizeof (record));
+
+        if (! isInBlob (record.nameOffset, record.nameLength) || ! isInBlob (record.keyOffset, record.keyLength))
+            return std::nullopt;
+
+        LibraryIndex::Entry entry;
+        entry.id = te::ProjectItemID (record.itemID, record.projectID);
+        entry.name = juce::String::fromUTF8 (strings + record.nameOffset, (int) record.nameLength);
+        entry.bpm = record.bpm;
+        entry.duration = record.duration;
+        entry.key = juce::String::fromUTF8 (strings + record.keyOffset, (int) record.keyLength);
+        entry.dateAdded = record.dateAdded;
+        entry.fileHash = record.fileHash;
+        entries.push_back (std::move (entry));
+    }
+
+    return entries;
+}
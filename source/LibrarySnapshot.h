@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "LibraryIndex.h"
+#include <optional>
+#include <vector>
+
+//==============================================================================
+/**
+    A compact binary copy of the LibraryIndex, stored next to Library.tracktion.
+
+    Reading it memory-maps the file and copies the entries straight out, so the
+    library table can be shown at startup without loading the Project. The
+    snapshot records the project file's modification time and size, and is
+    ignored once either changes.
+
+    Layout (native byte order; the magic doubles as a byte order check):
+    - Header
+    - numEntries fixed-size Records
+    - a UTF-8 string blob, which Records point into
+*/
+struct LibrarySnapshot
+{
+    /** Bump whenever Header or Record change. Older snapshots are then ignored and rewritten. */
+    static constexpr juce::uint32 currentVersion = 1;
+
+    /** The snapshot file that belongs to a project file. */
+    static juce::File getFileFor (const juce::File& projectFile);
+
+    /** The index's entries, stamped with the project file's current modification
+        time and size. LibraryPersistence writes them to the snapshot file.
+    */
+    static juce::MemoryBlock serialise (const LibraryIndex&, const juce::File& projectFile);
+
+    /** Returns the snapshot's entries, or nothing if it's missing, corrupt, from
+        another version or older than the project file.
+    */
+    static std::optional<std::vector<LibraryIndex::Entry>> read (const juce::File& snapshotFile, const juce::File& projectFile);
+
+private:
+    static constexpr juce::uint32 magic = 0x494c5343; // "CSLI" when little-endian
+
+    struct Header
+    {
+        juce::uint32 magic, version;
+        juce::int64 projectModificationTime, projectFileSize;
+        juce::uint32 numEntries, stringBytes;
+    };
+
+    struct Record
+    {
+        juce::int32 itemID, projectID;
+        juce::int64 dateAdded, fileHash;
+        double duration;
+        float bpm;
+        juce::uint32 nameOffset, nameLength, keyOffset, keyLength;
+        juce::uint32 reserved;
+    };
+
+    static_assert (sizeof (Header) == 32 && sizeof (Record) == 56, "the snapshot layout mustn't depend on the compiler");
+};
@@ -2,6 +2,7 @@
 #include "ChopComponent.h"
 #include "Plugins/ChopPlugin.h"
 #include <algorithm>
+#include <utility>
 
 #define JUCE_USE_DIRECTWRITE 0 // Fix drawing of Monospace fonts in Code Editor!
 
@@ -29,7 +30,7 @@ MainComponent::MainComponent()
     LookAndFeel::setDefaultLookAndFeel(customLookAndFeel.get());
     getLookAndFeel().setDefaultSansSerifTypefaceName("Arial");
     setSize(924, 720);
-    startTimerHz(30);
+    frameScheduler->setDisplayComponent(this);
 
     // Initialize licensing UI
     addAndMakeVisible(showActivationUiButton);
@@ -49,6 +50,7 @@ MainComponent::MainComponent()
 
     // Register our custom plugins with the engine
     engine.getPluginManager().createBuiltInType<tracktion::engine::OscilloscopePlugin>();
+    engine.getPluginManager().createBuiltInType<AutoReverbPlugin>();
     engine.getPluginManager().createBuiltInType<FlangerPlugin>();
     engine.getPluginManager().createBuiltInType<AutoDelayPlugin>();
     engine.getPluginManager().createBuiltInType<AutoPhaserPlugin>();
@@ -58,6 +60,9 @@ MainComponent::MainComponent()
     gamepadManager = GamepadManager::getInstance();
     gamepadManager->addListener(this);
 
+    // Watch the engine's device callback alongside our own getNextAudioBlock
+    audioMonitor.attachTo(engine.getDeviceManager().deviceManager);
+
     // Initialize controller mapping component (not edit-dependent)
     controllerMappingComponent = std::make_unique<ControllerMappingComponent>();
     addAndMakeVisible(*controllerMappingComponent);
@@ -87,10 +92,16 @@ MainComponent::MainComponent()
 void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
     MOONBASE_PREPARE_TO_PLAY(sampleRate, samplesPerBlockExpected);
+    audioMonitor.prepare(AudioCallbackMonitor::Source::mainComponent, sampleRate);
 }
 
 void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
+    const AudioCallbackMonitor::ScopedCallback callbackTiming(audioMonitor,
+                                                              AudioCallbackMonitor::Source::mainComponent,
+                                                              bufferToFill.numSamples);
+    CHOPSHOP_SCOPED_REALTIME
+
     bufferToFill.clearActiveBufferRegion();
 
     // Your audio processing code here
@@ -110,6 +121,12 @@ MainComponent::~MainComponent()
     releaseResources();
     shutdownAudio();
 
+    audioHealthOverlay = nullptr;
+    audioMonitor.detach();
+
+    uiProfilerOverlay = nullptr;
+    UIProfiler::instance().setEnabled(false);
+
     // Additional cleanup if needed
     LookAndFeel::setDefaultLookAndFeel (nullptr);
     customLookAndFeel = nullptr;
@@ -149,6 +166,19 @@ void MainComponent::resized()
 
     MOONBASE_RESIZE_ACTIVATION_UI;
 
+    if (audioHealthOverlay != nullptr)
+    {
+        audioHealthOverlay->setBounds(getWidth() - 350, 35, 340, 230);
+        audioHealthOverlay->toFront(false);
+    }
+
+    if (uiProfilerOverlay != nullptr)
+    {
+        // Below the audio health overlay when both are open
+        uiProfilerOverlay->setBounds(getWidth() - 430, audioHealthOverlay != nullptr ? 275 : 35, 420, 330);
+        uiProfilerOverlay->toFront(false);
+    }
+
     // Always position the library bar at the top
     if (libraryBar != nullptr)
     {
@@ -230,6 +260,7 @@ void MainComponent::resized()
 
 void MainComponent::play()
 {
+    audioMonitor.markEvent("Toggle play");
     EngineHelpers::togglePlay (*edit);
 
     // Update button states based on transport state
@@ -239,6 +270,7 @@ void MainComponent::play()
 
 void MainComponent::stop()
 {
+    audioMonitor.markEvent("Stop");
     EngineHelpers::togglePlay (*edit, EngineHelpers::ReturnToStart::yes);
 
     // Stop transport and reset position
@@ -253,10 +285,8 @@ void MainComponent::updateTempo()
     // Calculate the new BPM based on the current tempo from the screw component
     double newBpm = screwComponent->getTempo();
 
-    // Insert tempo change at the beginning of the track
-    auto tempoSetting = edit->tempoSequence.insertTempo (tracktion::TimePosition::fromSeconds (0.0));
-    if (tempoSetting != nullptr)
-        tempoSetting->setBpm (newBpm);
+    // Scale the whole tempo map, so a drifting track keeps its drift
+    EngineHelpers::setTempo (*edit, newBpm);
 
     // Calculate ratio for thumbnail display
     const double ratio = baseTempo / newBpm;
@@ -326,6 +356,38 @@ void MainComponent::showControllerMappingWindow()
     controllerMappingWindow->toFront(true);
 }
 
+void MainComponent::toggleAudioHealthOverlay()
+{
+    if (audioHealthOverlay != nullptr)
+    {
+        audioHealthOverlay = nullptr;
+        return;
+    }
+
+    audioHealthOverlay = std::make_unique<AudioHealthOverlay>(audioMonitor);
+    addAndMakeVisible(*audioHealthOverlay);
+    resized();
+}
+
+void MainComponent::toggleUIProfilerOverlay()
+{
+    // Profiling only runs while its overlay is open
+    auto& profiler = UIProfiler::instance();
+
+    if (uiProfilerOverlay != nullptr)
+    {
+        uiProfilerOverlay = nullptr;
+        profiler.setEnabled(false);
+        return;
+    }
+
+    profiler.reset();
+    profiler.setEnabled(true);
+    uiProfilerOverlay = std::make_unique<UIProfilerOverlay>(profiler);
+    addAndMakeVisible(*uiProfilerOverlay);
+    resized();
+}
+
 void MainComponent::handleEditSelection (std::unique_ptr<tracktion::engine::Edit> newEdit)
 {
     if (!newEdit)
@@ -373,26 +435,23 @@ void MainComponent::loadNewEdit(std::unique_ptr<tracktion::engine::Edit> newEdit
     if (!newEdit)
         return;
 
+    audioMonitor.markEvent("Load edit: " + newEdit->getName());
+
+    // Mid-set switches start the new track as soon as it's set up. The old one
+    // is stopped first and there's no crossfade, so the switch is fast but not
+    // gapless: expect a short gap while the components are rebound.
+    const bool wasPlaying = edit != nullptr && edit->getTransport().isPlaying();
+
     // Stop any current playback if we have an existing edit
     if (edit)
     {
         edit->getTransport().stop(false, false);
-
-        // Clean up all edit-dependent components first
-        transportComponent = nullptr;
-        reverbComponent = nullptr;
-        delayComponent = nullptr;
-        flangerComponent = nullptr;
-        phaserComponent = nullptr;
-        chopComponent = nullptr;
-        screwComponent = nullptr;
-        scratchComponent = nullptr;
-        vinylBrakeComponent = nullptr;
-        oscilloscopeComponent = nullptr;
+        edit->getUndoManager().removeChangeListener(this);
+        detachOscilloscope();
     }
 
-    // Release current edit and assign new one
-    edit = std::move(newEdit);
+    // The old Edit is kept until the components have moved off it
+    auto previousEdit = std::exchange(edit, std::move(newEdit));
 
     // Update library bar with track name
     libraryBar->setCurrentTrackName(edit->getName());
@@ -407,34 +466,14 @@ void MainComponent::loadNewEdit(std::unique_ptr<tracktion::engine::Edit> newEdit
     // Setup audio graph
     setupAudioGraph();
 
-    // Initialize all edit-dependent components
-    reverbComponent = std::make_unique<ReverbComponent>(*edit);
-    addAndMakeVisible(*reverbComponent);
-
-    DBG("Setup reverb component");
-
-    setupChopComponent();
-
-    DBG("Setup chop component");
-
-    flangerComponent = std::make_unique<FlangerComponent>(*edit);
-    addAndMakeVisible(*flangerComponent);
-
-    delayComponent = std::make_unique<DelayComponent>(*edit);
-    addAndMakeVisible(*delayComponent);
-
-    phaserComponent = std::make_unique<PhaserComponent>(*edit);
-    addAndMakeVisible(*phaserComponent);
-
-    DBG("Setup phaser component");
+    // The components are built for the first Edit and rebound for every one after,
+    // which keeps their layout, thumbnail and GL state
+    if (transportComponent == nullptr)
+        createEditComponents();
+    else
+        rebindEditComponents();
 
-    setupVinylBrakeComponent();
-    setupScrewComponent();
-    setupScratchComponent();
-
-    // Create transport component
-    transportComponent = std::make_unique<TransportComponent>(*edit, ZoomState::instance());
-    addAndMakeVisible(*transportComponent);
+    previousEdit = nullptr;
 
     // Reset component states
     if (screwComponent)
@@ -443,23 +482,16 @@ void MainComponent::loadNewEdit(std::unique_ptr<tracktion::engine::Edit> newEdit
         screwComponent->setTempo (baseTempo, juce::dontSendNotification);
     }
 
-    // Initialize the tempo sequence with the base tempo
-    auto tempoSetting = edit->tempoSequence.insertTempo (tracktion::TimePosition::fromSeconds (0.0));
-    if (tempoSetting != nullptr)
-        tempoSetting->setBpm (baseTempo);
+    // Initialize the tempo sequence with the base tempo (or the imported tempo map)
+    EngineHelpers::setTempo (*edit, baseTempo);
 
     // Reset transport position and state
     edit->getTransport().setPosition (tracktion::TimePosition::fromSeconds (0.0));
     playState = PlayState::Stopped;
 
-    // Reset delay time to 1/4 note if component exists
+    // Sync the delay time to the selected note value at the new tempo
     if (delayComponent)
-    {
-        // Calculate quarter note duration in milliseconds
-        double quarterNoteMs = (60.0 / baseTempo) * 1000.0;
-        delayComponent->setDelayTime (quarterNoteMs);
         delayComponent->setTempo (baseTempo);
-    }
 
     // Update plugin components
     if (oscilloscopePlugin)
@@ -468,12 +500,72 @@ void MainComponent::loadNewEdit(std::unique_ptr<tracktion::engine::Edit> newEdit
     // Apply the current tempo to the clips
     updateTempo();
 
+    if (wasPlaying)
+    {
+        edit->getTransport().play(false);
+        playState = PlayState::Playing;
+    }
+
     // Force transport component to update its thumbnail
     if (transportComponent)
         transportComponent->updateThumbnail();
 
     // Trigger a layout update
     resized();
+
+    // Undo and redo are enabled from the new Edit's history
+    edit->getUndoManager().addChangeListener(this);
+    commandManager->commandStatusChanged();
+}
+
+void MainComponent::createEditComponents()
+{
+    reverbComponent = std::make_unique<ReverbComponent>(*edit);
+    addAndMakeVisible(*reverbComponent);
+
+    setupChopComponent();
+
+    flangerComponent = std::make_unique<FlangerComponent>(*edit);
+    addAndMakeVisible(*flangerComponent);
+
+    delayComponent = std::make_unique<DelayComponent>(*edit);
+    addAndMakeVisible(*delayComponent);
+
+    phaserComponent = std::make_unique<PhaserComponent>(*edit);
+    addAndMakeVisible(*phaserComponent);
+
+    setupVinylBrakeComponent();
+    setupScrewComponent();
+    setupScratchComponent();
+
+    // Create transport component
+    transportComponent = std::make_unique<TransportComponent>(*edit, ZoomState::instance());
+    addAndMakeVisible(*transportComponent);
+}
+
+void MainComponent::rebindEditComponents()
+{
+    reverbComponent->setEdit(*edit);
+    chopComponent->setEdit(*edit);
+    flangerComponent->setEdit(*edit);
+    delayComponent->setEdit(*edit);
+    phaserComponent->setEdit(*edit);
+    vinylBrakeComponent->setEdit(*edit);
+    screwComponent->setEdit(*edit);
+    scratchComponent->setEdit(*edit);
+    transportComponent->setEdit(*edit);
+}
+
+void MainComponent::detachOscilloscope()
+{
+    // The scope itself stays; it's pointed at the next Edit's buffer when that initialises
+    if (auto* scope = dynamic_cast<Oscilloscope2D*>(oscilloscopeComponent.get()))
+        scope->setRingBuffer(nullptr);
+
+    if (auto* oscPlugin = dynamic_cast<tracktion::engine::OscilloscopePlugin*>(oscilloscopePlugin.get()))
+        oscPlugin->removeListener(this);
+
+    oscilloscopePlugin = nullptr;
 }
 
 void MainComponent::armTrack (int trackIndex, bool arm)
@@ -504,6 +596,8 @@ void MainComponent::stopRecording()
 
 void MainComponent::gamepadButtonPressed(int buttonId)
 {
+    audioMonitor.markEvent("Gamepad button " + juce::String(buttonId));
+
     switch (buttonId)
     {
         case SDL_GAMEPAD_BUTTON_SOUTH:
@@ -727,12 +821,13 @@ void MainComponent::setupAudioGraph()
 
 void MainComponent::releaseResources()
 {
-    // Stop any active timers
-    stopTimer();
+    frameScheduler->setDisplayComponent(nullptr);
 
     // Stop playback if active and edit is valid
     if (edit != nullptr)
     {
+        edit->getUndoManager().removeChangeListener(this);
+
         if (edit->getTransport().isPlaying())
             edit->getTransport().stop(true, false);
     }
@@ -911,6 +1006,11 @@ juce::PopupMenu MainComponent::getMenuForIndex (int topLevelMenuIndex, const juc
         menu.addSeparator();
         menu.addItem(1, "Audio Settings", true, false);
         menu.addItem(3, "Game Controller Settings", true, false);
+        menu.addItem(4, "Audio Health Monitor", true, audioHealthOverlay != nullptr);
+        menu.addItem(5, "Dump Audio Timing On Xrun", true, audioMonitor.isDumpOnXrunEnabled());
+        menu.addItem(6, "GPU Timeline", transportComponent != nullptr,
+                     transportComponent != nullptr && transportComponent->isGpuTimelineEnabled());
+        menu.addItem(7, "UI Profiler", true, uiProfilerOverlay != nullptr);
         menu.addSeparator();
         menu.addItem(2, "Quit", true, false);
     }
@@ -938,6 +1038,19 @@ void MainComponent::menuItemSelected (int menuItemID, int topLevelMenuIndex)
             case 3: // Game Controller Settings
                 showControllerMappingWindow();
                 break;
+            case 4: // Audio Health Monitor
+                toggleAudioHealthOverlay();
+                break;
+            case 5: // Dump Audio Timing On Xrun
+                audioMonitor.setDumpOnXrun(!audioMonitor.isDumpOnXrunEnabled());
+                break;
+            case 6: // GPU Timeline
+                if (transportComponent != nullptr)
+                    transportComponent->setGpuTimelineEnabled(!transportComponent->isGpuTimelineEnabled());
+                break;
+            case 7: // UI Profiler
+                toggleUIProfilerOverlay();
+                break;
             default:
                 break;
         }
@@ -21,6 +21,7 @@ namespace ProjectInfo
 
 #include "Utilities.h"
 #include "CustomLookAndFeel.h"
+#include "FrameScheduler.h"
 #include "ReverbComponent.h"
 #include "GamepadManager.h"
 #include "FlangerComponent.h"
@@ -32,10 +33,15 @@ namespace ProjectInfo
 #include "ChopComponent.h"
 #include "ScrewComponent.h"
 #include "ControllerMappingComponent.h"
+#include "AudioCallbackMonitor.h"
+#include "AudioHealthOverlay.h"
+#include "UIProfilerOverlay.h"
+#include "RealtimeSanitizer.h"
 #include "PhaserComponent.h"
 #include "Plugins/FlangerPlugin.h"
 #include "Plugins/AutoDelayPlugin.h"
 #include "Plugins/AutoPhaserPlugin.h"
+#include "Plugins/AutoReverbPlugin.h"
 #include "Plugins/ScratchPlugin.h"
 #include "ScratchComponent.h"
 #include "TransportComponent.h"
@@ -88,6 +94,7 @@ private:
     
     void timerCallback() override
     {
+        const UIProfiler::ScopedTimer profile ("CompanyLogo::timerCallback");
         const auto jitterRange = 0.1f;
         jitterX.setTargetValue(juce::jmap(random.nextFloat(), 0.f, 1.f, -jitterRange, jitterRange));
         jitterY.setTargetValue(juce::jmap(random.nextFloat(), 0.f, 1.f, -jitterRange, jitterRange));
@@ -116,7 +123,7 @@ class MainComponent : public juce::AudioAppComponent,
                      public juce::ApplicationCommandTarget,
                      public GamepadManager::Listener,
                      public tracktion::engine::OscilloscopePlugin::Listener,
-                     private juce::Timer
+                     private juce::ChangeListener
 {
 public:
     //==============================================================================
@@ -150,25 +157,9 @@ public:
     void stop();
     void updateTempo();
 
-    void timerCallback() override
+    // The Edit's undo manager changed, so undo/redo may have become (un)available
+    void changeListenerCallback(juce::ChangeBroadcaster*) override
     {
-        // Check if we're shutting down
-        if (chopComponent == nullptr)
-        {
-            stopTimer();
-            return;
-        }
-        
-        // Only manipulate the crossfader if we're handling a chop release
-        if (chopReleaseDelay > 0)
-        {
-            stopTimer();
-            // float currentPosition = chopComponent->getCrossfaderValue();
-            // chopComponent->setCrossfaderValue(currentPosition <= 0.5f ? 1.0f : 0.0f);
-            chopReleaseDelay = 0;
-        }
-
-        // Update command states for undo/redo
         if (commandManager != nullptr && edit != nullptr)
             commandManager->commandStatusChanged();
     }
@@ -181,6 +172,13 @@ public:
         {
             if (auto* oscPlugin = dynamic_cast<tracktion::engine::OscilloscopePlugin*>(oscilloscopePlugin.get()))
             {
+                // A scope from an earlier Edit keeps its GL context and just reads the new buffer
+                if (auto* scope = dynamic_cast<Oscilloscope2D*>(oscilloscopeComponent.get()))
+                {
+                    scope->setRingBuffer(oscPlugin->getRingBuffer());
+                    return;
+                }
+
                 oscilloscopeComponent.reset(oscPlugin->createControlPanel());
                 if (oscilloscopeComponent != nullptr)
                 {
@@ -192,6 +190,12 @@ public:
         });
     }
 
+    void oscilloscopePluginDeinitialising() override
+    {
+        if (auto* scope = dynamic_cast<Oscilloscope2D*>(oscilloscopeComponent.get()))
+            scope->setRingBuffer(nullptr);
+    }
+
     // Command handler
     juce::ApplicationCommandTarget* getNextCommandTarget() override { return nullptr; }
     void getAllCommands(juce::Array<juce::CommandID>& commands) override;
@@ -206,6 +210,18 @@ private:
     tracktion::engine::Engine engine{ProjectInfo::projectName};
     std::unique_ptr<tracktion::engine::Edit> edit;
     std::unique_ptr<CustomLookAndFeel> customLookAndFeel;
+
+    // Every animation in the window runs off this window's vblank
+    juce::SharedResourcePointer<FrameScheduler> frameScheduler;
+
+    // Callback timing for both audio devices; the overlay is created on demand
+    AudioCallbackMonitor audioMonitor;
+    std::unique_ptr<AudioHealthOverlay> audioHealthOverlay;
+    void toggleAudioHealthOverlay();
+
+    // Message-thread timings; profiling runs while the overlay is open
+    std::unique_ptr<UIProfilerOverlay> uiProfilerOverlay;
+    void toggleUIProfilerOverlay();
     
     std::unique_ptr<juce::MenuBarComponent> menuBar;
 
@@ -227,9 +243,6 @@ private:
     void startRecording();
     void stopRecording();
 
-    double chopStartTime = 0.0;
-    double chopReleaseDelay = 0.0;
-
     // GameController member variables
     GamepadManager* gamepadManager = nullptr;
 
@@ -257,6 +270,10 @@ private:
     void setupScrewComponent();
     void setupScratchComponent();
 
+    void createEditComponents();
+    void rebindEditComponents();
+    void detachOscilloscope();
+
     void gamepadTouchpadMoved(float x, float y, bool touched) override;
     void showControllerMappingWindow();
 
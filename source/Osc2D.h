@@ -17,6 +17,7 @@
 #endif
 
 #include "RingBuffer.h"
+#include "UIProfiler.h"
 
 /** This 2D Oscilloscope uses a Fragment-Shader based implementation.
  
@@ -68,6 +69,15 @@ public:
         ringBuffer = nullptr;
     }
     
+    /** Points the scope at another ring buffer, or nullptr to detach it. The GL
+        context and shaders are kept, so a scope can outlive the plugin feeding it.
+    */
+    void setRingBuffer (RingBuffer<GLfloat>* bufferToUse)
+    {
+        const ScopedLock sl (ringBufferLock);
+        ringBuffer = bufferToUse;
+    }
+
     void handleAsyncUpdate() override
     {
         statusLabel.setText (statusText, dontSendNotification);
@@ -96,12 +106,11 @@ public:
      */
     void newOpenGLContextCreated() override
     {
-        // Add safety check for ring buffer
+        // The buffer can be attached later, so the shaders are built regardless
         if (ringBuffer == nullptr)
         {
             statusText = "No buffer available";
             triggerAsyncUpdate();
-            return;
         }
         
         createShaders();
@@ -125,21 +134,27 @@ public:
      */
     void renderOpenGL() override
     {
-        if (ringBuffer == nullptr)
-            return;
-        
+        const UIProfiler::ScopedTimer profile ("Oscilloscope2D::renderOpenGL");
+
         // Create a temporary buffer for reading samples
         AudioBuffer<GLfloat> tempBuffer(2, RING_BUFFER_READ_SIZE);
         
-        // Try to read samples, but handle empty buffer case
-        try 
         {
-            ringBuffer->readSamples(tempBuffer, RING_BUFFER_READ_SIZE);
-        }
-        catch (...)
-        {
-            // If reading fails, just return without rendering
-            return;
+            const ScopedLock sl (ringBufferLock);
+
+            if (ringBuffer == nullptr || shader == nullptr)
+                return;
+
+            // Try to read samples, but handle empty buffer case
+            try
+            {
+                ringBuffer->readSamples(tempBuffer, RING_BUFFER_READ_SIZE);
+            }
+            catch (...)
+            {
+                // If reading fails, just return without rendering
+                return;
+            }
         }
         
         jassert (OpenGLHelpers::isContextActive());
@@ -347,6 +362,7 @@ private:
     
     // Audio Buffer
     RingBuffer<GLfloat> * ringBuffer;
+    CriticalSection ringBufferLock;
     AudioBuffer<GLfloat> readBuffer;    // Stores data read from ring buffer
     GLfloat visualizationBuffer [RING_BUFFER_READ_SIZE];    // Single channel to visualize
     
@@ -47,6 +47,7 @@ void OscilloscopePlugin::initialise(const PluginInitialisationInfo& info)
     const int bufferSize = blockSize * 10;
     DBG("Creating oscilloscope buffer with size: " << bufferSize);
     oscilloscopeBuffer = std::make_unique<RingBuffer<GLfloat>>(2, bufferSize);
+    scratchBuffer.setSize(2, blockSize);
 
     // Notify listeners that initialization is complete
     listeners.call(&Listener::oscilloscopePluginInitialised);
@@ -54,37 +55,42 @@ void OscilloscopePlugin::initialise(const PluginInitialisationInfo& info)
 
 void OscilloscopePlugin::deinitialise()
 {
+    listeners.call(&Listener::oscilloscopePluginDeinitialising);
+
     oscilloscopeBuffer.reset();
+    scratchBuffer.setSize(0, 0);
 }
 
 void OscilloscopePlugin::applyToBuffer(const PluginRenderContext& rc)
 {
-    if (rc.bufferNumSamples > 0 && oscilloscopeBuffer != nullptr)
+    CHOPSHOP_SCOPED_REALTIME
+
+    if (rc.destBuffer == nullptr || rc.bufferNumSamples <= 0 || oscilloscopeBuffer == nullptr)
+        return;
+
+    // Only process if we actually have audio data
+    if (rc.destBuffer->hasBeenCleared())
+        return;
+
+    const int numSourceChannels = rc.destBuffer->getNumChannels();
+
+    if (numSourceChannels == 0)
+        return;
+
+    // Hosts can hand us more than the block size we were initialised with; write in chunks
+    // rather than resizing the scratch buffer here
+    const int chunkSize = scratchBuffer.getNumSamples();
+
+    for (int offset = 0; offset < rc.bufferNumSamples; offset += chunkSize)
     {
-        // Only process if we actually have audio data
-        if (!rc.destBuffer->hasBeenCleared())
-        {
-            // Convert audio buffer to GLfloat buffer
-            AudioBuffer<GLfloat> tempBuffer(rc.destBuffer->getNumChannels(), rc.bufferNumSamples);
-            
-            for (int ch = 0; ch < rc.destBuffer->getNumChannels(); ++ch)
-            {
-                // Clear the temp buffer first
-                tempBuffer.clear(ch, 0, rc.bufferNumSamples);
-                
-                // Copy only if we have valid audio data
-                if (rc.destBuffer->getRMSLevel(ch, rc.bufferStartSample, rc.bufferNumSamples) > 0.0f)
-                {
-                    FloatVectorOperations::copy(
-                        tempBuffer.getWritePointer(ch), 
-                        rc.destBuffer->getReadPointer(ch, rc.bufferStartSample), 
-                        rc.bufferNumSamples
-                    );
-                }
-            }
-
-            oscilloscopeBuffer->writeSamples(tempBuffer, 0, rc.bufferNumSamples);
-        }
+        const int numSamples = jmin(chunkSize, rc.bufferNumSamples - offset);
+
+        // The ring is always stereo, so mono input is duplicated
+        for (int ch = 0; ch < scratchBuffer.getNumChannels(); ++ch)
+            scratchBuffer.copyFrom(ch, 0, *rc.destBuffer, jmin(ch, numSourceChannels - 1),
+                                   rc.bufferStartSample + offset, numSamples);
+
+        oscilloscopeBuffer->writeSamples(scratchBuffer, 0, numSamples);
     }
 }
 
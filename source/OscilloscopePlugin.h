@@ -17,6 +17,7 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <tracktion_engine/tracktion_engine.h>
 #include "Osc2D.h"
+#include "RealtimeSanitizer.h"
 
 namespace tracktion { inline namespace engine
 {
@@ -48,6 +49,9 @@ public:
     
     std::unique_ptr<RingBuffer<GLfloat>> getOscilloscopeBuffer() { return std::move(oscilloscopeBuffer); }
 
+    /** The buffer the scope reads from, or nullptr while the plugin isn't initialised. */
+    RingBuffer<GLfloat>* getRingBuffer() const { return oscilloscopeBuffer.get(); }
+
     juce::CachedValue<juce::String> textTitle, textBody;
 
     // Add listener interface
@@ -56,6 +60,9 @@ public:
     public:
         virtual ~Listener() = default;
         virtual void oscilloscopePluginInitialised() = 0;
+
+        /** Called before the ring buffer is freed; detach any scope reading it. */
+        virtual void oscilloscopePluginDeinitialising() {}
     };
 
     void addListener(Listener* listener) { listeners.add(listener); }
@@ -64,6 +71,7 @@ public:
 private:
     static constexpr int BUFFER_SIZE = 1024;
     std::unique_ptr<RingBuffer<GLfloat>> oscilloscopeBuffer;
+    AudioBuffer<GLfloat> scratchBuffer; // sized in initialise so applyToBuffer never allocates
     std::unique_ptr<Oscilloscope2D> oscilloscope;
     juce::ListenerList<Listener> listeners;
 
@@ -23,8 +23,12 @@ PhaserComponent::PhaserComponent(tracktion::engine::Edit& edit)
     contentComponent.addAndMakeVisible(rateSlider);
     contentComponent.addAndMakeVisible(feedbackSlider);
 
-    // Create and setup plugin
-    plugin = EngineHelpers::getPluginFromRack(edit, AutoPhaserPlugin::xmlTypeName);
+    bindToEdit();
+}
+
+void PhaserComponent::bindToEdit()
+{
+    plugin = EngineHelpers::getPluginFromRack(*edit, AutoPhaserPlugin::xmlTypeName);
     
     if (plugin != nullptr)
     {
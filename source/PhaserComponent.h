@@ -13,6 +13,9 @@ public:
     void setRate(float value);
     void setFeedback(float value);
 
+protected:
+    void bindToEdit() override;
+
 private:
     RotarySliderComponent depthSlider { "Depth" };
     RotarySliderComponent rateSlider { "Rate" };
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <tracktion_engine/tracktion_engine.h>
+
+//==============================================================================
+/**
+    The transport position at a FrameScheduler frame's time.
+
+    The transport only moves once per audio block, so a playhead that reads it
+    every frame stalls for a frame or two and then jumps. The clock notes the
+    frame at which each new position arrived and carries it on by the time
+    elapsed since, until the next one takes over.
+
+    Message thread only.
+*/
+class PlayheadClock
+{
+public:
+    /** The position in seconds at timeMs (on the Time::getMillisecondCounterHiRes() clock). */
+    double getPosition (const tracktion::engine::TransportControl& transport, double timeMs)
+    {
+        const auto audioPosition = transport.getPosition().inSeconds();
+
+        if (! transport.isPlaying())
+        {
+            reset();
+            return audioPosition;
+        }
+
+        if (audioPosition != lastAudioPosition)
+        {
+            lastAudioPosition = audioPosition;
+            lastAudioTimeMs = timeMs;
+            return audioPosition;
+        }
+
+        // Beyond any block we run with the audio has stalled, and the playhead waits for it
+        const auto elapsedMs = juce::jlimit (0.0, maxExtrapolationMs, timeMs - lastAudioTimeMs);
+        return audioPosition + elapsedMs / 1000.0;
+    }
+
+    void reset() noexcept
+    {
+        lastAudioPosition = -1.0;
+        lastAudioTimeMs = 0.0;
+    }
+
+    static constexpr double maxExtrapolationMs = 50.0;
+
+private:
+    double lastAudioPosition = -1.0;
+    double lastAudioTimeMs = 0.0;
+};
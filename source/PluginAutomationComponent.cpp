@@ -34,9 +34,12 @@ PluginAutomationComponent::~PluginAutomationComponent()
 {
     // Clear height listener
     heightListener = nullptr;
+    setViewport(nullptr);
+    pluginState.removeListener(this);
     
     // Clear automation lanes first
     automationLanes.clear();
+    spareLanes.clear();
     
     // Clear buttons
     groupCollapseButton = nullptr;
@@ -84,16 +87,17 @@ void PluginAutomationComponent::paint(juce::Graphics& g)
     // Draw separators between lanes
     if (!isGroupCollapsed)
     {
-        auto bounds = getLocalBounds();
-        bounds.removeFromTop(headerHeight);
-        
+        auto clip = g.getClipBounds();
+
         for (size_t i = 0; i < automationLanes.size(); ++i)
         {
             auto& laneInfo = automationLanes[i];
-            float currentLaneHeight = laneInfo.isCollapsed ? collapsedLaneHeight : laneHeight;
             
             // Draw lane background
-            auto laneBounds = bounds.removeFromTop(currentLaneHeight);
+            auto laneBounds = getRowBounds(i);
+
+            if (! laneBounds.intersects(clip))
+                continue;
             
             // Flat background
             const auto laneColor = getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId).brighter(0.05f);
@@ -109,6 +113,28 @@ void PluginAutomationComponent::paint(juce::Graphics& g)
             // Add subtle highlight at top of header
             g.setColour(juce::Colours::white.withAlpha(0.03f));
             g.fillRect(headerBounds.removeFromTop(1));
+
+            // A collapsed lane shows the shape of its curve beside its name
+            if (laneInfo.isCollapsed)
+                updateSummary(laneInfo.summary, *laneInfo.parameter);
+
+            if (laneInfo.isCollapsed && ! laneInfo.summary.columns.empty())
+            {
+                auto summaryBounds = headerBounds.withTrimmedLeft((int) labelWidth).reduced(4, 3).toFloat();
+                const auto columnWidth = summaryBounds.getWidth() / (float) summaryColumns;
+                g.setColour(juce::Colours::orange.withAlpha(0.6f));
+
+                for (int c = 0; c < summaryColumns; ++c)
+                {
+                    if (auto& span = laneInfo.summary.columns[(size_t) c])
+                    {
+                        auto top = summaryBounds.getBottom() - span->getEnd() * summaryBounds.getHeight();
+                        auto bottom = summaryBounds.getBottom() - span->getStart() * summaryBounds.getHeight();
+                        g.fillRect(summaryBounds.getX() + (float) c * columnWidth, top,
+                                   juce::jmax(1.0f, columnWidth), juce::jmax(1.0f, bottom - top));
+                    }
+                }
+            }
             
             // Add separator line at bottom of lane
             if (i < automationLanes.size() - 1)
@@ -142,19 +168,18 @@ void PluginAutomationComponent::resized()
     
     // If group is collapsed, don't layout the lanes
     if (isGroupCollapsed)
+    {
+        updateVisibleLanes();
         return;
+    }
     
-    // Layout automation lanes
+    // Layout the row headers; the lanes themselves only exist for rows on screen
     for (size_t i = 0; i < automationLanes.size(); ++i)
     {
         auto& laneInfo = automationLanes[i];
         
-        // Calculate lane height based on collapsed state
-        float currentLaneHeight = laneInfo.isCollapsed ? collapsedLaneHeight : laneHeight;
-        auto laneBounds = bounds.removeFromTop(currentLaneHeight);
-        
         // Create header section
-        auto headerBounds = laneBounds.removeFromTop(25);
+        auto headerBounds = getRowBounds(i).removeFromTop(25);
         
         // Position collapse button
         if (laneInfo.collapseButton != nullptr)
@@ -176,30 +201,221 @@ void PluginAutomationComponent::resized()
                                         labelWidth - labelMargin,
                                         headerBounds.getHeight());
         }
-        
-        // Position automation lane if not collapsed
-        if (!laneInfo.isCollapsed && laneInfo.lane != nullptr)
-        {
-            laneInfo.lane->setBounds(laneBounds);
-            laneInfo.lane->setVisible(true);
-        }
+    }
+
+    updateVisibleLanes();
+}
+
+void PluginAutomationComponent::moved()
+{
+    updateVisibleLanes();
+}
+
+juce::Rectangle<int> PluginAutomationComponent::getRowBounds(size_t laneIndex) const
+{
+    auto y = headerHeight;
+
+    for (size_t i = 0; i < laneIndex; ++i)
+        y += automationLanes[i].isCollapsed ? collapsedLaneHeight : laneHeight;
+
+    const auto height = automationLanes[laneIndex].isCollapsed ? collapsedLaneHeight : laneHeight;
+    return { 0, (int) y, getWidth(), (int) height };
+}
+
+juce::Rectangle<int> PluginAutomationComponent::getVisibleArea() const
+{
+    if (viewport == nullptr)
+        return getLocalBounds();
+
+    return getLocalArea(viewport, viewport->getLocalBounds()).getIntersection(getLocalBounds());
+}
+
+void PluginAutomationComponent::updateVisibleLanes()
+{
+    const auto visibleArea = getVisibleArea();
+    std::vector<size_t> needLanes;
+
+    // Free the lanes that have left the screen before handing any out
+    for (size_t i = 0; i < automationLanes.size(); ++i)
+    {
+        auto& laneInfo = automationLanes[i];
+        auto laneBounds = getRowBounds(i).withTrimmedTop(25);
+        const auto onScreen = ! isGroupCollapsed && ! laneInfo.isCollapsed && laneBounds.intersects(visibleArea);
+
+        if (laneInfo.isCollapsed && ! isGroupCollapsed && getRowBounds(i).intersects(visibleArea))
+            updateSummary(laneInfo.summary, *laneInfo.parameter);
+
+        if (onScreen && laneInfo.lane == nullptr)
+            needLanes.push_back(i);
+        else if (! onScreen && laneInfo.lane != nullptr)
+            releaseLane(std::move(laneInfo.lane));
         else if (laneInfo.lane != nullptr)
-        {
-            laneInfo.lane->setVisible(false);
-        }
+            laneInfo.lane->setBounds(laneBounds);
+    }
+
+    for (auto i : needLanes)
+    {
+        auto& laneInfo = automationLanes[i];
+        laneInfo.lane = acquireLane();
+        laneInfo.lane->setParameter(laneInfo.parameter);
+        laneInfo.lane->setBounds(getRowBounds(i).withTrimmedTop(25));
+        laneInfo.lane->setVisible(true);
+    }
+}
+
+std::unique_ptr<AutomationLane> PluginAutomationComponent::acquireLane()
+{
+    if (spareLanes.empty())
+    {
+        auto lane = std::make_unique<AutomationLane>(edit, zoomState);
+        addChildComponent(*lane);
+        return lane;
+    }
+
+    auto lane = std::move(spareLanes.back());
+    spareLanes.pop_back();
+    return lane;
+}
+
+void PluginAutomationComponent::releaseLane(std::unique_ptr<AutomationLane> lane)
+{
+    // Parked lanes stop listening to their curve
+    lane->setVisible(false);
+    lane->setParameter(nullptr);
+    spareLanes.push_back(std::move(lane));
+}
+
+void PluginAutomationComponent::updateSummary(CurveSummary& summary, tracktion::engine::AutomatableParameter& param) const
+{
+    if (summary.isUpToDate)
+        return;
+
+    auto& curve = param.getCurve();
+    const auto numPoints = curve.getNumPoints();
+
+    summary.isUpToDate = true;
+    summary.columns.clear();
+
+    if (numPoints == 0)
+        return;
+
+    auto clip = EngineHelpers::getCurrentClip(edit);
+    const auto length = clip != nullptr ? clip->getPosition().getLength().inSeconds() : 60.0;
+    const auto range = param.getValueRange();
+    summary.columns.resize(summaryColumns);
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        auto point = curve.getPoint(i);
+        auto column = juce::jlimit(0, summaryColumns - 1, (int) (point.time.inSeconds() / length * summaryColumns));
+        auto value = juce::jlimit(0.0f, 1.0f, range.getLength() > 0.0f ? (point.value - range.getStart()) / range.getLength() : 0.0f);
+        auto& span = summary.columns[(size_t) column];
+
+        span = span.has_value() ? span->getUnionWith(value) : juce::Range<float>(value, value);
+    }
+}
+
+void PluginAutomationComponent::parentHierarchyChanged()
+{
+    setViewport(findParentComponentOfClass<juce::Viewport>());
+    updateVisibleLanes();
+}
+
+void PluginAutomationComponent::setViewport(juce::Viewport* newViewport)
+{
+    auto* newViewedComponent = newViewport != nullptr ? newViewport->getViewedComponent() : nullptr;
+
+    if (viewport == newViewport && viewedComponent == newViewedComponent)
+        return;
+
+    if (viewport != nullptr)
+        viewport->removeComponentListener(this);
+
+    if (viewedComponent != nullptr)
+        viewedComponent->removeComponentListener(this);
+
+    viewport = newViewport;
+    viewedComponent = newViewedComponent;
+
+    // Scrolling moves the viewed component; resizing the viewport shows more or less of it
+    if (viewport != nullptr)
+        viewport->addComponentListener(this);
+
+    if (viewedComponent != nullptr)
+        viewedComponent->addComponentListener(this);
+}
+
+void PluginAutomationComponent::componentMovedOrResized(juce::Component&, bool, bool)
+{
+    updateVisibleLanes();
+}
+
+void PluginAutomationComponent::componentBeingDeleted(juce::Component& component)
+{
+    if (&component == viewport || &component == viewedComponent)
+    {
+        component.removeComponentListener(this);
+
+        if (&component == viewport)
+            viewport = nullptr;
+        else
+            viewedComponent = nullptr;
+    }
+}
+
+void PluginAutomationComponent::valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier&)
+{
+    curveChanged(tree);
+}
+
+void PluginAutomationComponent::valueTreeChildAdded(juce::ValueTree& parent, juce::ValueTree&)
+{
+    curveChanged(parent);
+}
+
+void PluginAutomationComponent::valueTreeChildRemoved(juce::ValueTree& parent, juce::ValueTree&, int)
+{
+    curveChanged(parent);
+}
+
+void PluginAutomationComponent::curveChanged(const juce::ValueTree& tree)
+{
+    // A point moving, or one being added to or removed from its curve
+    const auto parent = tree.getParent();
+
+    for (size_t i = 0; i < automationLanes.size(); ++i)
+    {
+        auto& laneInfo = automationLanes[i];
+        const auto curveState = laneInfo.parameter->getCurve().state;
+
+        if (tree != curveState && parent != curveState)
+            continue;
+
+        laneInfo.summary.isUpToDate = false;
+
+        // Rebuilt when the row's next painted, so a drag only rebuilds it once a frame
+        if (laneInfo.isCollapsed && ! isGroupCollapsed)
+            repaint(getRowBounds(i).removeFromTop(25));
     }
 }
 
 void PluginAutomationComponent::setPlugin(tracktion::engine::Plugin* p)
 {
+    pluginState.removeListener(this);
     plugin = p;
+    pluginState = plugin != nullptr ? plugin->state : juce::ValueTree();
+    pluginState.addListener(this);
     updateAutomationLanes();
     resized();
 }
 
 void PluginAutomationComponent::updateAutomationLanes()
 {
-    // Clear existing lanes
+    // Clear existing rows, keeping their lanes for the new ones
+    for (auto& laneInfo : automationLanes)
+        if (laneInfo.lane != nullptr)
+            releaseLane(std::move(laneInfo.lane));
+
     automationLanes.clear();
     
     if (plugin != nullptr)
@@ -232,11 +448,7 @@ void PluginAutomationComponent::createAutomationLaneForParameter(tracktion::engi
         return;
         
     AutomationLaneInfo laneInfo;
-    
-    // Create and setup automation lane
-    laneInfo.lane = std::make_unique<AutomationLane>(edit, zoomState);
-    laneInfo.lane->setParameter(param);
-    addAndMakeVisible(*laneInfo.lane);
+    laneInfo.parameter = param;
     
     // Setup label
     laneInfo.nameLabel->setText(param->getParameterName(), juce::dontSendNotification);
@@ -247,6 +459,8 @@ void PluginAutomationComponent::createAutomationLaneForParameter(tracktion::engi
     const size_t laneIndex = automationLanes.size();
     laneInfo.collapseButton->onClick = [this, laneIndex]() { toggleLaneCollapsed(laneIndex); };
     addAndMakeVisible(*laneInfo.collapseButton);
+    laneInfo.nameLabel->setVisible(!isGroupCollapsed);
+    laneInfo.collapseButton->setVisible(!isGroupCollapsed);
     
     automationLanes.push_back(std::move(laneInfo));
 }
@@ -275,14 +489,20 @@ void PluginAutomationComponent::updateSize()
 
 void PluginAutomationComponent::toggleGroupCollapsed()
 {
-    isGroupCollapsed = !isGroupCollapsed;
+    setGroupCollapsed(!isGroupCollapsed);
+}
+
+void PluginAutomationComponent::setGroupCollapsed(bool shouldBeCollapsed)
+{
+    if (isGroupCollapsed == shouldBeCollapsed)
+        return;
+
+    isGroupCollapsed = shouldBeCollapsed;
     groupCollapseButton->setToggleState(isGroupCollapsed, juce::dontSendNotification);
     
-    // Show/hide all automation lanes based on group state
+    // Show/hide the row headers; resized() hands out or takes back the lanes
     for (auto& laneInfo : automationLanes)
     {
-        if (laneInfo.lane != nullptr)
-            laneInfo.lane->setVisible(!isGroupCollapsed);
         if (laneInfo.nameLabel != nullptr)
             laneInfo.nameLabel->setVisible(!isGroupCollapsed);
         if (laneInfo.collapseButton != nullptr)
@@ -301,8 +521,8 @@ void PluginAutomationComponent::toggleLaneCollapsed(size_t laneIndex)
         laneInfo.isCollapsed = !laneInfo.isCollapsed;
         laneInfo.collapseButton->setToggleState(laneInfo.isCollapsed, juce::dontSendNotification);
         
-        if (laneInfo.lane != nullptr)
-            laneInfo.lane->setVisible(!laneInfo.isCollapsed);
+        if (laneInfo.isCollapsed)
+            updateSummary(laneInfo.summary, *laneInfo.parameter);
             
         notifyHeightChanged();
         resized();
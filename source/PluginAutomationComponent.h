@@ -5,8 +5,15 @@
 #include <tracktion_engine/tracktion_engine.h>
 #include "AutomationLane.h"
 #include "ZoomState.h"
+#include <optional>
 
-class PluginAutomationComponent : public juce::Component
+// One plugin's automation: a header, then a row per parameter. Only the rows on
+// screen get a live AutomationLane (with its curve listeners); lanes scrolled
+// out of the viewport are recycled, and collapsed rows draw a small summary of
+// their curve instead.
+class PluginAutomationComponent : public juce::Component,
+                                  private juce::ComponentListener,
+                                  private juce::ValueTree::Listener
 {
 public:
     class HeightListener
@@ -24,9 +31,12 @@ public:
 
     void paint(juce::Graphics& g) override;
     void resized() override;
+    void moved() override;
+    void parentHierarchyChanged() override;
 
     void setPlugin(tracktion::engine::Plugin* plugin);
     void setAllowedParameterIDs(const std::vector<juce::String>& paramIDs) { allowedParameterIDs = paramIDs; updateAutomationLanes(); }
+    void setGroupCollapsed(bool shouldBeCollapsed);
     
     // Add method to get preferred height
     float getPreferredHeight() const;
@@ -37,6 +47,23 @@ private:
     void createAutomationLaneForParameter(tracktion::engine::AutomatableParameter* param);
     void toggleLaneCollapsed(size_t laneIndex);
     void toggleGroupCollapsed();
+
+    // Gives the rows in the viewport a lane and takes them from the rest
+    void updateVisibleLanes();
+    juce::Rectangle<int> getVisibleArea() const;
+    juce::Rectangle<int> getRowBounds(size_t laneIndex) const;
+    std::unique_ptr<AutomationLane> acquireLane();
+    void releaseLane(std::unique_ptr<AutomationLane>);
+
+    void componentMovedOrResized(juce::Component&, bool wasMoved, bool wasResized) override;
+    void componentBeingDeleted(juce::Component&) override;
+    void setViewport(juce::Viewport*);
+
+    // The plugin's state holds its curves, so its listener hears every point change
+    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded(juce::ValueTree& parent, juce::ValueTree&) override;
+    void valueTreeChildRemoved(juce::ValueTree& parent, juce::ValueTree&, int) override;
+    void curveChanged(const juce::ValueTree&);
     void notifyHeightChanged() 
     { 
         if (heightListener != nullptr)
@@ -45,13 +72,29 @@ private:
 
     tracktion::engine::Edit& edit;
     tracktion::engine::Plugin* plugin = nullptr;
+    juce::ValueTree pluginState;
     bool isGroupCollapsed = true;
     std::unique_ptr<juce::DrawableButton> groupCollapseButton;
     ZoomState& zoomState;
+    juce::Viewport* viewport = nullptr;
+    juce::Component* viewedComponent = nullptr;
     std::vector<juce::String> allowedParameterIDs;
     
+    // A collapsed row's curve as the span of values in each of a fixed number of
+    // columns across the clip, rebuilt when it's next drawn after its curve changes
+    struct CurveSummary
+    {
+        bool isUpToDate = false;
+        std::vector<std::optional<juce::Range<float>>> columns;     // normalised values
+    };
+
+    static constexpr int summaryColumns = 128;
+    void updateSummary(CurveSummary&, tracktion::engine::AutomatableParameter&) const;
+
     struct AutomationLaneInfo {
-        std::unique_ptr<AutomationLane> lane;
+        tracktion::engine::AutomatableParameter* parameter = nullptr;
+        std::unique_ptr<AutomationLane> lane;       // only while the row is on screen
+        CurveSummary summary;
         std::unique_ptr<juce::Label> nameLabel;
         std::unique_ptr<juce::DrawableButton> collapseButton;
         bool isCollapsed = false;
@@ -85,6 +128,7 @@ private:
     };
     
     std::vector<AutomationLaneInfo> automationLanes;
+    std::vector<std::unique_ptr<AutomationLane>> spareLanes;
     
     const float laneHeight = 60.0f;
     const float collapsedLaneHeight = 25.0f;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <tracktion_engine/tracktion_engine.h>
+#include "EffectIdleDetector.h"
+#include "RealtimeSanitizer.h"
 
 using namespace tracktion::engine;
 
@@ -17,6 +19,8 @@ public:
         auto um = getUndoManager();
         length.referTo(state, IDs::length, um, 0.0f);
         autoLengthMs->attachToCurrentValue(length);
+
+        mixParam = getAutomatableParameterByID("mix proportion");
     }
 
     ~AutoDelayPlugin() override
@@ -32,6 +36,34 @@ public:
     juce::String getShortName(int) override            { return getName(); }
     juce::String getSelectableDescription() override   { return TRANS("Auto Delay Plugin"); }
 
+    void initialise(const PluginInitialisationInfo& info) override
+    {
+        DelayPlugin::initialise(info);
+        idleDetector.prepare(info.sampleRate, info.blockSizeSamples);
+    }
+
+    void applyToBuffer(const PluginRenderContext& fc) override
+    {
+        CHOPSHOP_SCOPED_REALTIME
+
+        if (fc.destBuffer == nullptr)
+            return;
+
+        // Keeps running at zero mix until the echoes have died away
+        const bool mixOff = mixParam != nullptr && mixParam->getCurrentValue() <= 0.0f;
+
+        if (idleDetector.canSkipBlock(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, mixOff))
+            return;
+
+        if (idleDetector.hasJustResumed())
+            reset();
+
+        DelayPlugin::applyToBuffer(fc);
+        idleDetector.blockProcessed(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+    }
+
+    bool isSuspended() const noexcept  { return idleDetector.isSuspended(); }
+
     void setLength(float value)    { autoLengthMs->setParameter(juce::jlimit(0.0f, 1000.0f, value), juce::sendNotification); }
     float getLength()              { return autoLengthMs->getCurrentValue(); }
 
@@ -39,6 +71,8 @@ public:
 
 private:
     juce::CachedValue<float> length;
+    AutomatableParameter::Ptr mixParam;
+    EffectIdleDetector idleDetector;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoDelayPlugin)
 };
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <tracktion_engine/tracktion_engine.h>
+#include "EffectIdleDetector.h"
+#include "RealtimeSanitizer.h"
 
 using namespace tracktion::engine;
 
@@ -43,5 +45,34 @@ public:
   juce::String getShortName(int) override { return getName(); }
   juce::String getSelectableDescription() override { return TRANS("Auto Phaser Plugin"); }
 
+  void initialise(const PluginInitialisationInfo& info) override
+  {
+    PhaserPlugin::initialise(info);
+    idleDetector.prepare(info.sampleRate, info.blockSizeSamples);
+  }
+
+  void applyToBuffer(const PluginRenderContext& fc) override
+  {
+    CHOPSHOP_SCOPED_REALTIME
+
+    if (fc.destBuffer == nullptr)
+      return;
+
+    // The phaser has no mix control; depth at zero is its off position
+    if (idleDetector.canSkipBlock(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, depthParam->getCurrentValue() <= 0.0f))
+      return;
+
+    if (idleDetector.hasJustResumed())
+      reset();
+
+    PhaserPlugin::applyToBuffer(fc);
+    idleDetector.blockProcessed(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+  }
+
+  bool isSuspended() const noexcept { return idleDetector.isSuspended(); }
+
   AutomatableParameter::Ptr depthParam, rateParam, feedbackGainParam;
+
+private:
+  EffectIdleDetector idleDetector;
 };
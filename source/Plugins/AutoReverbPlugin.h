@@ -0,0 +1,66 @@
+#pragma once
+
+#include <tracktion_engine/tracktion_engine.h>
+#include "EffectIdleDetector.h"
+#include "RealtimeSanitizer.h"
+
+using namespace tracktion::engine;
+
+// The master-rack reverb. Library items imported before this existed still use
+// the plain ReverbPlugin, so look this up with ReverbPlugin as the fallback.
+class AutoReverbPlugin : public ReverbPlugin
+{
+public:
+    AutoReverbPlugin(PluginCreationInfo info)
+        : ReverbPlugin(info)
+    {
+        wetParam = getAutomatableParameterByID("wet level");
+    }
+
+    ~AutoReverbPlugin() override
+    {
+        notifyListenersOfDeletion();
+    }
+
+    static const char* getPluginName()                  { return NEEDS_TRANS("Auto Reverb"); }
+    static constexpr const char* xmlTypeName = "auto-reverb";
+
+    juce::String getName() const override               { return TRANS("Reverb"); }
+    juce::String getPluginType() override              { return xmlTypeName; }
+    juce::String getShortName(int) override            { return getName(); }
+    juce::String getSelectableDescription() override   { return TRANS("Auto Reverb Plugin"); }
+
+    void initialise(const PluginInitialisationInfo& info) override
+    {
+        ReverbPlugin::initialise(info);
+        idleDetector.prepare(info.sampleRate, info.blockSizeSamples);
+    }
+
+    void applyToBuffer(const PluginRenderContext& fc) override
+    {
+        CHOPSHOP_SCOPED_REALTIME
+
+        if (fc.destBuffer == nullptr)
+            return;
+
+        // At zero wet the dry gain still applies, so this only suspends on silence
+        const bool wetOff = wetParam != nullptr && wetParam->getCurrentValue() <= 0.0f;
+
+        if (idleDetector.canSkipBlock(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, wetOff))
+            return;
+
+        if (idleDetector.hasJustResumed())
+            reset();
+
+        ReverbPlugin::applyToBuffer(fc);
+        idleDetector.blockProcessed(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+    }
+
+    bool isSuspended() const noexcept  { return idleDetector.isSuspended(); }
+
+private:
+    AutomatableParameter::Ptr wetParam;
+    EffectIdleDetector idleDetector;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoReverbPlugin)
+};
@@ -1,11 +1,16 @@
 #pragma once
 
 #include <tracktion_engine/tracktion_engine.h>
+#include <optional>
 
+#include "FrameScheduler.h"
+#include "RealtimeSanitizer.h"
 #include "Utilities.h"
 
 class ChopPlugin : public tracktion::engine::Plugin,
-                  private juce::Timer
+                  private FrameScheduler::Client,
+                  private juce::ChangeListener,
+                  private juce::AsyncUpdater
 {
 public:
     static const char* getPluginName() { return NEEDS_TRANS("Chop"); }
@@ -32,15 +37,24 @@ public:
             DBG("Remapping on tempo change on Plugin is disabled.");
         }
         
-        // Start the timer to check clip states
-        startTimerHz(30); // Check 30 times per second
+        // Check the clip states every frame while the transport plays. Library
+        // Edits are built on the EditPreloader's thread, so the transport and the
+        // frame scheduler are only touched once we're on the message thread.
+        triggerAsyncUpdate();
         
         DBG("ChopPlugin constructor complete");
     }
 
     ~ChopPlugin() override
     {
-        stopTimer();
+        cancelPendingUpdate();
+
+        if (frameScheduler.has_value())
+        {
+            (*frameScheduler)->stopAnimating(*this);
+            edit.getTransport().removeChangeListener(this);
+        }
+
         notifyListenersOfDeletion();
     }
 
@@ -60,6 +74,8 @@ public:
     
     void applyToBuffer(const tracktion::engine::PluginRenderContext& fc) override 
     {
+        CHOPSHOP_SCOPED_REALTIME
+
         // This plugin doesn't process audio directly
         // Instead it controls the volume of two tracks via their VolumeAndPanPlugins
     }
@@ -92,7 +108,31 @@ public:
         updateTrackVolumes();
     }
 
-    void timerCallback() override
+    void changeListenerCallback(juce::ChangeBroadcaster*) override
+    {
+        if (! frameScheduler.has_value())
+            return;
+
+        if (edit.getTransport().isPlaying())
+            (*frameScheduler)->startAnimating(*this);
+        else
+            (*frameScheduler)->stopAnimating(*this);
+    }
+
+    void handleAsyncUpdate() override
+    {
+        if (! frameScheduler.has_value())
+        {
+            // Acquired here rather than as a member so the shared scheduler is
+            // never created on the EditPreloader's thread.
+            frameScheduler.emplace();
+            edit.getTransport().addChangeListener(this);
+        }
+
+        changeListenerCallback(nullptr);
+    }
+
+    void frameCallback(double) override
     {
         auto& transport = edit.getTransport();
         bool isTransportPlaying = transport.isPlaying();
@@ -104,16 +144,11 @@ public:
         }
         if (auto chopTrack = EngineHelpers::getChopTrack(edit))
         {
-            DBG("ChopPlugin::timerCallback - Chop track found");
-            DBG("ChopPlugin::timerCallback - Chop track clips: " + juce::String(chopTrack->getClips().size()));
             for (auto clip : chopTrack->getClips())
             {
                 auto currentPosition = transport.getPosition();
                 auto clipPosition = clip->getPosition();
 
-                DBG("ChopPlugin::timerCallback - Clip position: " + juce::String(clipPosition.getStart().inSeconds()) + " - " + juce::String(clipPosition.getEnd().inSeconds()));
-                DBG("ChopPlugin::timerCallback - Current position: " + juce::String(currentPosition.inSeconds()));
-
                 bool isClipPlaying = currentPosition >= clipPosition.getStart() 
                                         && currentPosition < clipPosition.getEnd();
                 if (isClipPlaying)
@@ -176,6 +211,8 @@ public:
     }
 
 private:
+    std::optional<juce::SharedResourcePointer<FrameScheduler>> frameScheduler;    // message thread only
+
     double sampleRate = 48000.0;
     int blockSize = 512;
     float track1Volume = 1.0f;
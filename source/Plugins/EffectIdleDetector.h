@@ -0,0 +1,135 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/**
+    Lets a master-rack effect skip its processing while it can't be heard.
+
+    An effect is idle when its controls are in their "off" position (mix or
+    depth at zero) or its input is silent. Being idle isn't enough on its own:
+    the effect only suspends once its output has also matched its input for
+    the hold time, so delay and reverb tails ring out first and an effect whose
+    off position isn't transparent (e.g. a fixed dry gain) never suspends on
+    its controls.
+
+    While suspended the block is left untouched. As soon as a control moves or
+    audio arrives, hasJustResumed() returns true once so the effect can clear
+    its (stale) internal state before processing again. The effect resumes
+    from silence or from its transparent "off" position, so the resume is
+    click-free.
+
+    Usage in applyToBuffer:
+    @code
+    if (idleDetector.canSkipBlock (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, mix == 0.0f))
+        return;
+
+    if (idleDetector.hasJustResumed())
+        reset();
+
+    ...process...
+
+    idleDetector.blockProcessed (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+    @endcode
+*/
+class EffectIdleDetector
+{
+public:
+    EffectIdleDetector() = default;
+
+    /** Allocates the dry copy; call from the plugin's initialise(). */
+    void prepare (double sampleRate, int maxBlockSize, double holdSeconds = 0.25)
+    {
+        dryCopy.setSize (maxNumChannels, juce::jmax (maxBlockSize, 1), false, false, true);
+        holdSamples = (juce::int64) (sampleRate * holdSeconds);
+        quietSamples = 0;
+        suspended = false;
+        justResumed = false;
+    }
+
+    /** Returns true if this block can be left as it is. Otherwise keeps a copy
+        of the dry input, when needed, for blockProcessed() to compare against.
+    */
+    bool canSkipBlock (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples, bool controlsInactive) noexcept
+    {
+        const auto numChannels = juce::jmin (buffer.getNumChannels(), maxNumChannels);
+
+        // Blocks bigger than we prepared for are processed rather than measured
+        isMeasuring = numSamples <= dryCopy.getNumSamples()
+                        && (controlsInactive || isSilent (buffer, numChannels, startSample, numSamples));
+
+        if (suspended)
+        {
+            if (isMeasuring)
+                return true;
+
+            suspended = false;
+            justResumed = true;
+            quietSamples = 0;
+        }
+
+        if (isMeasuring)
+            for (int ch = 0; ch < numChannels; ++ch)
+                dryCopy.copyFrom (ch, 0, buffer, ch, startSample, numSamples);
+
+        return false;
+    }
+
+    /** Compares the processed block with the dry copy and suspends once the
+        effect has been idle and transparent for the hold time.
+    */
+    void blockProcessed (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+    {
+        justResumed = false;
+
+        if (! isMeasuring)
+        {
+            quietSamples = 0;
+            return;
+        }
+
+        const auto numChannels = juce::jmin (buffer.getNumChannels(), maxNumChannels);
+        float maxDifference = 0.0f;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            // The dry copy isn't needed after this, so the difference is written over it
+            auto* diff = dryCopy.getWritePointer (ch);
+            juce::FloatVectorOperations::subtract (diff, buffer.getReadPointer (ch, startSample), diff, numSamples);
+            const auto range = juce::FloatVectorOperations::findMinAndMax (diff, numSamples);
+            maxDifference = juce::jmax (maxDifference, -range.getStart(), range.getEnd());
+        }
+
+        quietSamples = maxDifference < threshold ? quietSamples + numSamples : 0;
+        suspended = quietSamples >= holdSamples;
+    }
+
+    /** True for the first block processed after a suspension. */
+    bool hasJustResumed() const noexcept    { return justResumed; }
+    bool isSuspended() const noexcept       { return suspended; }
+
+    /** -100 dBFS: below anything audible on the master */
+    static constexpr float threshold = 1.0e-5f;
+
+private:
+    static constexpr int maxNumChannels = 2;
+
+    juce::AudioBuffer<float> dryCopy;
+    juce::int64 holdSamples = 0, quietSamples = 0;
+    bool isMeasuring = false, suspended = false, justResumed = false;
+
+    static bool isSilent (const juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax (buffer.getReadPointer (ch, startSample), numSamples);
+
+            if (range.getStart() < -threshold || range.getEnd() > threshold)
+                return false;
+        }
+
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EffectIdleDetector)
+};
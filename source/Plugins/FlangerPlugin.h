@@ -1,6 +1,8 @@
 #pragma once
 
 #include <tracktion_engine/tracktion_engine.h>
+#include "EffectIdleDetector.h"
+#include "RealtimeSanitizer.h"
 
 using namespace tracktion::engine;
 
@@ -54,6 +56,7 @@ public:
     void initialise(const PluginInitialisationInfo& info) override 
     { 
         ChorusPlugin::initialise(info); 
+        idleDetector.prepare(info.sampleRate, info.blockSizeSamples);
     }
 
     void restorePluginStateFromValueTree(const juce::ValueTree& v) override 
@@ -61,6 +64,25 @@ public:
         ChorusPlugin::restorePluginStateFromValueTree(v); 
     }
 
+    void applyToBuffer(const PluginRenderContext& fc) override
+    {
+        CHOPSHOP_SCOPED_REALTIME
+
+        if (fc.destBuffer == nullptr)
+            return;
+
+        if (idleDetector.canSkipBlock(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, getMix() <= 0.0f))
+            return;
+
+        if (idleDetector.hasJustResumed())
+            reset();
+
+        ChorusPlugin::applyToBuffer(fc);
+        idleDetector.blockProcessed(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+    }
+
+    bool isSuspended() const noexcept { return idleDetector.isSuspended(); }
+
     AutomatableParameter::Ptr depthParam, speedParam,
         widthParam, mixParam;
 
@@ -77,5 +99,7 @@ public:
     float getMix() { return mixParam->getCurrentValue(); }
 
 private:
+    EffectIdleDetector idleDetector;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FlangerPlugin)
 };
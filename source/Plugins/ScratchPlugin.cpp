@@ -1,4 +1,5 @@
 #include "ScratchPlugin.h"
+#include "RealtimeSanitizer.h"
 
 const char* ScratchPlugin::xmlTypeName = "scratch";
 
@@ -57,6 +58,8 @@ void ScratchPlugin::initialise(const tracktion::engine::PluginInitialisationInfo
     
     // Update smoothing time based on sample rate
     smoothedScratchPos.reset(sampleRate, 0.05);
+
+    idleDetector.prepare(sampleRate, info.blockSizeSamples);
 }
 
 void ScratchPlugin::deinitialise()
@@ -129,13 +132,27 @@ void ScratchPlugin::applyToBuffer(const tracktion::engine::PluginRenderContext&
         return;
         
     SCOPED_REALTIME_CHECK
+    CHOPSHOP_SCOPED_REALTIME
     
     const float wetGain = mixParam->getCurrentValue();
     const float dryGain = 1.0f - wetGain;
     
+    // Suspended at zero mix or on silence: no processing and no history writes
+    if (idleDetector.canSkipBlock(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, wetGain <= 0.0f))
+        return;
+    
     const int lengthInSamples = (int)(sampleRate * 4.0); // 4 second buffer
     scratchBuffer.ensureMaxBufferSize(lengthInSamples);
     
+    // The history stopped while we were suspended, so start from silence rather
+    // than scratching back into stale audio
+    if (idleDetector.hasJustResumed())
+    {
+        scratchBuffer.clearBuffer();
+        smoothedScratchPos.setCurrentAndTargetValue(0.0f);
+        smoothedAcceleration.setCurrentAndTargetValue(0.0f);
+    }
+    
     const int offset = scratchBuffer.bufferPos;
     
     // Clear any channels we're not using
@@ -153,10 +170,13 @@ void ScratchPlugin::applyToBuffer(const tracktion::engine::PluginRenderContext&
     smoothedDepth.setTargetValue(currentDepth);
     smoothedAcceleration.setTargetValue(std::abs(processedScratch - smoothedScratchPos.getCurrentValue()));
     
-    // If scratch is at neutral position (very close to 0), just pass through the audio
+    // If scratch is at neutral position (very close to 0), just pass through the audio,
+    // keeping the history current so a scratch starts from what was just played
     if (std::abs(rawScratch) < 0.05f) // Slightly larger dead zone
     {
+        writeHistory(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, lengthInSamples);
         scratchBuffer.bufferPos = (scratchBuffer.bufferPos + fc.bufferNumSamples) % lengthInSamples;
+        idleDetector.blockProcessed(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
         return;
     }
     
@@ -201,6 +221,22 @@ void ScratchPlugin::applyToBuffer(const tracktion::engine::PluginRenderContext&
     scratchBuffer.bufferPos = (scratchBuffer.bufferPos + fc.bufferNumSamples) % lengthInSamples;
     
     tracktion::engine::zeroDenormalisedValuesIfNeeded(*fc.destBuffer);
+    idleDetector.blockProcessed(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+}
+
+void ScratchPlugin::writeHistory(const juce::AudioBuffer<float>& source, int startSample, int numSamples, int lengthInSamples)
+{
+    const int offset = scratchBuffer.bufferPos;
+    const int firstPart = std::min(numSamples, lengthInSamples - offset);
+
+    for (int chan = std::min(2, source.getNumChannels()); --chan >= 0;)
+    {
+        float* const buf = (float*)scratchBuffer.buffers[chan].getData();
+        const float* const src = source.getReadPointer(chan, startSample);
+
+        juce::FloatVectorOperations::copy(buf + offset, src, firstPart);
+        juce::FloatVectorOperations::copy(buf, src + firstPart, numSamples - firstPart);
+    }
 }
 
 void ScratchPlugin::restorePluginStateFromValueTree(const juce::ValueTree& v)
@@ -3,6 +3,7 @@
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
 #include <tracktion_engine/tracktion_engine.h>
+#include "EffectIdleDetector.h"
 
 //==============================================================================
 struct ScratchBufferBase
@@ -64,6 +65,8 @@ public:
     void applyToBuffer(const tracktion::engine::PluginRenderContext&) override;
     void restorePluginStateFromValueTree(const juce::ValueTree&) override;
 
+    bool isSuspended() const noexcept { return idleDetector.isSuspended(); }
+
     // Parameters
     juce::CachedValue<float> scratchValue, depthValue, mixValue;
     tracktion::engine::AutomatableParameter::Ptr scratchParam, depthParam, mixParam;
@@ -72,12 +75,14 @@ private:
     float interpolateHermite4pt3oX(float x, float y0, float y1, float y2, float y3);
     float getSampleAtPosition(float* buf, int bufferLength, float position);
     float processNonLinearScratch(float input, float depth) const;
+    void writeHistory(const juce::AudioBuffer<float>& source, int startSample, int numSamples, int lengthInSamples);
     
     ScratchBufferBase scratchBuffer;
     double sampleRate = 44100.0;
     juce::SmoothedValue<float> smoothedScratchPos;
     juce::SmoothedValue<float> smoothedAcceleration;
     juce::SmoothedValue<float> smoothedDepth;
+    EffectIdleDetector idleDetector;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScratchPlugin)
 }; 
\ No newline at end of file
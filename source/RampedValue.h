@@ -3,12 +3,19 @@
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
 
+#include "FrameScheduler.h"
 
-class RampedValue : public juce::Timer
+// Eases towards a target over rampLengthMs, stepped once per display frame
+class RampedValue : private FrameScheduler::Client
 {
 public:
     RampedValue(double initialValue = 0.0, int rampLengthMs = 500) 
         : currentValue(initialValue), rampDurationMs(rampLengthMs) {}
+
+    ~RampedValue() override
+    {
+        frameScheduler->stopAnimating(*this);
+    }
     
     void startRamp(double targetVal)
     {
@@ -16,15 +23,15 @@ public:
         targetValue = targetVal;
         startTime = juce::Time::getMillisecondCounterHiRes();
         isRamping = true;
-        startTimerHz(60);
+        frameScheduler->startAnimating(*this);
     }
     
-    void timerCallback() override
+    void frameCallback(double timeMs) override
     {
         if (!isRamping) return;
         
-        double elapsed = juce::Time::getMillisecondCounterHiRes() - startTime;
-        double progress = juce::jmin(elapsed / rampDurationMs, 1.0);
+        double elapsed = timeMs - startTime;
+        double progress = juce::jlimit(0.0, 1.0, elapsed / rampDurationMs);
         
         // Use cubic easing for smooth ramping
         double easedProgress = 1.0 - std::pow(1.0 - progress, 3.0);
@@ -36,13 +43,14 @@ public:
         if (progress >= 1.0)
         {
             isRamping = false;
-            stopTimer();
+            frameScheduler->stopAnimating(*this);
         }
     }
     
     std::function<void(double)> onValueChange;
     
 private:
+    juce::SharedResourcePointer<FrameScheduler> frameScheduler;
     double startValue = 0.0;
     double targetValue = 0.0;
     double currentValue = 0.0;
@@ -0,0 +1,274 @@
+#include "RealtimeSanitizer.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if CHOPSHOP_RT_SANITIZER && JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+#if CHOPSHOP_RT_SANITIZER && JUCE_LINUX
+ #define CHOPSHOP_RT_SANITIZER_HOOK_MALLOC 1
+
+ // glibc's own allocator entry points, so our malloc can forward without recursing
+ extern "C"
+ {
+     void* __libc_malloc (size_t);
+     void* __libc_calloc (size_t, size_t);
+     void* __libc_realloc (void*, size_t);
+     void* __libc_memalign (size_t, size_t);
+     void __libc_free (void*);
+ }
+#else
+ #define CHOPSHOP_RT_SANITIZER_HOOK_MALLOC 0
+#endif
+
+#if CHOPSHOP_RT_SANITIZER && (JUCE_LINUX || JUCE_MAC)
+ #define CHOPSHOP_RT_SANITIZER_HOOK_PTHREAD 1
+ #include <dlfcn.h>
+ #include <pthread.h>
+#else
+ #define CHOPSHOP_RT_SANITIZER_HOOK_PTHREAD 0
+#endif
+
+namespace RealtimeSanitizer
+{
+namespace
+{
+    // Trivial thread_locals in the executable use the initial-exec TLS model,
+    // so touching them from inside malloc can't call back into the allocator
+    thread_local int realtimeDepth = 0;
+    thread_local bool isReporting = false;
+
+    std::atomic<int> violationCount { 0 };
+    std::atomic<Mode> mode { Mode::log };
+
+    // After this many full reports only a running total is printed, otherwise
+    // a per-block violation floods the console
+    constexpr int maxFullReports = 32;
+}
+
+ScopedRealtime::ScopedRealtime() noexcept   { ++realtimeDepth; }
+ScopedRealtime::~ScopedRealtime() noexcept  { --realtimeDepth; }
+
+ScopedNonRealtime::ScopedNonRealtime() noexcept  : savedDepth (realtimeDepth) { realtimeDepth = 0; }
+ScopedNonRealtime::~ScopedNonRealtime() noexcept { realtimeDepth = savedDepth; }
+
+bool isEnabled() noexcept           { return CHOPSHOP_RT_SANITIZER != 0; }
+bool isRealtimeThread() noexcept    { return realtimeDepth > 0; }
+void setMode (Mode newMode) noexcept { mode = newMode; }
+
+int getViolationCount() noexcept    { return violationCount.load(); }
+void resetViolationCount() noexcept { violationCount = 0; }
+
+void checkCall (const char* functionName) noexcept
+{
+    if (realtimeDepth == 0 || isReporting)
+        return;
+
+    // Building the report allocates, so drop the real-time mark while we do it
+    const ScopedNonRealtime nonRealtime;
+    isReporting = true;
+
+    const auto count = ++violationCount;
+
+    if (count <= maxFullReports)
+    {
+        const auto message = juce::String ("*** Real-time violation #") + juce::String (count) + ": "
+                           + functionName + " called on a real-time thread\n"
+                           + juce::SystemStats::getStackBacktrace() + "\n";
+
+        std::fputs (message.toRawUTF8(), stderr);
+        std::fflush (stderr);
+    }
+    else if (count % 1000 == 0)
+    {
+        std::fprintf (stderr, "*** %d real-time violations so far\n", count);
+    }
+
+    isReporting = false;
+
+    switch (mode.load())
+    {
+        case Mode::breakpoint:  JUCE_BREAK_IN_DEBUGGER; break;
+        case Mode::abort:       std::abort();
+        case Mode::log:         break;
+    }
+}
+}
+
+#if CHOPSHOP_RT_SANITIZER
+
+//==============================================================================
+namespace
+{
+   #if CHOPSHOP_RT_SANITIZER_HOOK_MALLOC
+    void* rawMalloc (size_t size) noexcept  { return __libc_malloc (size); }
+    void rawFree (void* ptr) noexcept       { __libc_free (ptr); }
+   #else
+    void* rawMalloc (size_t size) noexcept  { return std::malloc (size); }
+    void rawFree (void* ptr) noexcept       { std::free (ptr); }
+   #endif
+
+   #if JUCE_WINDOWS
+    void* rawAlignedMalloc (size_t size, size_t alignment) noexcept  { return _aligned_malloc (size, alignment); }
+    void rawAlignedFree (void* ptr) noexcept                        { _aligned_free (ptr); }
+   #elif CHOPSHOP_RT_SANITIZER_HOOK_MALLOC
+    void* rawAlignedMalloc (size_t size, size_t alignment) noexcept  { return __libc_memalign (alignment, size); }
+    void rawAlignedFree (void* ptr) noexcept                        { __libc_free (ptr); }
+   #else
+    void* rawAlignedMalloc (size_t size, size_t alignment) noexcept
+    {
+        void* ptr = nullptr;
+        return posix_memalign (&ptr, juce::jmax (alignment, sizeof (void*)), size) == 0 ? ptr : nullptr;
+    }
+
+    void rawAlignedFree (void* ptr) noexcept                        { std::free (ptr); }
+   #endif
+
+    void* checkedNew (size_t size, const char* functionName)
+    {
+        RealtimeSanitizer::checkCall (functionName);
+
+        if (auto* ptr = rawMalloc (size > 0 ? size : 1))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    void* checkedNewNoThrow (size_t size, const char* functionName) noexcept
+    {
+        RealtimeSanitizer::checkCall (functionName);
+        return rawMalloc (size > 0 ? size : 1);
+    }
+
+    void checkedDelete (void* ptr, const char* functionName) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        RealtimeSanitizer::checkCall (functionName);
+        rawFree (ptr);
+    }
+
+    void* checkedAlignedNewNoThrow (size_t size, std::align_val_t alignment, const char* functionName) noexcept
+    {
+        RealtimeSanitizer::checkCall (functionName);
+        return rawAlignedMalloc (size > 0 ? size : 1, (size_t) alignment);
+    }
+
+    void* checkedAlignedNew (size_t size, std::align_val_t alignment, const char* functionName)
+    {
+        if (auto* ptr = checkedAlignedNewNoThrow (size, alignment, functionName))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    void checkedAlignedDelete (void* ptr, const char* functionName) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        RealtimeSanitizer::checkCall (functionName);
+        rawAlignedFree (ptr);
+    }
+}
+
+void* operator new (size_t size)                                   { return checkedNew (size, "operator new"); }
+void* operator new[] (size_t size)                                 { return checkedNew (size, "operator new[]"); }
+void* operator new (size_t size, const std::nothrow_t&) noexcept   { return checkedNewNoThrow (size, "operator new"); }
+void* operator new[] (size_t size, const std::nothrow_t&) noexcept { return checkedNewNoThrow (size, "operator new[]"); }
+
+void operator delete (void* ptr) noexcept                                { checkedDelete (ptr, "operator delete"); }
+void operator delete[] (void* ptr) noexcept                              { checkedDelete (ptr, "operator delete[]"); }
+void operator delete (void* ptr, size_t) noexcept                        { checkedDelete (ptr, "operator delete"); }
+void operator delete[] (void* ptr, size_t) noexcept                      { checkedDelete (ptr, "operator delete[]"); }
+void operator delete (void* ptr, const std::nothrow_t&) noexcept         { checkedDelete (ptr, "operator delete"); }
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept       { checkedDelete (ptr, "operator delete[]"); }
+
+// Over-aligned types (e.g. SIMD buffers) use these; their memory has to come
+// back through the matching aligned delete
+void* operator new (size_t size, std::align_val_t alignment)                                    { return checkedAlignedNew (size, alignment, "operator new"); }
+void* operator new[] (size_t size, std::align_val_t alignment)                                  { return checkedAlignedNew (size, alignment, "operator new[]"); }
+void* operator new (size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept    { return checkedAlignedNewNoThrow (size, alignment, "operator new"); }
+void* operator new[] (size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept  { return checkedAlignedNewNoThrow (size, alignment, "operator new[]"); }
+
+void operator delete (void* ptr, std::align_val_t) noexcept                          { checkedAlignedDelete (ptr, "operator delete"); }
+void operator delete[] (void* ptr, std::align_val_t) noexcept                        { checkedAlignedDelete (ptr, "operator delete[]"); }
+void operator delete (void* ptr, size_t, std::align_val_t) noexcept                  { checkedAlignedDelete (ptr, "operator delete"); }
+void operator delete[] (void* ptr, size_t, std::align_val_t) noexcept                { checkedAlignedDelete (ptr, "operator delete[]"); }
+void operator delete (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept   { checkedAlignedDelete (ptr, "operator delete"); }
+void operator delete[] (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { checkedAlignedDelete (ptr, "operator delete[]"); }
+
+//==============================================================================
+#if CHOPSHOP_RT_SANITIZER_HOOK_MALLOC
+extern "C"
+{
+    void* malloc (size_t size) noexcept
+    {
+        RealtimeSanitizer::checkCall ("malloc");
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t num, size_t size) noexcept
+    {
+        RealtimeSanitizer::checkCall ("calloc");
+        return __libc_calloc (num, size);
+    }
+
+    void* realloc (void* ptr, size_t size) noexcept
+    {
+        RealtimeSanitizer::checkCall ("realloc");
+        return __libc_realloc (ptr, size);
+    }
+
+    void free (void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+            RealtimeSanitizer::checkCall ("free");
+
+        __libc_free (ptr);
+    }
+}
+#endif
+
+//==============================================================================
+#if CHOPSHOP_RT_SANITIZER_HOOK_PTHREAD
+namespace
+{
+    using MutexFunction = int (*) (pthread_mutex_t*);
+
+    // Resolved lazily without a function-local static, whose guard may itself take a mutex
+    std::atomic<MutexFunction> realMutexLock { nullptr };
+
+    MutexFunction getRealMutexLock() noexcept
+    {
+        auto fn = realMutexLock.load (std::memory_order_acquire);
+
+        if (fn == nullptr)
+        {
+            fn = reinterpret_cast<MutexFunction> (dlsym (RTLD_NEXT, "pthread_mutex_lock"));
+            realMutexLock.store (fn, std::memory_order_release);
+        }
+
+        return fn;
+    }
+}
+
+// trylock can't block, so only the blocking lock is trapped. glibc declares
+// it noexcept, Apple's headers don't, and the redeclaration has to match.
+#if JUCE_LINUX
+extern "C" int pthread_mutex_lock (pthread_mutex_t* mutex) noexcept
+#else
+extern "C" int pthread_mutex_lock (pthread_mutex_t* mutex)
+#endif
+{
+    RealtimeSanitizer::checkCall ("pthread_mutex_lock");
+    return getRealMutexLock() (mutex);
+}
+#endif
+
+#endif // CHOPSHOP_RT_SANITIZER
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Enabled for Debug builds from CMakeLists.txt. When off, everything below
+// compiles away and no allocator or pthread symbols are replaced.
+#ifndef CHOPSHOP_RT_SANITIZER
+ #define CHOPSHOP_RT_SANITIZER 0
+#endif
+
+//==============================================================================
+/**
+    Debug-build checker for code that must not block on the audio thread.
+
+    Threads are marked real-time with CHOPSHOP_SCOPED_REALTIME (the audio
+    callbacks and every ChopShop plugin's applyToBuffer). While a thread is
+    marked, the replaced global operator new/delete, the malloc family (glibc)
+    and pthread_mutex_lock report a violation with a symbolised stack.
+
+    Coverage is what the platform lets us hook from inside the executable:
+    operator new/delete (the aligned forms too) everywhere,
+    malloc/calloc/realloc/free on Linux, and
+    pthread mutexes for calls made from code linked into the app.
+*/
+namespace RealtimeSanitizer
+{
+    enum class Mode
+    {
+        log,        // print the report and carry on
+        breakpoint, // print and break into the debugger
+        abort       // print and abort, for headless runs
+    };
+
+    /** Marks the calling thread real-time for the lifetime of the object. Nests. */
+    struct ScopedRealtime
+    {
+        ScopedRealtime() noexcept;
+        ~ScopedRealtime() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRealtime)
+    };
+
+    /** Suspends checking on this thread, for code that is known to be safe
+        but trips the hooks (e.g. one-off lazy initialisation).
+    */
+    struct ScopedNonRealtime
+    {
+        ScopedNonRealtime() noexcept;
+        ~ScopedNonRealtime() noexcept;
+
+    private:
+        int savedDepth;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedNonRealtime)
+    };
+
+    bool isEnabled() noexcept;
+    bool isRealtimeThread() noexcept;
+
+    void setMode (Mode newMode) noexcept;
+
+    /** Called by the hooks; public so other blocking calls can be flagged explicitly. */
+    void checkCall (const char* functionName) noexcept;
+
+    int getViolationCount() noexcept;
+    void resetViolationCount() noexcept;
+}
+
+#if CHOPSHOP_RT_SANITIZER
+ #define CHOPSHOP_SCOPED_REALTIME const RealtimeSanitizer::ScopedRealtime JUCE_JOIN_MACRO (scopedRealtime, __LINE__);
+#else
+ #define CHOPSHOP_SCOPED_REALTIME
+#endif
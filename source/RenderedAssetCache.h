@@ -0,0 +1,82 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <functional>
+#include <map>
+
+//==============================================================================
+/**
+    Pre-rendered images of the parts of a control that don't change with its
+    value: knob dials, slider tracks and thumbs, panel backgrounds.
+
+    Each asset is rendered once per size and display scale, then repainting it
+    is an image blit. Owners give their assets ids of their own; the colours and
+    angles in the key are whatever else the drawing depends on.
+
+    Message thread only.
+*/
+class RenderedAssetCache
+{
+public:
+    struct Key
+    {
+        int asset = 0;
+        int width = 0, height = 0;                      // logical pixels
+        float scale = 1.0f;
+        juce::uint32 colour = 0, secondColour = 0;
+        float startAngle = 0.0f, endAngle = 0.0f;
+
+        auto operator<=> (const Key&) const = default;
+    };
+
+    /** Draws the asset over area, rendering it first with paintAsset if it isn't
+        cached. paintAsset draws in logical pixels with area's top-left at 0, 0.
+    */
+    void draw (juce::Graphics& g, Key key, juce::Rectangle<int> area,
+               const std::function<void (juce::Graphics&)>& paintAsset)
+    {
+        if (area.isEmpty())
+            return;
+
+        key.width = area.getWidth();
+        key.height = area.getHeight();
+        key.scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        auto& image = getImage (key, paintAsset);
+
+        // Drawn on the physical pixel grid, so the blit isn't resampled between pixels
+        const auto x = std::round ((float) area.getX() * key.scale) / key.scale;
+        const auto y = std::round ((float) area.getY() * key.scale) / key.scale;
+        g.drawImageTransformed (image, juce::AffineTransform::scale (1.0f / key.scale).translated (x, y));
+    }
+
+    int getNumAssets() const noexcept                   { return (int) images.size(); }
+
+    /** More sizes than any window shows at once; beyond it the cache starts again. */
+    static constexpr size_t maxAssets = 256;
+
+private:
+    std::map<Key, juce::Image> images;
+
+    const juce::Image& getImage (const Key& key, const std::function<void (juce::Graphics&)>& paintAsset)
+    {
+        if (auto found = images.find (key); found != images.end())
+            return found->second;
+
+        if (images.size() >= maxAssets)
+            images.clear();
+
+        juce::Image image (juce::Image::ARGB,
+                           juce::jmax (1, (int) std::ceil ((float) key.width * key.scale)),
+                           juce::jmax (1, (int) std::ceil ((float) key.height * key.scale)),
+                           true);
+
+        {
+            juce::Graphics g (image);
+            g.addTransform (juce::AffineTransform::scale (key.scale));
+            paintAsset (g);
+        }
+
+        return images.emplace (key, std::move (image)).first->second;
+    }
+};
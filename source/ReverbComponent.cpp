@@ -14,8 +14,15 @@ ReverbComponent::ReverbComponent(tracktion::engine::Edit& edit)
     contentComponent.addAndMakeVisible(roomSizeSlider);
     contentComponent.addAndMakeVisible(wetSlider);
 
-    // Create and setup plugin
-    plugin = EngineHelpers::getPluginFromRack(edit, tracktion::engine::ReverbPlugin::xmlTypeName);
+    bindToEdit();
+}
+
+void ReverbComponent::bindToEdit()
+{
+    plugin = EngineHelpers::getPluginFromRack(*edit, AutoReverbPlugin::xmlTypeName);
+
+    if (plugin == nullptr) // items imported before AutoReverbPlugin
+        plugin = EngineHelpers::getPluginFromRack(*edit, tracktion::engine::ReverbPlugin::xmlTypeName);
     
     if (plugin != nullptr)
     {
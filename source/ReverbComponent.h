@@ -2,6 +2,7 @@
 
 #include "BaseEffectComponent.h"
 #include "RotarySliderComponent.h"
+#include "Plugins/AutoReverbPlugin.h"
 
 class ReverbComponent : public BaseEffectComponent
 {
@@ -11,6 +12,9 @@ public:
     void rampMixLevel(bool rampUp);
     void restoreMixLevel() override;
 
+protected:
+    void bindToEdit() override;
+
 private:
     RotarySliderComponent roomSizeSlider { "Room Size" };
     RotarySliderComponent wetSlider { "Wet Level" };
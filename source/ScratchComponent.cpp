@@ -3,15 +3,20 @@
 
 ScratchComponent::ScratchComponent(tracktion::engine::Edit& e) : BaseEffectComponent(e)
 {
-    // Create the scratch plugin
-    plugin = EngineHelpers::getPluginFromRack(edit, ScratchPlugin::xmlTypeName);
-    
     titleLabel.setText("Scratch", juce::dontSendNotification);
 
     // Create and setup the scratch pad
     scratchPad = std::make_unique<ScratchPad>();
     addAndMakeVisible(scratchPad.get());
 
+    bindToEdit();
+}
+
+void ScratchComponent::bindToEdit()
+{
+    plugin = EngineHelpers::getPluginFromRack(*edit, ScratchPlugin::xmlTypeName);
+    scratchPad->onPositionChange = nullptr;
+
     // Bind pad to parameters
     if (auto* scratchPlugin = dynamic_cast<ScratchPlugin*>(plugin.get()))
     {
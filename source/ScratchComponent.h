@@ -38,6 +38,9 @@ public:
 
     void setScratchSpeed(float speed);
     
+protected:
+    void bindToEdit() override;
+
 private:
     class ScratchPad : public juce::Component
     {
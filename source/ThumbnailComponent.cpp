@@ -1,12 +1,15 @@
 #include "ThumbnailComponent.h"
 #include "Utilities.h"
+#include "UIProfiler.h"
 
 ThumbnailComponent::ThumbnailComponent(tracktion::engine::Edit& e, ZoomState& zs)
-    : edit(e),
-      transport(e.getTransport()),
-      thumbnail(e.engine, tracktion::AudioFile(e.engine), *this, &e),
+    : edit(&e),
+      transport(&e.getTransport()),
+      // Not tied to the Edit so the same thumbnail serves every Edit we switch to
+      thumbnail(e.engine, tracktion::AudioFile(e.engine), *this, nullptr),
       currentClip(nullptr),
-      zoomState(zs)
+      zoomState(zs),
+      beatGrid(e)
 {
     // Initialize thumbnail
     thumbnail.audioFileChanged();
@@ -18,27 +21,86 @@ ThumbnailComponent::ThumbnailComponent(tracktion::engine::Edit& e, ZoomState& zs
 
     // Register as listener for zoom state changes
     zoomState.addListener(this);
+    beatGrid.onChange = [this] { invalidateOverlays(); };
 
-    startTimerHz(30);
+    attachToTransport();
 }
 
 ThumbnailComponent::~ThumbnailComponent()
 {
-    stopTimer();
+    detachFromTransport();
+    frameScheduler->stopAnimating(*this);
     zoomState.removeListener(this);
 }
 
-void ThumbnailComponent::timerCallback()
+void ThumbnailComponent::frameCallback(double timeMs)
 {
-    updatePlayheadPosition();
-    
-    // Force redraw during playback
-    if (transport.isPlaying())
-        repaint();
+    // Only the playhead moves; the layers are reused
+    updatePlayheadPosition(timeMs);
+}
+
+void ThumbnailComponent::attachToTransport()
+{
+    transport->addChangeListener(this);
+    transport->state.addListener(this);
+
+    // Chops redraw the overlays (as do tempo changes, through the beat grid)
+    if (auto chopTrack = EngineHelpers::getChopTrack(*edit))
+        chopTrackState = chopTrack->state;
+
+    chopTrackState.addListener(this);
+
+    updateAnimationState();
+}
+
+void ThumbnailComponent::detachFromTransport()
+{
+    transport->removeChangeListener(this);
+    transport->state.removeListener(this);
+    chopTrackState.removeListener(this);
+    chopTrackState = {};
+}
+
+void ThumbnailComponent::updateAnimationState()
+{
+    if (transport->isPlaying())
+        frameScheduler->startAnimating(*this);
+    else
+        frameScheduler->stopAnimating(*this);
+
+    frameScheduler->requestFrame(*this);
+}
+
+void ThumbnailComponent::valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier& property)
+{
+    if (tree == transport->state)
+    {
+        // While playing the frames already follow the position
+        if (property == te::IDs::position && ! transport->isPlaying())
+            frameScheduler->requestFrame(*this);
+
+        return;
+    }
+
+    invalidateOverlays();
+}
+
+void ThumbnailComponent::valueTreeChildAdded(juce::ValueTree&, juce::ValueTree&)
+{
+    invalidateOverlays();
+}
+
+void ThumbnailComponent::valueTreeChildRemoved(juce::ValueTree&, juce::ValueTree&, int)
+{
+    invalidateOverlays();
 }
 
 void ThumbnailComponent::paint(juce::Graphics& g)
 {
+    if (gpuRendered)
+        return;
+
+    const UIProfiler::ScopedTimer profile ("ThumbnailComponent::paint");
     auto bounds = getLocalBounds();
 
     // Draw background
@@ -51,125 +113,199 @@ void ThumbnailComponent::paint(juce::Graphics& g)
     // Create drawing bounds
     auto drawBounds = bounds.reduced(2);
 
-    // Draw waveform if we have a clip
-    if (currentClip != nullptr)
-    {
-        auto clipLength = currentClip->getPosition().getLength().inSeconds();
-        auto sourceLength = currentClip->getSourceLength().inSeconds();
-        auto timeStretchRatio = clipLength / sourceLength;
+    if (currentClip == nullptr || drawBounds.isEmpty())
+        return;
 
-        // Calculate visible time range in source time domain
-        auto visibleTimeStart = (sourceLength * zoomState.getScrollPosition()) * timeStretchRatio;
-        auto visibleTimeEnd = visibleTimeStart + ((sourceLength / zoomState.getZoomLevel()) * timeStretchRatio);
+    // The visible part of the clip, in edit time
+    const auto clipLength = currentClip->getPosition().getLength().inSeconds();
+    const auto visibleStart = clipLength * zoomState.getScrollPosition();
+    const auto view = juce::Range<double>(visibleStart, visibleStart + clipLength / zoomState.getZoomLevel());
 
-        auto timeRange = tracktion::TimeRange(
-            tracktion::TimePosition::fromSeconds(visibleTimeStart),
-            tracktion::TimePosition::fromSeconds(visibleTimeEnd));
+    if (view.isEmpty())
+        return;
 
-        if (sourceLength > 0.0)
-        {
-            // Enable anti-aliasing
-            g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+    // The cached layers are only redrawn when what they show has changed; the
+    // playhead is a child component, so playback only repaints its strip
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    updateLayers(drawBounds, view, scale);
 
-            // Calculate gains from clip properties
-            const auto gain = currentClip->getGain();
-            const auto pan = thumbnail.getNumChannels() == 1 ? 0.0f : currentClip->getPan();
-            const float pv = pan * gain;
-            const float leftGain = (gain - pv);
-            const float rightGain = (gain + pv);
+    // The layers extend beyond the view, and are drawn at the nearest whole pixel
+    const auto x = drawBounds.getX() + juce::roundToInt((layers.range.getStart() - view.getStart()) * layers.pixelsPerSecond);
+    const auto transform = juce::AffineTransform::scale(1.0f / scale).translated((float) x, (float) drawBounds.getY());
 
-            // Draw waveform
-            g.setColour(juce::Colours::lime.withAlpha(0.7f));
+    g.reduceClipRegion(drawBounds);
+    g.drawImageTransformed(waveformLayer, transform);
+    g.drawImageTransformed(overlayLayer, transform);
+}
 
-            if (thumbnail.getTotalLength() > 0.0)
-            {
-                // Draw base waveform
-                g.setGradientFill(juce::ColourGradient(
-                    juce::Colours::lime.withAlpha(0.8f),
-                    drawBounds.getTopLeft().toFloat(),
-                    juce::Colours::lime.withAlpha(0.3f),
-                    drawBounds.getBottomLeft().toFloat(),
-                    false));
-
-                auto sourceTimeRange = tracktion::TimeRange(
-                    tracktion::TimePosition::fromSeconds(visibleTimeStart / timeStretchRatio),
-                    tracktion::TimePosition::fromSeconds(visibleTimeEnd / timeStretchRatio));
-
-                float maxGain = juce::jmax(leftGain, rightGain);
-                thumbnail.drawChannels(g, drawBounds, sourceTimeRange, maxGain);
-
-                // Get chop track and overlay its clips
-                if (auto chopTrack = EngineHelpers::getChopTrack(edit))
-                {
-                    for (auto clip : chopTrack->getClips())
-                    {
-                        auto startTime = clip->getPosition().getStart().inSeconds();
-                        auto endTime = clip->getPosition().getEnd().inSeconds();
+void ThumbnailComponent::updateLayers(juce::Rectangle<int> drawBounds, juce::Range<double> view, float scale)
+{
+    // The clip only plays the file between the edit's sourceStart and sourceEnd
+    // (see LibraryComponent::createEditForAudioFile)
+    auto sourceStart = (double) edit->state.getProperty("sourceStart", 0.0);
+    auto sourceEnd = (double) edit->state.getProperty("sourceEnd", 0.0);
 
-                        // Skip clips that are completely outside the visible range
-                        if (endTime < visibleTimeStart || startTime > visibleTimeEnd)
-                            continue;
+    if (sourceEnd <= sourceStart)
+        sourceEnd = currentClip->getSourceLength().inSeconds();
 
-                        // Clamp clip times to visible range
-                        auto clampedStartTime = juce::jlimit(visibleTimeStart, visibleTimeEnd, startTime);
-                        auto clampedEndTime = juce::jlimit(visibleTimeStart, visibleTimeEnd, endTime);
+    const auto clipLength = currentClip->getPosition().getLength().inSeconds();
 
-                        // Calculate clip bounds in view coordinates
-                        auto startX = drawBounds.getX() + ((clampedStartTime - visibleTimeStart) / (visibleTimeEnd - visibleTimeStart)) * drawBounds.getWidth();
-                        auto endX = drawBounds.getX() + ((clampedEndTime - visibleTimeStart) / (visibleTimeEnd - visibleTimeStart)) * drawBounds.getWidth();
+    LayerKey key;
+    key.width = drawBounds.getWidth();
+    key.height = drawBounds.getHeight();
+    key.scale = scale;
+    key.pixelsPerSecond = drawBounds.getWidth() / view.getLength();
+    key.sourceStart = sourceStart;
+    key.timeStretchRatio = clipLength / (sourceEnd - sourceStart);
+    key.gain = currentClip->getGain();
+    key.pan = thumbnail.getNumChannels() == 1 ? 0.0f : currentClip->getPan();
 
-                        // Draw clip overlay
-                        auto clipBounds = juce::Rectangle<float>(
-                            startX, drawBounds.getY(),
-                            endX - startX, drawBounds.getHeight());
+    const auto waveformIsCurrent = waveformLayer.isValid() && key == layers.key && layers.range.contains(view) && layers.complete;
 
-                        g.setColour(juce::Colours::purple.withAlpha(0.3f));
-                        g.fillRect(clipBounds);
+    if (! waveformIsCurrent)
+    {
+        // A view's width either side, so following the playhead only moves the layers
+        const auto margin = view.getLength() * layerMarginInViews;
+        layers.key = key;
+        layers.pixelsPerSecond = key.pixelsPerSecond;
+        layers.range = { juce::jmax(0.0, view.getStart() - margin),
+                         juce::jmax(view.getEnd(), juce::jmin(clipLength, view.getEnd() + margin)) };
+        layers.complete = thumbnail.isFullyLoaded();
+
+        renderWaveformLayer();
+        overlaysInvalid = true;
+    }
 
-                        // Draw clip border
-                        g.setColour(juce::Colours::purple.withAlpha(0.5f));
-                        g.drawRect(clipBounds, 1.0f);
-                    }
-                }
-            }
-        }
+    if (overlaysInvalid)
+    {
+        renderOverlayLayer();
+        overlaysInvalid = false;
+    }
+}
 
-        // Draw center line
-        g.setColour(juce::Colours::grey.withAlpha(0.3f));
-        g.drawHorizontalLine(drawBounds.getCentreY(),
-            drawBounds.getX(),
-            drawBounds.getRight());
+juce::Rectangle<int> ThumbnailComponent::getLayerBounds() const
+{
+    return { juce::roundToInt(layers.range.getLength() * layers.pixelsPerSecond), layers.key.height };
+}
 
-        // Draw beat markers
-        auto& tempoSequence = edit.tempoSequence;
-        auto position = createPosition(tempoSequence);
+juce::Image ThumbnailComponent::createLayerImage() const
+{
+    const auto area = getLayerBounds();
+    return juce::Image(juce::Image::ARGB,
+                       juce::jmax(1, juce::roundToInt(area.getWidth() * layers.key.scale)),
+                       juce::jmax(1, juce::roundToInt(area.getHeight() * layers.key.scale)),
+                       true);
+}
+
+void ThumbnailComponent::renderWaveformLayer()
+{
+    waveformLayer = createLayerImage();
+
+    if (layers.key.timeStretchRatio <= 0.0 || thumbnail.getTotalLength() <= 0.0)
+        return;
+
+    juce::Graphics g(waveformLayer);
+    g.addTransform(juce::AffineTransform::scale(layers.key.scale));
+    const auto area = getLayerBounds();
+
+    // Calculate gains from clip properties
+    const float pv = layers.key.pan * layers.key.gain;
+    const float leftGain = (layers.key.gain - pv);
+    const float rightGain = (layers.key.gain + pv);
+
+    // Draw base waveform
+    g.setGradientFill(juce::ColourGradient(
+        juce::Colours::lime.withAlpha(0.8f),
+        area.getTopLeft().toFloat(),
+        juce::Colours::lime.withAlpha(0.3f),
+        area.getBottomLeft().toFloat(),
+        false));
+
+    auto sourceTimeRange = tracktion::TimeRange(
+        tracktion::TimePosition::fromSeconds(layers.key.sourceStart + layers.range.getStart() / layers.key.timeStretchRatio),
+        tracktion::TimePosition::fromSeconds(layers.key.sourceStart + layers.range.getEnd() / layers.key.timeStretchRatio));
+
+    float maxGain = juce::jmax(leftGain, rightGain);
+    thumbnail.drawChannels(g, area, sourceTimeRange, maxGain);
+}
+
+void ThumbnailComponent::renderOverlayLayer()
+{
+    overlayLayer = createLayerImage();
 
-        // Find the first beat before our visible range
-        position.set(tracktion::TimePosition::fromSeconds(timeRange.getStart().inSeconds()));
-        auto currentBarsBeats = position.getBarsBeats();
-        auto beatTime = timeRange.getStart().inSeconds() - (currentBarsBeats.beats.inBeats() * 60.0 / position.getTempo());
+    juce::Graphics g(overlayLayer);
+    g.addTransform(juce::AffineTransform::scale(layers.key.scale));
+    const auto area = getLayerBounds();
+    auto timeToX = [this] (double time) { return (time - layers.range.getStart()) * layers.pixelsPerSecond; };
 
-        // Draw all beat markers
-        for (double time = beatTime; time <= timeRange.getEnd().inSeconds(); time += 60.0 / position.getTempo())
+    // Chop clips
+    if (auto chopTrack = EngineHelpers::getChopTrack(*edit))
+    {
+        for (auto clip : chopTrack->getClips())
         {
-            if (time >= timeRange.getStart().inSeconds() && time <= timeRange.getEnd().inSeconds())
-            {
-                auto beatX = drawBounds.getX() + ((time - timeRange.getStart().inSeconds()) / (timeRange.getEnd().inSeconds() - timeRange.getStart().inSeconds())) * drawBounds.getWidth();
+            auto startTime = clip->getPosition().getStart().inSeconds();
+            auto endTime = clip->getPosition().getEnd().inSeconds();
 
-                position.set(tracktion::TimePosition::fromSeconds(time));
-                auto barsBeats = position.getBarsBeats();
+            // Skip clips that are completely outside the layer
+            if (endTime < layers.range.getStart() || startTime > layers.range.getEnd())
+                continue;
 
-                // Bar starts get a brighter color
-                g.setColour(barsBeats.beats.inBeats() == 0
-                    ? juce::Colours::white.withAlpha(0.4f)
-                    : juce::Colours::white.withAlpha(0.2f));
+            auto startX = timeToX(layers.range.clipValue(startTime));
+            auto endX = timeToX(layers.range.clipValue(endTime));
 
-                g.drawVerticalLine(static_cast<int>(beatX),
-                    drawBounds.getY(),
-                    drawBounds.getBottom());
-            }
+            // Draw clip overlay
+            auto clipBounds = juce::Rectangle<float>(
+                (float) startX, 0.0f,
+                (float) (endX - startX), (float) area.getHeight());
+
+            g.setColour(juce::Colours::purple.withAlpha(0.3f));
+            g.fillRect(clipBounds);
+
+            // Draw clip border
+            g.setColour(juce::Colours::purple.withAlpha(0.5f));
+            g.drawRect(clipBounds, 1.0f);
         }
     }
+
+    // Draw center line
+    g.setColour(juce::Colours::grey.withAlpha(0.3f));
+    g.drawHorizontalLine(area.getCentreY(), 0.0f, (float) area.getWidth());
+
+    // Draw beat markers; the grid follows the tempo map of a drifting track
+    for (auto& line : beatGrid.getLines(layers.range, 0.0f, (float) area.getWidth()))
+    {
+        // Bar starts get a brighter color
+        g.setColour(line.isBar
+            ? juce::Colours::white.withAlpha(0.4f)
+            : juce::Colours::white.withAlpha(0.2f));
+
+        g.drawVerticalLine(static_cast<int>(line.x), 0.0f, (float) area.getHeight());
+    }
+}
+
+void ThumbnailComponent::invalidateOverlays()
+{
+    overlaysInvalid = true;
+    repaint();
+}
+
+void ThumbnailComponent::invalidateLayers()
+{
+    waveformLayer = {};
+    invalidateOverlays();
+}
+
+void ThumbnailComponent::setGpuRendered(bool shouldBeGpuRendered)
+{
+    if (gpuRendered == shouldBeGpuRendered)
+        return;
+
+    gpuRendered = shouldBeGpuRendered;
+
+    // The layers are rebuilt if software drawing comes back
+    waveformLayer = {};
+    overlayLayer = {};
+    invalidateOverlays();
 }
 
 void ThumbnailComponent::resized()
@@ -184,14 +320,31 @@ void ThumbnailComponent::resized()
     }
 }
 
-void ThumbnailComponent::changeListenerCallback(juce::ChangeBroadcaster*)
+void ThumbnailComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
-    repaint();
+    if (source == transport)
+        updateAnimationState();
+    else
+        repaint();
+}
+
+void ThumbnailComponent::setEdit(tracktion::engine::Edit& newEdit)
+{
+    if (edit == &newEdit)
+        return;
+
+    detachFromTransport();
+    edit = &newEdit;
+    transport = &newEdit.getTransport();
+    beatGrid.setEdit(newEdit);
+    attachToTransport();
+    updateThumbnail();
+    updatePlayheadPosition();
 }
 
 void ThumbnailComponent::updateThumbnail()
 {
-    auto audioTracks = te::getAudioTracks(edit);
+    auto audioTracks = te::getAudioTracks(*edit);
     currentClip = nullptr; // Reset current clip reference
 
     for (auto track : audioTracks)
@@ -207,8 +360,15 @@ void ThumbnailComponent::updateThumbnail()
                 if (audioFile.isValid())
                 {
                     currentClip = waveClip;
-                    thumbnail.setNewFile(audioFile);
-                    repaint();
+
+                    // Reloading a track keeps the waveform that's already been built
+                    if (audioFile.getFile() != thumbnailFile)
+                    {
+                        thumbnailFile = audioFile.getFile();
+                        thumbnail.setNewFile(audioFile);
+                    }
+
+                    invalidateLayers();
                     break;
                 }
             }
@@ -232,7 +392,7 @@ void ThumbnailComponent::mouseDown(const juce::MouseEvent& event)
             auto sourceLength = currentClip->getPosition().getLength().inSeconds();
             auto newPosition = (normalizedPosition * sourceLength);
 
-            transport.setPosition(tracktion::TimePosition::fromSeconds(newPosition));
+            transport->setPosition(tracktion::TimePosition::fromSeconds(newPosition));
         }
     }
 }
@@ -275,28 +435,22 @@ void ThumbnailComponent::mouseWheelMove(const juce::MouseEvent& event, const juc
     }
 }
 
-void ThumbnailComponent::updatePlayheadPosition()
+void ThumbnailComponent::updatePlayheadPosition(double timeMs)
 {
     if (playhead != nullptr)
     {
         auto bounds = getLocalBounds();
         auto drawBounds = bounds.reduced(2);
 
-        // Get current position from transport (this is already in the correct time domain)
-        auto currentPosition = transport.getPosition().inSeconds();
+        // The transport's position (already in the correct time domain), carried on between audio blocks
+        auto currentPosition = playheadClock.getPosition(*transport, timeMs);
 
         if (currentClip != nullptr)
         {
             auto sourceLength = currentClip->getPosition().getLength().inSeconds();
 
-            // Get current tempo information
-            auto& tempoSequence = edit.tempoSequence;
-            auto position = createPosition(tempoSequence);
-            position.set(transport.getPosition());
-            auto currentTempo = position.getTempo();
-
             // If playing, adjust scroll position to keep playhead centered
-            if (transport.isPlaying())
+            if (transport->isPlaying())
             {
                 // Calculate the normalized position that would put the playhead in the center
                 auto normalizedCenter = currentPosition / sourceLength;
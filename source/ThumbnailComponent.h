@@ -6,13 +6,17 @@
 #include <juce_events/juce_events.h>
 #include <tracktion_engine/tracktion_engine.h>
 
+#include "BeatGrid.h"
+#include "FrameScheduler.h"
+#include "PlayheadClock.h"
 #include "Utilities.h"
 #include "Plugins/ChopPlugin.h"
 #include "ZoomState.h"
 
 class ThumbnailComponent : public juce::Component,
-                          public juce::Timer,
+                          public FrameScheduler::Client,
                           public juce::ChangeListener,
+                          private juce::ValueTree::Listener,
                           public ZoomStateListener
 {
 public:
@@ -21,7 +25,7 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
-    void timerCallback() override;
+    void frameCallback(double timeMs) override;
     void changeListenerCallback(juce::ChangeBroadcaster*) override;
     
     // ZoomStateListener implementation
@@ -31,18 +35,79 @@ public:
     void mouseDown(const juce::MouseEvent&) override;
     void mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails&) override;
     
+    /** Shows another Edit's clip. The thumbnail is only rebuilt if the source file differs. */
+    void setEdit(tracktion::engine::Edit& newEdit);
+
     void updateThumbnail();
 
+    /** Leaves the waveform and overlays to a TimelineRenderer drawing beneath this
+        component; only the playhead is still painted here.
+    */
+    void setGpuRendered(bool shouldBeGpuRendered);
+
 private:
-    tracktion::engine::Edit& edit;
-    tracktion::engine::TransportControl& transport;
+    tracktion::engine::Edit* edit;
+    tracktion::engine::TransportControl* transport;
     tracktion::engine::SmartThumbnail thumbnail;
+    juce::File thumbnailFile;
     tracktion::engine::WaveAudioClip* currentClip;
     
     ZoomState& zoomState;
     std::unique_ptr<juce::DrawableRectangle> playhead;
-    
-    void updatePlayheadPosition();
+    juce::SharedResourcePointer<FrameScheduler> frameScheduler;
+    BeatGrid beatGrid;
+    bool gpuRendered = false;
+
+    // Moves the playhead smoothly between audio blocks
+    PlayheadClock playheadClock;
+    void updatePlayheadPosition(double timeMs = juce::Time::getMillisecondCounterHiRes());
+
+    // Animates while the transport plays; a seek while stopped moves the playhead once
+    void attachToTransport();
+    void detachFromTransport();
+    void updateAnimationState();
+
+    // The waveform and the overlays (chops, centre line, beat grid) are drawn into
+    // cached images covering the view plus a margin either side. The waveform is
+    // redrawn when the zoom, size, clip or tempo changes or the view scrolls out
+    // of the margin; the overlays also when a chop or the tempo map changes.
+    struct LayerKey
+    {
+        int width = 0, height = 0;
+        float scale = 1.0f;
+        double pixelsPerSecond = 0.0;
+        double sourceStart = 0.0, timeStretchRatio = 0.0;
+        float gain = 1.0f, pan = 0.0f;
+
+        bool operator== (const LayerKey&) const = default;
+    };
+
+    struct Layers
+    {
+        LayerKey key;
+        juce::Range<double> range;      // edit time
+        double pixelsPerSecond = 0.0;
+        bool complete = false;          // drawn from a fully loaded thumbnail
+    };
+
+    static constexpr double layerMarginInViews = 1.0;
+
+    juce::Image waveformLayer, overlayLayer;
+    Layers layers;
+    bool overlaysInvalid = true;
+    juce::ValueTree chopTrackState;
+
+    void updateLayers(juce::Rectangle<int> drawBounds, juce::Range<double> view, float scale);
+    juce::Rectangle<int> getLayerBounds() const;
+    juce::Image createLayerImage() const;
+    void renderWaveformLayer();
+    void renderOverlayLayer();
+    void invalidateOverlays();
+    void invalidateLayers();
+
+    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded(juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved(juce::ValueTree&, juce::ValueTree&, int) override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ThumbnailComponent)
 }; 
\ No newline at end of file
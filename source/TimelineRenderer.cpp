@@ -0,0 +1,639 @@
+#include "TimelineRenderer.h"
+#include "Analysis/AnalysisPipeline.h"
+#include "Analysis/PeakPyramidAnalyzer.h"
+#include "UIProfiler.h"
+#include "Utilities.h"
+#include <algorithm>
+#include <cstddef>
+
+namespace te = tracktion::engine;
+using namespace juce::gl;
+
+//==============================================================================
+struct TimelineRenderer::PeakJob
+{
+    std::atomic<bool> cancelled { false };
+    juce::File file;
+    std::shared_ptr<PeakPyramidAnalyzer> peaks;
+    double sampleRate = 0.0;
+};
+
+//==============================================================================
+namespace
+{
+    // Textures are wrapped into rows, as a level can be longer than the widest
+    // texture. The waveform shader divides by the same width.
+    constexpr int peakTextureWidth = 4096;
+
+    const char* waveformVertexShader =
+        "attribute vec2 position;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = vec4 (position * 2.0 - 1.0, 0.0, 1.0);\n"
+        "}\n";
+
+    // Each pixel column reads one min/max peak, chosen from the level whose
+    // peaks are just wider than a column
+    const char* waveformFragmentShader =
+        "uniform sampler2D peaks;\n"
+        "uniform vec4 laneRect;\n"               // physical pixels, from the bottom left
+        "uniform float viewStart;\n"
+        "uniform float viewLength;\n"
+        "uniform float sourceStart;\n"
+        "uniform float timeStretchRatio;\n"
+        "uniform float peaksPerSecond;\n"
+        "uniform float numPeaks;\n"
+        "uniform float gain;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 p = (gl_FragCoord.xy - laneRect.xy) / laneRect.zw;\n"
+        "    float index = floor ((sourceStart + (viewStart + p.x * viewLength) / timeStretchRatio) * peaksPerSecond);\n"
+        "\n"
+        "    if (index < 0.0 || index >= numPeaks)\n"
+        "        discard;\n"
+        "\n"
+        "    int i = int (index);\n"
+        "    int row = i / 4096;\n"
+        "    vec2 peak = texelFetch (peaks, ivec2 (i - row * 4096, row), 0).rg * gain;\n"
+        "\n"
+        // Never thinner than a pixel, so silence still shows as a line
+        "    float y = p.y * 2.0 - 1.0;\n"
+        "    float halfPixel = 1.0 / laneRect.w;\n"
+        "\n"
+        "    if (y < peak.x - halfPixel || y > peak.y + halfPixel)\n"
+        "        discard;\n"
+        "\n"
+        "    gl_FragColor = vec4 (0.0, 1.0, 0.0, mix (0.3, 0.8, p.y));\n"
+        "}\n";
+
+    const char* quadVertexShader =
+        "attribute vec2 position;\n"
+        "attribute vec2 span;\n"
+        "attribute vec2 extent;\n"
+        "attribute float lane;\n"
+        "attribute vec4 colour;\n"
+        "\n"
+        "uniform vec4 lane0;\n"
+        "uniform vec4 lane1;\n"
+        "uniform vec2 resolution;\n"
+        "uniform float viewStart;\n"
+        "uniform float viewLength;\n"
+        "uniform float pixelSize;\n"
+        "\n"
+        "varying vec4 fragColour;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec4 rect = lane < 0.5 ? lane0 : lane1;\n"
+        "\n"
+        // Lines have no width in time or height, so quads are at least a logical pixel across
+        "    float x0 = floor (rect.x + (span.x - viewStart) / viewLength * rect.z);\n"
+        "    float x1 = max (rect.x + (span.y - viewStart) / viewLength * rect.z, x0 + pixelSize);\n"
+        "    float y0 = floor (rect.y + rect.w * (1.0 - extent.y));\n"
+        "    float y1 = max (rect.y + rect.w * (1.0 - extent.x), y0 + pixelSize);\n"
+        "\n"
+        "    vec2 p = vec2 (mix (x0, x1, position.x), mix (y0, y1, position.y));\n"
+        "    gl_Position = vec4 (p / resolution * 2.0 - 1.0, 0.0, 1.0);\n"
+        "    fragColour = colour;\n"
+        "}\n";
+
+    const char* quadFragmentShader =
+        "varying vec4 fragColour;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    gl_FragColor = fragColour;\n"
+        "}\n";
+
+    std::unique_ptr<juce::OpenGLShaderProgram> createProgram (juce::OpenGLContext& context,
+                                                              const juce::String& vertexShader,
+                                                              const juce::String& fragmentShader)
+    {
+        auto program = std::make_unique<juce::OpenGLShaderProgram> (context);
+
+        if (program->addVertexShader (juce::OpenGLHelpers::translateVertexShaderToV3 (vertexShader))
+            && program->addFragmentShader (juce::OpenGLHelpers::translateFragmentShaderToV3 (fragmentShader))
+            && program->link())
+            return program;
+
+        DBG ("TimelineRenderer: " + program->getLastError());
+        return {};
+    }
+}
+
+//==============================================================================
+struct TimelineRenderer::GLState
+{
+    explicit GLState (juce::OpenGLContext& context)
+        : waveform (createProgram (context, waveformVertexShader, waveformFragmentShader)),
+          quads (createProgram (context, quadVertexShader, quadFragmentShader))
+    {
+        glGenVertexArrays (1, &vertexArray);
+        glGenBuffers (1, &unitQuad);
+        glGenBuffers (1, &instanceBuffer);
+
+        const GLfloat corners[] = { 0.0f, 0.0f,  1.0f, 0.0f,  0.0f, 1.0f,  1.0f, 1.0f };
+        glBindBuffer (GL_ARRAY_BUFFER, unitQuad);
+        glBufferData (GL_ARRAY_BUFFER, sizeof (corners), corners, GL_STATIC_DRAW);
+        glBindBuffer (GL_ARRAY_BUFFER, 0);
+    }
+
+    ~GLState()
+    {
+        if (! peakTextures.empty())
+            glDeleteTextures ((GLsizei) peakTextures.size(), peakTextures.data());
+
+        glDeleteBuffers (1, &instanceBuffer);
+        glDeleteBuffers (1, &unitQuad);
+        glDeleteVertexArrays (1, &vertexArray);
+    }
+
+    bool isValid() const        { return waveform != nullptr && quads != nullptr; }
+
+    void uploadPeaks (const PeakPyramidAnalyzer* peaks)
+    {
+        if (! peakTextures.empty())
+            glDeleteTextures ((GLsizei) peakTextures.size(), peakTextures.data());
+
+        peakTextures.clear();
+        numPeaks.clear();
+
+        if (peaks == nullptr)
+            return;
+
+        peakTextures.resize ((size_t) peaks->getNumLevels());
+        glGenTextures ((GLsizei) peakTextures.size(), peakTextures.data());
+
+        std::vector<GLfloat> texels;
+
+        for (int level = 0; level < peaks->getNumLevels(); ++level)
+        {
+            // Channels are merged: the lane shows one waveform
+            const auto n = peaks->getNumPeaks (level);
+            const auto rows = juce::jmax (1, (n + peakTextureWidth - 1) / peakTextureWidth);
+            const auto width = juce::jlimit (1, peakTextureWidth, n);
+            texels.assign ((size_t) (width * rows * 2), 0.0f);
+
+            for (int i = 0; i < n; ++i)
+            {
+                auto peak = peaks->getPeak (level, i, 0);
+
+                for (int ch = 1; ch < peaks->getNumChannels(); ++ch)
+                    peak = peak.getUnionWith (peaks->getPeak (level, i, ch));
+
+                texels[(size_t) i * 2] = peak.getStart();
+                texels[(size_t) i * 2 + 1] = peak.getEnd();
+            }
+
+            glBindTexture (GL_TEXTURE_2D, peakTextures[(size_t) level]);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexImage2D (GL_TEXTURE_2D, 0, GL_RG32F, width, rows, 0, GL_RG, GL_FLOAT, texels.data());
+            numPeaks.push_back (n);
+        }
+
+        glBindTexture (GL_TEXTURE_2D, 0);
+    }
+
+    void uploadInstances (const std::vector<Instance>& instances)
+    {
+        // Lane by lane, so each lane is one draw call within its own scissor
+        std::vector<Instance> sorted (instances);
+        std::stable_sort (sorted.begin(), sorted.end(), [] (auto& a, auto& b) { return a.lane < b.lane; });
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            laneInstances[lane].setStart ((int) std::distance (sorted.begin(), std::lower_bound (sorted.begin(), sorted.end(), (float) lane, [] (auto& i, float l) { return i.lane < l; })));
+            laneInstances[lane].setEnd ((int) std::distance (sorted.begin(), std::upper_bound (sorted.begin(), sorted.end(), (float) lane, [] (float l, auto& i) { return l < i.lane; })));
+        }
+
+        glBindBuffer (GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferData (GL_ARRAY_BUFFER, (GLsizeiptr) (sorted.size() * sizeof (Instance)), sorted.data(), GL_STATIC_DRAW);
+        glBindBuffer (GL_ARRAY_BUFFER, 0);
+    }
+
+    std::unique_ptr<juce::OpenGLShaderProgram> waveform, quads;
+    GLuint vertexArray = 0, unitQuad = 0, instanceBuffer = 0;
+    std::vector<GLuint> peakTextures;
+    std::vector<int> numPeaks;
+    double peaksSampleRate = 0.0;
+    juce::Range<int> laneInstances[numLanes];
+};
+
+//==============================================================================
+TimelineRenderer::TimelineRenderer (juce::Component& timelineToUse, juce::Component& thumbnailLane, juce::Component& chopLane,
+                                    te::Edit& e, ZoomState& zs)
+    : timeline (timelineToUse), lanes { &thumbnailLane, &chopLane }, edit (&e), zoomState (zs), beatGrid (e)
+{
+    zoomState.addListener (this);
+    beatGrid.onChange = [this] { updateInstances(); updateView(); };
+
+    if (auto chopTrack = EngineHelpers::getChopTrack (*edit))
+        chopTrackState = chopTrack->state;
+
+    chopTrackState.addListener (this);
+
+    // Set up as Oscilloscope2D's is; the child components are still painted, on top
+    openGLContext.setOpenGLVersionRequired (juce::OpenGLContext::OpenGLVersion::openGL3_2);
+    openGLContext.setRenderer (this);
+    openGLContext.attachTo (timeline);
+
+    loadPeaks();
+    updateInstances();
+    lanesMoved();
+}
+
+TimelineRenderer::~TimelineRenderer()
+{
+    openGLContext.detach();
+
+    if (peakJob != nullptr)
+        peakJob->cancelled = true;
+
+    pool.removeAllJobs (true, 10000);
+    chopTrackState.removeListener (this);
+    zoomState.removeListener (this);
+}
+
+void TimelineRenderer::setEdit (te::Edit& newEdit)
+{
+    if (edit == &newEdit)
+        return;
+
+    edit = &newEdit;
+    beatGrid.setEdit (newEdit);
+
+    chopTrackState.removeListener (this);
+    chopTrackState = {};
+
+    if (auto chopTrack = EngineHelpers::getChopTrack (*edit))
+        chopTrackState = chopTrack->state;
+
+    chopTrackState.addListener (this);
+
+    loadPeaks();
+    updateInstances();
+    updateView();
+}
+
+void TimelineRenderer::lanesMoved()
+{
+    updateView();
+}
+
+bool TimelineRenderer::hasPeaks() const
+{
+    const juce::ScopedLock sl (lock);
+    return peaks != nullptr;
+}
+
+//==============================================================================
+void TimelineRenderer::loadPeaks()
+{
+    auto* clip = dynamic_cast<te::WaveAudioClip*> (EngineHelpers::getCurrentClip (*edit));
+    const auto file = clip != nullptr ? clip->getAudioFile().getFile() : juce::File();
+
+    // Reloading a track keeps the peaks that have already been read
+    if (file == peaksFile)
+        return;
+
+    peaksFile = file;
+
+    if (peakJob != nullptr)
+        peakJob->cancelled = true;
+
+    peakJob = nullptr;
+
+    {
+        const juce::ScopedLock sl (lock);
+        peaks = nullptr;
+        peaksChanged = true;
+    }
+
+    if (! file.existsAsFile())
+        return;
+
+    auto job = std::make_shared<PeakJob>();
+    job->file = file;
+    peakJob = job;
+
+    pool.addJob ([&formats = edit->engine.getAudioFileFormatManager().readFormatManager, job,
+                  weakThis = juce::WeakReference<TimelineRenderer> (this)]
+    {
+        if (std::unique_ptr<juce::AudioFormatReader> reader { formats.createReaderFor (job->file) })
+        {
+            auto peaks = std::make_shared<PeakPyramidAnalyzer>();
+            AnalysisPipeline pipeline (1);
+            pipeline.addAnalyzer (*peaks);
+
+            if (pipeline.run (*reader, [&job] { return job->cancelled.load(); }))
+            {
+                job->peaks = std::move (peaks);
+                job->sampleRate = reader->sampleRate;
+            }
+        }
+
+        juce::MessageManager::callAsync ([weakThis, job]
+        {
+            if (auto* renderer = weakThis.get())
+                renderer->peaksLoaded (job);
+        });
+    });
+}
+
+void TimelineRenderer::peaksLoaded (std::shared_ptr<PeakJob> job)
+{
+    if (job != peakJob || job->cancelled || job->peaks == nullptr)
+        return;
+
+    peakJob = nullptr;
+
+    {
+        const juce::ScopedLock sl (lock);
+        peaks = std::move (job->peaks);
+        peaksSampleRate = job->sampleRate;
+        peaksChanged = true;
+    }
+
+    openGLContext.triggerRepaint();
+}
+
+void TimelineRenderer::updateView()
+{
+    View newView;
+    newView.timeline = timeline.getLocalBounds();
+
+    // Both lanes span the same view as their software painting does; the
+    // waveform is inset by the thumbnail's border
+    newView.lanes[thumbnailLaneIndex] = lanes[thumbnailLaneIndex]->getBounds().reduced (2);
+    newView.lanes[chopLaneIndex] = lanes[chopLaneIndex]->getBounds();
+
+    auto* clip = dynamic_cast<te::WaveAudioClip*> (EngineHelpers::getCurrentClip (*edit));
+    const auto clipLength = clip != nullptr ? clip->getPosition().getLength().inSeconds() : 60.0;
+
+    newView.start = clipLength * zoomState.getScrollPosition();
+    newView.length = clipLength / zoomState.getZoomLevel();
+
+    if (clip != nullptr)
+    {
+        // See ThumbnailComponent::updateLayers
+        auto sourceStart = (double) edit->state.getProperty ("sourceStart", 0.0);
+        auto sourceEnd = (double) edit->state.getProperty ("sourceEnd", 0.0);
+
+        if (sourceEnd <= sourceStart)
+            sourceEnd = clip->getSourceLength().inSeconds();
+
+        newView.sourceStart = sourceStart;
+        newView.timeStretchRatio = sourceEnd > sourceStart ? clipLength / (sourceEnd - sourceStart) : 0.0;
+        newView.gain = clip->getGain();
+    }
+
+    {
+        const juce::ScopedLock sl (lock);
+        view = newView;
+    }
+
+    openGLContext.triggerRepaint();
+}
+
+void TimelineRenderer::updateInstances()
+{
+    std::vector<Instance> newInstances;
+
+    auto add = [&newInstances] (double start, double end, float top, float bottom, Lane lane, juce::Colour colour)
+    {
+        newInstances.push_back ({ (float) start, (float) end, top, bottom, (float) lane,
+                                  { colour.getFloatRed(), colour.getFloatGreen(), colour.getFloatBlue(), colour.getFloatAlpha() } });
+    };
+
+    auto* clip = EngineHelpers::getCurrentClip (*edit);
+    const auto clipLength = clip != nullptr ? clip->getPosition().getLength().inSeconds() : 60.0;
+    const juce::Range<double> wholeClip (0.0, clipLength);
+
+    // Thumbnail: chops, the centre line and the beat grid, as in ThumbnailComponent::renderOverlayLayer
+    if (auto chopTrack = EngineHelpers::getChopTrack (*edit))
+    {
+        for (auto chop : chopTrack->getClips())
+        {
+            const auto start = chop->getPosition().getStart().inSeconds();
+            const auto end = chop->getPosition().getEnd().inSeconds();
+
+            add (start, end, 0.0f, 1.0f, thumbnailLaneIndex, juce::Colours::purple.withAlpha (0.3f));
+            add (start, start, 0.0f, 1.0f, thumbnailLaneIndex, juce::Colours::purple.withAlpha (0.5f));
+            add (end, end, 0.0f, 1.0f, thumbnailLaneIndex, juce::Colours::purple.withAlpha (0.5f));
+        }
+    }
+
+    add (0.0, clipLength, 0.5f, 0.5f, thumbnailLaneIndex, juce::Colours::grey.withAlpha (0.3f));
+
+    // The lines are laid out in time, so the pixel arguments don't matter
+    for (auto& line : beatGrid.getLines (wholeClip, 0.0f, 1.0f))
+        add (line.time, line.time, 0.0f, 1.0f, thumbnailLaneIndex,
+             juce::Colours::white.withAlpha (line.isBar ? 0.4f : 0.2f));
+
+    // Chop lane: the snapping grid and the chops, as in ChopTrackLane::paint
+    for (auto& line : beatGrid.getLines (wholeClip, 0.0f, 1.0f, zoomState.getGridSize()))
+        add (line.time, line.time, 0.0f, 1.0f, chopLaneIndex, juce::Colours::grey.withAlpha (0.5f));
+
+    if (auto chopTrack = EngineHelpers::getChopTrack (*edit))
+    {
+        for (auto chop : chopTrack->getClips())
+        {
+            const auto start = chop->getPosition().getStart().inSeconds();
+            const auto end = chop->getPosition().getEnd().inSeconds();
+
+            add (start, end, 0.0f, 1.0f, chopLaneIndex, juce::Colours::orange);
+            add (start, start, 0.0f, 1.0f, chopLaneIndex, juce::Colours::white.withAlpha (0.5f));
+            add (end, end, 0.0f, 1.0f, chopLaneIndex, juce::Colours::white.withAlpha (0.5f));
+        }
+    }
+
+    {
+        const juce::ScopedLock sl (lock);
+        instances = std::move (newInstances);
+        instancesChanged = true;
+    }
+
+    openGLContext.triggerRepaint();
+}
+
+//==============================================================================
+void TimelineRenderer::newOpenGLContextCreated()
+{
+    gl = std::make_unique<GLState> (openGLContext);
+
+    // Everything is uploaded again into the new context
+    const juce::ScopedLock sl (lock);
+    instancesChanged = true;
+    peaksChanged = true;
+}
+
+void TimelineRenderer::openGLContextClosing()
+{
+    gl = nullptr;
+}
+
+void TimelineRenderer::renderOpenGL()
+{
+    jassert (juce::OpenGLHelpers::isContextActive());
+
+    if (gl == nullptr || ! gl->isValid())
+        return;
+
+    const UIProfiler::ScopedTimer profile ("TimelineRenderer::renderOpenGL");
+    View frame;
+
+    {
+        const juce::ScopedLock sl (lock);
+        frame = view;
+
+        if (instancesChanged)
+            gl->uploadInstances (instances);
+
+        if (peaksChanged)
+        {
+            gl->uploadPeaks (peaks.get());
+            gl->peaksSampleRate = peaksSampleRate;
+        }
+
+        instancesChanged = peaksChanged = false;
+    }
+
+    const auto scale = (float) openGLContext.getRenderingScale();
+    const auto width = (float) frame.timeline.getWidth() * scale;
+    const auto height = (float) frame.timeline.getHeight() * scale;
+
+    // Lane rectangles in physical pixels, with GL's origin at the bottom left
+    auto toGL = [&] (juce::Rectangle<int> r)
+    {
+        return juce::Rectangle<float> ((float) r.getX() * scale, height - (float) r.getBottom() * scale,
+                                       (float) r.getWidth() * scale, (float) r.getHeight() * scale);
+    };
+
+    auto scissor = [] (juce::Rectangle<float> r)
+    {
+        glScissor ((GLint) r.getX(), (GLint) r.getY(), (GLsizei) r.getWidth(), (GLsizei) r.getHeight());
+    };
+
+    glViewport (0, 0, juce::roundToInt (width), juce::roundToInt (height));
+    juce::OpenGLHelpers::clear (timeline.getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+
+    glEnable (GL_BLEND);
+    glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable (GL_SCISSOR_TEST);
+
+    const juce::Colour laneBackgrounds[numLanes] = { juce::Colours::darkgrey.darker (0.7f), juce::Colours::darkgrey };
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        // The thumbnail's background includes its border
+        scissor (toGL (lane == thumbnailLaneIndex ? frame.lanes[lane].expanded (2) : frame.lanes[lane]));
+        juce::OpenGLHelpers::clear (laneBackgrounds[lane]);
+    }
+
+    // JUCE keeps its own vertex array bound for painting the components
+    GLint previousVertexArray = 0;
+    glGetIntegerv (GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
+    glBindVertexArray (gl->vertexArray);
+
+    auto bindAttribute = [] (juce::OpenGLShaderProgram& program, const char* name, GLint size, GLsizei stride, size_t offset, GLuint divisor)
+    {
+        const auto location = glGetAttribLocation (program.getProgramID(), name);
+
+        if (location < 0)
+            return;
+
+        glVertexAttribPointer ((GLuint) location, size, GL_FLOAT, GL_FALSE, stride, (const void*) offset);
+        glEnableVertexAttribArray ((GLuint) location);
+        glVertexAttribDivisor ((GLuint) location, divisor);
+    };
+
+    auto setUniform = [] (juce::OpenGLShaderProgram& program, const char* name, auto... values)
+    {
+        const juce::OpenGLShaderProgram::Uniform uniform (program, name);
+
+        if (uniform.uniformID >= 0)
+            uniform.set ((GLfloat) values...);
+    };
+
+    // Waveform: one quad over the thumbnail lane, at the level nearest the zoom
+    const auto waveformRect = toGL (frame.lanes[thumbnailLaneIndex]);
+
+    if (! gl->peakTextures.empty() && frame.timeStretchRatio > 0.0 && ! waveformRect.isEmpty())
+    {
+        const auto samplesPerPixel = frame.length / frame.timeStretchRatio * gl->peaksSampleRate / waveformRect.getWidth();
+        auto level = 0;
+
+        while (level + 1 < (int) gl->peakTextures.size() && (double) PeakPyramidAnalyzer::getSamplesPerPeak (level) < samplesPerPixel)
+            ++level;
+
+        auto& program = *gl->waveform;
+        program.use();
+
+        glActiveTexture (GL_TEXTURE0);
+        glBindTexture (GL_TEXTURE_2D, gl->peakTextures[(size_t) level]);
+        glUniform1i (glGetUniformLocation (program.getProgramID(), "peaks"), 0);
+
+        setUniform (program, "laneRect", waveformRect.getX(), waveformRect.getY(), waveformRect.getWidth(), waveformRect.getHeight());
+        setUniform (program, "viewStart", frame.start);
+        setUniform (program, "viewLength", frame.length);
+        setUniform (program, "sourceStart", frame.sourceStart);
+        setUniform (program, "timeStretchRatio", frame.timeStretchRatio);
+        setUniform (program, "peaksPerSecond", gl->peaksSampleRate / (double) PeakPyramidAnalyzer::getSamplesPerPeak (level));
+        setUniform (program, "numPeaks", gl->numPeaks[(size_t) level]);
+        setUniform (program, "gain", frame.gain);
+
+        glBindBuffer (GL_ARRAY_BUFFER, gl->unitQuad);
+        bindAttribute (program, "position", 2, 0, 0, 0);
+
+        scissor (waveformRect);
+        glViewport ((GLint) waveformRect.getX(), (GLint) waveformRect.getY(), (GLsizei) waveformRect.getWidth(), (GLsizei) waveformRect.getHeight());
+        glDrawArrays (GL_TRIANGLE_STRIP, 0, 4);
+        glViewport (0, 0, juce::roundToInt (width), juce::roundToInt (height));
+        glBindTexture (GL_TEXTURE_2D, 0);
+    }
+
+    // Chops and grid lines: one instanced draw per lane
+    {
+        auto& program = *gl->quads;
+        program.use();
+
+        const auto lane0 = toGL (frame.lanes[thumbnailLaneIndex]);
+        const auto lane1 = toGL (frame.lanes[chopLaneIndex]);
+        setUniform (program, "lane0", lane0.getX(), lane0.getY(), lane0.getWidth(), lane0.getHeight());
+        setUniform (program, "lane1", lane1.getX(), lane1.getY(), lane1.getWidth(), lane1.getHeight());
+        setUniform (program, "resolution", width, height);
+        setUniform (program, "viewStart", frame.start);
+        setUniform (program, "viewLength", frame.length);
+        setUniform (program, "pixelSize", scale);
+
+        glBindBuffer (GL_ARRAY_BUFFER, gl->unitQuad);
+        bindAttribute (program, "position", 2, 0, 0, 0);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto range = gl->laneInstances[lane];
+
+            if (range.isEmpty())
+                continue;
+
+            // Each lane's instances start at a different offset in the buffer
+            const auto first = (size_t) range.getStart() * sizeof (Instance);
+            glBindBuffer (GL_ARRAY_BUFFER, gl->instanceBuffer);
+            bindAttribute (program, "span", 2, sizeof (Instance), first + offsetof (Instance, start), 1);
+            bindAttribute (program, "extent", 2, sizeof (Instance), first + offsetof (Instance, top), 1);
+            bindAttribute (program, "lane", 1, sizeof (Instance), first + offsetof (Instance, lane), 1);
+            bindAttribute (program, "colour", 4, sizeof (Instance), first + offsetof (Instance, colour), 1);
+
+            scissor (lane == thumbnailLaneIndex ? lane0 : lane1);
+            glDrawArraysInstanced (GL_TRIANGLE_STRIP, 0, 4, range.getLength());
+        }
+    }
+
+    // Leave the state as the component painting expects it
+    glDisable (GL_SCISSOR_TEST);
+    glBindBuffer (GL_ARRAY_BUFFER, 0);
+    glBindVertexArray ((GLuint) previousVertexArray);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_opengl/juce_opengl.h>
+#include <tracktion_engine/tracktion_engine.h>
+#include <memory>
+#include <vector>
+
+#include "BeatGrid.h"
+#include "ZoomState.h"
+
+class PeakPyramidAnalyzer;
+
+//==============================================================================
+/**
+    Draws the timeline's waveform, chops and grid lines with OpenGL.
+
+    It attaches a GL context to the timeline component, set up the same way
+    as Oscilloscope2D's, and draws the thumbnail and chop lanes underneath
+    the child components. The context then composites the rest of the
+    timeline, the automation lanes included, on the GPU.
+    - The clip's peak pyramid is read once in the background. Each level is
+      uploaded as a texture, and the fragment shader looks up a pixel
+      column's peak at the level nearest the zoom.
+    - Chops, beats, bars and grid lines are each uploaded as one instanced
+      quad, again only when the chops, tempo or grid size change.
+
+    Zooming and scrolling change only a handful of uniforms, so drawing a
+    frame costs almost no CPU. While attached, the thumbnail and chop lane
+    leave their painting to it (see ThumbnailComponent::setGpuRendered).
+
+    Optional, and off by default: see TransportComponent::setGpuTimelineEnabled.
+*/
+class TimelineRenderer : private juce::OpenGLRenderer,
+                         private juce::ValueTree::Listener,
+                         private ZoomStateListener
+{
+public:
+    TimelineRenderer (juce::Component& timeline, juce::Component& thumbnailLane, juce::Component& chopLane,
+                      tracktion::engine::Edit&, ZoomState&);
+    ~TimelineRenderer() override;
+
+    void setEdit (tracktion::engine::Edit&);
+
+    /** Call after the timeline has laid out its lanes. */
+    void lanesMoved();
+
+    /** False until the clip's peaks have been read. */
+    bool hasPeaks() const;
+
+private:
+    // One quad: a time span in a lane, between two heights (0 at the top, 1 at the bottom)
+    struct Instance
+    {
+        float start, end;
+        float top, bottom;
+        float lane;
+        float colour[4];
+    };
+
+    enum Lane { thumbnailLaneIndex, chopLaneIndex, numLanes };
+
+    // Everything a frame needs, handed from the message thread to the GL thread
+    struct View
+    {
+        double start = 0.0, length = 1.0;                       // edit seconds
+        double sourceStart = 0.0, timeStretchRatio = 1.0;
+        float gain = 1.0f;
+        juce::Rectangle<int> timeline;
+        juce::Rectangle<int> lanes[numLanes];
+    };
+
+    struct PeakJob;
+
+    juce::Component& timeline;
+    juce::Component* lanes[numLanes];
+    tracktion::engine::Edit* edit;
+    ZoomState& zoomState;
+    BeatGrid beatGrid;
+    juce::ValueTree chopTrackState;
+
+    juce::OpenGLContext openGLContext;
+    juce::ThreadPool pool { 1 };
+    std::shared_ptr<PeakJob> peakJob;
+    juce::File peaksFile;
+
+    // Shared with the GL thread
+    juce::CriticalSection lock;
+    View view;
+    std::vector<Instance> instances;
+    std::shared_ptr<const PeakPyramidAnalyzer> peaks;
+    double peaksSampleRate = 0.0;
+    bool instancesChanged = true, peaksChanged = false;
+
+    // GL thread only
+    struct GLState;
+    std::unique_ptr<GLState> gl;
+
+    void loadPeaks();
+    void peaksLoaded (std::shared_ptr<PeakJob>);
+    void updateView();
+    void updateInstances();
+
+    void newOpenGLContextCreated() override;
+    void renderOpenGL() override;
+    void openGLContextClosing() override;
+
+    void zoomLevelChanged (double) override                 { updateView(); }
+    void scrollPositionChanged (double) override            { updateView(); }
+    void gridSizeChanged (float) override                   { updateInstances(); }
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override   { updateInstances(); }
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override               { updateInstances(); }
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override        { updateInstances(); }
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (TimelineRenderer)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimelineRenderer)
+};
@@ -1,8 +1,8 @@
 #include "TransportBar.h"
 
 TransportBar::TransportBar(tracktion::engine::Edit& e, ZoomState& zs)
-    : edit(e),
-      transport(e.getTransport()),
+    : edit(&e),
+      transport(&e.getTransport()),
       zoomState(zs)
 {
     // Add and make visible all buttons
@@ -17,7 +17,7 @@ TransportBar::TransportBar(tracktion::engine::Edit& e, ZoomState& zs)
     addAndMakeVisible(gridSizeComboBox);
 
     // Listen to transport changes
-    edit.getTransport().addChangeListener(this);
+    attachToEdit();
     
     // Get colors from the look and feel
     const auto secondary = juce::Colour(0xFF707070);    // Light gray accent
@@ -85,32 +85,32 @@ TransportBar::TransportBar(tracktion::engine::Edit& e, ZoomState& zs)
 
     // Setup button callbacks
     playButton.onClick = [this] {
-        auto& tempoSequence = edit.tempoSequence;
+        auto& tempoSequence = edit->tempoSequence;
 
-        if (transport.isPlaying())
-            transport.stop(false, false);
+        if (transport->isPlaying())
+            transport->stop(false, false);
         else
         {
             // Ensure we're synced to tempo before playing
             auto position = createPosition(tempoSequence);
-            position.set(transport.getPosition());
+            position.set(transport->getPosition());
 
             // Update transport to sync with tempo
-            transport.setPosition(position.getTime());
-            transport.play(false);
+            transport->setPosition(position.getTime());
+            transport->play(false);
         }
         updateTransportState();
     };
 
     stopButton.onClick = [this] {
-        transport.stop(false, false);
-        transport.setPosition(tracktion::TimePosition::fromSeconds(0.0));
+        transport->stop(false, false);
+        transport->setPosition(tracktion::TimePosition::fromSeconds(0.0));
         updateTransportState();
     };
 
     loopButton.setClickingTogglesState(true);
     loopButton.onClick = [this] {
-        transport.looping = loopButton.getToggleState();
+        transport->looping = loopButton.getToggleState();
         updateTransportState();
     };
 
@@ -143,15 +143,14 @@ TransportBar::TransportBar(tracktion::engine::Edit& e, ZoomState& zs)
     );
     automationWriteButton.setOutline(secondary, 1.0f);
     
-    automationReadButton.setToggleState(edit.getAutomationRecordManager().isReadingAutomation(), juce::dontSendNotification);
-    automationWriteButton.setToggleState(edit.getAutomationRecordManager().isWritingAutomation(), juce::dontSendNotification);
+    updateAutomationButtonStates();
     
     automationReadButton.onClick = [this] {
-        edit.getAutomationRecordManager().setReadingAutomation(automationReadButton.getToggleState());
+        edit->getAutomationRecordManager().setReadingAutomation(automationReadButton.getToggleState());
     };
     
     automationWriteButton.onClick = [this] {
-        edit.getAutomationRecordManager().setWritingAutomation(automationWriteButton.getToggleState());
+        edit->getAutomationRecordManager().setWritingAutomation(automationWriteButton.getToggleState());
         // Update colors when armed state changes
         updateAutomationWriteButtonState();
     };
@@ -176,21 +175,86 @@ TransportBar::TransportBar(tracktion::engine::Edit& e, ZoomState& zs)
         zoomState.setZoomLevel(zoomState.getZoomLevel() / 1.5);
     };
 
-    startTimerHz(30);
+    updateAutomationWriteButtonState();
 }
 
 TransportBar::~TransportBar()
 {
-    stopTimer();
+    frameScheduler->stopAnimating(*this);
     
-    if (&edit != nullptr && &(edit.getTransport()) != nullptr)
-    {
-        edit.getTransport().removeChangeListener(this);
-    }
+    detachFromEdit();
     
     zoomState.removeListener(this);
 }
 
+void TransportBar::attachToEdit()
+{
+    transport->addChangeListener(this);
+    transport->state.addListener(this);
+
+    tempoState = edit->state.getChildWithName(tracktion::engine::IDs::TEMPOSEQUENCE);
+    tempoState.addListener(this);
+
+    updateAnimationState();
+}
+
+void TransportBar::detachFromEdit()
+{
+    transport->removeChangeListener(this);
+    transport->state.removeListener(this);
+    tempoState.removeListener(this);
+}
+
+void TransportBar::updateAnimationState()
+{
+    if (transport->isPlaying())
+        frameScheduler->startAnimating(*this);
+    else
+        frameScheduler->stopAnimating(*this);
+
+    frameScheduler->requestFrame(*this);
+}
+
+void TransportBar::valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier& property)
+{
+    const auto tempoChanged = tree == tempoState || tree.isAChildOf(tempoState);
+
+    if (tempoChanged)
+        invalidateTimeDisplay();
+
+    if (transport->isPlaying())
+        return;
+
+    if (tempoChanged || property == tracktion::engine::IDs::position)
+        frameScheduler->requestFrame(*this);
+}
+
+void TransportBar::setEdit(tracktion::engine::Edit& newEdit)
+{
+    if (edit == &newEdit)
+        return;
+
+    detachFromEdit();
+
+    edit = &newEdit;
+    transport = &newEdit.getTransport();
+    playheadClock.reset();
+    invalidateTimeDisplay();
+    attachToEdit();
+
+    // Looping and automation modes belong to the Edit, so the buttons follow it
+    updateAutomationButtonStates();
+    updateAutomationWriteButtonState();
+    updateTransportState();
+    updateTimeDisplay();
+}
+
+void TransportBar::updateAutomationButtonStates()
+{
+    automationReadButton.setToggleState(edit->getAutomationRecordManager().isReadingAutomation(), juce::dontSendNotification);
+    automationWriteButton.setToggleState(edit->getAutomationRecordManager().isWritingAutomation(), juce::dontSendNotification);
+}
+
 void TransportBar::resized()
 {
     auto bounds = getLocalBounds();
@@ -258,51 +322,89 @@ void TransportBar::resized()
 
 void TransportBar::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
-    if (source == &(edit.getTransport()))
+    if (source == &(edit->getTransport()))
     {
         updateTransportState();
-        snapButton.setToggleState(transport.snapToTimecode, juce::dontSendNotification);
-        repaint();
+        updateAutomationWriteButtonState();
+        updateAnimationState();
+        // The buttons repaint themselves when their state changes
+        snapButton.setToggleState(transport->snapToTimecode, juce::dontSendNotification);
     }
 }
 
-void TransportBar::timerCallback()
+void TransportBar::frameCallback(double timeMs)
 {
-    updateTimeDisplay();
-    updateAutomationWriteButtonState();
+    updateTimeDisplay(timeMs);
 }
 
-void TransportBar::updateTimeDisplay()
+void TransportBar::updateTimeDisplay(double timeMs)
 {
-    auto& tempoSequence = edit.tempoSequence;
+    // Between audio blocks the clock carries the position on, so it counts smoothly
+    const auto seconds = playheadClock.getPosition(*transport, timeMs);
+    const auto millis = (juce::int64) (seconds * 1000.0);
+    const auto barFieldsChanged = ! barFieldsSpan.contains(seconds);
+
+    if (millis == displayedMillis && ! barFieldsChanged)
+        return;
+
+    if (barFieldsChanged)
+        updateBarFields(seconds);
+
+    displayedMillis = millis;
+
+    timeDisplay.setText(juce::String::formatted("%02d:%02d:%03d | ",
+                            (int)(seconds / 60.0),
+                            (int)seconds % 60,
+                            (int)(millis % 1000))
+                            + barFieldsText,
+        juce::dontSendNotification);
+}
+
+void TransportBar::updateBarFields(double seconds)
+{
+    auto& tempoSequence = edit->tempoSequence;
     auto position = createPosition(tempoSequence);
-    position.set(transport.getPosition());
+    position.set(tracktion::TimePosition::fromSeconds(seconds));
 
     auto barsBeats = position.getBarsBeats();
     auto tempo = position.getTempo();
     auto timeSignature = position.getTimeSignature();
 
-    auto seconds = transport.getPosition().inSeconds();
-    auto minutes = (int)(seconds / 60.0);
-    auto millis = (int)(seconds * 1000) % 1000;
+    barFieldsText = juce::String::formatted("%d/%d | Bar %d | %.1f BPM",
+                                            timeSignature.numerator,
+                                            timeSignature.denominator,
+                                            barsBeats.bars + 1,
+                                            tempo);
 
-    timeDisplay.setText(juce::String::formatted("%02d:%02d:%03d | %d/%d | Bar %d | %.1f BPM",
-                            minutes,
-                            (int)seconds % 60,
-                            millis,
-                            timeSignature.numerator,
-                            timeSignature.denominator,
-                            barsBeats.bars + 1,
-                            tempo),
-        juce::dontSendNotification);
+    // Read again at the next beat rather than the next bar, so a tempo ramp still shows
+    auto beatStart = barsBeats;
+    beatStart.beats = tracktion::BeatDuration::fromBeats(std::floor(barsBeats.beats.inBeats()));
+    auto nextBeat = beatStart;
+    nextBeat.beats = beatStart.beats + tracktion::BeatDuration::fromBeats(1.0);
+
+    barFieldsSpan = { tempoSequence.toTime(beatStart).inSeconds(), tempoSequence.toTime(nextBeat).inSeconds() };
+}
+
+void TransportBar::invalidateTimeDisplay()
+{
+    barFieldsSpan = {};
+    displayedMillis = -1;
 }
 
 void TransportBar::updateTransportState()
 {
-    bool isPlaying = transport.isPlaying();
+    bool isPlaying = transport->isPlaying();
+
     playButton.setToggleState(isPlaying, juce::dontSendNotification);
-    playButton.setShape(isPlaying ? getPausePath() : getPlayPath(), false, true, false);
-    loopButton.setToggleState(transport.looping, juce::dontSendNotification);
+
+    // Rebuilding the shape repaints the button, so only when it changes
+    if (playButtonShowsPause != isPlaying)
+    {
+        playButtonShowsPause = isPlaying;
+        playButton.setShape(isPlaying ? getPausePath() : getPlayPath(), false, true, false);
+    }
+
+    loopButton.setToggleState(transport->looping, juce::dontSendNotification);
 }
 
 void TransportBar::gridSizeChanged(float newGridSize)
@@ -320,9 +422,17 @@ void TransportBar::gridSizeChanged(float newGridSize)
 
 void TransportBar::updateAutomationWriteButtonState()
 {
-    bool isArmed = edit.getAutomationRecordManager().isWritingAutomation();
-    bool isPlaying = transport.isPlaying();
-    
+    bool isArmed = edit->getAutomationRecordManager().isWritingAutomation();
+    bool isPlaying = transport->isPlaying();
+
+    const auto state = (isArmed ? 2 : 0) + (isPlaying ? 1 : 0);
+
+    if (state == writeButtonState)
+        return;
+
+    writeButtonState = state;
+    automationWriteButton.repaint();
+
     if (isArmed) {
         if (isPlaying) {
             // Flash between bright red and darker red when armed and playing
@@ -6,11 +6,14 @@
 #include <tracktion_engine/tracktion_engine.h>
 
 #include "CustomLookAndFeel.h"
+#include "FrameScheduler.h"
+#include "PlayheadClock.h"
 #include "ZoomState.h"
 
 class TransportBar : public juce::Component,
-                    public juce::Timer,
+                    public FrameScheduler::Client,
                     public juce::ChangeListener,
+                    private juce::ValueTree::Listener,
                     public ZoomStateListener
 {
 public:
@@ -22,18 +25,30 @@ public:
 
     void resized() override;
     void changeListenerCallback(juce::ChangeBroadcaster*) override;
-    void timerCallback() override;
+    void frameCallback(double timeMs) override;
     void gridSizeChanged(float newGridSize) override;
 
-    void updateTimeDisplay();
+    /** Follows another Edit's transport, keeping the bar's layout and zoom settings. */
+    void setEdit(tracktion::engine::Edit& newEdit);
+
+    void updateTimeDisplay(double timeMs = juce::Time::getMillisecondCounterHiRes());
     void updateTransportState();
     
     void setSnapCallback(SnapCallback callback) { onSnapStateChanged = callback; }
 
 private:
-    tracktion::engine::Edit& edit;
-    tracktion::engine::TransportControl& transport;
+    tracktion::engine::Edit* edit;
+    tracktion::engine::TransportControl* transport;
     ZoomState& zoomState;
+    juce::SharedResourcePointer<FrameScheduler> frameScheduler;
+
+    // The time display moves every frame while playing, and otherwise only when
+    // the position or tempo is changed
+    juce::ValueTree tempoState;
+    void attachToEdit();
+    void detachFromEdit();
+    void updateAnimationState();
+    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override;
     
     // Colors
     const juce::Colour primary{0xFF505050};  // Medium gray
@@ -60,7 +75,22 @@ private:
     // Timeline and position display
     juce::Label timeDisplay;
 
+    // The display is only rebuilt when its text would change: the clock on each
+    // new millisecond, the bar, time signature and tempo when the position
+    // leaves the beat they were read at or the tempo map changes
+    PlayheadClock playheadClock;
+    juce::int64 displayedMillis = -1;
+    juce::Range<double> barFieldsSpan;                  // seconds; empty when they need reading
+    juce::String barFieldsText;
+    void updateBarFields(double seconds);
+    void invalidateTimeDisplay();
+
+    // What the buttons last showed, so unchanged state isn't redrawn
+    bool playButtonShowsPause = false;
+    int writeButtonState = -1;                          // armed * 2 + playing
+
     void updateAutomationWriteButtonState();
+    void updateAutomationButtonStates();
 
     // Icon path functions
     static juce::Path getPlayPath()
@@ -6,8 +6,8 @@
 #include "Plugins/FlangerPlugin.h"
 
 TransportComponent::TransportComponent(tracktion::engine::Edit& e, ZoomState& zs)
-    : edit(e),
-      transport(e.getTransport()),
+    : edit(&e),
+      transport(&e.getTransport()),
       zoomState(zs),
       transportBar(e, zs)
 {
@@ -15,7 +15,7 @@ TransportComponent::TransportComponent(tracktion::engine::Edit& e, ZoomState& zs
     addAndMakeVisible(transportBar);
 
     // Create and add thumbnail component with zoom state
-    thumbnailComponent = std::make_unique<ThumbnailComponent>(edit, zoomState);
+    thumbnailComponent = std::make_unique<ThumbnailComponent>(e, zoomState);
     addAndMakeVisible(*thumbnailComponent);
 
     // Add and make visible other components
@@ -24,17 +24,7 @@ TransportComponent::TransportComponent(tracktion::engine::Edit& e, ZoomState& zs
     pluginAutomationViewport.setScrollBarsShown(true, false);
 
     // Create and add crossfader automation lane with zoom state
-    chopTrackLane = std::make_unique<ChopTrackLane>(edit, zoomState);
-    
-    // Find the crossfader parameter
-    tracktion::engine::AutomatableParameter* crossfaderParam = nullptr;
-    if (auto chopPlugin = EngineHelpers::getPluginFromMasterTrack(edit, ChopPlugin::xmlTypeName))
-    {
-        if (auto* plugin = chopPlugin.get())
-        {
-            crossfaderParam = plugin->getAutomatableParameterByID("crossfader");
-        }
-    }
+    chopTrackLane = std::make_unique<ChopTrackLane>(e, zoomState);
     
     addAndMakeVisible(*chopTrackLane);
 
@@ -43,64 +33,111 @@ TransportComponent::TransportComponent(tracktion::engine::Edit& e, ZoomState& zs
         setSnapEnabled(snapEnabled);
     });
 
-    // Find and create plugin automation components
-    if (auto reverbPlugin = EngineHelpers::getPluginFromRack(edit, tracktion::engine::ReverbPlugin::xmlTypeName))
+    createPluginAutomationComponents();
+
+    // Initialize layout manager
+    // We'll use indices 0-7 for our components (2 indices per component for spacing)
+    for (int i = 0; i < 8; ++i)
+        itemComponents.push_back(i);
+
+    // Set minimum sizes
+    layoutManager.setItemLayout(0, controlBarHeight, controlBarHeight, controlBarHeight);  // Transport bar (fixed)
+    layoutManager.setItemLayout(1, 2, 2, 2);  // Spacing
+    layoutManager.setItemLayout(2, thumbnailHeight, thumbnailHeight, thumbnailHeight);  // Thumbnail (fixed)
+    layoutManager.setItemLayout(3, 2, 2, 2);  // Spacing
+    layoutManager.setItemLayout(4, crossfaderHeight, crossfaderHeight, crossfaderHeight);  // Crossfader (fixed)
+    layoutManager.setItemLayout(5, 2, 2, 2);  // Spacing
+    layoutManager.setItemLayout(6, minPluginHeight, -1.0, -1.0);  // Plugin container (stretches)
+    layoutManager.setItemLayout(7, 2, 2, 2);  // Final spacing
+
+    // Register as automation listener
+    edit->getAutomationRecordManager().addListener(this);
+}
+
+void TransportComponent::setEdit(tracktion::engine::Edit& newEdit)
+{
+    if (edit == &newEdit)
+        return;
+
+    edit->getAutomationRecordManager().removeListener(this);
+
+    // The automation lanes hold the old Edit's curves, so they go before it does
+    clearPluginAutomationComponents();
+
+    edit = &newEdit;
+    transport = &newEdit.getTransport();
+
+    transportBar.setEdit(newEdit);
+    thumbnailComponent->setEdit(newEdit);
+    chopTrackLane->setEdit(newEdit);
+
+    if (timelineRenderer != nullptr)
+        timelineRenderer->setEdit(newEdit);
+
+    createPluginAutomationComponents();
+
+    edit->getAutomationRecordManager().addListener(this);
+
+    layoutItemsWithCurrentBounds();
+    repaint();
+}
+
+void TransportComponent::createPluginAutomationComponents()
+{
+    auto reverbPlugin = EngineHelpers::getPluginFromRack(*edit, AutoReverbPlugin::xmlTypeName);
+
+    if (reverbPlugin == nullptr) // items imported before AutoReverbPlugin
+        reverbPlugin = EngineHelpers::getPluginFromRack(*edit, tracktion::engine::ReverbPlugin::xmlTypeName);
+
+    if (reverbPlugin != nullptr)
     {
-        reverbAutomationComponent = std::make_unique<PluginAutomationComponent>(edit, reverbPlugin.get(), zoomState);
+        reverbAutomationComponent = std::make_unique<PluginAutomationComponent>(*edit, reverbPlugin.get(), zoomState);
         reverbAutomationComponent->setAllowedParameterIDs({"wet level", "room size"}); // Only show wet level and room size
         pluginAutomationContainer.addPluginComponent(reverbAutomationComponent.get());
     }
 
-    if (auto delayPlugin = EngineHelpers::getPluginFromRack(edit, AutoDelayPlugin::xmlTypeName))
+    if (auto delayPlugin = EngineHelpers::getPluginFromRack(*edit, AutoDelayPlugin::xmlTypeName))
     {
-        delayAutomationComponent = std::make_unique<PluginAutomationComponent>(edit, delayPlugin.get(), zoomState);
+        delayAutomationComponent = std::make_unique<PluginAutomationComponent>(*edit, delayPlugin.get(), zoomState);
         // Allow all parameters for delay plugin
         delayAutomationComponent->setAllowedParameterIDs({"delay time", "feedback", "mix"});
         pluginAutomationContainer.addPluginComponent(delayAutomationComponent.get());
     }
 
-    if (auto phaserPlugin = EngineHelpers::getPluginFromRack(edit, AutoPhaserPlugin::xmlTypeName))
+    if (auto phaserPlugin = EngineHelpers::getPluginFromRack(*edit, AutoPhaserPlugin::xmlTypeName))
     {
-        phaserAutomationComponent = std::make_unique<PluginAutomationComponent>(edit, phaserPlugin.get(), zoomState);
+        phaserAutomationComponent = std::make_unique<PluginAutomationComponent>(*edit, phaserPlugin.get(), zoomState);
         // Allow all parameters for phaser plugin
         phaserAutomationComponent->setAllowedParameterIDs({"depth", "rate", "feedback"});
         pluginAutomationContainer.addPluginComponent(phaserAutomationComponent.get());
     }
 
-    if (auto flangerPlugin = EngineHelpers::getPluginFromRack(edit, FlangerPlugin::xmlTypeName))
+    if (auto flangerPlugin = EngineHelpers::getPluginFromRack(*edit, FlangerPlugin::xmlTypeName))
     {
-        flangerAutomationComponent = std::make_unique<PluginAutomationComponent>(edit, flangerPlugin.get(), zoomState);
+        flangerAutomationComponent = std::make_unique<PluginAutomationComponent>(*edit, flangerPlugin.get(), zoomState);
         // Allow all parameters for flanger plugin
         flangerAutomationComponent->setAllowedParameterIDs({"depth", "speed", "width", "mix"});
         pluginAutomationContainer.addPluginComponent(flangerAutomationComponent.get());
     }
+}
 
-    // Initialize layout manager
-    // We'll use indices 0-7 for our components (2 indices per component for spacing)
-    for (int i = 0; i < 8; ++i)
-        itemComponents.push_back(i);
-
-    // Set minimum sizes
-    layoutManager.setItemLayout(0, controlBarHeight, controlBarHeight, controlBarHeight);  // Transport bar (fixed)
-    layoutManager.setItemLayout(1, 2, 2, 2);  // Spacing
-    layoutManager.setItemLayout(2, thumbnailHeight, thumbnailHeight, thumbnailHeight);  // Thumbnail (fixed)
-    layoutManager.setItemLayout(3, 2, 2, 2);  // Spacing
-    layoutManager.setItemLayout(4, crossfaderHeight, crossfaderHeight, crossfaderHeight);  // Crossfader (fixed)
-    layoutManager.setItemLayout(5, 2, 2, 2);  // Spacing
-    layoutManager.setItemLayout(6, minPluginHeight, -1.0, -1.0);  // Plugin container (stretches)
-    layoutManager.setItemLayout(7, 2, 2, 2);  // Final spacing
+void TransportComponent::clearPluginAutomationComponents()
+{
+    pluginAutomationContainer.clearPluginComponents();
 
-    // Register as automation listener
-    edit.getAutomationRecordManager().addListener(this);
+    reverbAutomationComponent = nullptr;
+    delayAutomationComponent = nullptr;
+    phaserAutomationComponent = nullptr;
+    flangerAutomationComponent = nullptr;
 }
 
 TransportComponent::~TransportComponent()
 {
-    // Stop any ongoing operations
-    stopTimer();
-    
     // Remove listeners first
-    edit.getAutomationRecordManager().removeListener(this);
+    edit->getAutomationRecordManager().removeListener(this);
+
+    // Detach the GL context while the lanes it draws are still here
+    timelineRenderer = nullptr;
     
     // First remove components from the container view
     pluginAutomationContainer.removeAllChildren();
@@ -124,19 +161,35 @@ TransportComponent::~TransportComponent()
     removeAllChildren();
 }
 
-void TransportComponent::timerCallback()
-{
-    // Force thumbnail redraw during playback
-    if (transport.isPlaying())
-        repaint();
-}
-
 void TransportComponent::paint(juce::Graphics& g)
 {
+    // With the GPU timeline the lanes are drawn beneath this component, so it
+    // mustn't paint over them
+    if (timelineRenderer != nullptr)
+    {
+        g.excludeClipRegion(thumbnailComponent->getBounds());
+        g.excludeClipRegion(chopTrackLane->getBounds());
+    }
+
     // Background is now handled by child components
     g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
 }
 
+void TransportComponent::setGpuTimelineEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == isGpuTimelineEnabled())
+        return;
+
+    if (shouldBeEnabled)
+        timelineRenderer = std::make_unique<TimelineRenderer>(*this, *thumbnailComponent, *chopTrackLane, *edit, zoomState);
+    else
+        timelineRenderer = nullptr;
+
+    thumbnailComponent->setGpuRendered(shouldBeEnabled);
+    chopTrackLane->setGpuRendered(shouldBeEnabled);
+    repaint();
+}
+
 void TransportComponent::resized()
 {
     auto bounds = getLocalBounds();
@@ -203,6 +256,9 @@ void TransportComponent::layoutItemsWithCurrentBounds()
     
     // Update container size
     pluginAutomationContainer.setSize(w, containerHeight);
+
+    if (timelineRenderer != nullptr)
+        timelineRenderer->lanesMoved();
 }
 
 void TransportComponent::updateLayout()
@@ -11,10 +11,12 @@
 #include "Plugins/ChopPlugin.h"
 #include "Plugins/AutoDelayPlugin.h"
 #include "Plugins/AutoPhaserPlugin.h"
+#include "Plugins/AutoReverbPlugin.h"
 #include "Plugins/FlangerPlugin.h"
 #include "PluginAutomationComponent.h"
 #include "TransportBar.h"
 #include "ThumbnailComponent.h"
+#include "TimelineRenderer.h"
 #include "ZoomState.h"
 #include "ChopTrackLane.h"
 
@@ -52,6 +54,17 @@ public:
         updateContainerBounds();
     }
 
+    void clearPluginComponents()
+    {
+        for (auto* component : components)
+            if (component != nullptr)
+                component->removeHeightListener(this);
+
+        removeAllChildren();
+        components.clearQuick();
+        updateContainerBounds();
+    }
+
 private:
     void updateContainerBounds()
     {
@@ -77,7 +90,6 @@ private:
 };
 
 class TransportComponent : public juce::Component,
-                         public juce::Timer,
                          public juce::ChangeListener,
                          public tracktion::engine::AutomationRecordManager::Listener
 {
@@ -85,9 +97,13 @@ public:
     TransportComponent(tracktion::engine::Edit& e, ZoomState& zs);
     ~TransportComponent() override;
 
+    /** Switches the timeline to another Edit. The transport bar, thumbnail, chop
+        lane and layout are kept; only the per-plugin automation lanes are rebuilt.
+    */
+    void setEdit(tracktion::engine::Edit& newEdit);
+
     void paint(juce::Graphics&) override;
     void resized() override;
-    void timerCallback() override;
     void changeListenerCallback(juce::ChangeBroadcaster*) override;
     
     void mouseDown(const juce::MouseEvent&) override;
@@ -105,12 +121,20 @@ public:
     // Expose zoom state for child components
     ZoomState& getZoomState() { return zoomState; }
 
+    /** Draws the waveform, chops and grid with OpenGL rather than in software
+        (see TimelineRenderer). Off by default.
+    */
+    void setGpuTimelineEnabled(bool shouldBeEnabled);
+    bool isGpuTimelineEnabled() const { return timelineRenderer != nullptr; }
+
 private:
     void updateLayout();
+    void createPluginAutomationComponents();
+    void clearPluginAutomationComponents();
     void layoutItemsWithCurrentBounds();
 
-    tracktion::engine::Edit& edit;
-    tracktion::engine::TransportControl& transport;
+    tracktion::engine::Edit* edit;
+    tracktion::engine::TransportControl* transport;
     ZoomState& zoomState;
     
     // Transport bar
@@ -121,6 +145,9 @@ private:
     
     std::unique_ptr<ChopTrackLane> chopTrackLane;
     std::unique_ptr<AutomationLane> reverbWetAutomationLane;
+
+    // Only while the GPU timeline is enabled; destroyed before the lanes it draws
+    std::unique_ptr<TimelineRenderer> timelineRenderer;
     
     // Plugin automation components
     std::unique_ptr<PluginAutomationComponent> reverbAutomationComponent;
@@ -0,0 +1,243 @@
+#include "UIProfiler.h"
+#include "AudioCallbackMonitor.h"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    constexpr int messageThreadId = 1;
+    constexpr int otherThreadId = 2;
+
+    // Keeps the history bounded if something fires thousands of times a frame
+    constexpr size_t maxHistorySize = 200000;
+
+    int getHistogramBin (double ms) noexcept
+    {
+        for (int bin = 0; bin < UIProfiler::numHistogramBins - 1; ++bin)
+            if (ms < UIProfiler::getBinLimitMs (bin))
+                return bin;
+
+        return UIProfiler::numHistogramBins - 1;
+    }
+}
+
+//==============================================================================
+UIProfiler& UIProfiler::instance()
+{
+    static UIProfiler instance;
+    return instance;
+}
+
+UIProfiler::UIProfiler() = default;
+
+void UIProfiler::setEnabled (bool shouldBeEnabled)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (enabled.exchange (shouldBeEnabled) == shouldBeEnabled)
+        return;
+
+    if (shouldBeEnabled)
+    {
+        nesting = 0;
+        startTimerHz (4);
+    }
+    else
+    {
+        stopTimer();
+    }
+
+    sendChangeMessage();
+}
+
+void UIProfiler::beginFrame (double timeMs)
+{
+    if (! isEnabled())
+        return;
+
+    const juce::ScopedLock sl (lock);
+    closeFrame();
+    currentFrame.startMs = timeMs;
+    frameStarts.push_back (timeMs);
+}
+
+void UIProfiler::record (const juce::Identifier& name, double startMs, double endMs, bool onMessageThread)
+{
+    // Only the outermost timing on the message thread counts towards the frame,
+    // so a paint inside a timed callback isn't counted twice
+    if (onMessageThread)
+        nesting = juce::jmax (0, nesting - 1);
+
+    const auto isTopLevel = onMessageThread && nesting == 0;
+    const auto durationMs = endMs - startMs;
+
+    const juce::ScopedLock sl (lock);
+
+    auto& s = stats[name];
+    s.name = name;
+    ++s.count;
+    s.totalMs += durationMs;
+    s.maxMs = juce::jmax (s.maxMs, durationMs);
+    ++s.histogram[(size_t) getHistogramBin (durationMs)];
+
+    history.push_back ({ name, startMs, endMs, onMessageThread });
+
+    const auto cutoffMs = endMs - historySeconds * 1000.0;
+
+    while (! history.empty() && (history.front().startMs < cutoffMs || history.size() > maxHistorySize))
+        history.pop_front();
+
+    while (! frameStarts.empty() && frameStarts.front() < cutoffMs)
+        frameStarts.pop_front();
+
+    if (isTopLevel)
+    {
+        // Work arriving while nothing is scheduling frames is grouped by a frame's length
+        if (startMs - currentFrame.startMs > frameWindowMs)
+        {
+            closeFrame();
+            currentFrame.startMs = startMs;
+        }
+
+        currentFrame.busyMs += durationMs;
+        currentFrame.breakdown[name] += durationMs;
+    }
+
+    changed = true;
+}
+
+void UIProfiler::closeFrame()
+{
+    if (currentFrame.busyMs > worstFrame.busyMs)
+        worstFrame = currentFrame;
+
+    currentFrame = {};
+}
+
+void UIProfiler::timerCallback()
+{
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (! std::exchange (changed, false))
+            return;
+    }
+
+    sendChangeMessage();
+}
+
+//==============================================================================
+std::vector<UIProfiler::Stats> UIProfiler::getStats() const
+{
+    std::vector<Stats> result;
+
+    {
+        const juce::ScopedLock sl (lock);
+        result.reserve (stats.size());
+
+        for (const auto& [name, s] : stats)
+            result.push_back (s);
+    }
+
+    std::sort (result.begin(), result.end(), [] (const Stats& a, const Stats& b) { return a.totalMs > b.totalMs; });
+    return result;
+}
+
+UIProfiler::Frame UIProfiler::getWorstFrame() const
+{
+    const juce::ScopedLock sl (lock);
+    return currentFrame.busyMs > worstFrame.busyMs ? currentFrame : worstFrame;
+}
+
+void UIProfiler::reset()
+{
+    const juce::ScopedLock sl (lock);
+    stats.clear();
+    history.clear();
+    frameStarts.clear();
+    currentFrame = {};
+    worstFrame = {};
+    changed = true;
+}
+
+//==============================================================================
+void UIProfiler::writeTrace (juce::OutputStream& out) const
+{
+    juce::Array<juce::var> events;
+
+    auto addThreadName = [&events] (int tid, const char* name)
+    {
+        auto* args = new juce::DynamicObject();
+        args->setProperty ("name", name);
+
+        auto* event = new juce::DynamicObject();
+        event->setProperty ("name", "thread_name");
+        event->setProperty ("ph", "M");
+        event->setProperty ("pid", 1);
+        event->setProperty ("tid", tid);
+        event->setProperty ("args", juce::var (args));
+        events.add (juce::var (event));
+    };
+
+    addThreadName (messageThreadId, "Message thread");
+    addThreadName (otherThreadId, "Other threads");
+
+    {
+        const juce::ScopedLock sl (lock);
+
+        // Trace timestamps are microseconds; ours are Time::getMillisecondCounterHiRes(),
+        // the same clock as the audio timing dumps
+        for (const auto& record : history)
+        {
+            auto* event = new juce::DynamicObject();
+            event->setProperty ("name", record.name.toString());
+            event->setProperty ("cat", "ui");
+            event->setProperty ("ph", "X");
+            event->setProperty ("ts", record.startMs * 1000.0);
+            event->setProperty ("dur", (record.endMs - record.startMs) * 1000.0);
+            event->setProperty ("pid", 1);
+            event->setProperty ("tid", record.onMessageThread ? messageThreadId : otherThreadId);
+            events.add (juce::var (event));
+        }
+
+        for (const auto timeMs : frameStarts)
+        {
+            auto* event = new juce::DynamicObject();
+            event->setProperty ("name", "Frame");
+            event->setProperty ("cat", "frame");
+            event->setProperty ("ph", "i");
+            event->setProperty ("s", "t");
+            event->setProperty ("ts", timeMs * 1000.0);
+            event->setProperty ("pid", 1);
+            event->setProperty ("tid", messageThreadId);
+            events.add (juce::var (event));
+        }
+    }
+
+    auto* trace = new juce::DynamicObject();
+    trace->setProperty ("traceEvents", events);
+    trace->setProperty ("displayTimeUnit", "ms");
+
+    out << juce::JSON::toString (juce::var (trace), true);
+}
+
+juce::File UIProfiler::exportTrace() const
+{
+    auto dir = AudioCallbackMonitor::getDiagnosticsDirectory();
+
+    if (! dir.createDirectory())
+        return {};
+
+    auto file = dir.getChildFile ("ui-trace-" + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S") + ".json")
+                   .getNonexistentSibling();
+
+    juce::FileOutputStream out (file);
+
+    if (! out.openedOk())
+        return {};
+
+    writeTrace (out);
+    out.flush();
+
+    return out.getStatus().wasOk() ? file : juce::File();
+}
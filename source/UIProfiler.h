@@ -0,0 +1,140 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <vector>
+
+//==============================================================================
+/**
+    Times the UI's work on the message thread, so stalls while performing can
+    be traced to the component that caused them.
+
+    Paints, timer callbacks, frame callbacks and gamepad dispatches are wrapped
+    in a ScopedTimer. When profiling is off, each one costs a single atomic
+    load. When it's on, every timing is added to its name's histogram and kept
+    for historySeconds, so it can be exported as a Chrome trace
+    (chrome://tracing or https://ui.perfetto.dev).
+
+    Timings are grouped into frames: the message-thread work between two
+    FrameScheduler frames, or within frameWindowMs when no frames are being
+    scheduled. The busiest frame so far is kept with a breakdown by name.
+
+    ScopedTimers may be used on any thread (e.g. the GL renderers). Only
+    message-thread timings count towards frames. Everything else is message
+    thread only.
+*/
+class UIProfiler : public juce::ChangeBroadcaster,
+                   private juce::Timer
+{
+public:
+    static UIProfiler& instance();
+
+    void setEnabled (bool shouldBeEnabled);
+    bool isEnabled() const noexcept                     { return enabled.load (std::memory_order_relaxed); }
+
+    /** Times the scope it's declared in under a name, when profiling is enabled. */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer (const char* name)
+        {
+            if (instance().isEnabled())
+                begin (juce::Identifier (name));
+        }
+
+        explicit ScopedTimer (const juce::String& name)
+        {
+            if (instance().isEnabled() && name.isNotEmpty())
+                begin (juce::Identifier (name));
+        }
+
+        ~ScopedTimer()
+        {
+            if (name.isValid())
+                instance().record (name, startMs, juce::Time::getMillisecondCounterHiRes(), onMessageThread);
+        }
+
+    private:
+        juce::Identifier name;
+        double startMs = 0.0;
+        bool onMessageThread = false;
+
+        void begin (const juce::Identifier& n)
+        {
+            name = n;
+            onMessageThread = juce::MessageManager::existsAndIsCurrentThread();
+            startMs = juce::Time::getMillisecondCounterHiRes();
+
+            if (onMessageThread)
+                instance().nesting++;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimer)
+    };
+
+    /** Called by the FrameScheduler as each frame starts. */
+    void beginFrame (double timeMs);
+
+    // Bin b counts timings under getBinLimitMs (b); the last is everything longer
+    static constexpr int numHistogramBins = 10;
+    static double getBinLimitMs (int bin) noexcept      { return 0.0625 * (double) (1 << bin); }
+
+    struct Stats
+    {
+        juce::Identifier name;
+        juce::int64 count = 0;
+        double totalMs = 0.0, maxMs = 0.0;
+        std::array<juce::uint32, numHistogramBins> histogram{};
+    };
+
+    struct Frame
+    {
+        double startMs = 0.0;
+        double busyMs = 0.0;
+        std::map<juce::Identifier, double> breakdown;       // ms per name
+    };
+
+    /** Every name timed since the last reset, busiest first. */
+    std::vector<Stats> getStats() const;
+    Frame getWorstFrame() const;
+    void reset();
+
+    /** Writes the last historySeconds of timings as Chrome trace event JSON. */
+    void writeTrace (juce::OutputStream&) const;
+
+    /** Writes a trace to the diagnostics folder; returns the file or an empty File on failure. */
+    juce::File exportTrace() const;
+
+    static constexpr double historySeconds = 10.0;
+    static constexpr double frameWindowMs = 1000.0 / 60.0;
+
+private:
+    UIProfiler();
+
+    struct Record
+    {
+        juce::Identifier name;
+        double startMs = 0.0, endMs = 0.0;
+        bool onMessageThread = true;
+    };
+
+    std::atomic<bool> enabled { false };
+    int nesting = 0;                                        // message thread only
+
+    juce::CriticalSection lock;
+    std::map<juce::Identifier, Stats> stats;
+    std::deque<Record> history;
+    std::deque<double> frameStarts;
+    Frame currentFrame, worstFrame;
+    bool changed = false;
+
+    void record (const juce::Identifier&, double startMs, double endMs, bool onMessageThread);
+    void closeFrame();
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE (UIProfiler)
+};
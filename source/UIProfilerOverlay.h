@@ -0,0 +1,162 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "UIProfiler.h"
+#include "CustomLookAndFeel.h"
+
+// Floating panel showing where the message thread's time goes: the busiest
+// names with their duration histograms, and the worst frame so far broken down
+class UIProfilerOverlay : public juce::Component,
+                          private juce::ChangeListener
+{
+public:
+    UIProfilerOverlay (UIProfiler& p) : profiler (p)
+    {
+        setInterceptsMouseClicks (true, true);
+
+        exportButton.setButtonText ("Export trace");
+        exportButton.onClick = [this]
+        {
+            auto file = profiler.exportTrace();
+
+            if (file != juce::File())
+                file.revealToUser();
+        };
+        addAndMakeVisible (exportButton);
+
+        resetButton.setButtonText ("Reset");
+        resetButton.onClick = [this] { profiler.reset(); };
+        addAndMakeVisible (resetButton);
+
+        profiler.addChangeListener (this);
+    }
+
+    ~UIProfilerOverlay() override
+    {
+        profiler.removeChangeListener (this);
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        g.setColour (juce::Colour (0xE0121212));
+        g.fillRoundedRectangle (bounds, 6.0f);
+        g.setColour (juce::Colour (0xFF2A2A2A));
+        g.drawRoundedRectangle (bounds.reduced (0.5f), 6.0f, 1.0f);
+
+        auto area = getLocalBounds().reduced (8);
+        area.removeFromBottom (buttonRowHeight);
+
+        g.setFont (CustomLookAndFeel::getMonospaceFont().withHeight (12.0f));
+
+        const auto stats = profiler.getStats();
+        auto listArea = area.removeFromTop (maxRows * lineHeight);
+
+        g.setColour (juce::Colours::white.withAlpha (0.5f));
+        g.drawText ("count  mean   max", listArea.removeFromTop (lineHeight), juce::Justification::centredRight);
+
+        if (stats.empty())
+            g.drawText ("Nothing timed yet", listArea.removeFromTop (lineHeight), juce::Justification::centredLeft);
+
+        for (size_t i = 0; i < stats.size() && listArea.getHeight() >= lineHeight; ++i)
+        {
+            const auto& s = stats[i];
+            auto row = listArea.removeFromTop (lineHeight);
+
+            const auto meanMs = s.count > 0 ? s.totalMs / (double) s.count : 0.0;
+            g.setColour (getDurationColour (s.maxMs));
+            g.drawText (juce::String (s.count).paddedLeft (' ', 5)
+                            + juce::String (meanMs, 2).paddedLeft (' ', 6)
+                            + juce::String (s.maxMs, 1).paddedLeft (' ', 6),
+                        row.removeFromRight (valuesWidth), juce::Justification::centredRight);
+
+            drawHistogram (g, row.removeFromRight (histogramWidth).reduced (4, 2).toFloat(), s);
+
+            g.setColour (juce::Colours::white);
+            g.drawText (s.name.toString(), row, juce::Justification::centredLeft, true);
+        }
+
+        area.removeFromTop (4);
+        g.setColour (juce::Colour (0xFF2A2A2A));
+        g.drawHorizontalLine (area.getY(), (float) area.getX(), (float) area.getRight());
+        area.removeFromTop (4);
+
+        const auto worst = profiler.getWorstFrame();
+        g.setColour (getDurationColour (worst.busyMs));
+        g.drawText ("Worst frame " + juce::String (worst.busyMs, 2) + "ms",
+                    area.removeFromTop (lineHeight), juce::Justification::centredLeft);
+
+        std::vector<std::pair<double, juce::Identifier>> parts;
+
+        for (const auto& [name, ms] : worst.breakdown)
+            parts.emplace_back (ms, name);
+
+        std::sort (parts.begin(), parts.end(), [] (const auto& a, const auto& b) { return a.first > b.first; });
+
+        g.setColour (juce::Colours::white.withAlpha (0.8f));
+
+        for (size_t i = 0; i < parts.size() && area.getHeight() >= lineHeight; ++i)
+        {
+            auto row = area.removeFromTop (lineHeight);
+            g.drawText (juce::String (parts[i].first, 2) + "ms", row.removeFromRight (70), juce::Justification::centredRight);
+            g.drawText ("  " + parts[i].second.toString(), row, juce::Justification::centredLeft, true);
+        }
+    }
+
+    void resized() override
+    {
+        auto row = getLocalBounds().reduced (8).removeFromBottom (buttonRowHeight);
+        exportButton.setBounds (row.removeFromLeft (100));
+        resetButton.setBounds (row.removeFromRight (60));
+    }
+
+private:
+    UIProfiler& profiler;
+
+    juce::TextButton exportButton;
+    juce::TextButton resetButton;
+
+    static constexpr int maxRows = 12;
+    static constexpr int lineHeight = 15;
+    static constexpr int histogramWidth = 70;
+    static constexpr int valuesWidth = 120;
+    static constexpr int buttonRowHeight = 24;
+
+    void changeListenerCallback (juce::ChangeBroadcaster*) override
+    {
+        if (isShowing())
+            repaint();
+    }
+
+    static juce::Colour getDurationColour (double ms)
+    {
+        if (ms >= UIProfiler::frameWindowMs) return juce::Colour (0xFFFF4545);
+        if (ms >= UIProfiler::frameWindowMs * 0.5) return juce::Colour (0xFFFFB445);
+        return juce::Colour (0xFF00FF41);
+    }
+
+    static void drawHistogram (juce::Graphics& g, juce::Rectangle<float> area, const UIProfiler::Stats& stats)
+    {
+        g.setColour (juce::Colour (0xFF1E1E1E));
+        g.fillRect (area);
+
+        const auto maxCount = *std::max_element (stats.histogram.begin(), stats.histogram.end());
+
+        if (maxCount == 0)
+            return;
+
+        // Log scale, as on the audio health overlay, so the slow tail stays visible
+        const auto scale = std::log1p ((double) maxCount);
+        const auto binWidth = area.getWidth() / (float) UIProfiler::numHistogramBins;
+
+        for (int b = 0; b < UIProfiler::numHistogramBins; ++b)
+        {
+            const auto h = (float) (std::log1p ((double) stats.histogram[(size_t) b]) / scale) * area.getHeight();
+            g.setColour (getDurationColour (UIProfiler::getBinLimitMs (b) * 0.5).withAlpha (0.8f));
+            g.fillRect (area.getX() + (float) b * binWidth, area.getBottom() - h, binWidth - 1.0f, h);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UIProfilerOverlay)
+};
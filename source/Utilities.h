@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "Analysis/TempoMap.h"
+
 namespace te = tracktion;
 using namespace std::literals;
 using namespace juce;
@@ -293,6 +295,43 @@ namespace EngineHelpers
         return plugin;
     }
 
+    // The tempo map the Edit was imported with, at the track's own speed. Edits
+    // from before tempo maps have a steady one at their "bpm".
+    inline TempoMap getBaseTempoMap (te::Edit& edit)
+    {
+        auto map = TempoMap::fromString (edit.state["tempoMap"].toString());
+
+        if (map.points.empty())
+            map = TempoMap::steady ((double) edit.state.getProperty ("bpm", 120.0));
+
+        return map;
+    }
+
+    // Sets the Edit's tempo sequence to its base tempo map, scaled so the track's
+    // overall tempo (its "bpm") plays at the given bpm. A drifting track keeps its
+    // tempo changes on the same beats, just faster or slower.
+    inline void setTempo (te::Edit& edit, double bpm)
+    {
+        const auto map = getBaseTempoMap (edit);
+        const auto ratio = bpm / (double) edit.state.getProperty ("bpm", 120.0);
+        auto& sequence = edit.tempoSequence;
+
+        if (sequence.getNumTempos() != (int) map.points.size())
+        {
+            for (int i = sequence.getNumTempos(); --i > 0;)
+                sequence.removeTempo (i, false);
+
+            // Each tempo ramps linearly to the next, as TempoMap assumes
+            for (size_t i = 1; i < map.points.size(); ++i)
+                sequence.insertTempo (tracktion::BeatPosition::fromBeats (map.getBeatAt (map.points[i].time)),
+                                      map.points[i].bpm * ratio, 0.0f);
+        }
+
+        for (int i = 0; i < sequence.getNumTempos(); ++i)
+            if (auto tempo = sequence.getTempo (i))
+                tempo->setBpm (map.points[(size_t) i].bpm * ratio);
+    }
+
     inline te::AudioTrack::Ptr getChopTrack(te::Edit& edit)
     {
         for (auto track : edit.getTrackList())
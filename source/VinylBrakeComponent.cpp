@@ -32,6 +32,22 @@ VinylBrakeComponent::VinylBrakeComponent(tracktion::engine::Edit& edit)
     addAndMakeVisible(brakeSlider);
 }
 
+VinylBrakeComponent::~VinylBrakeComponent()
+{
+    frameScheduler->stopAnimating(*this);
+}
+
+void VinylBrakeComponent::bindToEdit()
+{
+    // A brake in progress belongs to the old Edit's tempo, so drop it rather than
+    // let the spring finish on the new one
+    frameScheduler->stopAnimating(*this);
+    isSpringAnimating = false;
+    hasStoredAdjustment = false;
+    currentSpringValue = 0.0;
+    brakeSlider.setValue(0.0, juce::dontSendNotification);
+}
+
 void VinylBrakeComponent::resized()
 {
     BaseEffectComponent::resized(); // This will handle the title label
@@ -46,7 +62,7 @@ void VinylBrakeComponent::sliderValueChanged(juce::Slider* slider)
     if (slider == &brakeSlider)
     {
         const double value = slider->getValue();
-        auto& transport = edit.getTransport();
+        auto& transport = edit->getTransport();
         auto context = transport.getCurrentPlaybackContext();
         
         if (context != nullptr)
@@ -69,9 +85,6 @@ void VinylBrakeComponent::sliderValueChanged(juce::Slider* slider)
 
 void VinylBrakeComponent::setSpeed(double value)
 {
-    // Get the tempo sequence from the edit
-    auto& tempoSequence = edit.tempoSequence;
-    
     // Calculate the speed ratio based on the brake value
     // value is the adjustment from original tempo (negative for brake effect)
     double speedRatio = 1.0 / (1.0 + value);
@@ -86,12 +99,10 @@ void VinylBrakeComponent::setSpeed(double value)
     // The tempoAdjustment is already (ratio - 1.0), so we add 1.0 to get the full ratio
     double currentBpm = baseBpm / speedRatio;
     
-    // Insert a new tempo at the current position
-    auto tempo = tempoSequence.insertTempo(tracktion::TimePosition::fromSeconds(0.0));
     DBG("Setting tempo adjustment to: " + juce::String(currentBpm));
-    
-    // Set the new tempo
-    tempo->setBpm(currentBpm);
+
+    // Scales the whole tempo map, so a drifting track brakes from wherever it is
+    EngineHelpers::setTempo(*edit, currentBpm);
 }
 
 void VinylBrakeComponent::startSpringAnimation()
@@ -108,18 +119,18 @@ void VinylBrakeComponent::startSpringAnimation()
         isSpringAnimating = true;
         springStartValue = brakeSlider.getValue();
         springStartTime = juce::Time::getMillisecondCounterHiRes();
-        startTimerHz(60);
+        frameScheduler->startAnimating(*this);
     }
 }
 
-void VinylBrakeComponent::timerCallback()
+void VinylBrakeComponent::frameCallback(double timeMs)
 {
     if (isSpringAnimating)
     {
         // Track elapsed time
-        const double elapsedMs = (juce::Time::getMillisecondCounterHiRes() - springStartTime);
+        const double elapsedMs = (timeMs - springStartTime);
         const double duration = 500.0; // Match the 500ms duration from React
-        const double progress = juce::jmin(elapsedMs / duration, 1.0);
+        const double progress = juce::jlimit(0.0, 1.0, elapsedMs / duration);
         
         // Cubic easing function to match React implementation
         const double easeOut = 1.0 - pow(1.0 - progress, 3.0);
@@ -137,7 +148,7 @@ void VinylBrakeComponent::timerCallback()
             isSpringAnimating = false;
             currentSpringValue = 0.0;
             brakeSlider.setValue(0.0, juce::dontSendNotification);
-            stopTimer();
+            frameScheduler->stopAnimating(*this);
             setSpeed(originalTempoAdjustment);
             hasStoredAdjustment = false;
         }
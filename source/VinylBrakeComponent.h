@@ -1,17 +1,19 @@
 #pragma once
 
 #include "BaseEffectComponent.h"
+#include "FrameScheduler.h"
 #include "Utilities.h"
 
 class VinylBrakeComponent : public BaseEffectComponent,
                            public juce::Slider::Listener,
-                           public juce::Timer
+                           public FrameScheduler::Client
 {
 public:
     explicit VinylBrakeComponent(tracktion::engine::Edit&);
+    ~VinylBrakeComponent() override;
     void resized() override;
     void sliderValueChanged(juce::Slider* slider) override;
-    void timerCallback() override;
+    void frameCallback(double timeMs) override;
     
     // Add callback for getting parent's tempo adjustment
     std::function<double()> getCurrentTempoAdjustment;
@@ -33,6 +35,9 @@ public:
 
     std::function<double()> getEffectiveTempo;
 
+protected:
+    void bindToEdit() override;
+
 private:
     class SpringSlider : public juce::Slider
     {
@@ -49,6 +54,7 @@ private:
     };
     
     SpringSlider brakeSlider;
+    juce::SharedResourcePointer<FrameScheduler> frameScheduler;
 
     void setSpeed(double value);
     
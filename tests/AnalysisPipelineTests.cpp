@@ -0,0 +1,44 @@
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "Analysis/OnsetEnvelopeAnalyzer.h"
+#include "Analysis/PeakPyramidAnalyzer.h"
+#include "Analysis/SilenceAnalyzer.h"
+#include "Analysis/TempoAnalyzer.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("One decode feeds every import analyzer", "[analysis]")
+{
+    // One minute of stereo click track, with two seconds of silence in front
+    constexpr double seconds = 60.0, leadIn = 2.0;
+    const auto clicks = createClickTrack (referenceSampleRate, seconds - leadIn, referenceBpm);
+    juce::AudioBuffer<float> signal (2, (int) (referenceSampleRate * seconds));
+    signal.clear();
+
+    for (int ch = 0; ch < 2; ++ch)
+        signal.copyFrom (ch, (int) (referenceSampleRate * leadIn), clicks, ch, 0, clicks.getNumSamples());
+
+    TemporaryDirectory tempDir;
+    auto reader = createReaderFor (writeWavFile (signal, referenceSampleRate, tempDir.getChildFile ("analysis.wav")));
+
+    TempoAnalyzer tempo;
+    PeakPyramidAnalyzer peaks;
+    OnsetEnvelopeAnalyzer onsets;
+    SilenceAnalyzer silence;
+
+    AnalysisPipeline pipeline (0);
+
+    for (auto* analyzer : std::initializer_list<AudioAnalyzer*> { &tempo, &peaks, &onsets, &silence })
+        pipeline.addAnalyzer (*analyzer);
+
+    REQUIRE (pipeline.run (*reader));
+
+    CHECK (tempo.getBpm() == Catch::Approx (referenceBpm).margin (2.0));
+    CHECK (silence.getLeadingSilence() == Catch::Approx (leadIn).margin (0.01));
+    CHECK (peaks.getNumPeaks (peaks.getNumLevels() - 1) == 1);
+    CHECK (peaks.getPeak (peaks.getNumLevels() - 1, 0, 0).getEnd() > 0.5f);
+    CHECK ((double) onsets.getEnvelope().size() == Catch::Approx (seconds * onsets.getFrameRate()).margin (2.0));
+}
@@ -0,0 +1,47 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "CustomLookAndFeel.h"
+#include "ReverbComponent.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("Moving a knob renders no new assets", "[ui]")
+{
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+
+    auto lookAndFeel = std::make_unique<CustomLookAndFeel>();
+    auto panel = std::make_unique<ReverbComponent> (*edit);
+    panel->setBounds (0, 0, 300, 160);
+
+    juce::Image frame (juce::Image::ARGB, panel->getWidth(), panel->getHeight(), true);
+
+    auto paintPanel = [&]
+    {
+        juce::Graphics g (frame);
+        panel->paintEntireComponent (g, false);
+    };
+
+    paintPanel();
+    const auto numAssets = lookAndFeel->getAssetCache().getNumAssets();
+    CHECK (numAssets > 0);
+
+    const auto sliders = findSliders (*panel);
+    REQUIRE (! sliders.empty());
+
+    for (int step = 0; step < 100; ++step)
+    {
+        for (auto* slider : sliders)
+            slider->setValue (slider->proportionOfLengthToValue (step / 100.0), juce::dontSendNotification);
+
+        paintPanel();
+    }
+
+    CHECK (lookAndFeel->getAssetCache().getNumAssets() == numAssets);
+
+    panel = nullptr;
+    juce::LookAndFeel::setDefaultLookAndFeel (nullptr);
+    lookAndFeel = nullptr;
+}
@@ -0,0 +1,42 @@
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "BeatGrid.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("Beat grid lines follow the tempo sequence", "[ui]")
+{
+    // Ten minutes drifting 117 -> 123 BPM a beat at a time, with 16 bars in view
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    auto& tempoSequence = edit->tempoSequence;
+
+    for (int beat = 4; beat < 1200; beat += 4)
+        tempoSequence.insertTempo (tracktion::BeatPosition::fromBeats ((double) beat), 117.0 + 6.0 * beat / 1200.0, 0.0f);
+
+    BeatGrid grid (*edit);
+    const juce::Range<double> view (120.0, 152.0);
+    constexpr float width = 1200.0f;
+
+    // The cached lines land where the tempo sequence puts them
+    const auto& lines = grid.getLines (view, 0.0f, width);
+    REQUIRE (! lines.empty());
+
+    for (auto& line : lines)
+    {
+        const auto beat = tempoSequence.toBeats (tracktion::TimePosition::fromSeconds (line.time)).inBeats();
+        CHECK (beat == Catch::Approx (std::round (beat)).margin (1.0e-6));
+        CHECK (line.isBar == (juce::roundToInt (beat) % 4 == 0));
+    }
+
+    // A tempo change is picked up on the next request
+    const auto revision = grid.getRevision();
+    tempoSequence.getTempo (0)->setBpm (100.0);
+    CHECK (grid.getRevision() != revision);
+    CHECK (grid.getLines (view, 0.0f, width).front().time
+           == Catch::Approx (tempoSequence.toTime (tracktion::BeatPosition::fromBeats (
+                  std::ceil (tempoSequence.toBeats (tracktion::TimePosition::fromSeconds (view.getStart())).inBeats()))).inSeconds()));
+}
@@ -2,6 +2,8 @@
 
 #include "juce_gui_basics/juce_gui_basics.h"
 #include <catch2/catch_session.hpp>
+#include <catch2/internal/catch_clara.hpp>
+#include "TestOptions.h"
 
 int main (int argc, char* argv[])
 {
@@ -11,7 +13,18 @@ int main (int argc, char* argv[])
     // It's nicer DX when placed here vs. manually in Catch2 SECTIONs
     juce::ScopedJuceInitialiser_GUI gui;
 
-    const int result = Catch::Session().run (argc, argv);
+    Catch::Session session;
+
+    session.cli (session.cli()
+                 | Catch::Clara::Opt (TestOptions::regenerateGoldens) ["--regenerate-goldens"]
+                       ("re-record the render regression goldens in tests/goldens")
+                 | Catch::Clara::Opt (TestOptions::requireBitExact) ["--bit-exact"]
+                       ("fail render regressions on any hash change, not just spectral drift"));
+
+    if (const auto parseResult = session.applyCommandLine (argc, argv); parseResult != 0)
+        return parseResult;
+
+    const int result = session.run();
 
     return result;
 }
@@ -0,0 +1,34 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "ChopTrackLane.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("Dragging a chop keeps every chop on the lane", "[ui]")
+{
+    ReferenceEdit reference;
+    ZoomState zoomState;
+    ChopTrackLane lane (*reference.edit, zoomState);
+    lane.setBounds (0, 0, 1200, 30);
+    lane.setSnapToGrid (false);
+
+    // One every three seconds, so the one at 30 s is in the middle of the lane
+    constexpr int numChops = 20;
+
+    for (int i = 0; i < numChops; ++i)
+        lane.addClip (i * 3.0, i * 3.0 + 0.02);
+
+    auto chopTrack = EngineHelpers::getChopTrack (*reference.edit);
+    REQUIRE (chopTrack->getClips().size() == numChops);
+
+    constexpr float grabX = 600.2f;
+    lane.mouseDown (createMouseEvent (lane, { grabX, 15.0f }, false));
+
+    for (float x = grabX; x < grabX + 100.0f; x += 1.0f)
+        lane.mouseDrag (createMouseEvent (lane, { x, 15.0f }, true));
+
+    lane.mouseUp (createMouseEvent (lane, { grabX + 100.0f, 15.0f }, true));
+    CHECK (chopTrack->getClips().size() == numChops);
+}
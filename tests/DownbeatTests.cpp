@@ -0,0 +1,47 @@
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("Imported clips start on the first downbeat", "[analysis]")
+{
+    constexpr double seconds = 40.0, tail = 3.0, beat = 60.0 / referenceBpm;
+    TemporaryDirectory tempDir;
+
+    for (auto [leadIn, pickupBeats] : { std::pair { 1.3, 2 }, { 0.0, 0 }, { 0.77, 1 }, { 2.0, 3 } })
+    {
+        const auto analysis = analyseFile (writeWavFile (createDownbeatTrack (seconds, leadIn, pickupBeats, tail), referenceSampleRate,
+                                                         tempDir.getChildFile ("downbeat" + juce::String (pickupBeats) + ".wav")));
+
+        INFO ("lead-in " << leadIn << " s, " << pickupBeats << " pickup beats");
+        CHECK (analysis.firstDownbeat == Catch::Approx (leadIn + pickupBeats * beat).margin (0.02));
+        CHECK (analysis.leadingSilence == Catch::Approx (leadIn).margin (0.02));
+    }
+
+    // The Edit starts both decks there (the second a beat later, as ever), and
+    // neither plays into the silent tail
+    ChopShopEngine chopShopEngine;
+    const auto file = tempDir.getChildFile ("downbeat2.wav");
+    const auto analysis = analyseFile (file);
+
+    LibraryComponent::ClipSettings settings;
+    settings.start = analysis.firstDownbeat;
+    settings.end = analysis.duration - analysis.trailingSilence;
+
+    auto edit = LibraryComponent::createEditForAudioFile (chopShopEngine.engine, file, (float) referenceBpm, settings);
+    REQUIRE (edit != nullptr);
+
+    for (int trackIndex = 0; trackIndex < 2; ++trackIndex)
+    {
+        auto track = EngineHelpers::getAudioTrack (*edit, trackIndex);
+        REQUIRE (track != nullptr);
+        REQUIRE (! track->getClips().isEmpty());
+
+        const auto position = track->getClips().getFirst()->getPosition();
+        CHECK (position.getOffset().inSeconds() == Catch::Approx (settings.start + trackIndex * beat).margin (0.001));
+        CHECK (position.getLength().inSeconds() == Catch::Approx (settings.end - settings.start).margin (0.01));
+    }
+}
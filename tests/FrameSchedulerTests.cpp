@@ -0,0 +1,88 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "RampedValue.h"
+#include "UIProfiler.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("The frame scheduler only wakes while something animates", "[ui][idle]")
+{
+    // Every message-thread callback the animating components make is timed by
+    // the UI profiler, so its stats count them
+    auto& profiler = UIProfiler::instance();
+    profiler.setEnabled (true);
+
+    auto countCallbacks = [&profiler]
+    {
+        juce::int64 count = 0;
+
+        for (auto& stats : profiler.getStats())
+            count += stats.count;
+
+        return count;
+    };
+
+    ReferenceEdit reference;
+    AnimatedComponents components (*reference.edit);
+    auto& transport = reference.edit->getTransport();
+    juce::SharedResourcePointer<FrameScheduler> scheduler;
+
+    // Idle: transport stopped, nothing animating
+    {
+        const auto before = scheduler->getStats();
+        profiler.reset();
+        runDispatchLoopFor (1000);
+
+        CHECK (scheduler->getStats().frames == before.frames);
+        CHECK (countCallbacks() == 0);
+        CHECK (! scheduler->isRunning());
+    }
+
+    // Playing: every animating component is served by one wakeup per frame
+    {
+        transport.play (false);
+        runDispatchLoopFor (100);
+
+        const auto before = scheduler->getStats();
+        runDispatchLoopFor (1000);
+        const auto frames = scheduler->getStats().frames - before.frames;
+
+        CHECK (frames > 0);
+        CHECK (frames <= FrameScheduler::fallbackFrameRate + 5);
+
+        transport.stop (false, false);
+        runDispatchLoopFor (100);
+    }
+
+    profiler.setEnabled (false);
+    profiler.reset();
+}
+
+TEST_CASE ("Invalidations within a frame are merged into one repaint", "[ui]")
+{
+    juce::SharedResourcePointer<FrameScheduler> scheduler;
+    juce::Component component;
+    component.setSize (100, 100);
+    const auto before = scheduler->getStats();
+
+    for (int i = 0; i < 10; ++i)
+        scheduler->invalidate (component, { i * 10, 0, 10, 10 });
+
+    runDispatchLoopFor (100);
+    CHECK (scheduler->getStats().repaints - before.repaints == 1);
+}
+
+TEST_CASE ("A one-off ramp wakes the scheduler only for its length", "[ui]")
+{
+    juce::SharedResourcePointer<FrameScheduler> scheduler;
+    RampedValue ramp (0.0, 100);
+    double rampValue = 0.0;
+    ramp.onValueChange = [&] (double v) { rampValue = v; };
+
+    ramp.startRamp (1.0);
+    runDispatchLoopFor (300);
+    CHECK (rampValue == 1.0);
+    CHECK (! scheduler->isRunning());
+}
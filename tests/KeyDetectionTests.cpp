@@ -0,0 +1,45 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("Key detection on the 24 labelled fixtures", "[analysis]")
+{
+    TemporaryDirectory tempDir;
+
+    // Scored as MIREX does: related keys earn partial credit
+    int exact = 0, fifth = 0, relative = 0, parallel = 0, other = 0;
+    juce::StringArray misses;
+
+    for (int k = 0; k < 24; ++k)
+    {
+        const MusicalKey expected { k % 12, k >= 12 };
+        const auto file = writeWavFile (createKeyFixture (expected, 20.0), referenceSampleRate,
+                                        tempDir.getChildFile ("key-" + juce::String (k) + ".wav"));
+        const auto found = detectKey (file);
+
+        if (found == expected)
+            ++exact;
+        else if (found.minor == expected.minor && (found.tonic == (expected.tonic + 7) % 12 || found.tonic == (expected.tonic + 5) % 12))
+            ++fifth;
+        else if (found.minor != expected.minor && found.getCamelotNumber() == expected.getCamelotNumber())
+            ++relative;
+        else if (found.minor != expected.minor && found.tonic == expected.tonic)
+            ++parallel;
+        else
+            ++other;
+
+        if (! (found == expected))
+            misses.add (expected.getName() + " -> " + (found.isValid() ? found.getName() : juce::String ("none")));
+    }
+
+    const auto score = (exact + 0.5 * fifth + 0.3 * relative + 0.2 * parallel) / 24.0;
+
+    INFO ("Key accuracy on 24 synthetic fixtures: " << exact << " exact, " << fifth << " fifth, "
+          << relative << " relative, " << parallel << " parallel, " << other << " other; weighted score "
+          << score << (misses.isEmpty() ? juce::String() : " (" + misses.joinIntoString (", ") + ")"));
+
+    CHECK (score >= 0.9);
+}
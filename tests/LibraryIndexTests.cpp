@@ -0,0 +1,147 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "LibraryIndex.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+namespace
+{
+    LibraryIndex::Entry makeEntry (int itemID, const juce::String& name, const juce::String& key, float bpm)
+    {
+        LibraryIndex::Entry entry;
+        entry.id = tracktion::engine::ProjectItemID (itemID, 1);
+        entry.name = name;
+        entry.key = key;
+        entry.bpm = bpm;
+        return entry;
+    }
+
+    std::vector<LibraryIndex::Entry> createEntries()
+    {
+        return {
+            makeEntry (1, "Amber Groove", "C", 122.0f),
+            makeEntry (2, "Night Drive", "Am", 124.0f),
+            makeEntry (3, "Dub Signal", "A", 118.0f),
+            makeEntry (4, "Bbq Break", "Bbm", 126.0f),
+            makeEntry (5, "Lost Tape", "Bb", 90.0f),
+            makeEntry (6, "Acid Rain", "F#m", 130.0f),
+        };
+    }
+
+    std::vector<tracktion::engine::ProjectItemID> getVisibleIDs (const LibraryIndex& index)
+    {
+        std::vector<tracktion::engine::ProjectItemID> ids;
+
+        for (int row = 0; row < index.getNumRows(); ++row)
+            ids.push_back (index.getID (index.getEntryForRow (row)));
+
+        return ids;
+    }
+}
+
+//==============================================================================
+TEST_CASE ("Typing a filter matches filtering from scratch", "[library]")
+{
+    const auto entries = createEntries();
+
+    // Each is typed a character at a time, so every prefix is tried as a narrowing
+    for (juce::String text : { "am", "a am", "bbm", "dub 120-128", "f#m", "acid 125-135" })
+    {
+        DYNAMIC_SECTION ("\"" << text << "\"")
+        {
+            LibraryIndex typed;
+            typed.build (entries);
+
+            for (int i = 1; i <= text.length(); ++i)
+            {
+                typed.setFilter (text.substring (0, i));
+
+                // A new index has no previous filter to narrow
+                LibraryIndex reference;
+                reference.build (entries);
+                reference.setFilter (text.substring (0, i));
+
+                CHECK (getVisibleIDs (typed) == getVisibleIDs (reference));
+            }
+        }
+    }
+}
+
+TEST_CASE ("A word matches a key exactly or a name in part", "[library]")
+{
+    LibraryIndex index;
+    index.build (createEntries());
+
+    // "Amber Groove" by its name, "Night Drive" by its key
+    index.setFilter ("am");
+    CHECK (index.getNumRows() == 2);
+
+    // Everything but "Night Drive", whose key is Am rather than A
+    index.setFilter ("a");
+    CHECK (index.getNumRows() == 5);
+    CHECK (index.getRowForID (tracktion::engine::ProjectItemID (2, 1)) < 0);
+}
+
+TEST_CASE ("Filtering and sorting 100k rows", "[library]")
+{
+    constexpr int numEntries = 100000;
+
+    LibraryIndex index;
+    index.build (createLibraryEntries (numEntries));
+    REQUIRE (index.size() == numEntries);
+
+    SECTION ("Type-ahead keeps the rows matching every word")
+    {
+        // One keystroke at a time, as the search box delivers them
+        const juce::String typed = "dub step 12";
+
+        for (int i = 1; i <= typed.length(); ++i)
+            index.setFilter (typed.substring (0, i));
+
+        CHECK (index.getNumRows() > 0);
+        CHECK (index.getNumRows() < numEntries);
+
+        for (int row = 0; row < index.getNumRows(); ++row)
+        {
+            const auto name = index.getName (index.getEntryForRow (row)).toLowerCase();
+            CHECK ((name.contains ("dub") && name.contains ("step") && name.contains ("12")));
+        }
+
+        index.setFilter ({});
+        CHECK (index.getNumRows() == numEntries);
+    }
+
+    SECTION ("A BPM range keeps the rows inside it")
+    {
+        index.setFilter ("dub 120-128");
+        REQUIRE (index.getNumRows() > 0);
+
+        for (int row = 0; row < index.getNumRows(); ++row)
+        {
+            const auto entry = index.getEntryForRow (row);
+            CHECK (index.getName (entry).containsIgnoreCase ("dub"));
+            CHECK ((index.getBpm (entry) >= 120.0f && index.getBpm (entry) <= 128.0f));
+        }
+
+        CHECK (index.getEntriesInBpmRange (120.0f, 128.0f).size() >= (size_t) index.getNumRows());
+    }
+
+    SECTION ("Re-sorting orders every row")
+    {
+        // Twice each way, so the second pass of each comes from the cached order
+        for (auto forwards : { true, false, true, false })
+        {
+            index.setSortOrder (LibraryIndex::Column::bpm, forwards);
+
+            for (int row = 1; row < index.getNumRows(); ++row)
+            {
+                const auto previous = index.getBpm (index.getEntryForRow (row - 1));
+                const auto bpm = index.getBpm (index.getEntryForRow (row));
+
+                if (forwards ? previous > bpm : previous < bpm)
+                    FAIL ("Row " << row << " out of order");
+            }
+        }
+    }
+}
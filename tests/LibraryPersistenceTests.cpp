@@ -0,0 +1,48 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "LibraryPersistence.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("Library changes collapse into one save and one write", "[library]")
+{
+    // A 1,000-file import: every file marks the library changed, and the saves
+    // collapse into one when the window closes (flush() stands in for the timer)
+    TemporaryDirectory tempDir;
+    const auto target = tempDir.getChildFile ("Library.snapshot");
+
+    juce::MemoryBlock payload (1024 * 1024);
+    payload.fillWith (0x5a);
+
+    LibraryPersistence persistence;
+    persistence.onSave = [&] { persistence.writeFile (target, payload); };
+
+    for (int i = 0; i < 1000; ++i)
+        persistence.markChanged();
+
+    CHECK (persistence.getNumSaves() == 0);
+    persistence.flush();
+
+    CHECK (persistence.getNumSaves() == 1);
+    CHECK (persistence.getNumFileWrites() == 1);
+    CHECK (target.getSize() == (juce::int64) payload.getSize());
+    CHECK (tempDir.directory.getNumberOfChildFiles (juce::File::findFiles) == 1); // no temporary files left behind
+}
+
+TEST_CASE ("Waiting for a queued write leaves the file written", "[library]")
+{
+    TemporaryDirectory tempDir;
+    const auto target = tempDir.getChildFile ("Track.tracktionedit");
+
+    juce::MemoryBlock payload (4 * 1024 * 1024);
+    payload.fillWith (0x5a);
+
+    LibraryPersistence persistence;
+    persistence.writeFile (target, payload);
+    persistence.waitForWrite (target);
+
+    CHECK (target.getSize() == (juce::int64) payload.getSize());
+    CHECK (persistence.getNumFileWrites() == 1);
+}
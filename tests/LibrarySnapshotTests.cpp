@@ -0,0 +1,31 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "LibraryPersistence.h"
+#include "LibrarySnapshot.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("A library snapshot reads back until the project is saved", "[library]")
+{
+    const auto entries = createLibraryEntries (1000);
+
+    LibraryIndex index;
+    index.build (entries);
+
+    // The snapshot stands in for the Project until it has been opened
+    TemporaryDirectory tempDir;
+    const auto projectFile = tempDir.getChildFile ("Library.tracktion");
+    projectFile.replaceWithText ("stand-in for the project file");
+    const auto snapshotFile = LibrarySnapshot::getFileFor (projectFile);
+    REQUIRE (LibraryPersistence::writeAtomically (snapshotFile, LibrarySnapshot::serialise (index, projectFile)));
+
+    auto snapshotEntries = LibrarySnapshot::read (snapshotFile, projectFile);
+    REQUIRE (snapshotEntries.has_value());
+    CHECK (*snapshotEntries == entries);
+
+    // Saving the project invalidates the snapshot
+    projectFile.setLastModificationTime (projectFile.getLastModificationTime() + juce::RelativeTime::seconds (10));
+    CHECK (! LibrarySnapshot::read (snapshotFile, projectFile).has_value());
+}
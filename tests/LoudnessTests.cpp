@@ -0,0 +1,75 @@
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+namespace
+{
+    juce::AudioBuffer<float> createSine (double sampleRate, double seconds, double frequency, double decibels, double phase = 0.0)
+    {
+        constexpr auto twoPi = juce::MathConstants<double>::twoPi;
+        juce::AudioBuffer<float> buffer (2, (int) (sampleRate * seconds));
+        const auto gain = juce::Decibels::decibelsToGain (decibels);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            for (int ch = 0; ch < 2; ++ch)
+                buffer.setSample (ch, i, (float) (gain * std::sin (twoPi * frequency * i / sampleRate + phase)));
+
+        return buffer;
+    }
+}
+
+//==============================================================================
+TEST_CASE ("A -23 dBFS sine reads -23 LUFS at any rate", "[analysis]")
+{
+    // EBU Tech 3341 case 1: a 1 kHz stereo sine
+    LoudnessAnalyzer loudness;
+
+    for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+    {
+        analyseLoudness (loudness, createSine (sampleRate, 20.0, 1000.0, -23.0), sampleRate);
+
+        INFO (sampleRate << " Hz");
+        CHECK (loudness.getIntegratedLoudness() == Catch::Approx (-23.0).margin (0.1));
+    }
+}
+
+TEST_CASE ("Near-silence is gated out of the integrated loudness", "[analysis]")
+{
+    // Ten seconds of near-silence either side don't drag the reading down
+    auto gated = createSine (referenceSampleRate, 40.0, 1000.0, -80.0);
+    const auto tone = createSine (referenceSampleRate, 20.0, 1000.0, -23.0);
+
+    for (int ch = 0; ch < 2; ++ch)
+        gated.copyFrom (ch, (int) (referenceSampleRate * 10.0), tone, ch, 0, tone.getNumSamples());
+
+    // (the blocks straddling each edge still count, which costs a few hundredths of a dB)
+    LoudnessAnalyzer loudness;
+    analyseLoudness (loudness, gated, referenceSampleRate);
+    CHECK (loudness.getIntegratedLoudness() == Catch::Approx (-23.0).margin (0.15));
+}
+
+TEST_CASE ("True peak finds the peaks between samples", "[analysis]")
+{
+    // A full-scale sine at a quarter of the rate, sampled 45 degrees off its
+    // peaks, so every sample reads -3 dB
+    constexpr auto twoPi = juce::MathConstants<double>::twoPi;
+
+    LoudnessAnalyzer loudness;
+    analyseLoudness (loudness, createSine (referenceSampleRate, 1.0, referenceSampleRate / 4.0, 0.0, twoPi / 8.0), referenceSampleRate);
+
+    CHECK (loudness.getSamplePeak() == Catch::Approx (-3.01).margin (0.05));
+    CHECK (loudness.getTruePeak() == Catch::Approx (0.0).margin (0.3));
+}
+
+TEST_CASE ("Silence never gets past the absolute gate", "[analysis]")
+{
+    juce::AudioBuffer<float> silence (2, (int) referenceSampleRate);
+    silence.clear();
+
+    LoudnessAnalyzer loudness;
+    analyseLoudness (loudness, silence, referenceSampleRate);
+    CHECK (std::isinf (loudness.getIntegratedLoudness()));
+}
@@ -0,0 +1,26 @@
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "TestFixtures.h"
+#include "minibpm.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("MiniBPM finds the tempo at every common rate", "[analysis]")
+{
+    for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+    {
+        const auto signal = createClickTrack (sampleRate, 30.0, referenceBpm, 1);
+        constexpr int blockSize = 1024;
+
+        breakfastquay::MiniBPM detector ((float) sampleRate);
+        detector.setBPMRange (60, 180);
+
+        for (int pos = 0; pos < signal.getNumSamples(); pos += blockSize)
+            detector.process (signal.getReadPointer (0, pos), std::min (blockSize, signal.getNumSamples() - pos));
+
+        INFO (sampleRate << " Hz");
+        CHECK (detector.estimateTempo() == Catch::Approx (referenceBpm).margin (2.0));
+    }
+}
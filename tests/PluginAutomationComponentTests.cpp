@@ -0,0 +1,23 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("Only automation rows on screen get a lane", "[ui]")
+{
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    RackAutomationPanels rack (*edit);
+
+    // 300 px of 60 px lanes, plus part-shown ones
+    CHECK (rack.countLiveLanes() <= 7);
+    CHECK (rack.countLiveLanes() < rack.numParameters);
+
+    for (int scrollY = 0; scrollY <= rack.height - rack.viewport.getHeight(); scrollY += 10)
+    {
+        rack.viewport.setViewPosition (0, scrollY);
+        CHECK (rack.countLiveLanes() <= 7);
+    }
+}
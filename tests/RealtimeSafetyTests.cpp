@@ -0,0 +1,95 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <set>
+
+#include "RealtimeSanitizer.h"
+#include "TestFixtures.h"
+
+// Renders an Edit through every ChopShop plugin with the real-time sanitizer
+// trapping allocations and locks in their applyToBuffer. The RealtimeTests
+// target builds with the sanitizer on in every configuration; in the Tests
+// target it's only on in Debug, and the test is skipped otherwise.
+
+namespace te = tracktion::engine;
+using namespace TestFixtures;
+
+namespace
+{
+    const std::set<juce::String>& getChopShopPluginTypes()
+    {
+        static const std::set<juce::String> types {
+            AutoReverbPlugin::xmlTypeName, AutoDelayPlugin::xmlTypeName, FlangerPlugin::xmlTypeName,
+            AutoPhaserPlugin::xmlTypeName, ScratchPlugin::xmlTypeName, ChopPlugin::xmlTypeName,
+            te::OscilloscopePlugin::xmlTypeName
+        };
+
+        return types;
+    }
+
+    // Chops as ChopComponent makes them, so ChopPlugin has clips to switch between
+    void addChops (te::Edit& edit)
+    {
+        auto chopTrack = EngineHelpers::getChopTrack (edit);
+        REQUIRE (chopTrack != nullptr);
+
+        for (double startBeat = 2.0; startBeat < 14.0; startBeat += 3.0)
+        {
+            const auto start = edit.tempoSequence.toTime (tracktion::BeatPosition::fromBeats (startBeat));
+            const auto end = edit.tempoSequence.toTime (tracktion::BeatPosition::fromBeats (startBeat + 1.0));
+            REQUIRE (chopTrack->insertNewClip (te::TrackItem::Type::arranger, tracktion::TimeRange (start, end), nullptr) != nullptr);
+        }
+    }
+
+    // Every parameter ramps across its whole range, so no effect renders suspended
+    // and every parameter change is made from the audio thread
+    void sweepParameters (te::Plugin& plugin, tracktion::TimePosition end)
+    {
+        for (auto* param : plugin.getAutomatableParameters())
+        {
+            const auto range = param->getValueRange();
+            auto& curve = param->getCurve();
+            curve.addPoint (tracktion::TimePosition(), range.getStart(), 0.0f, nullptr);
+            curve.addPoint (end, range.getEnd(), 0.0f, nullptr);
+        }
+    }
+}
+
+//==============================================================================
+TEST_CASE ("ChopShop plugins render without real-time violations", "[realtime]")
+{
+    if (! RealtimeSanitizer::isEnabled())
+        SKIP ("Built without CHOPSHOP_RT_SANITIZER; run the RealtimeTests target");
+
+    // Built as a library import builds it, with the oscilloscope MainComponent puts on the master track
+    ReferenceEdit reference (8.0);
+    auto& edit = reference.edit;
+
+    auto masterTrack = edit->getMasterTrack();
+    REQUIRE (masterTrack != nullptr);
+    REQUIRE (masterTrack->pluginList.insertPlugin (te::OscilloscopePlugin::create(), -1) != nullptr);
+
+    addChops (*edit);
+
+    std::set<juce::String> typesFound;
+
+    for (auto plugin : te::getAllPlugins (*edit, false))
+    {
+        if (getChopShopPluginTypes().count (plugin->getPluginType()) == 0)
+            continue;
+
+        typesFound.insert (plugin->getPluginType());
+        sweepParameters (*plugin, tracktion::TimePosition::fromSeconds (edit->getLength().inSeconds()));
+    }
+
+    REQUIRE (typesFound == getChopShopPluginTypes());
+
+    RealtimeSanitizer::setMode (RealtimeSanitizer::Mode::log);
+    RealtimeSanitizer::resetViolationCount();
+
+    const auto renderFile = reference.tempDir.getChildFile ("render.wav");
+    REQUIRE (te::Renderer::renderToFile (*edit, renderFile, false));
+    CHECK (renderFile.existsAsFile());
+
+    // The reports with stack traces are on stderr
+    REQUIRE (RealtimeSanitizer::getViolationCount() == 0);
+}
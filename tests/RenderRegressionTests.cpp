@@ -0,0 +1,456 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <optional>
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_cryptography/juce_cryptography.h>
+#include <juce_dsp/juce_dsp.h>
+#include <tracktion_engine/tracktion_engine.h>
+
+#include "LibraryComponent.h"
+#include "TestFixtures.h"
+#include "TestOptions.h"
+
+// Offline-render regression tests. Each scenario builds an Edit the same way a
+// library import does (LibraryComponent::createEditForAudioFile), scripts some
+// performance onto it, renders it and compares the result with a golden in
+// tests/goldens:
+//
+//   - a SHA-256 of the rendered samples. If it matches, the output is
+//     bit-identical and nothing else is checked.
+//   - per-frame band energies. They must stay within tolerance when the hash
+//     moves (a different compiler, or an optimisation that reorders float maths).
+//
+// A scenario without a golden is skipped, not passed, so a checkout that hasn't
+// recorded them yet reports that nothing was compared. Pass --regenerate-goldens
+// to record them (and to re-record all of them after an intentional change to
+// the sound), and --bit-exact to fail on any hash change.
+
+namespace te = tracktion::engine;
+using namespace TestFixtures;
+
+namespace
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr int blockSize = 512;
+    constexpr double sourceBpm = 120.0;
+    constexpr double sourceSeconds = 8.0;
+
+    // Spectral fingerprint: Hann-windowed 2048-point frames, log-spaced bands
+    constexpr int fftOrder = 11;
+    constexpr int fftSize = 1 << fftOrder;
+    constexpr int hopSize = fftSize;
+    constexpr int numBands = 24;
+    constexpr float minBandHz = 50.0f;
+    constexpr float maxBandHz = 16000.0f;
+    constexpr float silenceFloorDb = -80.0f;
+
+    // Allowed drift before a render counts as sounding different
+    constexpr float maxBandDifferenceDb = 3.0f;
+    constexpr float maxRmsDifferenceDb = 0.5f;
+
+    juce::File getGoldensDirectory()
+    {
+       #ifdef CHOPSHOP_GOLDENS_DIR
+        return juce::File (CHOPSHOP_GOLDENS_DIR);
+       #else
+        return juce::File::getCurrentWorkingDirectory().getChildFile ("tests/goldens");
+       #endif
+    }
+
+    //==============================================================================
+    // Drums and bass with no external files: a kick on every beat, a hat on the
+    // off-beats and a bass note that changes each bar, so chops and tempo changes
+    // move energy around in both time and frequency
+    juce::AudioBuffer<float> createSourceSignal()
+    {
+        const auto numSamples = (int) (sampleRate * sourceSeconds);
+        const auto samplesPerBeat = sampleRate * 60.0 / sourceBpm;
+        constexpr auto twoPi = juce::MathConstants<double>::twoPi;
+        constexpr double bassNotes[] = { 55.0, 65.41, 73.42, 49.0 };
+
+        juce::AudioBuffer<float> buffer (2, numSamples);
+        juce::uint32 noiseState = 22222; // fixed seed, so the hat is identical every run
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto beat = (double) i / samplesPerBeat;
+            const auto beatPhase = beat - std::floor (beat);
+            const auto t = i / sampleRate;
+
+            const auto kickT = beatPhase * samplesPerBeat / sampleRate;
+            const auto kick = 0.7 * std::exp (-kickT * 18.0) * std::sin (twoPi * (50.0 + 90.0 * std::exp (-kickT * 40.0)) * kickT);
+
+            noiseState = noiseState * 1664525u + 1013904223u;
+            const auto noise = (double) (noiseState >> 8) / (double) (1u << 24) * 2.0 - 1.0;
+            const auto hatPhase = std::fmod (beatPhase + 0.5, 1.0) * samplesPerBeat / sampleRate;
+            const auto hat = 0.15 * std::exp (-hatPhase * 60.0) * noise;
+
+            const auto bar = (int) (beat / 4.0) % 4;
+            const auto bass = 0.2 * std::sin (twoPi * bassNotes[bar] * t);
+
+            buffer.setSample (0, i, (float) (kick + bass + hat));
+            buffer.setSample (1, i, (float) (kick + bass - hat));
+        }
+
+        return buffer;
+    }
+
+    //==============================================================================
+    template <typename PluginType>
+    PluginType* findPlugin (te::Edit& edit)
+    {
+        // Includes the plugins wrapped in the master rack
+        for (auto plugin : te::getAllPlugins (edit, false))
+            if (auto typed = dynamic_cast<PluginType*> (plugin))
+                return typed;
+
+        return nullptr;
+    }
+
+    te::AutomatableParameter* getTrackVolume (te::Edit& edit, int trackIndex)
+    {
+        if (auto track = EngineHelpers::getAudioTrack (edit, trackIndex))
+            if (auto volPan = dynamic_cast<te::VolumeAndPanPlugin*> (EngineHelpers::getPlugin (*track, te::VolumeAndPanPlugin::xmlTypeName).get()))
+                return volPan->volParam.get();
+
+        return nullptr;
+    }
+
+    // Steps an automation curve to a new value with a 1 ms ramp, the way a
+    // button press or a pad hit changes a parameter
+    void addStep (te::AutomatableParameter& param, double timeSeconds, float from, float to)
+    {
+        auto& curve = param.getCurve();
+        curve.addPoint (tracktion::TimePosition::fromSeconds (juce::jmax (0.0, timeSeconds - 0.001)), from, 0.0f, nullptr);
+        curve.addPoint (tracktion::TimePosition::fromSeconds (timeSeconds), to, 0.0f, nullptr);
+    }
+
+    //==============================================================================
+    // Scripted performances
+
+    // Chops as ChopComponent::handleChopButtonPressed makes them: beat-length clips on
+    // the chop track. ChopPlugin switches between the two deck tracks from a UI timer,
+    // which doesn't run during an offline render, so the same switch is written as
+    // volume automation (deck 1 off, the beat-delayed deck 2 on, for each chop).
+    void scriptChops (te::Edit& edit)
+    {
+        auto chopTrack = EngineHelpers::getChopTrack (edit);
+        auto* deck1 = getTrackVolume (edit, 0);
+        auto* deck2 = getTrackVolume (edit, 1);
+        REQUIRE (chopTrack != nullptr);
+        REQUIRE (deck1 != nullptr);
+        REQUIRE (deck2 != nullptr);
+
+        // { start beat, length in beats }, using each of the chop durations on offer
+        constexpr std::pair<double, double> chops[] = { { 2.0, 1.0 }, { 5.0, 0.5 }, { 6.5, 0.25 }, { 8.0, 2.0 }, { 12.0, 4.0 } };
+
+        deck1->getCurve().addPoint (tracktion::TimePosition(), 1.0f, 0.0f, nullptr);
+        deck2->getCurve().addPoint (tracktion::TimePosition(), 0.0f, 0.0f, nullptr);
+
+        for (auto [startBeat, lengthInBeats] : chops)
+        {
+            const auto start = edit.tempoSequence.toTime (tracktion::BeatPosition::fromBeats (startBeat));
+            const auto end = edit.tempoSequence.toTime (tracktion::BeatPosition::fromBeats (startBeat + lengthInBeats));
+
+            REQUIRE (chopTrack->insertNewClip (te::TrackItem::Type::arranger, tracktion::TimeRange (start, end), nullptr) != nullptr);
+
+            addStep (*deck1, start.inSeconds(), 1.0f, 0.0f);
+            addStep (*deck2, start.inSeconds(), 0.0f, 1.0f);
+            addStep (*deck1, end.inSeconds(), 0.0f, 1.0f);
+            addStep (*deck2, end.inSeconds(), 1.0f, 0.0f);
+        }
+    }
+
+    // The 80% button on ScrewComponent, applied the way MainComponent::updateTempo does
+    void scriptScrew (te::Edit& edit)
+    {
+        EngineHelpers::setTempo (edit, sourceBpm * 0.8);
+        REQUIRE (edit.tempoSequence.getNumTempos() == 1);
+    }
+
+    // A baby scratch on the master ScratchPlugin: forward and back every eighth
+    // note for a bar, then a slower release back to centre
+    void scriptScratch (te::Edit& edit)
+    {
+        auto* scratch = findPlugin<ScratchPlugin> (edit);
+        REQUIRE (scratch != nullptr);
+
+        const auto eighth = 60.0 / sourceBpm / 2.0;
+        const auto start = 2.0;
+        auto& scratchCurve = scratch->scratchParam->getCurve();
+
+        scratch->depthParam->getCurve().addPoint (tracktion::TimePosition(), 0.7f, 0.0f, nullptr);
+        scratchCurve.addPoint (tracktion::TimePosition::fromSeconds (start), 0.0f, 0.0f, nullptr);
+
+        for (int i = 0; i < 8; ++i)
+            scratchCurve.addPoint (tracktion::TimePosition::fromSeconds (start + eighth * (i + 1)),
+                                   (i % 2) == 0 ? 0.8f : -0.6f, 0.0f, nullptr);
+
+        scratchCurve.addPoint (tracktion::TimePosition::fromSeconds (start + eighth * 12), 0.0f, 0.0f, nullptr);
+    }
+
+    struct Scenario
+    {
+        const char* name;
+        std::function<void (te::Edit&)> script;
+    };
+
+    const std::vector<Scenario>& getScenarios()
+    {
+        static const std::vector<Scenario> scenarios {
+            { "import",  [] (te::Edit&) {} },
+            { "chops",   scriptChops },
+            { "screw",   scriptScrew },
+            { "scratch", scriptScratch },
+            { "set",     [] (te::Edit& edit) { scriptScrew (edit); scriptChops (edit); scriptScratch (edit); } },
+        };
+
+        return scenarios;
+    }
+
+    //==============================================================================
+    juce::AudioBuffer<float> renderEdit (te::Edit& edit, const juce::File& destFile)
+    {
+        // Everything that could depend on the machine's audio setup is pinned here
+        te::Renderer::Parameters params (edit);
+        params.destFile = destFile;
+        params.audioFormat = edit.engine.getAudioFileFormatManager().getWavFormat();
+        params.bitDepth = 32;
+        params.sampleRateForAudio = sampleRate;
+        params.blockSizeForAudio = blockSize;
+        params.time = { tracktion::TimePosition(), edit.getLength() };
+        params.tracksToDo = te::toBitSet (te::getAllTracks (edit));
+        params.usePlugins = true;
+        params.useMasterPlugins = true;
+        params.realTimeRender = false;
+
+        destFile.deleteFile();
+        te::Renderer::renderToFile ("Render regression", params);
+        REQUIRE (destFile.existsAsFile());
+
+        return readWavFile (destFile);
+    }
+
+    struct Fingerprint
+    {
+        juce::String sha256;
+        int numChannels = 0;
+        int numSamples = 0;
+        std::vector<std::array<float, numBands>> frames;
+    };
+
+    juce::String hashSamples (const juce::AudioBuffer<float>& buffer)
+    {
+        juce::MemoryBlock data;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            data.append (buffer.getReadPointer (ch), (size_t) buffer.getNumSamples() * sizeof (float));
+
+        return juce::SHA256 (data).toHexString();
+    }
+
+    std::vector<std::array<float, numBands>> analyseBands (const juce::AudioBuffer<float>& buffer)
+    {
+        juce::dsp::FFT fft (fftOrder);
+        juce::dsp::WindowingFunction<float> window ((size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false);
+        std::vector<float> fftData ((size_t) fftSize * 2);
+
+        // Bin ranges for each log-spaced band
+        std::array<std::pair<int, int>, numBands> bandBins;
+
+        for (int b = 0; b < numBands; ++b)
+        {
+            auto edgeToBin = [] (int edge)
+            {
+                const auto hz = minBandHz * std::pow (maxBandHz / minBandHz, (float) edge / numBands);
+                return juce::jlimit (1, fftSize / 2, (int) std::round (hz * fftSize / sampleRate));
+            };
+
+            bandBins[(size_t) b] = { edgeToBin (b), juce::jmax (edgeToBin (b) + 1, edgeToBin (b + 1)) };
+        }
+
+        std::vector<std::array<float, numBands>> frames;
+        const auto gain = 1.0f / (float) buffer.getNumChannels();
+
+        for (int start = 0; start + fftSize <= buffer.getNumSamples(); start += hopSize)
+        {
+            std::fill (fftData.begin(), fftData.end(), 0.0f);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                juce::FloatVectorOperations::addWithMultiply (fftData.data(), buffer.getReadPointer (ch, start), gain, fftSize);
+
+            window.multiplyWithWindowingTable (fftData.data(), (size_t) fftSize);
+            fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+            auto& frame = frames.emplace_back();
+
+            for (int b = 0; b < numBands; ++b)
+            {
+                const auto [first, last] = bandBins[(size_t) b];
+                double energy = 0.0;
+
+                for (int bin = first; bin < last; ++bin)
+                    energy += (double) fftData[(size_t) bin] * fftData[(size_t) bin];
+
+                const auto db = juce::Decibels::gainToDecibels ((float) std::sqrt (energy / (last - first)) / (fftSize / 4.0f), -100.0f);
+                frame[(size_t) b] = std::round (db * 100.0f) / 100.0f; // keeps the golden files readable
+            }
+        }
+
+        return frames;
+    }
+
+    Fingerprint createFingerprint (const juce::AudioBuffer<float>& buffer)
+    {
+        return { hashSamples (buffer), buffer.getNumChannels(), buffer.getNumSamples(), analyseBands (buffer) };
+    }
+
+    //==============================================================================
+    void saveGolden (const Fingerprint& fingerprint, const juce::File& file)
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty ("sha256", fingerprint.sha256);
+        obj->setProperty ("numChannels", fingerprint.numChannels);
+        obj->setProperty ("numSamples", fingerprint.numSamples);
+
+        juce::Array<juce::var> frames;
+
+        for (const auto& frame : fingerprint.frames)
+        {
+            juce::Array<juce::var> bands;
+
+            for (auto db : frame)
+                bands.add (db);
+
+            frames.add (bands);
+        }
+
+        obj->setProperty ("bands", frames);
+
+        REQUIRE (file.getParentDirectory().createDirectory());
+        REQUIRE (file.replaceWithText (juce::JSON::toString (juce::var (obj), true)));
+    }
+
+    std::optional<Fingerprint> loadGolden (const juce::File& file)
+    {
+        if (! file.existsAsFile())
+            return std::nullopt;
+
+        const auto json = juce::JSON::parse (file);
+
+        Fingerprint fingerprint;
+        fingerprint.sha256 = json["sha256"].toString();
+        fingerprint.numChannels = json["numChannels"];
+        fingerprint.numSamples = json["numSamples"];
+
+        if (auto* frames = json["bands"].getArray())
+        {
+            for (const auto& frame : *frames)
+            {
+                auto& bands = fingerprint.frames.emplace_back();
+
+                for (int b = 0; b < numBands; ++b)
+                    bands[(size_t) b] = (float) frame[b];
+            }
+        }
+
+        return fingerprint;
+    }
+
+    struct SpectralDifference
+    {
+        float maxDb = 0.0f;
+        float rmsDb = 0.0f;
+        int worstFrame = -1;
+        int worstBand = -1;
+    };
+
+    SpectralDifference compareBands (const Fingerprint& a, const Fingerprint& b)
+    {
+        SpectralDifference result;
+        double sumSquares = 0.0;
+        int count = 0;
+
+        for (size_t f = 0; f < std::min (a.frames.size(), b.frames.size()); ++f)
+        {
+            for (size_t band = 0; band < (size_t) numBands; ++band)
+            {
+                const auto dbA = a.frames[f][band];
+                const auto dbB = b.frames[f][band];
+
+                // Differences between two near-silent bands are just noise
+                if (dbA < silenceFloorDb && dbB < silenceFloorDb)
+                    continue;
+
+                const auto diff = std::abs (dbA - dbB);
+                sumSquares += diff * diff;
+                ++count;
+
+                if (diff > result.maxDb)
+                    result = { diff, result.rmsDb, (int) f, (int) band };
+            }
+        }
+
+        result.rmsDb = count > 0 ? (float) std::sqrt (sumSquares / count) : 0.0f;
+        return result;
+    }
+}
+
+//==============================================================================
+TEST_CASE ("Offline renders match their goldens", "[render][regression]")
+{
+    ChopShopEngine chopShopEngine;
+    auto& engine = chopShopEngine.engine;
+    TemporaryDirectory tempDir;
+
+    const auto sourceFile = writeWavFile (createSourceSignal(), sampleRate, tempDir.getChildFile ("source.wav"), 32);
+
+    for (const auto& scenario : getScenarios())
+    {
+        DYNAMIC_SECTION (scenario.name)
+        {
+            auto edit = LibraryComponent::createEditForAudioFile (engine, sourceFile, (float) sourceBpm);
+            REQUIRE (edit != nullptr);
+
+            scenario.script (*edit);
+
+            const auto rendered = renderEdit (*edit, tempDir.getChildFile (juce::String (scenario.name) + ".wav"));
+            REQUIRE (rendered.getNumSamples() > 0);
+            CHECK (rendered.findMinMax (0, 0, rendered.getNumSamples()).getLength() > 0.0f); // not silent
+
+            const auto actual = createFingerprint (rendered);
+            const auto goldenFile = getGoldensDirectory().getChildFile (juce::String (scenario.name) + ".json");
+            const auto golden = loadGolden (goldenFile);
+
+            if (TestOptions::regenerateGoldens)
+            {
+                saveGolden (actual, goldenFile);
+                WARN ("Recorded golden " << goldenFile.getFullPathName() << ", commit it with the change");
+                continue;
+            }
+
+            if (! golden.has_value())
+                SKIP ("No golden at " << goldenFile.getFullPathName() << "; record it with --regenerate-goldens and commit it");
+
+            INFO ("Golden: " << goldenFile.getFullPathName());
+            REQUIRE (actual.numChannels == golden->numChannels);
+            REQUIRE (actual.numSamples == golden->numSamples);
+
+            if (actual.sha256 == golden->sha256)
+                continue;
+
+            if (TestOptions::requireBitExact)
+                FAIL_CHECK ("Render is no longer bit-identical to the golden");
+            else
+                WARN (scenario.name << " render is no longer bit-identical, falling back to the spectral comparison");
+
+            const auto difference = compareBands (actual, *golden);
+            INFO ("Worst band difference " << difference.maxDb << " dB in frame " << difference.worstFrame
+                                           << ", band " << difference.worstBand << "; RMS " << difference.rmsDb << " dB");
+            CHECK (actual.frames.size() == golden->frames.size());
+            CHECK (difference.maxDb <= maxBandDifferenceDb);
+            CHECK (difference.rmsDb <= maxRmsDifferenceDb);
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "Analysis/TempoMap.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("A drifting track gets a tempo map that stays in phase", "[analysis]")
+{
+    constexpr double seconds = 120.0, startBpm = 117.0, endBpm = 123.0;
+    auto bpmAt = [] (double t) { return startBpm + (endBpm - startBpm) * t / seconds; };
+
+    TemporaryDirectory tempDir;
+    const auto analysis = analyseFile (writeWavFile (createDriftingClickTrack (seconds, startBpm, endBpm),
+                                                     referenceSampleRate, tempDir.getChildFile ("drifting.wav")));
+    const auto& map = analysis.tempoMap;
+
+    REQUIRE (! map.isSteady());
+
+    for (auto& point : map.points)
+        CHECK (point.bpm == Catch::Approx (bpmAt (point.time)).margin (0.75));
+
+    // What matters for the grid: the beat count stays in phase to the end
+    CHECK (map.getBeatAt (seconds) == Catch::Approx ((startBpm + endBpm) / 2.0 * seconds / 60.0).margin (0.25));
+    CHECK (TempoMap::fromString (map.toString()).points.size() == map.points.size());
+}
+
+TEST_CASE ("A steady track keeps a single tempo", "[analysis]")
+{
+    TemporaryDirectory tempDir;
+    const auto analysis = analyseFile (writeWavFile (createClickTrack (referenceSampleRate, 120.0, referenceBpm),
+                                                     referenceSampleRate, tempDir.getChildFile ("steady.wav")));
+
+    CHECK (analysis.tempoMap.isSteady());
+}
@@ -0,0 +1,450 @@
+#pragma once
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <tracktion_engine/tracktion_engine.h>
+
+#include "Analysis/AnalysisPipeline.h"
+#include "Analysis/KeyAnalyzer.h"
+#include "Analysis/LoudnessAnalyzer.h"
+#include "Analysis/MusicalKey.h"
+#include "Analysis/TrackAnalysis.h"
+#include "LibraryComponent.h"
+#include "LibraryIndex.h"
+#include "OscilloscopePlugin.h"
+#include "PluginAutomationComponent.h"
+#include "Plugins/AutoDelayPlugin.h"
+#include "Plugins/AutoPhaserPlugin.h"
+#include "Plugins/AutoReverbPlugin.h"
+#include "Plugins/ChopPlugin.h"
+#include "Plugins/FlangerPlugin.h"
+#include "Plugins/ScratchPlugin.h"
+#include "ThumbnailComponent.h"
+#include "TransportBar.h"
+
+// Setup shared by the Tests, RealtimeTests and Benchmarks targets
+namespace TestFixtures
+{
+    constexpr double referenceSampleRate = 44100.0;
+    constexpr double referenceBpm = 120.0;
+
+    // An engine with the same built-in plugins MainComponent registers
+    struct ChopShopEngine
+    {
+        ChopShopEngine()
+        {
+            auto& plugins = engine.getPluginManager();
+            plugins.createBuiltInType<AutoReverbPlugin>();
+            plugins.createBuiltInType<FlangerPlugin>();
+            plugins.createBuiltInType<AutoDelayPlugin>();
+            plugins.createBuiltInType<AutoPhaserPlugin>();
+            plugins.createBuiltInType<ScratchPlugin>();
+            plugins.createBuiltInType<ChopPlugin>();
+            plugins.createBuiltInType<tracktion::engine::OscilloscopePlugin>();
+        }
+
+        tracktion::engine::Engine engine { "ChopShopTests" };
+    };
+
+    // A scratch directory removed with everything in it when the test ends
+    struct TemporaryDirectory
+    {
+        TemporaryDirectory()
+        {
+            REQUIRE (directory.createDirectory());
+        }
+
+        ~TemporaryDirectory()
+        {
+            directory.deleteRecursively();
+        }
+
+        juce::File getChildFile (const juce::String& name) const   { return directory.getChildFile (name); }
+
+        const juce::File directory = juce::File::createTempFile ("chopshop-tests");
+
+        JUCE_DECLARE_NON_COPYABLE (TemporaryDirectory)
+    };
+
+    // A 1 kHz click on every beat over a quiet two-note pad, so tempo detection has
+    // transients to lock onto and the effects have tonal content to chew on
+    inline juce::AudioBuffer<float> createClickTrack (double sampleRate, double seconds, double bpm, int numChannels = 2)
+    {
+        const auto numSamples = (int) (sampleRate * seconds);
+        const auto samplesPerBeat = sampleRate * 60.0 / bpm;
+        const auto clickLength = sampleRate * 0.02;
+        constexpr auto twoPi = juce::MathConstants<double>::twoPi;
+
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto t = i / sampleRate;
+            auto sample = 0.1 * std::sin (twoPi * 110.0 * t) + 0.05 * std::sin (twoPi * 164.8 * t);
+
+            const auto posInBeat = std::fmod ((double) i, samplesPerBeat);
+
+            if (posInBeat < clickLength)
+                sample += 0.8 * std::exp (-5.0 * posInBeat / clickLength) * std::sin (twoPi * 1000.0 * t);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.setSample (ch, i, (float) sample);
+        }
+
+        return buffer;
+    }
+
+    inline juce::File writeWavFile (const juce::AudioBuffer<float>& buffer, double sampleRate, const juce::File& file,
+                                    int bitsPerSample = 24)
+    {
+        file.deleteFile();
+
+        juce::WavAudioFormat wav;
+        auto out = file.createOutputStream();
+        REQUIRE (out != nullptr);
+
+        std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (out.get(), sampleRate,
+                                                                              (unsigned int) buffer.getNumChannels(),
+                                                                              bitsPerSample, {}, 0));
+        REQUIRE (writer != nullptr);
+        out.release(); // now owned by the writer
+
+        writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+        return file;
+    }
+
+    inline juce::AudioBuffer<float> readWavFile (const juce::File& file)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader (wav.createReaderFor (file.createInputStream().release(), true));
+        REQUIRE (reader != nullptr);
+
+        juce::AudioBuffer<float> buffer ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+        return buffer;
+    }
+
+    inline std::unique_ptr<juce::AudioFormatReader> createReaderFor (const juce::File& file)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (file));
+        REQUIRE (reader != nullptr);
+        return reader;
+    }
+
+    // What a library import works out about a file
+    inline TrackAnalysis analyseFile (const juce::File& file)
+    {
+        return TrackAnalysis::analyse (*createReaderFor (file));
+    }
+
+    inline MusicalKey detectKey (const juce::File& file, int numThreads = 1)
+    {
+        auto reader = createReaderFor (file);
+        KeyAnalyzer analyzer;
+        AnalysisPipeline pipeline (numThreads);
+        pipeline.addAnalyzer (analyzer);
+        pipeline.run (*reader);
+        return analyzer.getKey();
+    }
+
+    // Feeds a signal through the analyzer in pipeline-sized blocks
+    inline void analyseLoudness (LoudnessAnalyzer& analyzer, const juce::AudioBuffer<float>& signal, double sampleRate)
+    {
+        analyzer.prepare (sampleRate, signal.getNumChannels(), signal.getNumSamples());
+        juce::AudioBuffer<float> block (signal.getNumChannels(), AnalysisPipeline::blockSize);
+
+        for (int pos = 0; pos < signal.getNumSamples(); pos += AnalysisPipeline::blockSize)
+        {
+            const auto n = std::min (AnalysisPipeline::blockSize, signal.getNumSamples() - pos);
+
+            for (int ch = 0; ch < signal.getNumChannels(); ++ch)
+                block.copyFrom (ch, 0, signal, ch, pos, n);
+
+            analyzer.process (block, n);
+        }
+
+        analyzer.finish();
+    }
+
+    // A click track whose tempo drifts linearly from startBpm to endBpm, like a live take
+    inline juce::AudioBuffer<float> createDriftingClickTrack (double seconds, double startBpm, double endBpm)
+    {
+        constexpr auto twoPi = juce::MathConstants<double>::twoPi;
+
+        juce::AudioBuffer<float> buffer (2, (int) (referenceSampleRate * seconds));
+        double beatPhase = 0.0;
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const auto t = i / referenceSampleRate;
+            const auto bpm = startBpm + (endBpm - startBpm) * t / seconds;
+            beatPhase += bpm / 60.0 / referenceSampleRate;
+
+            const auto sinceBeat = (beatPhase - std::floor (beatPhase)) * 60.0 / bpm;
+            auto sample = 0.1 * std::sin (twoPi * 110.0 * t);
+
+            if (sinceBeat < 0.02)
+                sample += 0.8 * std::exp (-5.0 * sinceBeat / 0.02) * std::sin (twoPi * 1000.0 * t);
+
+            buffer.setSample (0, i, (float) sample);
+            buffer.setSample (1, i, (float) sample);
+        }
+
+        return buffer;
+    }
+
+    // A silent lead-in, some soft pickup beats, then bars at referenceBpm with a kick
+    // on the one and a silent tail: the decks should start on the first kick
+    inline juce::AudioBuffer<float> createDownbeatTrack (double seconds, double leadIn, int pickupBeats, double tail)
+    {
+        constexpr auto twoPi = juce::MathConstants<double>::twoPi;
+        constexpr auto beat = 60.0 / referenceBpm;
+
+        juce::AudioBuffer<float> buffer (2, (int) (referenceSampleRate * seconds));
+        juce::Random random (3);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const auto t = i / referenceSampleRate;
+            auto sample = 0.0;
+
+            if (t >= leadIn && t < seconds - tail)
+            {
+                const auto beatNumber = (int) std::floor ((t - leadIn) / beat);
+                const auto sinceBeat = t - leadIn - beatNumber * beat;
+                const auto beatInBar = ((beatNumber - pickupBeats) % 4 + 4) % 4;
+                const auto amplitude = beatNumber < pickupBeats ? 0.25 : (beatInBar == 0 ? 1.0 : (beatInBar == 2 ? 0.6 : 0.35));
+
+                sample = 0.05 * std::sin (twoPi * 110.0 * t);
+
+                if (beatInBar == 0 && beatNumber >= pickupBeats)
+                    sample += amplitude * std::exp (-40.0 * sinceBeat) * std::sin (twoPi * (60.0 + 200.0 * std::exp (-50.0 * sinceBeat)) * sinceBeat);
+
+                sample += amplitude * 0.5 * std::exp (-60.0 * sinceBeat) * (random.nextFloat() * 2.0 - 1.0);
+            }
+
+            buffer.setSample (0, i, (float) sample);
+            buffer.setSample (1, i, (float) sample);
+        }
+
+        return buffer;
+    }
+
+    // I-IV-V-I in a major key or i-iv-V-i in a minor one, as four-harmonic triads
+    // over a root bass, with a noise hat on every beat so there's something atonal
+    // in the spectrum too
+    inline juce::AudioBuffer<float> createKeyFixture (MusicalKey key, double seconds)
+    {
+        constexpr auto twoPi = juce::MathConstants<double>::twoPi;
+        const auto numSamples = (int) (referenceSampleRate * seconds);
+
+        juce::AudioBuffer<float> buffer (2, numSamples);
+        juce::Random random (key.tonic * 2 + (key.minor ? 1 : 0));
+
+        auto frequencyOf = [] (int pitchClass, double octaveC) { return octaveC * std::pow (2.0, (pitchClass % 12) / 12.0); };
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto t = i / referenceSampleRate;
+            const auto degree = std::array<int, 4> { 0, 5, 7, 0 }[(size_t) ((int) (t * 8.0 / seconds) % 4)];
+            const auto root = key.tonic + degree;
+            const auto third = root + ((key.minor && degree != 7) ? 3 : 4);
+
+            double sample = 0.15 * std::sin (twoPi * frequencyOf (root, 65.41) * t);
+
+            for (auto note : { root, third, root + 7 })
+                for (int harmonic = 1; harmonic <= 4; ++harmonic)
+                    sample += 0.05 / harmonic * std::sin (twoPi * harmonic * frequencyOf (note, 261.63) * t);
+
+            if (const auto sinceBeat = std::fmod (t, 60.0 / referenceBpm); sinceBeat < 0.05)
+                sample += 0.3 * std::exp (-60.0 * sinceBeat) * (random.nextFloat() * 2.0 - 1.0);
+
+            buffer.setSample (0, i, (float) sample);
+            buffer.setSample (1, i, (float) sample);
+        }
+
+        return buffer;
+    }
+
+    // A large library with names, tempos and keys spread the way a real one's are.
+    // Deterministic, so runs are comparable.
+    inline std::vector<LibraryIndex::Entry> createLibraryEntries (int numEntries)
+    {
+        const juce::StringArray firstWords { "Deep", "Dub", "Late", "Broken", "Warm", "Acid", "Lost", "Silver", "Night", "Dusty" };
+        const juce::StringArray secondWords { "Groove", "Step", "Signal", "Tape", "Circuit", "Garden", "Engine", "Sermon", "Drift", "Break" };
+        const juce::StringArray musicalKeys { "C", "Am", "G", "Em", "D", "Bm", "A", "F#m", "E", "C#m", "F", "Dm" };
+        juce::Random random (42);
+
+        std::vector<LibraryIndex::Entry> entries;
+        entries.reserve ((size_t) numEntries);
+
+        for (int i = 0; i < numEntries; ++i)
+        {
+            LibraryIndex::Entry entry;
+            entry.id = tracktion::engine::ProjectItemID (i + 1, 1);
+            entry.name = firstWords[random.nextInt (firstWords.size())] + " "
+                       + secondWords[random.nextInt (secondWords.size())] + " " + juce::String (i);
+            entry.bpm = 70.0f + (float) random.nextInt (1100) / 10.0f;
+            entry.duration = 120.0 + random.nextInt (480);
+            entry.key = musicalKeys[random.nextInt (musicalKeys.size())];
+            entry.dateAdded = 1700000000000 + (juce::int64) i * 60000;
+            entry.fileHash = random.nextInt64();
+            entries.push_back (entry);
+        }
+
+        return entries;
+    }
+
+    //==============================================================================
+    // A click track imported as LibraryComponent::addToLibrary imports one
+    struct ReferenceEdit
+    {
+        explicit ReferenceEdit (double seconds = 60.0)
+            : sourceFile (writeWavFile (createClickTrack (referenceSampleRate, seconds, referenceBpm),
+                                        referenceSampleRate, tempDir.getChildFile ("reference.wav"))),
+              edit (LibraryComponent::createEditForAudioFile (chopShopEngine.engine, sourceFile, (float) referenceBpm))
+        {
+            REQUIRE (edit != nullptr);
+        }
+
+        ChopShopEngine chopShopEngine;
+        TemporaryDirectory tempDir;
+        const juce::File sourceFile;
+        std::unique_ptr<tracktion::engine::Edit> edit;
+
+        JUCE_DECLARE_NON_COPYABLE (ReferenceEdit)
+    };
+
+    inline void runDispatchLoopFor (int milliseconds)
+    {
+        juce::MessageManager::getInstance()->runDispatchLoopUntil (milliseconds);
+    }
+
+    // The components that animate while the transport plays: the thumbnail, the
+    // transport bar and the Edit's ChopPlugin
+    struct AnimatedComponents
+    {
+        explicit AnimatedComponents (tracktion::engine::Edit& edit)
+            : thumbnail (edit, zoomState), transportBar (edit, zoomState)
+        {
+            thumbnail.setBounds (0, 0, 1200, 200);
+            transportBar.setBounds (0, 0, 1200, 40);
+
+            for (auto plugin : tracktion::engine::getAllPlugins (edit, false))
+                if (auto chop = dynamic_cast<ChopPlugin*> (plugin))
+                    chopPlugin = chop;
+
+            REQUIRE (chopPlugin != nullptr);
+
+            // The thumbnail's proxy and the plugin's registration arrive asynchronously
+            runDispatchLoopFor (1000);
+        }
+
+        ZoomState zoomState;
+        ThumbnailComponent thumbnail;
+        TransportBar transportBar;
+        ChopPlugin* chopPlugin = nullptr;
+    };
+
+    // The label TransportBar shows the position, time signature and tempo in
+    inline juce::Label* findTimeDisplay (TransportBar& transportBar)
+    {
+        juce::Label* timeDisplay = nullptr;
+
+        for (auto* child : transportBar.getChildren())
+            if (auto* label = dynamic_cast<juce::Label*> (child))
+                timeDisplay = label;
+
+        REQUIRE (timeDisplay != nullptr);
+        return timeDisplay;
+    }
+
+    // The time display's text, worked out from scratch from the transport and tempo sequence
+    inline juce::String formatTransportDisplay (tracktion::engine::Edit& edit)
+    {
+        auto& transport = edit.getTransport();
+        auto position = createPosition (edit.tempoSequence);
+        position.set (transport.getPosition());
+
+        auto barsBeats = position.getBarsBeats();
+        auto timeSignature = position.getTimeSignature();
+        auto seconds = transport.getPosition().inSeconds();
+
+        return juce::String::formatted ("%02d:%02d:%03d | %d/%d | Bar %d | %.1f BPM",
+                                        (int) (seconds / 60.0), (int) seconds % 60, (int) (seconds * 1000) % 1000,
+                                        timeSignature.numerator, timeSignature.denominator,
+                                        barsBeats.bars + 1, position.getTempo());
+    }
+
+    inline std::vector<juce::Slider*> findSliders (juce::Component& component)
+    {
+        std::vector<juce::Slider*> sliders;
+
+        for (auto* child : component.getChildren())
+        {
+            if (auto* slider = dynamic_cast<juce::Slider*> (child))
+                sliders.push_back (slider);
+
+            for (auto* slider : findSliders (*child))
+                sliders.push_back (slider);
+        }
+
+        return sliders;
+    }
+
+    inline juce::MouseEvent createMouseEvent (juce::Component& component, juce::Point<float> position, bool dragged)
+    {
+        return juce::MouseEvent (juce::Desktop::getInstance().getMainMouseSource(), position, {}, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                                 &component, &component, juce::Time::getCurrentTime(), position, juce::Time::getCurrentTime(),
+                                 1, dragged);
+    }
+
+    // Every parameter of every rack effect expanded, in a viewport a few lanes high
+    struct RackAutomationPanels
+    {
+        explicit RackAutomationPanels (tracktion::engine::Edit& edit)
+        {
+            viewport.setViewedComponent (&container, false);
+            viewport.setBounds (0, 0, 1200, 300);
+
+            for (auto type : { AutoReverbPlugin::xmlTypeName, AutoDelayPlugin::xmlTypeName,
+                               AutoPhaserPlugin::xmlTypeName, FlangerPlugin::xmlTypeName, ScratchPlugin::xmlTypeName })
+            {
+                auto& plugin = plugins.emplace_back (edit.getPluginCache().createNewPlugin (type, {}));
+                REQUIRE (plugin != nullptr);
+                numParameters += plugin->getAutomatableParameters().size();
+
+                auto& panel = panels.emplace_back (std::make_unique<PluginAutomationComponent> (edit, plugin.get()));
+                container.addAndMakeVisible (*panel);
+                panel->setGroupCollapsed (false);
+                panel->setBounds (0, height, 1200, (int) panel->getPreferredHeight());
+                height += panel->getHeight();
+            }
+
+            container.setSize (1200, height);
+        }
+
+        int countLiveLanes() const
+        {
+            int live = 0;
+
+            for (auto& panel : panels)
+                for (auto* child : panel->getChildren())
+                    live += (dynamic_cast<AutomationLane*> (child) != nullptr && child->isVisible()) ? 1 : 0;
+
+            return live;
+        }
+
+        juce::Viewport viewport;
+        juce::Component container;
+        std::vector<tracktion::engine::Plugin::Ptr> plugins;
+        std::vector<std::unique_ptr<PluginAutomationComponent>> panels;
+        int numParameters = 0, height = 0;
+
+        JUCE_DECLARE_NON_COPYABLE (RackAutomationPanels)
+    };
+}
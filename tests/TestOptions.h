@@ -0,0 +1,11 @@
+#pragma once
+
+// Command line switches for the Tests executable, parsed in Catch2Main.cpp
+namespace TestOptions
+{
+    // Re-record every render regression golden instead of comparing against it
+    inline bool regenerateGoldens = false;
+
+    // Treat a golden hash mismatch as a failure even when the spectra still match
+    inline bool requireBitExact = false;
+}
@@ -0,0 +1,35 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("The transport display matches a full update", "[ui]")
+{
+    ChopShopEngine chopShopEngine;
+    auto edit = tracktion::engine::Edit::createSingleTrackEdit (chopShopEngine.engine);
+    auto& transport = edit->getTransport();
+
+    ZoomState zoomState;
+    TransportBar transportBar (*edit, zoomState);
+    transportBar.setBounds (0, 0, 1200, 40);
+    auto* timeDisplay = findTimeDisplay (transportBar);
+
+    // A position a few milliseconds on each frame, as playback moves it
+    double timeMs = 0.0;
+
+    for (int frame = 0; frame < 100; ++frame)
+    {
+        transport.setPosition (tracktion::TimePosition::fromSeconds (12.0 + frame * 0.0167));
+        timeMs += 16.7;
+        transportBar.frameCallback (timeMs);
+        CHECK (timeDisplay->getText() == formatTransportDisplay (*edit));
+    }
+
+    // A tempo change is shown without the position moving
+    edit->tempoSequence.getTempo (0)->setBpm (140.0);
+    transportBar.frameCallback (timeMs + 16.7);
+    CHECK (timeDisplay->getText() == formatTransportDisplay (*edit));
+    CHECK (timeDisplay->getText().contains ("140.0 BPM"));
+}
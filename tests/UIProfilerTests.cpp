@@ -0,0 +1,42 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "UIProfiler.h"
+#include "TestFixtures.h"
+
+using namespace TestFixtures;
+
+//==============================================================================
+TEST_CASE ("Only the outermost profiler timing counts towards the frame", "[ui]")
+{
+    auto& profiler = UIProfiler::instance();
+    profiler.setEnabled (true);
+    profiler.reset();
+    profiler.beginFrame (juce::Time::getMillisecondCounterHiRes());
+
+    {
+        const UIProfiler::ScopedTimer outer ("Test::outer");
+        const UIProfiler::ScopedTimer inner ("Test::inner");
+        juce::Thread::sleep (2);
+    }
+
+    // Nested timings are kept
+    CHECK (profiler.getStats().size() == 2);
+
+    const auto worst = profiler.getWorstFrame();
+    CHECK (worst.breakdown.size() == 1);
+    CHECK (worst.breakdown.count (juce::Identifier ("Test::outer")) == 1);
+    CHECK (worst.busyMs >= 1.0);
+
+    juce::MemoryOutputStream trace;
+    profiler.writeTrace (trace);
+
+    const auto json = juce::JSON::parse (trace.toString());
+    const auto* events = json["traceEvents"].getArray();
+    REQUIRE (events != nullptr);
+
+    // Two thread names, two timings and the frame marker
+    CHECK (events->size() == 5);
+
+    profiler.setEnabled (false);
+    profiler.reset();
+}